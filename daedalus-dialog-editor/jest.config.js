@@ -10,6 +10,7 @@ const hasDaedalusParser = fs.existsSync(daedalusParserPath) || fs.existsSync(dae
 
 const moduleNameMapper = {
   '\\.(css|less|scss|sass)$': 'identity-obj-proxy',
+  '\\?worker$': '<rootDir>/tests/mocks/worker.ts',
 };
 
 // Only use mocks if the real parser is not available
@@ -17,6 +18,8 @@ if (!hasDaedalusParser) {
   console.log('Using mocks for daedalus-parser');
   moduleNameMapper['^daedalus-parser/semantic-code-generator$'] = '<rootDir>/tests/mocks/semantic-code-generator.ts';
   moduleNameMapper['^daedalus-parser/semantic-model$'] = '<rootDir>/tests/mocks/semantic-model.ts';
+  // Tracing has no native parts; run the parser package's source directly
+  moduleNameMapper['^daedalus-parser/tracing$'] = '<rootDir>/../daedalus-parser/src/core/tracing.js';
 }
 
 module.exports = {
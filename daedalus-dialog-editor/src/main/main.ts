@@ -1,19 +1,44 @@
-import { app, BrowserWindow, ipcMain, dialog } from 'electron';
+import { app, BrowserWindow, ipcMain, dialog, MessageChannelMain, type IpcMainInvokeEvent, type WebContents } from 'electron';
 import * as path from 'path';
 import { FileService } from './services/FileService';
 import { ParserService } from './services/ParserService';
-import { CodeGeneratorService } from './services/CodeGeneratorService';
-import { ValidationService } from './services/ValidationService';
+import { CodegenWorkerPool, type CodegenJobOptions } from './services/CodegenWorkerPool';
 import ProjectService from './services/ProjectService';
+import { IngestionService } from './services/IngestionService';
+import { ProjectWatcher } from './services/ProjectWatcherService';
 import { PathValidationService, PathValidationError } from './services/PathValidationService';
 import { SettingsService } from './services/SettingsService';
+import { TraceService } from './services/TraceService';
+import { ModelDocumentService } from './services/ModelDocumentService';
+import {
+  CodegenDocumentMissingError,
+  type CodegenRequest,
+  type ModelSource,
+  type PreparedSave,
+  type SaveTaskOptions
+} from './utils/codegenTasks';
+import { configureParseCache } from './utils/parseCache';
+import { isParseAbortError, type ParseRequestOptions } from '../shared/parseJobs';
+import { traceAsync, type TraceEvent } from 'daedalus-parser/tracing';
+import type { ModelDelta, ModelTask, ModelTaskResult } from '../shared/modelDelta';
+import type { ProjectIndexStreamMessage, ProjectIngestionMessage, ProjectWatchMessage } from '../shared/types';
 
 let mainWindow: BrowserWindow | null = null;
+// Enabled before the services start so their worker threads trace too
+const traceService = TraceService.fromEnv();
 const fileService = new FileService();
 const parserService = new ParserService();
-const codeGeneratorService = new CodeGeneratorService();
-const validationService = new ValidationService(parserService, codeGeneratorService);
+// Validation and code generation run on worker threads, off the IPC event loop
+const codegenPool = new CodegenWorkerPool();
+// Open files' models, kept current by renderer deltas so saves need not ship whole models.
+// Capped because a renderer that crashes or reloads never releases its files; an
+// evicted file's next save just sends its full model again.
+const MAX_MODEL_DOCUMENTS = 64;
+const modelDocuments = new ModelDocumentService(MAX_MODEL_DOCUMENTS);
 const projectService = new ProjectService();
+const ingestionService = new IngestionService(fileService, parserService);
+const activeIngestions = new Map<string, AbortController>();
+const activeWatchers = new Map<string, () => void>();
 const settingsService = new SettingsService();
 // Path validator starts empty - paths are added when user opens files/projects via dialogs
 const pathValidator = new PathValidationService([]);
@@ -36,12 +61,24 @@ function createWindow() {
     mainWindow.loadFile(path.join(__dirname, '../renderer/index.html'));
   }
 
+  // A (re)loading renderer starts without synced models, so the copies held for it are dead
+  mainWindow.webContents.on('did-start-loading', () => {
+    modelDocuments.clear();
+  });
+
   mainWindow.on('closed', () => {
     mainWindow = null;
   });
 }
 
 app.whenReady().then(async () => {
+  // Per-file parse results shared by all projects, so base scripts vendored by every mod parse once
+  try {
+    configureParseCache({ directory: path.join(app.getPath('userData'), 'parse-cache') })?.schedulePrune();
+  } catch (error) {
+    console.error('Failed to set up the parse cache:', error);
+  }
+
   // Initialize path validator with recent projects to allow opening them
   try {
     const recentProjects = await settingsService.getRecentProjects();
@@ -62,36 +99,173 @@ app.whenReady().then(async () => {
   });
 });
 
+app.on('will-quit', () => {
+  codegenPool.terminate();
+  if (!traceService) {
+    return;
+  }
+  try {
+    console.log(`[Trace] Session trace written to ${traceService.writeSession(app.getPath('logs'))}`);
+  } catch (error) {
+    console.error('[Trace] Failed to write session trace:', error);
+  }
+});
+
 app.on('window-all-closed', () => {
   if (process.platform !== 'darwin') {
     app.quit();
   }
 });
 
+const senderSignals = new WeakMap<WebContents, AbortSignal>();
+
+/**
+ * Validate, generate and write a model; the path must already be validated.
+ * With `delta` (what turned the previous save into `model`) the worker applies
+ * it to its own copy of the file, so unchanged declarations are neither cloned
+ * nor regenerated.
+ */
+async function saveModel(
+  event: IpcMainInvokeEvent,
+  filePath: string,
+  model: any,
+  settings: any,
+  options?: SaveTaskOptions,
+  delta?: ModelDelta
+) {
+  // Saves of the same file run in order on the worker that generated it last
+  const jobOptions = { signal: senderSignal(event), affinityKey: filePath };
+
+  // Forced saves without validation skip the sanity check, so stream the
+  // generated fragments straight into the encoder instead of building the full string.
+  if (options?.skipValidation && options?.forceOnErrors) {
+    return withModelDocument(filePath, model, delta, (source) =>
+      writeStreamed(filePath, { type: 'generateChunks', settings, ...source }, jobOptions));
+  }
+
+  // Validation, generation and the fallback sanity parse happen in the worker
+  const prepared = await withModelDocument(filePath, model, delta, (source) =>
+    codegenPool.run<PreparedSave>({ type: 'prepareSave', settings, options, ...source }, jobOptions));
+  if (prepared.blocked) {
+    console.warn(`[IPC] saveModel - Validation failed for ${filePath}, skipping save.`);
+    return {
+      success: false,
+      validationResult: prepared.validationResult
+    };
+  }
+
+  const writeResult = await fileService.writeFile(filePath, prepared.code!);
+  return prepared.validationResult ? { ...writeResult, validationResult: prepared.validationResult } : writeResult;
+}
+
+/**
+ * Run a codegen request on the worker's copy of the file when `delta` is
+ * given, so its unchanged declarations keep their identity and hit the
+ * generated-code cache; otherwise on the whole model.
+ */
+async function withModelDocument<T>(
+  filePath: string,
+  model: any,
+  delta: ModelDelta | undefined,
+  run: (source: ModelSource) => Promise<T>
+): Promise<T> {
+  if (!delta) {
+    return run({ model });
+  }
+
+  try {
+    return await run({ document: { key: filePath, delta } });
+  } catch (error) {
+    if (!(error instanceof CodegenDocumentMissingError)) {
+      throw error;
+    }
+  }
+
+  // The worker had no copy at the delta's base version; seed it with the whole model
+  const full: ModelDelta = { baseVersion: delta.version, version: delta.version, full: model };
+  return run({ document: { key: filePath, delta: full } });
+}
+
+/**
+ * Stream generated code into the file. The first fragment is awaited before
+ * the file is touched, so a missing worker copy surfaces as a
+ * CodegenDocumentMissingError rather than a failed write.
+ */
+async function writeStreamed(
+  filePath: string,
+  request: Extract<CodegenRequest, { type: 'generateChunks' }>,
+  jobOptions: CodegenJobOptions
+) {
+  const iterator = codegenPool.stream(request, jobOptions)[Symbol.asyncIterator]();
+  try {
+    const first = await iterator.next();
+    return await fileService.writeFileChunks(filePath, (async function* () {
+      for (let next = first; !next.done; next = await iterator.next()) {
+        yield next.value;
+      }
+    })());
+  } finally {
+    // Cancels the job if the write stopped early
+    await iterator.return?.();
+  }
+}
+
+/** Aborts once the requesting window goes away, so its queued codegen work is dropped */
+function senderSignal(event: IpcMainInvokeEvent): AbortSignal {
+  let signal = senderSignals.get(event.sender);
+  if (!signal) {
+    const controller = new AbortController();
+    if (event.sender.isDestroyed()) {
+      controller.abort();
+    } else {
+      event.sender.once('destroyed', () => controller.abort());
+    }
+    signal = controller.signal;
+    senderSignals.set(event.sender, signal);
+  }
+  return signal;
+}
+
+/** ipcMain.handle that records a span per invocation while tracing */
+function handleTraced(channel: string, handler: (event: IpcMainInvokeEvent, ...args: any[]) => Promise<unknown>) {
+  ipcMain.handle(channel, (event, ...args) => traceAsync(`ipc.${channel}`, () => handler(event, ...args)));
+}
+
 function setupIpcHandlers() {
+  // Tracing handlers
+  ipcMain.handle('trace:getConfig', () => ({ enabled: traceService !== null }));
+  ipcMain.on('trace:record', (event, events: TraceEvent[]) => {
+    traceService?.record(events, event.sender.getOSProcessId(), 'renderer');
+  });
+
   // Parser handler (main process has access to native modules)
-  ipcMain.handle('parser:parseSource', async (_event, sourceCode: string) => {
+  handleTraced('parser:parseSource', async (_event, sourceCode: string, options?: ParseRequestOptions) => {
     try {
-      return parserService.parseSource(sourceCode);
+      return await parserService.parseSource(sourceCode, options);
     } catch (error) {
-      console.error('[IPC] parser:parseSource error:', error);
+      if (!isParseAbortError(error)) {
+        console.error('[IPC] parser:parseSource error:', error);
+      }
       throw new Error(`Failed to parse source: ${error instanceof Error ? error.message : 'Unknown error'}`);
     }
   });
 
   // Code generator handlers
-  ipcMain.handle('generator:generateCode', async (_event, model: any, settings: any) => {
+  handleTraced('generator:generateCode', async (event, model: any, settings: any) => {
     try {
-      return codeGeneratorService.generateCode(model, settings);
+      return await codegenPool.run({ type: 'generateCode', model, settings }, { signal: senderSignal(event) });
     } catch (error) {
       console.error('[IPC] generator:generateCode error:', error);
       throw new Error(`Failed to generate code: ${error instanceof Error ? error.message : 'Unknown error'}`);
     }
   });
 
-  ipcMain.handle('generator:generateDialogCode', async (_event, model: any, dialogName: string, settings: any) => {
+  ipcMain.handle('generator:generateDialogCode', async (event, model: any, dialogName: string, settings: any) => {
     try {
-      return codeGeneratorService.generateDialogCode(model, dialogName, settings);
+      return await codegenPool.run(
+        { type: 'generateDialogCode', model, dialogName, settings },
+        { signal: senderSignal(event) }
+      );
     } catch (error) {
       console.error('[IPC] generator:generateDialogCode error:', error);
       throw new Error(`Failed to generate dialog code: ${error instanceof Error ? error.message : 'Unknown error'}`);
@@ -99,77 +273,72 @@ function setupIpcHandlers() {
   });
 
   // Validation handler - validates model without saving
-  ipcMain.handle('validation:validate', async (_event, model: any, settings: any, options?: any) => {
+  handleTraced('validation:validate', async (event, model: any, settings: any, options?: any) => {
     try {
-      return validationService.validate(model, settings, options);
+      return await codegenPool.run({ type: 'validate', model, settings, options }, { signal: senderSignal(event) });
     } catch (error) {
       console.error('[IPC] validation:validate error:', error);
       throw new Error(`Validation failed: ${error instanceof Error ? error.message : 'Unknown error'}`);
     }
   });
 
-  ipcMain.handle('generator:saveFile', async (_event, filePath: string, model: any, settings: any, options?: { skipValidation?: boolean; forceOnErrors?: boolean }) => {
+  handleTraced('generator:saveFile', async (event, filePath: string, model: any, settings: any, options?: SaveTaskOptions) => {
     try {
       // Validate path before saving
       pathValidator.validatePath(filePath);
 
-      // Validate model unless explicitly skipped
-      if (!options?.skipValidation) {
-        const validationResult = await validationService.validate(model, settings);
-
-        // If validation failed and not forcing save, return validation result
-        if (!validationResult.isValid && !options?.forceOnErrors) {
-          console.warn(`[IPC] generator:saveFile - Validation failed for ${filePath}, skipping save.`);
-          return {
-            success: false,
-            validationResult
-          };
-        }
-
-        // Use pre-generated code from validation if available
-        if (validationResult.generatedCode) {
-          const writeResult = await fileService.writeFile(filePath, validationResult.generatedCode);
-          return {
-            ...writeResult,
-            validationResult
-          };
-        }
+      return await saveModel(event, filePath, model, settings, options);
+    } catch (error) {
+      if (error instanceof PathValidationError) {
+        console.error('[IPC] generator:saveFile - Path validation failed:', error.message);
+        throw new Error(`Path validation failed: ${error.reason}`);
       }
+      console.error('[IPC] generator:saveFile error:', error);
+      throw new Error(`Failed to save file: ${error instanceof Error ? error.message : 'Unknown error'}`);
+    }
+  });
 
-      // Fallback: generate code directly (only if validation skipped or didn't provide code)
-      const code = codeGeneratorService.generateCode(model, settings);
-      
-      // Final sanity check for generated code - ALWAYS run this if we are falling back
-      const syntaxResult = await parserService.parseSource(code);
-      if (syntaxResult.hasErrors && !options?.forceOnErrors) {
-          return {
-              success: false,
-              validationResult: {
-                  isValid: false,
-                  errors: syntaxResult.errors?.map((e: any) => ({
-                      type: 'syntax_error' as const,
-                      message: e.message || 'Syntax error',
-                      position: e.position
-                  })) || [{
-                      type: 'syntax_error' as const,
-                      message: 'Syntax error detected (sanity check)',
-                  }],
-                  warnings: []
-              }
-          };
-      }
+  // Delta save: the renderer sends only what changed since its last save of the file
+  handleTraced('generator:saveModelDelta', async (event, filePath: string, delta: ModelDelta, settings: any, options?: SaveTaskOptions) => {
+    try {
+      pathValidator.validatePath(filePath);
 
-      return fileService.writeFile(filePath, code);
+      const model = modelDocuments.apply(filePath, delta);
+      if (!model) {
+        return { success: false, needsFullModel: true };
+      }
+      return await saveModel(event, filePath, model, settings, options, delta);
     } catch (error) {
       if (error instanceof PathValidationError) {
-        console.error('[IPC] generator:saveFile - Path validation failed:', error.message);
+        console.error('[IPC] generator:saveModelDelta - Path validation failed:', error.message);
         throw new Error(`Path validation failed: ${error.reason}`);
       }
-      console.error('[IPC] generator:saveFile error:', error);
+      console.error('[IPC] generator:saveModelDelta error:', error);
       throw new Error(`Failed to save file: ${error instanceof Error ? error.message : 'Unknown error'}`);
     }
   });
 
+  // Previews and validation of an open file: a delta against the copy saves also use
+  handleTraced('generator:runModelTask', async (event, filePath: string, delta: ModelDelta, task: ModelTask): Promise<ModelTaskResult> => {
+    try {
+      const model = modelDocuments.apply(filePath, delta);
+      if (!model) {
+        return { needsFullModel: true };
+      }
+      const jobOptions = { signal: senderSignal(event), affinityKey: filePath };
+      const result = await withModelDocument(filePath, model, delta, (source) =>
+        codegenPool.run({ ...task, ...source } as Exclude<CodegenRequest, { type: 'generateChunks' }>, jobOptions));
+      return { result };
+    } catch (error) {
+      console.error(`[IPC] generator:runModelTask (${task?.type}) error:`, error);
+      throw new Error(`Failed to run ${task?.type}: ${error instanceof Error ? error.message : 'Unknown error'}`);
+    }
+  });
+
+  ipcMain.on('model:release', (_event, filePath: string) => {
+    modelDocuments.release(filePath);
+  });
+
   // File I/O handlers
   ipcMain.handle('file:read', async (_event, filePath: string) => {
     try {
@@ -261,7 +430,7 @@ function setupIpcHandlers() {
     }
   });
 
-  ipcMain.handle('project:buildIndex', async (_event, folderPath: string) => {
+  handleTraced('project:buildIndex', async (_event, folderPath: string) => {
     try {
       // Validate project folder path
       pathValidator.validatePath(folderPath);
@@ -277,7 +446,121 @@ function setupIpcHandlers() {
     }
   });
 
-  ipcMain.handle('project:parseDialogFile', async (_event, filePath: string) => {
+  handleTraced('project:streamIndex', async (event, folderPath: string, streamId: string) => {
+    const { port1, port2 } = new MessageChannelMain();
+    const postMessage = (message: ProjectIndexStreamMessage) => port1.postMessage(message);
+    try {
+      // Validate project folder path
+      pathValidator.validatePath(folderPath);
+
+      // Hand the receiving end to the renderer, then stream batches as the index grows
+      event.sender.postMessage('project:indexPort', streamId, [port2]);
+
+      const index = await projectService.buildProjectIndex(folderPath, undefined, (batch) => {
+        postMessage({ type: 'batch', batch });
+      });
+      // The index reaches the renderer once, as the invoke result
+      return index;
+    } catch (error) {
+      if (error instanceof PathValidationError) {
+        console.error('[IPC] project:streamIndex - Path validation failed:', error.message);
+        throw new Error(`Path validation failed: ${error.reason}`);
+      }
+      console.error('[IPC] project:streamIndex error:', error);
+      throw new Error(`Failed to build project index: ${error instanceof Error ? error.message : 'Unknown error'}`);
+    } finally {
+      port1.close();
+    }
+  });
+
+  handleTraced('project:ingestFiles', async (event, filePaths: string[], ingestionId: string) => {
+    const { port1, port2 } = new MessageChannelMain();
+    const postMessage = (message: ProjectIngestionMessage) => port1.postMessage(message);
+    const controller = new AbortController();
+    activeIngestions.get(ingestionId)?.abort();
+    activeIngestions.set(ingestionId, controller);
+
+    try {
+      event.sender.postMessage('project:ingestionPort', ingestionId, [port2]);
+
+      // Paths are validated per file so one rejected path doesn't abort the whole batch
+      const summary = await ingestionService.ingestFiles(
+        filePaths,
+        (results, processedFiles) => {
+          postMessage({ type: 'results', results, processedFiles, totalFiles: filePaths.length });
+        },
+        {
+          signal: controller.signal,
+          validatePath: (filePath) => pathValidator.validatePath(filePath)
+        }
+      );
+      return summary;
+    } catch (error) {
+      console.error('[IPC] project:ingestFiles error:', error);
+      throw new Error(`Failed to ingest project files: ${error instanceof Error ? error.message : 'Unknown error'}`);
+    } finally {
+      if (activeIngestions.get(ingestionId) === controller) {
+        activeIngestions.delete(ingestionId);
+      }
+      port1.close();
+    }
+  });
+
+  ipcMain.on('project:cancelIngestion', (_event, ingestionId: string) => {
+    activeIngestions.get(ingestionId)?.abort();
+  });
+
+  ipcMain.handle('project:watch', async (event, folderPath: string, watchId: string) => {
+    const { port1, port2 } = new MessageChannelMain();
+    const postMessage = (message: ProjectWatchMessage) => port1.postMessage(message);
+    activeWatchers.get(watchId)?.();
+
+    try {
+      pathValidator.validatePath(folderPath);
+      event.sender.postMessage('project:watchPort', watchId, [port2]);
+
+      const watcher = new ProjectWatcher(folderPath, {
+        onChanges: (deltas) => postMessage({ type: 'changes', deltas }),
+        onError: (error) => {
+          console.error('[IPC] project:watch error:', error);
+          postMessage({ type: 'error', message: error.message });
+        }
+      });
+
+      // The invoke stays pending for as long as the project is watched
+      await new Promise<void>((resolve) => {
+        const stop = () => {
+          if (activeWatchers.get(watchId) === stop) {
+            activeWatchers.delete(watchId);
+          }
+          event.sender.removeListener('destroyed', stop);
+          watcher.close();
+          resolve();
+        };
+        activeWatchers.set(watchId, stop);
+        event.sender.once('destroyed', stop);
+        watcher.start().catch((error) => {
+          console.error('[IPC] project:watch error:', error);
+          stop();
+        });
+      });
+    } catch (error) {
+      if (error instanceof PathValidationError) {
+        console.error('[IPC] project:watch - Path validation failed:', error.message);
+        throw new Error(`Path validation failed: ${error.reason}`);
+      }
+      console.error('[IPC] project:watch error:', error);
+      throw new Error(`Failed to watch project: ${error instanceof Error ? error.message : 'Unknown error'}`);
+    } finally {
+      port1.close();
+    }
+  });
+
+  ipcMain.on('project:unwatch', (_event, watchId: string) => {
+    activeWatchers.get(watchId)?.();
+  });
+
+  handleTraced('project:parseDialogFile', async (_event, filePath: string) => {
     try {
       // Validate file path before parsing
       pathValidator.validatePath(filePath);
@@ -1,11 +1,97 @@
-import { contextBridge, ipcRenderer } from 'electron';
+import { contextBridge, ipcRenderer, type IpcRendererEvent } from 'electron';
+import type {
+  IngestedFileResult,
+  ProjectIndexBatch,
+  ProjectIndexStreamMessage,
+  ProjectIngestionMessage,
+  ProjectFileDelta,
+  ProjectWatchMessage
+} from '../shared/types';
+import type { ParseRequestOptions } from '../shared/parseJobs';
+import type { TraceEvent } from 'daedalus-parser/tracing';
+import type { ModelDelta, ModelTask } from '../shared/modelDelta';
+
+let nextStreamId = 0;
+
+/**
+ * Invoke `channel` while receiving streamed messages over a dedicated
+ * MessagePort that the main process sends on `portChannel`. The port is
+ * closed once the invoke settles; later messages are dropped.
+ */
+function invokeWithPort<TMessage>(
+  channel: string,
+  portChannel: string,
+  streamId: string,
+  onMessage: (message: TMessage) => void,
+  ...args: unknown[]
+) {
+  let port: MessagePort | null = null;
+
+  const handlePort = (event: IpcRendererEvent, id: string) => {
+    if (id !== streamId) {
+      return;
+    }
+    ipcRenderer.removeListener(portChannel, handlePort);
+    port = event.ports[0];
+    port.onmessage = (message: MessageEvent<TMessage>) => onMessage(message.data);
+    port.start();
+  };
+
+  ipcRenderer.on(portChannel, handlePort);
+
+  return ipcRenderer.invoke(channel, ...args, streamId).finally(() => {
+    ipcRenderer.removeListener(portChannel, handlePort);
+    port?.close();
+  });
+}
+
+/**
+ * Build the project index while receiving incremental batches.
+ * Resolves with the complete index.
+ */
+function streamProjectIndex(folderPath: string, onBatch: (batch: ProjectIndexBatch) => void) {
+  const streamId = `index-${++nextStreamId}`;
+  return invokeWithPort<ProjectIndexStreamMessage>('project:streamIndex', 'project:indexPort', streamId, (message) => {
+    onBatch(message.batch);
+  }, folderPath);
+}
+
+/**
+ * Parse a list of project files in the main process; results arrive in
+ * coalesced chunks with file paths already attached.
+ */
+function ingestProjectFiles(
+  ingestionId: string,
+  filePaths: string[],
+  onResults: (results: IngestedFileResult[], processedFiles: number, totalFiles: number) => void
+) {
+  return invokeWithPort<ProjectIngestionMessage>('project:ingestFiles', 'project:ingestionPort', ingestionId, (message) => {
+    onResults(message.results, message.processedFiles, message.totalFiles);
+  }, filePaths);
+}
+
+/**
+ * Watch a project folder for external changes. The returned promise settles
+ * when the watch ends (see `unwatchProject`).
+ */
+function watchProject(
+  watchId: string,
+  folderPath: string,
+  onChanges: (deltas: ProjectFileDelta[]) => void
+) {
+  return invokeWithPort<ProjectWatchMessage>('project:watch', 'project:watchPort', watchId, (message) => {
+    if (message.type === 'changes') {
+      onChanges(message.deltas);
+    }
+  }, folderPath);
+}
 
 // Expose protected methods that allow the renderer process to use
 // the ipcRenderer without exposing the entire object
 // All daedalus-parser operations run in main process (has access to native modules)
 contextBridge.exposeInMainWorld('editorAPI', {
   // Parser API
-  parseSource: (sourceCode: string) => ipcRenderer.invoke('parser:parseSource', sourceCode),
+  parseSource: (sourceCode: string, options?: ParseRequestOptions) => ipcRenderer.invoke('parser:parseSource', sourceCode, options),
 
   // Validation API
   validateModel: (model: any, settings: any, options?: any) => ipcRenderer.invoke('validation:validate', model, settings, options),
@@ -15,6 +101,11 @@ contextBridge.exposeInMainWorld('editorAPI', {
   generateDialogCode: (model: any, dialogName: string, settings: any) => ipcRenderer.invoke('generator:generateDialogCode', model, dialogName, settings),
   saveFile: (filePath: string, model: any, settings: any, options?: { skipValidation?: boolean; forceOnErrors?: boolean }) =>
     ipcRenderer.invoke('generator:saveFile', filePath, model, settings, options),
+  saveModelDelta: (filePath: string, delta: ModelDelta, settings: any, options?: { skipValidation?: boolean; forceOnErrors?: boolean }) =>
+    ipcRenderer.invoke('generator:saveModelDelta', filePath, delta, settings, options),
+  runModelTask: (filePath: string, delta: ModelDelta, task: ModelTask) =>
+    ipcRenderer.invoke('generator:runModelTask', filePath, delta, task),
+  releaseModel: (filePath: string) => ipcRenderer.send('model:release', filePath),
 
   // File I/O API
   readFile: (filePath: string) => ipcRenderer.invoke('file:read', filePath),
@@ -25,10 +116,19 @@ contextBridge.exposeInMainWorld('editorAPI', {
   // Project API
   openProjectFolderDialog: () => ipcRenderer.invoke('project:openFolderDialog'),
   buildProjectIndex: (folderPath: string) => ipcRenderer.invoke('project:buildIndex', folderPath),
+  streamProjectIndex,
   parseDialogFile: (filePath: string) => ipcRenderer.invoke('project:parseDialogFile', filePath),
+  ingestProjectFiles,
+  cancelIngestion: (ingestionId: string) => ipcRenderer.send('project:cancelIngestion', ingestionId),
+  watchProject,
+  unwatchProject: (watchId: string) => ipcRenderer.send('project:unwatch', watchId),
   addAllowedPath: (folderPath: string) => ipcRenderer.invoke('project:addAllowedPath', folderPath),
 
   // Settings API
   getRecentProjects: () => ipcRenderer.invoke('settings:getRecentProjects'),
   addRecentProject: (projectPath: string, projectName: string) => ipcRenderer.invoke('settings:addRecentProject', projectPath, projectName),
+
+  // Tracing API
+  getTraceConfig: () => ipcRenderer.invoke('trace:getConfig'),
+  recordTraceEvents: (events: TraceEvent[]) => ipcRenderer.send('trace:record', events),
 });
\ No newline at end of file
@@ -1,4 +1,4 @@
-import { SemanticCodeGenerator } from 'daedalus-parser/semantic-code-generator';
+import { SemanticCodeGenerator, GeneratedCodeCache } from 'daedalus-parser/semantic-code-generator';
 import { deserializeSemanticModel } from 'daedalus-parser/semantic-model';
 
 interface CodeGeneratorSettings {
@@ -8,6 +8,12 @@ interface CodeGeneratorSettings {
   uppercaseKeywords: boolean;
 }
 
+/**
+ * Generated dialog/function fragments shared by every generation request
+ * (previews, validation, saves), so unchanged declarations are not regenerated.
+ */
+const fragmentCache = new GeneratedCodeCache();
+
 export class CodeGeneratorService {
   /**
    * Generate Daedalus code from semantic model
@@ -21,12 +27,32 @@ export class CodeGeneratorService {
       includeComments: settings.includeComments,
       sectionHeaders: settings.sectionHeaders,
       uppercaseKeywords: settings.uppercaseKeywords,
-      preserveSourceStyle: true
+      preserveSourceStyle: true,
+      fragmentCache
     });
 
     return generator.generateSemanticModel(model);
   }
 
+  /**
+   * Generate Daedalus code from semantic model as a lazy sequence of fragments.
+   * Intended for streaming writes where the full file never needs to exist as one string.
+   */
+  generateCodeChunks(plainModel: any, settings: CodeGeneratorSettings): Iterable<string> {
+    const model = deserializeSemanticModel(plainModel);
+
+    const generator = new SemanticCodeGenerator({
+      indentChar: settings.indentChar,
+      includeComments: settings.includeComments,
+      sectionHeaders: settings.sectionHeaders,
+      uppercaseKeywords: settings.uppercaseKeywords,
+      preserveSourceStyle: true,
+      fragmentCache
+    });
+
+    return generator.generateSemanticModelChunks(model);
+  }
+
   /**
    * Generate Daedalus code for a specific dialog
    */
@@ -39,7 +65,8 @@ export class CodeGeneratorService {
       includeComments: settings.includeComments,
       sectionHeaders: settings.sectionHeaders,
       uppercaseKeywords: settings.uppercaseKeywords,
-      preserveSourceStyle: true
+      preserveSourceStyle: true,
+      fragmentCache
     });
 
     return generator.generateDialogWithFunctions(dialogName, model);
@@ -0,0 +1,409 @@
+import { Worker } from 'worker_threads';
+import * as os from 'os';
+import { randomUUID } from 'crypto';
+import { CodegenDocumentMissingError, CodegenTaskRunner, type CodegenRequest } from '../utils/codegenTasks';
+import { appendTraceEvents, isTracingEnabled, recordSpan, traceNow, type TraceEvent } from 'daedalus-parser/tracing';
+import { isLikelyTestRuntime, resolveWorkerPath } from '../utils/workerRuntime';
+
+export interface CodegenJobOptions {
+  /** Aborting drops the job if queued and stops it if running */
+  signal?: AbortSignal;
+  /**
+   * Jobs sharing a key run one at a time in submission order, preferably on
+   * the worker that ran the previous one (its generated-code cache is warm).
+   */
+  affinityKey?: string;
+}
+
+export interface CodegenWorkerPoolOptions {
+  /**
+   * Worker entry to run. Defaults to the compiled codegen.worker.js; setting
+   * it also uses real workers under Jest instead of running tasks inline.
+   */
+  workerPath?: string;
+}
+
+/**
+ * Streamed batches a worker may post ahead of the consumer. The worker waits
+ * for the consumer beyond this, so a slow writer bounds the buffered output.
+ */
+export const MAX_UNCONSUMED_CHUNKS = 4;
+
+export class CodegenCancelledError extends Error {
+  constructor(message = 'Code generation cancelled') {
+    super(message);
+    this.name = 'CodegenCancelledError';
+  }
+}
+
+interface CodegenJob {
+  id: string;
+  /** Sequence number the worker compares against its cancellation slot */
+  seq: number;
+  request: CodegenRequest;
+  options: CodegenJobOptions;
+  onChunk?: (chunk: string) => void;
+  promise: Promise<any>;
+  resolve: (value: any) => void;
+  reject: (reason?: any) => void;
+  cleanup: () => void;
+  settled: boolean;
+  /** traceNow() when sent to a worker; 0 while tracing is off */
+  dispatchedAt: number;
+}
+
+interface CodegenWorkerSlot {
+  index: number;
+  worker: Worker;
+  /** Shared with the worker; holds the seq of the job to stop */
+  cancelFlag: Int32Array;
+  /** Shared with the worker; streamed batches of the current job consumed so far */
+  consumedChunks: Int32Array;
+  job: CodegenJob | null;
+}
+
+interface CodegenWorkerMessage {
+  id: string;
+  result?: unknown;
+  chunk?: string;
+  done?: boolean;
+  error?: string;
+  cancelled?: boolean;
+  documentMissing?: boolean;
+  traceEvents?: TraceEvent[];
+}
+
+/**
+ * CodegenWorkerPool - runs validation and code generation on worker threads
+ *
+ * Keeps the main process event loop free for IPC while large models are
+ * generated and round-trip parsed. Workers start on first use. Under Jest
+ * the tasks run inline against the TypeScript sources unless a worker path
+ * is given.
+ */
+export class CodegenWorkerPool {
+  private workers: CodegenWorkerSlot[] = [];
+  private queue: CodegenJob[] = [];
+  /** Affinity keys with a job on a worker */
+  private busyKeys = new Set<string>();
+  /** Worker index that last ran each affinity key */
+  private keyAffinity = new Map<string, number>();
+  private nextSeq = 1;
+  private isTerminated = false;
+  private inlineRunner: CodegenTaskRunner | null = null;
+  private readonly workerPath: string;
+
+  constructor(
+    private readonly workerCount = Math.max(1, Math.min(2, os.cpus().length - 1)),
+    options: CodegenWorkerPoolOptions = {}
+  ) {
+    this.workerPath = options.workerPath ?? resolveWorkerPath('codegen.worker.js');
+    if (!options.workerPath && isLikelyTestRuntime()) {
+      this.inlineRunner = new CodegenTaskRunner();
+    }
+  }
+
+  /**
+   * Run a request and resolve with its result. Rejects with a
+   * CodegenCancelledError when aborted.
+   */
+  run<T = any>(request: Exclude<CodegenRequest, { type: 'generateChunks' }>, options: CodegenJobOptions = {}): Promise<T> {
+    if (this.inlineRunner) {
+      const runner = this.inlineRunner;
+      return this.withAbortCheck(options.signal, (checkpoint) => runner.run(request, checkpoint)) as Promise<T>;
+    }
+    return this.submit(request, options);
+  }
+
+  /**
+   * Generate code as a stream of fragments, e.g. for FileService.writeFileChunks.
+   * Generation starts right away and runs at most MAX_UNCONSUMED_CHUNKS
+   * batches ahead of the consumer. Leaving the loop early cancels it.
+   */
+  stream(request: Extract<CodegenRequest, { type: 'generateChunks' }>, options: CodegenJobOptions = {}): AsyncIterable<string> {
+    if (this.inlineRunner) {
+      const runner = this.inlineRunner;
+      const signal = options.signal;
+      return (async function* () {
+        yield* runner.chunks(request, () => {
+          if (signal?.aborted) {
+            throw new CodegenCancelledError();
+          }
+        });
+      })();
+    }
+
+    const chunks: string[] = [];
+    let finished = false;
+    let failure: unknown = null;
+    let wake: (() => void) | null = null;
+    const notify = () => {
+      wake?.();
+      wake = null;
+    };
+
+    const job = this.enqueue(request, options, (chunk) => {
+      chunks.push(chunk);
+      notify();
+    });
+    job.promise.then(
+      () => { finished = true; notify(); },
+      (error) => { failure = error; finished = true; notify(); }
+    );
+
+    const pool = this;
+    return (async function* () {
+      try {
+        for (;;) {
+          // Chunks still buffered when the job fails are dropped
+          if (options.signal?.aborted) {
+            throw new CodegenCancelledError();
+          }
+          if (failure) {
+            throw failure;
+          }
+          if (chunks.length > 0) {
+            const chunk = chunks.shift()!;
+            pool.acknowledgeChunk(job);
+            yield chunk;
+            continue;
+          }
+          if (finished) {
+            return;
+          }
+          await new Promise<void>((resolve) => { wake = resolve; });
+        }
+      } finally {
+        if (!finished) {
+          pool.cancel(job);
+        }
+      }
+    })();
+  }
+
+  terminate(): void {
+    this.isTerminated = true;
+    for (const job of this.queue) {
+      this.settle(job, new CodegenCancelledError('Pool terminated'));
+    }
+    this.queue = [];
+    for (const slot of this.workers) {
+      if (slot.job) {
+        this.settle(slot.job, new CodegenCancelledError('Pool terminated'));
+      }
+      slot.worker.terminate();
+    }
+    this.workers = [];
+  }
+
+  private async withAbortCheck<T>(signal: AbortSignal | undefined, task: (checkpoint: () => void) => Promise<T>): Promise<T> {
+    const checkpoint = () => {
+      if (signal?.aborted) {
+        throw new CodegenCancelledError();
+      }
+    };
+    checkpoint();
+    return task(checkpoint);
+  }
+
+  private submit(request: CodegenRequest, options: CodegenJobOptions): Promise<any> {
+    return this.enqueue(request, options).promise;
+  }
+
+  private enqueue(request: CodegenRequest, options: CodegenJobOptions, onChunk?: (chunk: string) => void): CodegenJob {
+    let resolve!: (value: any) => void;
+    let reject!: (reason?: any) => void;
+    const promise = new Promise<any>((resolvePromise, rejectPromise) => {
+      resolve = resolvePromise;
+      reject = rejectPromise;
+    });
+
+    const job: CodegenJob = {
+      id: randomUUID(),
+      seq: this.nextSeq++,
+      request,
+      options,
+      onChunk,
+      promise,
+      resolve,
+      reject,
+      cleanup: () => undefined,
+      settled: false,
+      dispatchedAt: 0
+    };
+
+    if (this.isTerminated) {
+      job.settled = true;
+      reject(new Error('Pool terminated'));
+      return job;
+    }
+    if (options.signal?.aborted) {
+      job.settled = true;
+      reject(new CodegenCancelledError());
+      return job;
+    }
+
+    if (options.signal) {
+      const onAbort = () => this.cancel(job);
+      options.signal.addEventListener('abort', onAbort, { once: true });
+      job.cleanup = () => options.signal!.removeEventListener('abort', onAbort);
+    }
+
+    this.ensureWorkers();
+    this.queue.push(job);
+    this.dispatch();
+    return job;
+  }
+
+  private ensureWorkers(): void {
+    while (this.workers.length < this.workerCount) {
+      this.workers.push(this.spawnWorker(this.workers.length));
+    }
+  }
+
+  private spawnWorker(index: number): CodegenWorkerSlot {
+    const cancelFlag = new Int32Array(new SharedArrayBuffer(Int32Array.BYTES_PER_ELEMENT));
+    const consumedChunks = new Int32Array(new SharedArrayBuffer(Int32Array.BYTES_PER_ELEMENT));
+    const worker = new Worker(this.workerPath, {
+      workerData: { cancelFlag, consumedChunks, maxUnconsumedChunks: MAX_UNCONSUMED_CHUNKS, trace: isTracingEnabled() }
+    });
+    const slot: CodegenWorkerSlot = { index, worker, cancelFlag, consumedChunks, job: null };
+
+    worker.on('message', (message: CodegenWorkerMessage) => this.handleMessage(slot, message));
+
+    worker.on('error', (err) => {
+      console.error(`Codegen Worker ${index} error:`, err);
+    });
+
+    worker.on('exit', (code) => {
+      if (this.isTerminated || this.workers[index] !== slot) {
+        return;
+      }
+      console.error(`Codegen Worker ${index} stopped with exit code ${code}`);
+      const job = slot.job;
+      slot.job = null;
+      if (job) {
+        this.release(job);
+        this.settle(job, new Error(`Codegen worker exited with code ${code}`));
+      }
+      this.workers[index] = this.spawnWorker(index);
+      this.dispatch();
+    });
+
+    return slot;
+  }
+
+  private handleMessage(slot: CodegenWorkerSlot, message: CodegenWorkerMessage): void {
+    appendTraceEvents(message.traceEvents);
+    const job = slot.job;
+    if (!job || job.id !== message.id) {
+      return;
+    }
+
+    if (message.chunk !== undefined) {
+      if (!job.settled) {
+        job.onChunk?.(message.chunk);
+      }
+      return;
+    }
+
+    slot.job = null;
+    this.release(job);
+    if (job.dispatchedAt > 0) {
+      recordSpan('codegen.job', job.dispatchedAt, traceNow(), { type: job.request.type, worker: slot.index });
+    }
+    if (message.error) {
+      const error = message.cancelled
+        ? new CodegenCancelledError()
+        : message.documentMissing ? new CodegenDocumentMissingError(message.error) : new Error(message.error);
+      this.settle(job, error);
+    } else {
+      this.settle(job, null, message.result);
+    }
+    this.dispatch();
+  }
+
+  private dispatch(): void {
+    for (let i = 0; i < this.queue.length; i++) {
+      const job = this.queue[i];
+      const key = job.options.affinityKey;
+      if (key && this.busyKeys.has(key)) {
+        continue;
+      }
+
+      const slot = this.pickWorker(key);
+      if (!slot) {
+        return;
+      }
+
+      this.queue.splice(i--, 1);
+      slot.job = job;
+      if (key) {
+        this.busyKeys.add(key);
+        this.keyAffinity.set(key, slot.index);
+      }
+      if (isTracingEnabled()) {
+        job.dispatchedAt = traceNow();
+      }
+      Atomics.store(slot.consumedChunks, 0, 0);
+      slot.worker.postMessage({ id: job.id, seq: job.seq, request: job.request });
+    }
+  }
+
+  private pickWorker(key: string | undefined): CodegenWorkerSlot | null {
+    if (key !== undefined) {
+      const preferred = this.workers[this.keyAffinity.get(key) ?? -1];
+      if (preferred && !preferred.job) {
+        return preferred;
+      }
+    }
+    return this.workers.find((slot) => !slot.job) ?? null;
+  }
+
+  /** Drop a queued job, or ask the worker running it to stop */
+  private cancel(job: CodegenJob): void {
+    const queuedIndex = this.queue.indexOf(job);
+    if (queuedIndex !== -1) {
+      this.queue.splice(queuedIndex, 1);
+      this.settle(job, new CodegenCancelledError());
+      return;
+    }
+
+    const slot = this.workers.find((candidate) => candidate.job === job);
+    if (slot) {
+      // Reject right away; the slot frees up once the worker notices and replies
+      Atomics.store(slot.cancelFlag, 0, job.seq);
+      // A worker waiting for the consumer wakes up and sees the flag
+      Atomics.notify(slot.consumedChunks, 0);
+      this.settle(job, new CodegenCancelledError());
+    }
+  }
+
+  /** Let the worker streaming `job` post one more batch */
+  private acknowledgeChunk(job: CodegenJob): void {
+    const slot = this.workers.find((candidate) => candidate.job === job);
+    if (slot) {
+      Atomics.add(slot.consumedChunks, 0, 1);
+      Atomics.notify(slot.consumedChunks, 0);
+    }
+  }
+
+  private release(job: CodegenJob): void {
+    if (job.options.affinityKey) {
+      this.busyKeys.delete(job.options.affinityKey);
+    }
+  }
+
+  private settle(job: CodegenJob, error: Error | null, result?: unknown): void {
+    if (job.settled) {
+      return;
+    }
+    job.settled = true;
+    job.cleanup();
+    if (error) {
+      job.reject(error);
+    } else {
+      job.resolve(result);
+    }
+  }
+}
@@ -1,7 +1,11 @@
 import { promises as fs } from 'fs';
+import type { FileHandle } from 'fs/promises';
+import * as path from 'path';
+import { randomUUID } from 'crypto';
 import { dialog } from 'electron';
 import * as chardet from 'chardet';
 import * as iconv from 'iconv-lite';
+import { recordOwnWrite } from '../utils/writeJournal';
 
 /**
  * Error types for FileService operations
@@ -30,6 +34,68 @@ const fileEncodingCache = new Map<string, string>();
  */
 const fileLocks = new Map<string, Promise<any>>();
 
+/**
+ * Number of characters buffered before a chunk is encoded and written.
+ * Keeps peak memory for very large generated files at a small constant.
+ */
+const WRITE_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Error codes Windows reports when a virus scanner, indexer or editor briefly
+ * holds the target open without FILE_SHARE_DELETE, so it cannot be replaced
+ */
+const TRANSIENT_RENAME_ERRORS = new Set(['EPERM', 'EBUSY', 'EACCES']);
+
+/**
+ * Delays between attempts to move a written temporary file over its target
+ */
+const RENAME_RETRY_DELAYS_MS = [10, 25, 50, 100, 200, 400];
+
+/**
+ * Split a string into slices of at most `size` characters without
+ * separating UTF-16 surrogate pairs.
+ */
+function* sliceString(content: string, size: number): Generator<string, void, undefined> {
+  let start = 0;
+  while (start < content.length) {
+    let end = Math.min(start + size, content.length);
+    const lastCode = content.charCodeAt(end - 1);
+    if (end < content.length && lastCode >= 0xD800 && lastCode <= 0xDBFF) {
+      end--;
+    }
+    yield content.slice(start, end);
+    start = end;
+  }
+}
+
+/**
+ * Move a fully written temporary file over `filePath`.
+ * Retries with backoff while the target is transiently locked, then falls back
+ * to copying the temporary file's content over the target in place, which
+ * only needs write access to it. The fallback is not atomic, but the content
+ * is complete on disk before the target is touched.
+ */
+async function replaceFile(tempPath: string, filePath: string): Promise<void> {
+  for (let attempt = 0; ; attempt++) {
+    try {
+      await fs.rename(tempPath, filePath);
+      return;
+    } catch (error) {
+      const err = error as NodeJS.ErrnoException;
+      if (!err.code || !TRANSIENT_RENAME_ERRORS.has(err.code)) {
+        throw err;
+      }
+      if (attempt >= RENAME_RETRY_DELAYS_MS.length) {
+        break;
+      }
+      await new Promise(resolve => setTimeout(resolve, RENAME_RETRY_DELAYS_MS[attempt]));
+    }
+  }
+
+  await fs.copyFile(tempPath, filePath);
+  await fs.unlink(tempPath).catch(() => {});
+}
+
 /**
  * Acquires a lock for a file operation
  * Ensures only one operation per file can proceed at a time
@@ -181,17 +247,85 @@ export class FileService {
    * @throws {FileServiceError} If file cannot be written
    */
   async writeFile(filePath: string, content: string): Promise<{ success: boolean; encoding?: string }> {
+    return this.writeFileChunks(filePath, sliceString(content, WRITE_CHUNK_SIZE));
+  }
+
+  /**
+   * Stream content chunks to a file using the original encoding if available.
+   * Chunks are encoded incrementally into a temporary file next to the target,
+   * which then atomically replaces it, so readers never observe a partial file.
+   * If the target stays locked (common on Windows), it is overwritten in place
+   * from the temporary file instead.
+   * @param filePath - Absolute path to the file
+   * @param chunks - Content fragments, written in iteration order
+   * @returns Success status with encoding information
+   * @throws {FileServiceError} If file cannot be written
+   */
+  async writeFileChunks(
+    filePath: string,
+    chunks: Iterable<string> | AsyncIterable<string>
+  ): Promise<{ success: boolean; encoding?: string }> {
     return acquireLock(filePath, async () => {
+      const tempPath = path.join(
+        path.dirname(filePath),
+        `.${path.basename(filePath)}.${randomUUID()}.tmp`
+      );
+      let handle: FileHandle | null = null;
+
       try {
         // Use the cached encoding if available, otherwise default to utf8
         const encoding = fileEncodingCache.get(filePath) || 'utf8';
+        const encoder = iconv.getEncoder(encoding);
 
-        // Encode the content using the appropriate encoding
-        const buffer = iconv.encode(content, encoding);
+        handle = await fs.open(tempPath, 'w');
+        const existing = await fs.stat(filePath).catch(() => null);
+        if (existing) {
+          await handle.chmod(existing.mode);
+        }
 
-        await fs.writeFile(filePath, buffer);
+        let pending: string[] = [];
+        let pendingLength = 0;
+        const flush = async () => {
+          if (pendingLength === 0) return;
+          const buffer = encoder.write(pending.join(''));
+          pending = [];
+          pendingLength = 0;
+          if (buffer && buffer.length > 0) {
+            await handle!.write(buffer);
+          }
+        };
+
+        for await (const chunk of chunks) {
+          pending.push(chunk);
+          pendingLength += chunk.length;
+          if (pendingLength >= WRITE_CHUNK_SIZE) {
+            await flush();
+          }
+        }
+        await flush();
+
+        const tail = encoder.end();
+        if (tail && tail.length > 0) {
+          await handle.write(tail);
+        }
+
+        await handle.sync();
+        await handle.close();
+        handle = null;
+
+        await replaceFile(tempPath, filePath);
+        // Lets the project watcher recognize the events this save causes
+        const written = await fs.stat(filePath).catch(() => null);
+        if (written) {
+          recordOwnWrite(filePath, written);
+        }
         return { success: true, encoding };
       } catch (error) {
+        if (handle) {
+          await handle.close().catch(() => {});
+        }
+        await fs.unlink(tempPath).catch(() => {});
+
         const err = error as NodeJS.ErrnoException;
 
         if (err.code === 'EACCES') {
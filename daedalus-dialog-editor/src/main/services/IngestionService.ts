@@ -0,0 +1,136 @@
+/**
+ * IngestionService - Batched background parsing of project files
+ *
+ * Reads and parses a list of files through the parser worker pool and hands
+ * results back in coalesced chunks, so the renderer receives one message per
+ * chunk instead of one IPC round-trip per file.
+ */
+
+import type { IngestedFileResult, SemanticModel } from '../../shared/types';
+import type { FileService } from './FileService';
+import type { ParserService } from './ParserService';
+import { getParseCache } from '../utils/parseCache';
+
+export interface IngestionOptions {
+  /** Stops scheduling new files once aborted; files already in flight are dropped */
+  signal?: AbortSignal;
+  /** Maximum number of files read/parsed at once (default: 16) */
+  concurrency?: number;
+  /** Flush a chunk once this many results are pending (default: 32) */
+  chunkSize?: number;
+  /** Flush pending results at least this often (default: 100ms) */
+  flushIntervalMs?: number;
+  /** Optional per-file check run before reading (e.g. path validation) */
+  validatePath?: (filePath: string) => void;
+}
+
+export interface IngestionSummary {
+  processedFiles: number;
+  cancelled: boolean;
+}
+
+const DEFAULT_INGESTION_CONCURRENCY = 16;
+const DEFAULT_CHUNK_SIZE = 32;
+const DEFAULT_FLUSH_INTERVAL_MS = 100;
+
+/**
+ * Tag constants and variables with the file that declares them.
+ */
+export function attachFilePath(model: SemanticModel, filePath: string): SemanticModel {
+  if (model.constants) {
+    Object.values(model.constants).forEach((constant) => { constant.filePath = filePath; });
+  }
+  if (model.variables) {
+    Object.values(model.variables).forEach((variable) => { variable.filePath = filePath; });
+  }
+  return model;
+}
+
+export class IngestionService {
+  constructor(
+    private readonly fileService: FileService,
+    private readonly parserService: ParserService
+  ) {}
+
+  /**
+   * Parse `filePaths` in the given order and report results via `onChunk`.
+   * A file that fails to read or parse produces a result with `error` set
+   * instead of failing the whole run.
+   */
+  async ingestFiles(
+    filePaths: string[],
+    onChunk: (results: IngestedFileResult[], processedFiles: number) => void,
+    options: IngestionOptions = {}
+  ): Promise<IngestionSummary> {
+    const { signal, validatePath } = options;
+    const concurrency = Math.max(1, options.concurrency ?? DEFAULT_INGESTION_CONCURRENCY);
+    const chunkSize = Math.max(1, options.chunkSize ?? DEFAULT_CHUNK_SIZE);
+    const flushIntervalMs = options.flushIntervalMs ?? DEFAULT_FLUSH_INTERVAL_MS;
+
+    let pending: IngestedFileResult[] = [];
+    let processedFiles = 0;
+    let nextIndex = 0;
+    let flushTimer: ReturnType<typeof setTimeout> | null = null;
+
+    const flush = () => {
+      if (flushTimer) {
+        clearTimeout(flushTimer);
+        flushTimer = null;
+      }
+      if (pending.length === 0 || signal?.aborted) {
+        return;
+      }
+      const chunk = pending;
+      pending = [];
+      onChunk(chunk, processedFiles);
+    };
+
+    const push = (result: IngestedFileResult) => {
+      if (signal?.aborted) {
+        return;
+      }
+      processedFiles++;
+      pending.push(result);
+      if (pending.length >= chunkSize) {
+        flush();
+      } else if (!flushTimer) {
+        flushTimer = setTimeout(flush, flushIntervalMs);
+      }
+    };
+
+    const ingestOne = async (filePath: string): Promise<IngestedFileResult> => {
+      try {
+        validatePath?.(filePath);
+        const content = await this.fileService.readFile(filePath);
+        // Text seen before, in any project, comes from the parse cache; the worker does the lookup
+        const semanticModel = await this.parserService.parseSource(content, { signal, useParseCache: true });
+        return { filePath, semanticModel: attachFilePath(semanticModel, filePath) };
+      } catch (error) {
+        return {
+          filePath,
+          semanticModel: null,
+          error: error instanceof Error ? error.message : String(error)
+        };
+      }
+    };
+
+    const runWorker = async (): Promise<void> => {
+      while (nextIndex < filePaths.length && !signal?.aborted) {
+        const filePath = filePaths[nextIndex++];
+        push(await ingestOne(filePath));
+      }
+    };
+
+    try {
+      await Promise.all(Array.from({ length: Math.min(concurrency, filePaths.length) }, runWorker));
+      flush();
+    } finally {
+      if (flushTimer) {
+        clearTimeout(flushTimer);
+      }
+      getParseCache()?.schedulePrune();
+    }
+
+    return { processedFiles, cancelled: !!signal?.aborted };
+  }
+}
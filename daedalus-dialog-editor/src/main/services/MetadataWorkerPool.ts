@@ -1,11 +1,12 @@
 import { Worker } from 'worker_threads';
-import * as path from 'path';
 import * as os from 'os';
 import * as fs from 'fs';
 import { randomUUID } from 'crypto';
 import type { DialogMetadata } from '../../shared/types';
-import { promises as fsPromises } from 'fs';
-import { extractFileMetadataFromSource } from '../utils/semanticMetadataUtils';
+import { extractFileMetadata } from '../utils/semanticMetadataUtils';
+import { getParseCache } from '../utils/parseCache';
+import { appendTraceEvents, isTracingEnabled, type TraceEvent } from 'daedalus-parser/tracing';
+import { isLikelyTestRuntime, resolveWorkerPath } from '../utils/workerRuntime';
 
 interface PendingTask {
   resolve: (value: {
@@ -17,10 +18,6 @@ interface PendingTask {
   reject: (reason?: any) => void;
 }
 
-function isLikelyTestRuntime(): boolean {
-  return process.env.NODE_ENV === 'test' || !!process.env.JEST_WORKER_ID;
-}
-
 export class MetadataWorkerPool {
   private workers: Worker[] = [];
   private pendingRequests: Map<string, PendingTask> = new Map();
@@ -39,26 +36,17 @@ export class MetadataWorkerPool {
     // Leave one core for the main thread/event loop
     const numWorkers = Math.max(1, os.cpus().length - 1);
 
-    // Worker path relative to dist/main/services/MetadataWorkerPool.js
-    let workerPath = path.join(__dirname, '../workers/metadata.worker.js');
-
-    // If running in TS environment (tests), the worker file won't exist at the relative path
-    // because __dirname points to src/...
-    // We need to point to the compiled worker in dist
-    if (!fs.existsSync(workerPath)) {
-      // From src/main/services -> ../../../ -> root -> dist/main/workers/metadata.worker.js
-      const distPath = path.join(__dirname, '../../../dist/main/workers/metadata.worker.js');
-      if (fs.existsSync(distPath)) {
-        workerPath = distPath;
-      }
-    }
+    const workerPath = resolveWorkerPath('metadata.worker.js');
 
     if (!fs.existsSync(workerPath)) {
       throw new Error(`Metadata worker entry was not found at ${workerPath}. Build the app/workers before runtime.`);
     }
 
     for (let i = 0; i < numWorkers; i++) {
-      const worker = new Worker(workerPath);
+      const worker = new Worker(workerPath, {
+        // Workers share the main process's parse cache directly through the filesystem
+        workerData: { trace: isTracingEnabled(), parseCache: getParseCache()?.options }
+      });
 
       worker.on('message', (message: {
         id: string;
@@ -67,8 +55,10 @@ export class MetadataWorkerPool {
         prototypes?: Array<{ name: string; parent: string }>;
         isQuestFile?: boolean;
         error?: string;
+        traceEvents?: TraceEvent[];
       }) => {
-        const { id, dialogs, instances, prototypes, isQuestFile, error } = message;
+        const { id, dialogs, instances, prototypes, isQuestFile, error, traceEvents } = message;
+        appendTraceEvents(traceEvents);
         const pending = this.pendingRequests.get(id);
 
         if (pending) {
@@ -150,8 +140,7 @@ export class MetadataWorkerPool {
     isQuestFile: boolean;
   }> {
     try {
-      const content = await fsPromises.readFile(filePath, 'utf-8');
-      return extractFileMetadataFromSource(content, filePath);
+      return await extractFileMetadata(filePath);
     } catch {
       // Match worker-path behavior: tolerate per-file processing failures.
       return { dialogs: [], instances: [], prototypes: [], isQuestFile: false };
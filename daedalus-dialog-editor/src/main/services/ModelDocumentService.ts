@@ -0,0 +1,56 @@
+import { applyModelDelta, type ModelDelta } from '../../shared/modelDelta';
+import type { SemanticModel } from '../../shared/types';
+
+interface ModelDocument {
+  version: number;
+  model: SemanticModel;
+}
+
+/**
+ * ModelDocumentService - authoritative copies of the models open in the editor
+ *
+ * The renderer sends model deltas tagged with versions instead of whole
+ * models; saves then work on the copy held here.
+ */
+export class ModelDocumentService {
+  private documents = new Map<string, ModelDocument>();
+
+  /**
+   * @param maxDocuments Copies kept at most; the least recently updated one is
+   *   dropped first (its next delta then asks for the full model again)
+   */
+  constructor(private readonly maxDocuments = Infinity) {}
+
+  /**
+   * Bring a file's copy up to the delta's version.
+   * @returns The updated model, or null when the delta does not apply to the
+   *   held version (unknown file or missed update) and the full model is needed
+   */
+  apply(filePath: string, delta: ModelDelta): SemanticModel | null {
+    const current = this.documents.get(filePath);
+    if (!delta.full && (!current || current.version !== delta.baseVersion)) {
+      return null;
+    }
+
+    const model = applyModelDelta(current?.model ?? delta.full!, delta);
+    // Re-insert so Map order is least recently updated first
+    this.documents.delete(filePath);
+    this.documents.set(filePath, { version: delta.version, model });
+    if (this.documents.size > this.maxDocuments) {
+      this.documents.delete(this.documents.keys().next().value!);
+    }
+    return model;
+  }
+
+  getVersion(filePath: string): number | undefined {
+    return this.documents.get(filePath)?.version;
+  }
+
+  release(filePath: string): void {
+    this.documents.delete(filePath);
+  }
+
+  clear(): void {
+    this.documents.clear();
+  }
+}
@@ -2,15 +2,54 @@ import { Worker } from 'worker_threads';
 import * as path from 'path';
 import { randomUUID } from 'crypto';
 import * as os from 'os';
+import {
+  PARSE_CANCELLED,
+  formatParseAbortMessage,
+  type ParseAbortCode,
+  type ParseRequestOptions
+} from '../../shared/parseJobs';
+import { appendTraceEvents, isTracingEnabled, recordSpan, traceNow, type TraceEvent } from 'daedalus-parser/tracing';
+import { getParseCache } from '../utils/parseCache';
+
+export interface ParseJobOptions extends ParseRequestOptions {
+  /** Aborting drops the job if queued and stops it if running */
+  signal?: AbortSignal;
+  /**
+   * Let the worker serve and store the model through the shared parse cache.
+   * Off by default: edited buffers are rarely seen twice.
+   */
+  useParseCache?: boolean;
+}
+
+interface ParseJob {
+  id: string;
+  /** Sequence number the worker compares against its cancellation slot */
+  seq: number;
+  sourceCode: string;
+  options: ParseJobOptions;
+  resolve: (value: any) => void;
+  reject: (reason?: any) => void;
+  cleanup: () => void;
+  /** traceNow() when queued / sent to a worker; 0 while tracing is off */
+  queuedAt: number;
+  dispatchedAt: number;
+}
+
+interface ParserWorkerSlot {
+  index: number;
+  worker: Worker;
+  /** Shared with the worker; holds the seq of the job to stop */
+  cancelFlag: Int32Array;
+  job: ParseJob | null;
+}
 
 export class ParserService {
-  private workers: Worker[] = [];
-  private pendingRequests: Map<string, { resolve: (value: any) => void; reject: (reason?: any) => void }>;
-  private nextWorkerIndex = 0;
+  private workers: ParserWorkerSlot[] = [];
+  private queue: ParseJob[] = [];
+  private jobsByKey = new Map<string, ParseJob>();
+  private nextSeq = 1;
 
   constructor() {
-    this.pendingRequests = new Map();
-
     // Worker is located at ../workers/parser.worker.js relative to this file
     // This works because both files are compiled to the same relative structure in dist/main
     const workerPath = path.join(__dirname, '../workers/parser.worker.js');
@@ -23,56 +62,144 @@ export class ParserService {
     console.log(`[ParserService] Initializing worker pool with ${workerCount} workers`);
 
     for (let i = 0; i < workerCount; i++) {
-      const worker = new Worker(workerPath);
-      this.setupWorker(worker, i);
-      this.workers.push(worker);
+      const cancelFlag = new Int32Array(new SharedArrayBuffer(Int32Array.BYTES_PER_ELEMENT));
+      const worker = new Worker(workerPath, { workerData: { cancelFlag, trace: isTracingEnabled() } });
+      const slot: ParserWorkerSlot = { index: i, worker, cancelFlag, job: null };
+      this.setupWorker(slot);
+      this.workers.push(slot);
     }
   }
 
-  private setupWorker(worker: Worker, index: number) {
-    worker.on('message', (message: { id: string; result?: any; error?: string }) => {
-      const { id, result, error } = message;
-      const pending = this.pendingRequests.get(id);
+  private setupWorker(slot: ParserWorkerSlot) {
+    slot.worker.on('message', (message: { id: string; result?: any; error?: string; traceEvents?: TraceEvent[] }) => {
+      const { id, result, error, traceEvents } = message;
+      const job = slot.job;
+      appendTraceEvents(traceEvents);
 
-      if (pending) {
-        if (error) {
-          pending.reject(new Error(error));
-        } else {
-          pending.resolve(result);
+      if (job && job.id === id) {
+        slot.job = null;
+        if (job.dispatchedAt > 0) {
+          // Worker time plus both structured-clone hops
+          recordSpan('parser.job', job.dispatchedAt, traceNow(), { bytes: job.sourceCode.length, worker: slot.index });
         }
-        this.pendingRequests.delete(id);
+        this.settle(job, error ? new Error(error) : null, result);
+        this.dispatch();
       }
     });
 
-    worker.on('error', (err) => {
-        console.error(`Parser Worker ${index} error:`, err);
+    slot.worker.on('error', (err) => {
+        console.error(`Parser Worker ${slot.index} error:`, err);
     });
 
-    worker.on('exit', (code) => {
+    slot.worker.on('exit', (code) => {
         if (code !== 0) {
-            console.error(`Parser Worker ${index} stopped with exit code ${code}`);
+            console.error(`Parser Worker ${slot.index} stopped with exit code ${code}`);
         }
         // In a robust system, we might want to restart the worker here
     });
   }
 
-  private getNextWorker(): Worker {
-    const worker = this.workers[this.nextWorkerIndex];
-    this.nextWorkerIndex = (this.nextWorkerIndex + 1) % this.workers.length;
-    return worker;
-  }
-
   /**
    * Parse Daedalus source code and return semantic model asynchronously
-   * Offloads parsing to a worker thread pool to avoid blocking the main process
+   * Offloads parsing to a worker thread pool to avoid blocking the main process.
+   *
+   * Rejects with a PARSE_CANCELLED error when superseded or aborted, and with
+   * PARSE_TIMEOUT when `timeoutMs` elapses first.
    */
-  async parseSource(sourceCode: string): Promise<any> {
+  async parseSource(sourceCode: string, options: ParseJobOptions = {}): Promise<any> {
     return new Promise((resolve, reject) => {
-      const id = randomUUID();
-      this.pendingRequests.set(id, { resolve, reject });
-      
-      const worker = this.getNextWorker();
-      worker.postMessage({ id, sourceCode });
+      if (options.signal?.aborted) {
+        reject(new Error(formatParseAbortMessage(PARSE_CANCELLED, 'Parse cancelled')));
+        return;
+      }
+
+      const job: ParseJob = {
+        id: randomUUID(),
+        seq: this.nextSeq++,
+        sourceCode,
+        options,
+        resolve,
+        reject,
+        cleanup: () => undefined,
+        queuedAt: isTracingEnabled() ? traceNow() : 0,
+        dispatchedAt: 0
+      };
+
+      if (options.supersedeKey) {
+        const previous = this.jobsByKey.get(options.supersedeKey);
+        if (previous) {
+          this.cancel(previous, PARSE_CANCELLED, 'Parse superseded by a newer request');
+        }
+        this.jobsByKey.set(options.supersedeKey, job);
+      }
+
+      if (options.signal) {
+        const onAbort = () => this.cancel(job, PARSE_CANCELLED, 'Parse cancelled');
+        options.signal.addEventListener('abort', onAbort, { once: true });
+        job.cleanup = () => options.signal!.removeEventListener('abort', onAbort);
+      }
+
+      this.queue.push(job);
+      this.dispatch();
     });
   }
+
+  private dispatch(): void {
+    for (const slot of this.workers) {
+      if (this.queue.length === 0) {
+        return;
+      }
+      if (slot.job) {
+        continue;
+      }
+
+      const job = this.queue.shift()!;
+      slot.job = job;
+      if (job.queuedAt > 0) {
+        job.dispatchedAt = traceNow();
+        recordSpan('parser.queueWait', job.queuedAt, job.dispatchedAt, { queued: this.queue.length });
+      }
+      slot.worker.postMessage({
+        id: job.id,
+        seq: job.seq,
+        sourceCode: job.sourceCode,
+        timeoutMs: job.options.timeoutMs,
+        parseCache: job.options.useParseCache ? getParseCache()?.options : undefined
+      });
+    }
+  }
+
+  /** Drop a queued job, or ask the worker running it to stop */
+  private cancel(job: ParseJob, code: ParseAbortCode, reason: string): void {
+    const queuedIndex = this.queue.indexOf(job);
+    if (queuedIndex !== -1) {
+      this.queue.splice(queuedIndex, 1);
+      this.settle(job, new Error(formatParseAbortMessage(code, reason)));
+      return;
+    }
+
+    const slot = this.workers.find((candidate) => candidate.job === job);
+    if (slot) {
+      // The worker notices between parse slices and stages and answers with a cancellation error.
+      // Reject right away so callers don't wait for it; the slot frees up once the worker replies.
+      Atomics.store(slot.cancelFlag, 0, job.seq);
+      this.settle(job, new Error(formatParseAbortMessage(code, reason)));
+    }
+  }
+
+  private settle(job: ParseJob, error: Error | null, result?: any): void {
+    job.cleanup();
+    job.cleanup = () => undefined;
+    const key = job.options.supersedeKey;
+    if (key && this.jobsByKey.get(key) === job) {
+      this.jobsByKey.delete(key);
+    }
+
+    // Settling twice is a no-op for promises, so late worker replies for cancelled jobs are harmless
+    if (error) {
+      job.reject(error);
+    } else {
+      job.resolve(result);
+    }
+  }
 }
@@ -9,48 +9,29 @@
 
 import { promises as fs } from 'fs';
 import * as path from 'path';
-import type { DialogMetadata, ProjectIndex } from '../../shared/types';
+import type { DialogMetadata, ProjectIndex, ProjectIndexBatch } from '../../shared/types';
 
 // Re-export types for consumers of this service
-export type { DialogMetadata, ProjectIndex } from '../../shared/types';
+export type { DialogMetadata, ProjectIndex, ProjectIndexBatch } from '../../shared/types';
 
 import { extractFileMetadataFromSource } from '../utils/semanticMetadataUtils';
+import { walkDirectory, type DirectoryWalkOptions } from '../utils/directoryWalker';
 import { MetadataWorkerPool } from './MetadataWorkerPool';
+import { getParseCache } from '../utils/parseCache';
+import { ClassHierarchyIndex } from '../../shared/classHierarchy';
 
-function normalizeIdentifier(value: string): string {
-  return value.trim().toUpperCase();
-}
+/** Minimum delay between two streamed index batches */
+const INDEX_BATCH_INTERVAL_MS = 50;
 
 class ProjectService {
   /**
    * Recursively scan directory for .d files (async)
    */
-  async scanDirectory(rootPath: string): Promise<string[]> {
+  async scanDirectory(rootPath: string, options?: DirectoryWalkOptions): Promise<string[]> {
     const files: string[] = [];
-
-    const scanRecursive = async (dir: string): Promise<void> => {
-      try {
-        const entries = await fs.readdir(dir, { withFileTypes: true });
-
-        const promises: Promise<void>[] = [];
-
-        for (const entry of entries) {
-          const fullPath = path.join(dir, entry.name);
-
-          if (entry.isDirectory()) {
-            promises.push(scanRecursive(fullPath));
-          } else if (entry.isFile() && path.extname(entry.name).toLowerCase() === '.d') {
-            files.push(fullPath);
-          }
-        }
-
-        await Promise.all(promises);
-      } catch {
-        // Silently skip directories that can't be read (permissions, etc.)
-      }
-    };
-
-    await scanRecursive(rootPath);
+    for await (const filePath of walkDirectory(rootPath, options)) {
+      files.push(filePath);
+    }
     return files;
   }
 
@@ -63,94 +44,161 @@ class ProjectService {
 
   /**
    * Build complete project index from directory (async)
+   *
+   * When `onBatch` is given, newly discovered NPCs, dialogs and files are
+   * reported in coalesced batches while the scan is still running. The
+   * returned index is the same regardless of the order files finish in.
    */
-  async buildProjectIndex(rootPath: string): Promise<ProjectIndex> {
-    // Scan for all .d files
-    const allFiles = await this.scanDirectory(rootPath);
-
-    // Map to store dialogs by NPC
-    const dialogsByNpc = new Map<string, DialogMetadata[]>();
+  async buildProjectIndex(
+    rootPath: string,
+    options?: DirectoryWalkOptions,
+    onBatch?: (batch: ProjectIndexBatch) => void
+  ): Promise<ProjectIndex> {
+    const allFiles: string[] = [];
     const allNpcs = new Set<string>();
-    const questFiles: string[] = [];
+    const hierarchy = new ClassHierarchyIndex();
+    const resultsByFile: Awaited<ReturnType<MetadataWorkerPool['processFile']>>[] = [];
+    let processedFiles = 0;
+    let scanComplete = false;
+
+    let pendingBatch: ProjectIndexBatch | null = null;
+    let flushTimer: ReturnType<typeof setTimeout> | null = null;
+
+    const currentBatch = (): ProjectIndexBatch => {
+      if (!pendingBatch) {
+        pendingBatch = {
+          npcs: [],
+          dialogs: [],
+          files: [],
+          questFiles: [],
+          progress: { discoveredFiles: 0, processedFiles: 0, scanComplete: false }
+        };
+      }
+      return pendingBatch;
+    };
 
-    // Use worker pool to process files in parallel
-    const pool = new MetadataWorkerPool();
+    const flush = () => {
+      if (flushTimer) {
+        clearTimeout(flushTimer);
+        flushTimer = null;
+      }
+      if (!onBatch || !pendingBatch) {
+        return;
+      }
+      const batch = pendingBatch;
+      pendingBatch = null;
+      batch.progress = { discoveredFiles: allFiles.length, processedFiles, scanComplete };
+      onBatch(batch);
+    };
 
-    try {
-      const results = await Promise.all(
-        allFiles.map(filePath => pool.processFile(filePath))
-      );
-
-      const parentByType = new Map<string, string>();
-      results.forEach((result) => {
-        result.prototypes.forEach((prototype) => {
-          parentByType.set(normalizeIdentifier(prototype.name), prototype.parent);
-        });
-      });
+    const scheduleFlush = () => {
+      if (onBatch && !flushTimer) {
+        flushTimer = setTimeout(flush, INDEX_BATCH_INTERVAL_MS);
+      }
+    };
 
-      const isNpcParent = (parentName: string): boolean => {
-        const visited = new Set<string>();
-        let currentParent = parentName;
+    const addNpc = (name: string) => {
+      if (allNpcs.has(name)) {
+        return;
+      }
+      allNpcs.add(name);
+      if (onBatch) {
+        currentBatch().npcs.push(name);
+      }
+    };
 
-        while (currentParent) {
-          const normalizedParent = normalizeIdentifier(currentParent);
-          if (normalizedParent === 'C_NPC') {
-            return true;
-          }
-          if (visited.has(normalizedParent)) {
-            return false;
+    const ingestResult = (index: number, result: Awaited<ReturnType<MetadataWorkerPool['processFile']>>) => {
+      resultsByFile[index] = result;
+      processedFiles++;
+
+      // Instances declared here, plus instances elsewhere that were waiting on
+      // a prototype from this file, may now resolve to C_NPC
+      hierarchy
+        .setFileDeclarations(allFiles[index], { prototypes: result.prototypes, instances: result.instances })
+        .forEach((instanceName) => {
+          if (hierarchy.getBaseClass(instanceName) === 'C_NPC') {
+            addNpc(instanceName);
           }
+        });
 
-          visited.add(normalizedParent);
-          currentParent = parentByType.get(normalizedParent) || '';
-        }
+      result.dialogs.forEach((dialog) => addNpc(dialog.npc));
 
-        return false;
-      };
+      if (onBatch) {
+        const batch = currentBatch();
+        batch.dialogs.push(...result.dialogs);
+        if (result.isQuestFile) {
+          batch.questFiles.push(allFiles[index]);
+        }
+        scheduleFlush();
+      }
+    };
 
-      // Process results
-      for (let i = 0; i < allFiles.length; i++) {
-        const result = results[i];
-        const filePath = allFiles[i];
+    // Use worker pool to process files in parallel
+    const pool = new MetadataWorkerPool();
 
-        // Track NPC instances from dialogs and prototype inheritance chains.
-        result.instances.forEach((instance) => {
-          if (!isNpcParent(instance.parent)) {
-            return;
-          }
+    try {
+      // Feed .d files to the pool as they are discovered and fold each result in
+      // as soon as it completes, so enumeration, parsing and indexing overlap
+      const pendingResults: Promise<void>[] = [];
+      for await (const filePath of walkDirectory(rootPath, options)) {
+        const index = allFiles.length;
+        allFiles.push(filePath);
+        if (onBatch) {
+          currentBatch().files.push(filePath);
+          scheduleFlush();
+        }
+        pendingResults.push(pool.processFile(filePath).then((result) => ingestResult(index, result)));
+      }
+      scanComplete = true;
+      await Promise.all(pendingResults);
+    } finally {
+      pool.terminate();
+      if (flushTimer) {
+        clearTimeout(flushTimer);
+        flushTimer = null;
+      }
+      // The scan may have added entries; bring the shared cache back within budget
+      getParseCache()?.schedulePrune();
+    }
 
-          allNpcs.add(instance.name);
-          if (!dialogsByNpc.has(instance.name)) {
-            dialogsByNpc.set(instance.name, []);
-          }
-        });
+    // Group dialogs by NPC in file order so the final index is deterministic
+    const dialogsByNpc = new Map<string, DialogMetadata[]>();
+    const questFiles: string[] = [];
+    for (let i = 0; i < allFiles.length; i++) {
+      const result = resultsByFile[i];
 
-        // Group dialogs by NPC
-        for (const dialog of result.dialogs) {
-          allNpcs.add(dialog.npc);
-          if (!dialogsByNpc.has(dialog.npc)) {
-            dialogsByNpc.set(dialog.npc, []);
-          }
-          dialogsByNpc.get(dialog.npc)!.push(dialog);
+      for (const dialog of result.dialogs) {
+        if (!dialogsByNpc.has(dialog.npc)) {
+          dialogsByNpc.set(dialog.npc, []);
         }
+        dialogsByNpc.get(dialog.npc)!.push(dialog);
+      }
 
-        // Collect quest files
-        if (result.isQuestFile) {
-          questFiles.push(filePath);
-        }
+      if (result.isQuestFile) {
+        questFiles.push(allFiles[i]);
       }
-    } finally {
-      pool.terminate();
     }
 
     // Extract and sort NPC list
     const npcs = Array.from(allNpcs).sort();
+    npcs.forEach((npc) => {
+      if (!dialogsByNpc.has(npc)) {
+        dialogsByNpc.set(npc, []);
+      }
+    });
+
+    if (onBatch) {
+      // Always finish with a batch so listeners see the final progress
+      currentBatch();
+      flush();
+    }
 
     return {
       npcs,
       dialogsByNpc,
       allFiles,
-      questFiles
+      questFiles,
+      classHierarchy: hierarchy.toSnapshot()
     };
   }
 
@@ -0,0 +1,290 @@
+/**
+ * ProjectWatcherService - keeps a project index in step with external edits
+ *
+ * Watches the project root recursively (inotify on Linux, FSEvents on macOS,
+ * ReadDirectoryChangesW on Windows via `fs.watch`), coalesces events per path
+ * and, once the tree has been quiet for a moment, re-extracts metadata for the
+ * affected .d files only. A `git checkout` touching thousands of files becomes
+ * a few large delta batches instead of one index rebuild per event.
+ *
+ * The size and modification time of every known file are kept, so a directory
+ * event (or lost events, which rescan the root) is reconciled by comparing
+ * stats instead of re-reading every file. Files the app saved itself are
+ * recognized through the write journal and not reported back.
+ */
+
+import { watch, promises as fs, type FSWatcher, type Stats } from 'fs';
+import * as path from 'path';
+import type { ProjectFileDelta } from '../../shared/types';
+import { walkDirectory, DEFAULT_WALK_IGNORE } from '../utils/directoryWalker';
+import { MetadataWorkerPool } from './MetadataWorkerPool';
+import { isOwnWrite } from '../utils/writeJournal';
+
+export interface ProjectWatcherOptions {
+  /** Quiet period before pending changes are processed (default: 150ms) */
+  debounceMs?: number;
+  /** Upper bound on how long changes wait while events keep arriving (default: 1000ms) */
+  maxWaitMs?: number;
+  /** Entry names to ignore anywhere in the tree (default: .git, .svn, node_modules) */
+  ignore?: string[];
+}
+
+export interface ProjectWatcherCallbacks {
+  onChanges: (deltas: ProjectFileDelta[]) => void;
+  onError: (error: Error) => void;
+}
+
+const DEFAULT_DEBOUNCE_MS = 150;
+const DEFAULT_MAX_WAIT_MS = 1000;
+const WATCHED_EXTENSION = '.d';
+
+/** Identifies a version of a file's content without reading it */
+function statSignature(stats: Stats): string {
+  return `${stats.size}:${stats.mtimeMs}`;
+}
+
+/** Stat `filePath`; null when it no longer exists */
+async function statIfExists(filePath: string): Promise<Stats | null> {
+  try {
+    return await fs.stat(filePath);
+  } catch (error) {
+    const code = (error as NodeJS.ErrnoException).code;
+    if (code === 'ENOENT' || code === 'ENOTDIR') {
+      return null;
+    }
+    throw error;
+  }
+}
+
+export class ProjectWatcher {
+  private watcher: FSWatcher | null = null;
+  private readonly pendingPaths = new Set<string>();
+  /** Known .d files and their stat signature when last reported */
+  private readonly knownFiles = new Map<string, string>();
+  private readonly ignoredNames: Set<string>;
+  private readonly debounceMs: number;
+  private readonly maxWaitMs: number;
+  private debounceTimer: ReturnType<typeof setTimeout> | null = null;
+  private firstPendingAt = 0;
+  private processing: Promise<void> | null = null;
+  private pool: MetadataWorkerPool | null = null;
+  private closed = false;
+
+  constructor(
+    private readonly rootPath: string,
+    private readonly callbacks: ProjectWatcherCallbacks,
+    options: ProjectWatcherOptions = {}
+  ) {
+    this.debounceMs = options.debounceMs ?? DEFAULT_DEBOUNCE_MS;
+    this.maxWaitMs = options.maxWaitMs ?? DEFAULT_MAX_WAIT_MS;
+    this.ignoredNames = new Set((options.ignore ?? DEFAULT_WALK_IGNORE).map((name) => name.toLowerCase()));
+  }
+
+  /**
+   * Start watching. Resolves once the initial file list is known, so that
+   * deleted directories can be mapped back to the files they contained.
+   */
+  async start(): Promise<void> {
+    // Subscribe first so nothing is missed while the tree is being listed
+    this.watcher = watch(this.rootPath, { recursive: true }, (_eventType, filename) => {
+      if (filename === null || filename === undefined) {
+        // The platform couldn't tell us what changed (e.g. inotify queue overflow)
+        this.rescan();
+        return;
+      }
+      this.enqueue(path.join(this.rootPath, filename.toString()));
+    });
+    this.watcher.on('error', (error) => this.callbacks.onError(error));
+
+    for await (const filePath of walkDirectory(this.rootPath, { ignore: Array.from(this.ignoredNames) })) {
+      if (this.closed) return;
+      const stats = await statIfExists(filePath).catch(() => null);
+      if (stats) {
+        this.knownFiles.set(filePath, statSignature(stats));
+      }
+    }
+  }
+
+  /**
+   * Reconcile the whole tree against the known files, e.g. after events were
+   * lost. Only files whose size or modification time changed are re-read.
+   */
+  rescan(): void {
+    this.enqueue(this.rootPath);
+  }
+
+  close(): void {
+    this.closed = true;
+    this.watcher?.close();
+    this.watcher = null;
+    if (this.debounceTimer) {
+      clearTimeout(this.debounceTimer);
+      this.debounceTimer = null;
+    }
+    this.pendingPaths.clear();
+    this.pool?.terminate();
+    this.pool = null;
+  }
+
+  private isIgnored(fullPath: string): boolean {
+    const relativePath = path.relative(this.rootPath, fullPath);
+    if (relativePath === '') {
+      return false;
+    }
+    return relativePath.split(path.sep).some((segment) => this.ignoredNames.has(segment.toLowerCase()));
+  }
+
+  private enqueue(fullPath: string): void {
+    if (this.closed || this.isIgnored(fullPath)) {
+      return;
+    }
+    if (this.pendingPaths.size === 0) {
+      this.firstPendingAt = Date.now();
+    }
+    this.pendingPaths.add(fullPath);
+    this.schedule();
+  }
+
+  private schedule(): void {
+    if (this.debounceTimer) {
+      clearTimeout(this.debounceTimer);
+    }
+    // Keep debouncing while events arrive, but never past maxWait
+    const waited = Date.now() - this.firstPendingAt;
+    const delay = Math.max(0, Math.min(this.debounceMs, this.maxWaitMs - waited));
+    this.debounceTimer = setTimeout(() => {
+      this.debounceTimer = null;
+      this.flush();
+    }, delay);
+  }
+
+  private flush(): void {
+    if (this.closed || this.pendingPaths.size === 0) {
+      return;
+    }
+    if (this.processing) {
+      // Picked up again when the current batch is done
+      return;
+    }
+
+    const paths = Array.from(this.pendingPaths);
+    this.pendingPaths.clear();
+    this.processing = this.processPaths(paths)
+      .catch((error) => {
+        if (!this.closed) {
+          this.callbacks.onError(error instanceof Error ? error : new Error(String(error)));
+        }
+      })
+      .finally(() => {
+        this.processing = null;
+        if (this.pendingPaths.size > 0) {
+          this.firstPendingAt = Date.now();
+          this.schedule();
+        }
+      });
+  }
+
+  /** Long-lived: created on the first change and kept until the watcher closes */
+  private getPool(): MetadataWorkerPool {
+    if (!this.pool) {
+      this.pool = new MetadataWorkerPool();
+    }
+    return this.pool;
+  }
+
+  /**
+   * Resolve raw event paths (files or directories) to the .d files they
+   * affect. `changed` maps each file to re-read to its current stat signature.
+   */
+  private async collectAffectedFiles(paths: string[]): Promise<{ changed: Map<string, string>; removed: Set<string> }> {
+    const changed = new Map<string, string>();
+    const removed = new Set<string>();
+
+    const noteFile = (filePath: string, stats: Stats) => {
+      const signature = statSignature(stats);
+      if (this.knownFiles.get(filePath) === signature) {
+        // Touched without changes, or already reported
+        return;
+      }
+      if (isOwnWrite(filePath, stats)) {
+        // Saved by the app itself; the renderer already has this content
+        this.knownFiles.set(filePath, signature);
+        return;
+      }
+      changed.set(filePath, signature);
+    };
+
+    const removeKnownBelow = (directory: string, present: Set<string>) => {
+      const prefix = directory.endsWith(path.sep) ? directory : directory + path.sep;
+      this.knownFiles.forEach((_signature, filePath) => {
+        if (filePath.startsWith(prefix) && !present.has(filePath)) {
+          removed.add(filePath);
+        }
+      });
+    };
+
+    await Promise.all(paths.map(async (fullPath) => {
+      const stats = await statIfExists(fullPath);
+
+      if (stats?.isFile()) {
+        if (path.extname(fullPath).toLowerCase() === WATCHED_EXTENSION) {
+          noteFile(fullPath, stats);
+        }
+        return;
+      }
+
+      if (stats?.isDirectory()) {
+        // New, moved-in or rescanned directory: its files may produce no events of their own
+        const present = new Set<string>();
+        for await (const filePath of walkDirectory(fullPath, { ignore: Array.from(this.ignoredNames) })) {
+          const fileStats = await statIfExists(filePath);
+          if (fileStats) {
+            present.add(filePath);
+            noteFile(filePath, fileStats);
+          }
+        }
+        removeKnownBelow(fullPath, present);
+        return;
+      }
+
+      // Gone: either a file or a whole directory
+      if (this.knownFiles.has(fullPath)) {
+        removed.add(fullPath);
+        return;
+      }
+      removeKnownBelow(fullPath, new Set());
+    }));
+
+    return { changed, removed };
+  }
+
+  private async processPaths(paths: string[]): Promise<void> {
+    const { changed, removed } = await this.collectAffectedFiles(paths);
+    if (this.closed || (changed.size === 0 && removed.size === 0)) {
+      return;
+    }
+
+    const deltas: ProjectFileDelta[] = [];
+    removed.forEach((filePath) => {
+      this.knownFiles.delete(filePath);
+      deltas.push({ filePath, metadata: null });
+    });
+
+    const pool = this.getPool();
+    const changedDeltas = await Promise.all(Array.from(changed).map(async ([filePath, signature]): Promise<ProjectFileDelta> => {
+      const metadata = await pool.processFile(filePath);
+      // The pool reports unreadable files as empty metadata; one that is gone by now was deleted
+      if (!(await statIfExists(filePath).catch(() => true))) {
+        this.knownFiles.delete(filePath);
+        return { filePath, metadata: null };
+      }
+      this.knownFiles.set(filePath, signature);
+      return { filePath, metadata };
+    }));
+    deltas.push(...changedDeltas);
+
+    if (!this.closed) {
+      this.callbacks.onChanges(deltas);
+    }
+  }
+}
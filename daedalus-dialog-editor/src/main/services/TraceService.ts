@@ -0,0 +1,75 @@
+/**
+ * TraceService - collects one Chrome/Perfetto trace per editor session
+ *
+ * Enabled with DAEDALUS_TRACE: `1` writes to the app's log directory, any
+ * other value is taken as the output directory. Main-thread spans and the
+ * spans workers post back share the main thread's buffer; renderer spans
+ * arrive over IPC. The file is written when the app quits and opens in
+ * chrome://tracing or ui.perfetto.dev.
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import {
+  appendTraceEvents,
+  drainTraceEvents,
+  enableTracing,
+  toChromeTrace,
+  type TraceEvent
+} from 'daedalus-parser/tracing';
+
+export const TRACE_ENV_VAR = 'DAEDALUS_TRACE';
+
+export class TraceService {
+  private readonly processNames = new Map<number, string>();
+  private readonly startedAt = new Date();
+
+  /**
+   * @param outputDir - Where the trace goes; null defers to the directory passed to writeSession
+   */
+  constructor(private readonly outputDir: string | null) {
+    this.processNames.set(process.pid, 'main');
+  }
+
+  /** Start tracing if the environment asks for it; null when tracing is off */
+  static fromEnv(env: NodeJS.ProcessEnv = process.env): TraceService | null {
+    const value = env[TRACE_ENV_VAR]?.trim();
+    if (!value || value === '0' || value.toLowerCase() === 'false') {
+      return null;
+    }
+    enableTracing({ threadName: 'main' });
+    const useDefaultDir = value === '1' || value.toLowerCase() === 'true';
+    return new TraceService(useDefaultDir ? null : path.resolve(value));
+  }
+
+  /** Add events recorded in another process, stamping them with its pid */
+  record(events: TraceEvent[], pid: number, processName: string): void {
+    if (!Array.isArray(events)) {
+      return;
+    }
+    this.processNames.set(pid, processName);
+    appendTraceEvents(events.map((event) => (event.pid === 0 ? { ...event, pid } : event)));
+  }
+
+  /**
+   * Write everything recorded so far. Synchronous so it can run while the app quits.
+   * @returns Path of the trace file
+   */
+  writeSession(defaultDir: string): string {
+    const outputDir = this.outputDir ?? defaultDir;
+    const metadata: TraceEvent[] = Array.from(this.processNames, ([pid, name]) => ({
+      name: 'process_name',
+      ph: 'M',
+      pid,
+      tid: 0,
+      args: { name }
+    }));
+    const events = [...metadata, ...drainTraceEvents()];
+
+    fs.mkdirSync(outputDir, { recursive: true });
+    const stamp = this.startedAt.toISOString().replace(/[:.]/g, '-');
+    const tracePath = path.join(outputDir, `daedalus-trace-${stamp}.json`);
+    fs.writeFileSync(tracePath, JSON.stringify(toChromeTrace(events)), 'utf8');
+    return tracePath;
+  }
+}
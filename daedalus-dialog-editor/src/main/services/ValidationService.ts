@@ -1,4 +1,3 @@
-import type { ParserService } from './ParserService';
 import type { CodeGeneratorService } from './CodeGeneratorService';
 import { deserializeSemanticModel } from 'daedalus-parser/semantic-model';
 
@@ -53,6 +52,14 @@ export interface ValidationResult {
   generatedCode?: string;
 }
 
+/**
+ * Anything that parses source into a model with `hasErrors`/`errors`:
+ * ParserService, or an in-thread parser inside a codegen worker
+ */
+export interface SourceParser {
+  parseSource(sourceCode: string): Promise<any>;
+}
+
 /**
  * Code generation settings
  */
@@ -74,21 +81,23 @@ interface CodeGeneratorSettings {
  * 5. Choice target function validation
  */
 export class ValidationService {
-  private parserService: ParserService;
+  private parserService: SourceParser;
   private codeGeneratorService: CodeGeneratorService;
 
-  constructor(parserService: ParserService, codeGeneratorService: CodeGeneratorService) {
+  constructor(parserService: SourceParser, codeGeneratorService: CodeGeneratorService) {
     this.parserService = parserService;
     this.codeGeneratorService = codeGeneratorService;
   }
 
   /**
    * Validate a semantic model before saving
+   * @param checkpoint - Called between steps; throw from it to abandon the validation
    */
   async validate(
     model: any,
     settings: CodeGeneratorSettings,
-    options: ValidationOptions = {}
+    options: ValidationOptions = {},
+    checkpoint?: () => void
   ): Promise<ValidationResult> {
     const errors: ValidationError[] = [];
     const warnings: ValidationWarning[] = [];
@@ -107,11 +116,13 @@ export class ValidationService {
       });
       return { isValid: false, errors, warnings };
     }
+    checkpoint?.();
 
     // Step 2: Syntax validation via round-trip parsing
     if (!options.skipSyntaxValidation) {
       const syntaxErrors = await this.validateSyntax(generatedCode);
       errors.push(...syntaxErrors);
+      checkpoint?.();
     }
 
     // Step 3: Duplicate dialog detection
@@ -0,0 +1,186 @@
+import { CodeGeneratorService } from '../services/CodeGeneratorService';
+import { ModelDocumentService } from '../services/ModelDocumentService';
+import { ValidationService, type SourceParser, type ValidationOptions, type ValidationResult } from '../services/ValidationService';
+import type { ModelDelta } from '../../shared/modelDelta';
+
+/**
+ * Work that CodegenWorkerPool runs off the main thread. Models arrive as
+ * plain (structured-cloned) objects and are deserialized by the services.
+ */
+export type CodegenRequest =
+  | ({ type: 'generateCode'; settings: any } & ModelSource)
+  | ({ type: 'generateDialogCode'; dialogName: string; settings: any } & ModelSource)
+  | ({ type: 'validate'; settings: any; options?: ValidationOptions } & ModelSource)
+  | ({ type: 'prepareSave'; settings: any; options?: SaveTaskOptions } & ModelSource)
+  | ({ type: 'generateChunks'; settings: any } & ModelSource);
+
+/**
+ * A whole model, or a delta against the copy of an open file the runner keeps
+ * from earlier requests. Unchanged declarations of a kept copy keep their
+ * identity, so the generated-code cache serves them without regenerating;
+ * a whole model is a fresh structured clone each time and always misses.
+ */
+export type ModelSource =
+  | { model: any; document?: undefined }
+  | { model?: undefined; document: { key: string; delta: ModelDelta } };
+
+/** Open files whose models a runner keeps for delta requests */
+const MAX_RUNNER_DOCUMENTS = 16;
+
+/** The runner has no copy at the delta's base version; resend the delta with `full` set */
+export class CodegenDocumentMissingError extends Error {
+  constructor(message = 'No model copy at the delta\'s base version') {
+    super(message);
+    this.name = 'CodegenDocumentMissingError';
+  }
+}
+
+export interface SaveTaskOptions {
+  skipValidation?: boolean;
+  forceOnErrors?: boolean;
+}
+
+/**
+ * Outcome of the validation/generation part of a save. The main process
+ * writes `code` unless `blocked` is set.
+ */
+export interface PreparedSave {
+  blocked: boolean;
+  code?: string;
+  validationResult?: ValidationResult;
+}
+
+/** Throws to abandon the current task; called between stages */
+export type Checkpoint = () => void;
+
+/**
+ * Round-trip parser for validation inside the current thread: only the
+ * syntax check runs, which is all validation looks at.
+ */
+export function createInThreadSyntaxParser(): SourceParser {
+  // Loaded on first use so modules that only generate code never load the native parser
+  // eslint-disable-next-line @typescript-eslint/no-var-requires
+  const DaedalusParser = require('daedalus-parser');
+  // eslint-disable-next-line @typescript-eslint/no-var-requires
+  const { SemanticModelBuilderVisitor } = require('daedalus-parser/semantic-visitor');
+  const parser = new DaedalusParser();
+
+  return {
+    async parseSource(sourceCode: string) {
+      const parseResult = parser.parse(sourceCode);
+      const visitor = new SemanticModelBuilderVisitor();
+      visitor.checkForSyntaxErrors(parseResult.tree.rootNode, sourceCode);
+      return visitor.semanticModel;
+    }
+  };
+}
+
+export class CodegenTaskRunner {
+  private readonly codeGenerator = new CodeGeneratorService();
+  private readonly documents = new ModelDocumentService(MAX_RUNNER_DOCUMENTS);
+  private parser: SourceParser | null = null;
+  private validationService: ValidationService | null = null;
+
+  constructor(private readonly createParser: () => SourceParser = createInThreadSyntaxParser) {}
+
+  private getParser(): SourceParser {
+    if (!this.parser) {
+      this.parser = this.createParser();
+    }
+    return this.parser;
+  }
+
+  private getValidationService(): ValidationService {
+    if (!this.validationService) {
+      this.validationService = new ValidationService(this.getParser(), this.codeGenerator);
+    }
+    return this.validationService;
+  }
+
+  async run(request: CodegenRequest, checkpoint: Checkpoint): Promise<unknown> {
+    switch (request.type) {
+      case 'generateCode':
+        return this.codeGenerator.generateCode(this.resolveModel(request), request.settings);
+      case 'generateDialogCode':
+        return this.codeGenerator.generateDialogCode(this.resolveModel(request), request.dialogName, request.settings);
+      case 'validate':
+        return this.getValidationService().validate(
+          this.resolveModel(request),
+          request.settings,
+          request.options,
+          checkpoint
+        );
+      case 'prepareSave':
+        return this.prepareSave(this.resolveModel(request), request.settings, request.options ?? {}, checkpoint);
+      case 'generateChunks':
+        throw new Error('generateChunks is streamed; use chunks()');
+    }
+  }
+
+  private resolveModel(source: ModelSource): any {
+    if (!source.document) {
+      return source.model;
+    }
+    const model = this.documents.apply(source.document.key, source.document.delta);
+    if (!model) {
+      throw new CodegenDocumentMissingError();
+    }
+    return model;
+  }
+
+  /** Generated code for `generateChunks`, checking for cancellation between fragments */
+  *chunks(request: Extract<CodegenRequest, { type: 'generateChunks' }>, checkpoint: Checkpoint): Generator<string> {
+    for (const chunk of this.codeGenerator.generateCodeChunks(this.resolveModel(request), request.settings)) {
+      checkpoint();
+      yield chunk;
+    }
+  }
+
+  private async prepareSave(
+    model: any,
+    settings: any,
+    options: SaveTaskOptions,
+    checkpoint: Checkpoint
+  ): Promise<PreparedSave> {
+    // Validate model unless explicitly skipped
+    if (!options.skipValidation) {
+      const validationResult = await this.getValidationService().validate(model, settings, {}, checkpoint);
+
+      // If validation failed and not forcing save, return validation result
+      if (!validationResult.isValid && !options.forceOnErrors) {
+        return { blocked: true, validationResult };
+      }
+
+      // Use pre-generated code from validation if available
+      if (validationResult.generatedCode) {
+        return { blocked: false, code: validationResult.generatedCode, validationResult };
+      }
+    }
+
+    // Fallback: generate code directly (only if validation skipped or didn't provide code)
+    const code = this.codeGenerator.generateCode(model, settings);
+    checkpoint();
+
+    // Final sanity check for generated code - ALWAYS run this if we are falling back
+    const syntaxResult = await this.getParser().parseSource(code);
+    if (syntaxResult.hasErrors && !options.forceOnErrors) {
+      return {
+        blocked: true,
+        validationResult: {
+          isValid: false,
+          errors: syntaxResult.errors?.map((e: any) => ({
+            type: 'syntax_error' as const,
+            message: e.message || 'Syntax error',
+            position: e.position
+          })) || [{
+            type: 'syntax_error' as const,
+            message: 'Syntax error detected (sanity check)',
+          }],
+          warnings: []
+        }
+      };
+    }
+
+    return { blocked: false, code };
+  }
+}
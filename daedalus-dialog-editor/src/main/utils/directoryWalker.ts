@@ -0,0 +1,186 @@
+/**
+ * Streaming directory walker for project scanning
+ *
+ * Enumerates matching files breadth-first with a fixed number of concurrent
+ * readdir calls and yields each path as soon as its directory has been read,
+ * so callers can start processing files while enumeration continues.
+ */
+
+import { promises as fs } from 'fs';
+import type { Dirent } from 'fs';
+import * as path from 'path';
+
+export interface DirectoryWalkOptions {
+  /** File extensions to yield, compared case-insensitively (default: ['.d']) */
+  extensions?: string[];
+  /**
+   * Glob patterns (`*`, `?`) for entries to skip, matched case-insensitively.
+   * Patterns without a slash match the entry name; patterns with a slash match
+   * the path relative to the root (using forward slashes).
+   */
+  ignore?: string[];
+  /** Maximum number of directories read concurrently (default: 8) */
+  concurrency?: number;
+  /** Whether to descend into symlinked directories (default: true) */
+  followSymlinks?: boolean;
+}
+
+export const DEFAULT_WALK_IGNORE = ['.git', '.svn', 'node_modules'];
+const DEFAULT_WALK_CONCURRENCY = 8;
+
+interface CompiledPattern {
+  regex: RegExp;
+  matchesRelativePath: boolean;
+}
+
+function compilePattern(pattern: string): CompiledPattern {
+  const normalized = pattern.replace(/\\/g, '/').replace(/^\/+|\/+$/g, '');
+  const source = normalized
+    .split('')
+    .map((char) => {
+      if (char === '*') return '[^/]*';
+      if (char === '?') return '[^/]';
+      return char.replace(/[.+^${}()|[\]\\]/g, '\\$&');
+    })
+    .join('');
+
+  return {
+    regex: new RegExp(`^${source}$`, 'i'),
+    matchesRelativePath: normalized.includes('/')
+  };
+}
+
+interface PendingDirectory {
+  fullPath: string;
+  realPath: string;
+  relativePath: string;
+}
+
+/**
+ * Walk `rootPath` and yield every matching file path.
+ *
+ * Unreadable directories are skipped silently. Directories are tracked by
+ * their resolved real path, so symlink cycles are visited only once.
+ */
+export async function* walkDirectory(
+  rootPath: string,
+  options: DirectoryWalkOptions = {}
+): AsyncGenerator<string, void, undefined> {
+  const extensions = new Set((options.extensions ?? ['.d']).map((ext) => ext.toLowerCase()));
+  const patterns = (options.ignore ?? DEFAULT_WALK_IGNORE).map(compilePattern);
+  const concurrency = Math.max(1, options.concurrency ?? DEFAULT_WALK_CONCURRENCY);
+  const followSymlinks = options.followSymlinks ?? true;
+
+  const isIgnored = (name: string, relativePath: string): boolean =>
+    patterns.some((pattern) => pattern.regex.test(pattern.matchesRelativePath ? relativePath : name));
+
+  let rootRealPath: string;
+  try {
+    rootRealPath = await fs.realpath(rootPath);
+  } catch {
+    return;
+  }
+
+  const visited = new Set<string>([rootRealPath]);
+  const pendingDirectories: PendingDirectory[] = [{ fullPath: rootPath, realPath: rootRealPath, relativePath: '' }];
+  const readyFiles: string[] = [];
+  let activeReads = 0;
+  let stopped = false;
+  let wakeConsumer: (() => void) | null = null;
+
+  const notify = () => {
+    if (wakeConsumer) {
+      const wake = wakeConsumer;
+      wakeConsumer = null;
+      wake();
+    }
+  };
+
+  const enqueueDirectory = (directory: PendingDirectory) => {
+    if (visited.has(directory.realPath)) {
+      return;
+    }
+    visited.add(directory.realPath);
+    pendingDirectories.push(directory);
+  };
+
+  const readDirectory = async (directory: PendingDirectory): Promise<void> => {
+    let entries: Dirent[];
+    try {
+      entries = await fs.readdir(directory.fullPath, { withFileTypes: true });
+    } catch {
+      // Silently skip directories that can't be read (permissions, etc.)
+      return;
+    }
+
+    for (const entry of entries) {
+      const relativePath = directory.relativePath ? `${directory.relativePath}/${entry.name}` : entry.name;
+      if (isIgnored(entry.name, relativePath)) {
+        continue;
+      }
+
+      const fullPath = path.join(directory.fullPath, entry.name);
+      let isDirectory = entry.isDirectory();
+      let isFile = entry.isFile();
+      let realPath = path.join(directory.realPath, entry.name);
+
+      if (entry.isSymbolicLink()) {
+        if (!followSymlinks) {
+          continue;
+        }
+        try {
+          const [stats, resolved] = await Promise.all([fs.stat(fullPath), fs.realpath(fullPath)]);
+          isDirectory = stats.isDirectory();
+          isFile = stats.isFile();
+          realPath = resolved;
+        } catch {
+          // Dangling symlink
+          continue;
+        }
+      }
+
+      if (isDirectory) {
+        enqueueDirectory({ fullPath, realPath, relativePath });
+      } else if (isFile && extensions.has(path.extname(entry.name).toLowerCase())) {
+        readyFiles.push(fullPath);
+      }
+    }
+  };
+
+  const pump = () => {
+    while (!stopped && activeReads < concurrency && pendingDirectories.length > 0) {
+      const directory = pendingDirectories.shift()!;
+      activeReads++;
+      readDirectory(directory).finally(() => {
+        activeReads--;
+        pump();
+        notify();
+      });
+    }
+  };
+
+  pump();
+
+  try {
+    while (true) {
+      if (readyFiles.length > 0) {
+        const batch = readyFiles.splice(0, readyFiles.length);
+        for (const filePath of batch) {
+          yield filePath;
+        }
+        continue;
+      }
+
+      if (activeReads === 0 && pendingDirectories.length === 0) {
+        return;
+      }
+
+      await new Promise<void>((resolve) => {
+        wakeConsumer = resolve;
+      });
+    }
+  } finally {
+    // Stop scheduling further reads if the consumer exits early
+    stopped = true;
+  }
+}
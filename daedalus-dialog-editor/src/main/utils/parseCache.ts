@@ -0,0 +1,364 @@
+/**
+ * Content-addressed cache of per-file parse results, shared by all projects
+ *
+ * Mods vendor the same base-game scripts, so most files of a newly opened
+ * project were already parsed for another one. Entries are keyed by a hash
+ * of the file text, not its path, and live under a namespace derived from
+ * the parser version, grammar and semantic passes so an upgrade never serves
+ * stale results. The cache is plain files: worker threads read and write it
+ * directly, and a main-process prune keeps it within its size budget by
+ * evicting the least recently used entries.
+ */
+
+import { createHash, randomBytes } from 'crypto';
+import * as fs from 'fs';
+import { promises as fsPromises } from 'fs';
+import * as path from 'path';
+
+/**
+ * Bump when the shape of cached values changes (e.g. metadata extraction).
+ * 2: models are stored in the semantic model wire format.
+ */
+export const PARSE_CACHE_FORMAT_VERSION = 2;
+
+/** Default size budget */
+export const DEFAULT_PARSE_CACHE_MAX_BYTES = 256 * 1024 * 1024;
+
+/** Pruning brings the cache down to this share of the budget so it is not pruned on every write */
+const PRUNE_LOW_WATER_MARK = 0.8;
+
+/** Delay that coalesces prune requests from back-to-back scans */
+const PRUNE_DEBOUNCE_MS = 5_000;
+
+/** Temp files of interrupted writes older than this are removed by prune */
+const STALE_TEMP_FILE_MS = 60 * 60 * 1000;
+
+/**
+ * Entries of other namespaces unused for this long are removed by prune.
+ * Another installed editor build may still be using a sibling namespace,
+ * so recently used ones are kept and only count toward the size budget.
+ */
+const STALE_NAMESPACE_ENTRY_MS = 14 * 24 * 60 * 60 * 1000;
+
+export type ParseCacheKind = 'metadata' | 'model';
+
+export interface ParseCacheOptions {
+  /** User-level cache root; each namespace gets a subdirectory */
+  directory: string;
+  /** Parser/grammar version tag; defaults to parseCacheNamespace() */
+  namespace?: string;
+  maxBytes?: number;
+}
+
+export interface ParseCachePruneResult {
+  removedFiles: number;
+  removedBytes: number;
+  totalBytes: number;
+}
+
+interface CacheFileEntry {
+  namespace: string;
+  filePath: string;
+  size: number;
+  lastUsedMs: number;
+}
+
+/** Key of a file's text */
+export function contentHash(text: string): string {
+  return createHash('sha256').update(text, 'utf8').digest('hex');
+}
+
+/** Hash `filePath`, or every .js/.ts file below it in name order; missing paths add nothing */
+function hashSources(hash: ReturnType<typeof createHash>, filePath: string): void {
+  let stats: fs.Stats;
+  try {
+    stats = fs.statSync(filePath);
+  } catch {
+    return;
+  }
+  if (stats.isFile()) {
+    hash.update(path.basename(filePath));
+    hash.update(fs.readFileSync(filePath));
+    return;
+  }
+  const children = fs.readdirSync(filePath, { withFileTypes: true }).sort((a, b) => a.name.localeCompare(b.name));
+  for (const child of children) {
+    if (child.isDirectory() || /\.(js|ts)$/.test(child.name)) {
+      hashSources(hash, path.join(filePath, child.name));
+    }
+  }
+}
+
+let cachedNamespace: string | null = null;
+
+/**
+ * Namespace for the installed parser and editor: the parser's package
+ * version plus a hash of its grammar, its semantic visitors and the
+ * editor's metadata extraction, so changing any of them invalidates entries
+ * even without a version bump.
+ */
+export function parseCacheNamespace(): string {
+  if (cachedNamespace) {
+    return cachedNamespace;
+  }
+  const parserRoot = path.resolve(path.dirname(require.resolve('daedalus-parser')), '../..');
+  let version = 'unknown';
+  try {
+    version = JSON.parse(fs.readFileSync(path.join(parserRoot, 'package.json'), 'utf-8')).version || version;
+  } catch {
+    // Keep 'unknown'; the grammar hash still separates parser builds
+  }
+
+  const hash = createHash('sha256');
+  for (const file of ['src/grammar.json', 'src/node-types.json']) {
+    try {
+      hash.update(fs.readFileSync(path.join(parserRoot, file)));
+    } catch {
+      // Not shipped in this build
+    }
+  }
+  for (const moduleName of ['daedalus-parser/semantic-visitor', './semanticMetadataUtils']) {
+    try {
+      // The visitor's whole directory: the passes live in sibling modules
+      const resolved = require.resolve(moduleName);
+      hashSources(hash, moduleName.startsWith('.') ? resolved : path.dirname(resolved));
+    } catch {
+      // Not resolvable in this build
+    }
+  }
+  cachedNamespace = `v${PARSE_CACHE_FORMAT_VERSION}-${version}-${hash.digest('hex').slice(0, 12)}`;
+  return cachedNamespace;
+}
+
+export class ParseCache {
+  readonly directory: string;
+  readonly namespace: string;
+  readonly maxBytes: number;
+  private pruneTimer: ReturnType<typeof setTimeout> | null = null;
+  private pruning: Promise<ParseCachePruneResult> | null = null;
+
+  constructor(options: ParseCacheOptions) {
+    this.directory = options.directory;
+    this.namespace = options.namespace ?? parseCacheNamespace();
+    this.maxBytes = options.maxBytes ?? DEFAULT_PARSE_CACHE_MAX_BYTES;
+  }
+
+  /** Options that recreate this cache in a worker thread */
+  get options(): Required<ParseCacheOptions> {
+    return { directory: this.directory, namespace: this.namespace, maxBytes: this.maxBytes };
+  }
+
+  private get namespaceDirectory(): string {
+    return path.join(this.directory, this.namespace);
+  }
+
+  private entryPath(kind: ParseCacheKind, hash: string): string {
+    return path.join(this.namespaceDirectory, hash.slice(0, 2), `${hash}.${kind}.json`);
+  }
+
+  /**
+   * Cached value for a content hash, or undefined on a miss. A hit marks the
+   * entry as recently used.
+   */
+  async get<T>(kind: ParseCacheKind, hash: string): Promise<T | undefined> {
+    const filePath = this.entryPath(kind, hash);
+    let text: string;
+    try {
+      text = await fsPromises.readFile(filePath, 'utf-8');
+    } catch {
+      return undefined;
+    }
+
+    try {
+      const value = JSON.parse(text) as T;
+      const now = new Date();
+      fsPromises.utimes(filePath, now, now).catch(() => undefined);
+      return value;
+    } catch {
+      // Torn or corrupted entry: drop it and parse again
+      await fsPromises.unlink(filePath).catch(() => undefined);
+      return undefined;
+    }
+  }
+
+  /**
+   * Store a value. The value is serialized before this returns, so callers
+   * may mutate it afterwards. Failures are logged, never thrown: the cache
+   * is an optimization.
+   */
+  async set(kind: ParseCacheKind, hash: string, value: unknown): Promise<void> {
+    const text = JSON.stringify(value);
+    const filePath = this.entryPath(kind, hash);
+    // Unique temp name + rename: concurrent writers of one entry never expose a partial file
+    const tempPath = `${filePath}.${process.pid}.${randomBytes(4).toString('hex')}.tmp`;
+    try {
+      await fsPromises.mkdir(path.dirname(filePath), { recursive: true });
+      await fsPromises.writeFile(tempPath, text, 'utf-8');
+      await fsPromises.rename(tempPath, filePath);
+    } catch (error) {
+      await fsPromises.unlink(tempPath).catch(() => undefined);
+      console.error('[ParseCache] Failed to write cache entry:', error);
+    }
+  }
+
+  /** Prune soon, coalescing requests from back-to-back scans */
+  schedulePrune(delayMs = PRUNE_DEBOUNCE_MS): void {
+    if (this.pruneTimer) {
+      return;
+    }
+    this.pruneTimer = setTimeout(() => {
+      this.pruneTimer = null;
+      this.prune().catch((error) => console.error('[ParseCache] Prune failed:', error));
+    }, delayMs);
+    this.pruneTimer.unref?.();
+  }
+
+  /**
+   * Remove long unused entries of other namespaces and, when the cache as a
+   * whole is over budget, the least recently used entries of any namespace
+   * until it is back under the low-water mark.
+   */
+  prune(): Promise<ParseCachePruneResult> {
+    if (!this.pruning) {
+      this.pruning = this.pruneNow().finally(() => {
+        this.pruning = null;
+      });
+    }
+    return this.pruning;
+  }
+
+  cancelScheduledPrune(): void {
+    if (this.pruneTimer) {
+      clearTimeout(this.pruneTimer);
+      this.pruneTimer = null;
+    }
+  }
+
+  private async pruneNow(): Promise<ParseCachePruneResult> {
+    const result: ParseCachePruneResult = { removedFiles: 0, removedBytes: 0, totalBytes: 0 };
+    const entries = await this.listEntries();
+    const now = Date.now();
+    const live: CacheFileEntry[] = [];
+    for (const entry of entries) {
+      const age = now - entry.lastUsedMs;
+      const stale = entry.filePath.endsWith('.tmp')
+        ? age > STALE_TEMP_FILE_MS
+        : entry.namespace !== this.namespace && age > STALE_NAMESPACE_ENTRY_MS;
+      if (stale) {
+        if (await this.removeEntry(entry)) {
+          result.removedFiles++;
+          result.removedBytes += entry.size;
+        }
+        continue;
+      }
+      if (!entry.filePath.endsWith('.tmp')) {
+        live.push(entry);
+        result.totalBytes += entry.size;
+      }
+    }
+
+    if (result.totalBytes > this.maxBytes) {
+      live.sort((a, b) => a.lastUsedMs - b.lastUsedMs);
+      const target = this.maxBytes * PRUNE_LOW_WATER_MARK;
+      for (const entry of live) {
+        if (result.totalBytes <= target) {
+          break;
+        }
+        if (await this.removeEntry(entry)) {
+          result.removedFiles++;
+          result.removedBytes += entry.size;
+          result.totalBytes -= entry.size;
+        }
+      }
+    }
+
+    await this.removeEmptyNamespaces();
+    return result;
+  }
+
+  /** Entry and temp files of every namespace under the cache root */
+  private async listEntries(): Promise<CacheFileEntry[]> {
+    const entries: CacheFileEntry[] = [];
+    const namespaces = await fsPromises.readdir(this.directory, { withFileTypes: true }).catch(() => []);
+    for (const namespace of namespaces) {
+      if (!namespace.isDirectory()) {
+        continue;
+      }
+      const namespacePath = path.join(this.directory, namespace.name);
+      const shards = await fsPromises.readdir(namespacePath, { withFileTypes: true }).catch(() => []);
+      for (const shard of shards) {
+        if (!shard.isDirectory()) {
+          continue;
+        }
+        const shardPath = path.join(namespacePath, shard.name);
+        const files = await fsPromises.readdir(shardPath).catch(() => [] as string[]);
+        for (const name of files) {
+          const filePath = path.join(shardPath, name);
+          try {
+            const stats = await fsPromises.stat(filePath);
+            entries.push({ namespace: namespace.name, filePath, size: stats.size, lastUsedMs: stats.mtimeMs });
+          } catch {
+            // Removed concurrently
+          }
+        }
+      }
+    }
+    return entries;
+  }
+
+  /** Drop directories of other namespaces that pruning emptied; rmdir leaves non-empty ones alone */
+  private async removeEmptyNamespaces(): Promise<void> {
+    const namespaces = await fsPromises.readdir(this.directory, { withFileTypes: true }).catch(() => []);
+    for (const namespace of namespaces) {
+      if (!namespace.isDirectory() || namespace.name === this.namespace) {
+        continue;
+      }
+      const namespacePath = path.join(this.directory, namespace.name);
+      const shards = await fsPromises.readdir(namespacePath).catch(() => [] as string[]);
+      for (const shard of shards) {
+        await fsPromises.rmdir(path.join(namespacePath, shard)).catch(() => undefined);
+      }
+      await fsPromises.rmdir(namespacePath).catch(() => undefined);
+    }
+  }
+
+  private async removeEntry(entry: CacheFileEntry): Promise<boolean> {
+    try {
+      await fsPromises.unlink(entry.filePath);
+      return true;
+    } catch {
+      return false;
+    }
+  }
+}
+
+// Process-wide (per thread) cache; set up by main.ts and by worker threads from workerData
+let sharedCache: ParseCache | null = null;
+
+/** Set (or with null, disable) the cache used by metadata extraction and ingestion */
+export function configureParseCache(options: ParseCacheOptions | null | undefined): ParseCache | null {
+  sharedCache?.cancelScheduledPrune();
+  sharedCache = options ? new ParseCache(options) : null;
+  return sharedCache;
+}
+
+export function getParseCache(): ParseCache | null {
+  return sharedCache;
+}
+
+/**
+ * The thread's cache for `options`, set up on first use. Parser workers start
+ * before main.ts configures the cache, so they receive its options with each
+ * job instead of in workerData.
+ */
+export function useParseCache(options: ParseCacheOptions | null | undefined): ParseCache | null {
+  if (!options) {
+    return null;
+  }
+  const current = sharedCache;
+  if (current && current.directory === options.directory && current.namespace === options.namespace &&
+    current.maxBytes === (options.maxBytes ?? DEFAULT_PARSE_CACHE_MAX_BYTES)) {
+    return current;
+  }
+  return configureParseCache(options);
+}
@@ -1,16 +1,13 @@
-import type { DialogMetadata, SemanticModel } from '../../shared/types';
+import { promises as fs } from 'fs';
+import type { DialogMetadata, ProjectFileMetadata, SemanticModel, TypeDeclaration } from '../../shared/types';
 import { SemanticModelBuilderVisitor } from 'daedalus-parser/semantic-visitor';
+import { contentHash, getParseCache } from './parseCache';
 
 // @ts-ignore - CommonJS module
 const DaedalusParser = require('daedalus-parser');
 const daedalusWrapper = new DaedalusParser();
 
-export interface ParsedFileMetadata {
-  dialogs: DialogMetadata[];
-  instances: Array<{ name: string; parent: string }>;
-  prototypes: Array<{ name: string; parent: string }>;
-  isQuestFile: boolean;
-}
+export type ParsedFileMetadata = ProjectFileMetadata;
 
 const hasQuestTopicConstants = (semanticModel: SemanticModel): boolean => {
   const constantNames = Object.keys(semanticModel.constants || {});
@@ -41,30 +38,29 @@ const extractDialogs = (semanticModel: SemanticModel, filePath: string): DialogM
   return dialogs;
 };
 
-const extractInstanceDeclarations = (parseResult: any): Array<{ name: string; parent: string }> => {
+/**
+ * `instance` and `prototype` declarations with their parents, in source order.
+ * Lines let the class hierarchy order redefinitions deterministically.
+ */
+const extractTypeDeclarations = (parseResult: any): Pick<ParsedFileMetadata, 'instances' | 'prototypes'> => {
   const declarations = typeof daedalusWrapper.extractDeclarations === 'function'
     ? daedalusWrapper.extractDeclarations(parseResult)
     : [];
 
-  return declarations
-    .filter((declaration: any) => declaration?.type === 'instance' && declaration.name && declaration.parent)
-    .map((declaration: any) => ({
-      name: declaration.name,
-      parent: declaration.parent
-    }));
-};
-
-const extractPrototypeDeclarations = (parseResult: any): Array<{ name: string; parent: string }> => {
-  const declarations = typeof daedalusWrapper.extractDeclarations === 'function'
-    ? daedalusWrapper.extractDeclarations(parseResult)
-    : [];
-
-  return declarations
-    .filter((declaration: any) => declaration?.type === 'prototype' && declaration.name && declaration.parent)
-    .map((declaration: any) => ({
+  const instances: TypeDeclaration[] = [];
+  const prototypes: TypeDeclaration[] = [];
+  declarations.forEach((declaration: any) => {
+    if (!declaration?.name || !declaration.parent) {
+      return;
+    }
+    const target = declaration.type === 'instance' ? instances : declaration.type === 'prototype' ? prototypes : null;
+    target?.push({
       name: declaration.name,
-      parent: declaration.parent
-    }));
+      parent: declaration.parent,
+      line: declaration.startPosition ? declaration.startPosition.row + 1 : undefined
+    });
+  });
+  return { instances, prototypes };
 };
 
 export function extractFileMetadataFromSource(sourceCode: string, filePath: string): ParsedFileMetadata {
@@ -86,8 +82,39 @@ export function extractFileMetadataFromSource(sourceCode: string, filePath: stri
 
   return {
     dialogs: extractDialogs(semanticModel, filePath),
-    instances: extractInstanceDeclarations(parseResult),
-    prototypes: extractPrototypeDeclarations(parseResult),
+    ...extractTypeDeclarations(parseResult),
     isQuestFile: hasQuestTopicConstants(semanticModel) || hasQuestStateVariables(semanticModel)
   };
 }
+
+/** Metadata as cached: content-addressed, so without the path of the file it came from */
+type CachedFileMetadata = Omit<ParsedFileMetadata, 'dialogs'> & {
+  dialogs: Array<Omit<DialogMetadata, 'filePath'>>;
+};
+
+/**
+ * Read a file and extract its metadata, reusing the shared parse cache when
+ * one is configured: a file whose text was seen before, in any project, is
+ * not parsed again.
+ */
+export async function extractFileMetadata(filePath: string): Promise<ParsedFileMetadata> {
+  const content = await fs.readFile(filePath, 'utf-8');
+  const cache = getParseCache();
+  if (!cache) {
+    return extractFileMetadataFromSource(content, filePath);
+  }
+
+  const hash = contentHash(content);
+  const cached = await cache.get<CachedFileMetadata>('metadata', hash);
+  if (cached) {
+    return { ...cached, dialogs: cached.dialogs.map((dialog) => ({ ...dialog, filePath })) };
+  }
+
+  const metadata = extractFileMetadataFromSource(content, filePath);
+  const entry: CachedFileMetadata = {
+    ...metadata,
+    dialogs: metadata.dialogs.map(({ filePath: _filePath, ...dialog }) => dialog)
+  };
+  await cache.set('metadata', hash, entry);
+  return metadata;
+}
@@ -0,0 +1,31 @@
+/**
+ * Where worker entry points live and when the pools run without them
+ *
+ * Under Jest the pools run their tasks inline against the TypeScript sources,
+ * so a stale dist worker build never decides a test. Tests of the worker
+ * protocol itself pass a worker path explicitly and may use the compiled
+ * entries, which resolveWorkerPath finds from both dist/main and src/main.
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+
+export function isLikelyTestRuntime(): boolean {
+  return process.env.NODE_ENV === 'test' || !!process.env.JEST_WORKER_ID;
+}
+
+/**
+ * Path of a compiled worker entry, e.g. `codegen.worker.js`. Falls back to
+ * dist/main/workers when running from the TypeScript sources; the result may
+ * still not exist if the main process was never built.
+ */
+export function resolveWorkerPath(fileName: string): string {
+  // Next to this file's directory in dist/main
+  const compiledPath = path.join(__dirname, '../workers', fileName);
+  if (fs.existsSync(compiledPath)) {
+    return compiledPath;
+  }
+  // From src/main/utils -> ../../../ -> root -> dist/main/workers
+  const distPath = path.join(__dirname, '../../../dist/main/workers', fileName);
+  return fs.existsSync(distPath) ? distPath : compiledPath;
+}
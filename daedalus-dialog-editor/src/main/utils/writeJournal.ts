@@ -0,0 +1,54 @@
+/**
+ * Write journal - files this process just wrote
+ *
+ * FileService records the size and modification time each saved file has
+ * afterwards; the project watcher skips change events whose file still has
+ * exactly that size and time, since the renderer already knows what it
+ * saved. A later external edit changes the time and is reported as usual.
+ */
+
+import * as path from 'path';
+
+interface JournalEntry {
+  size: number;
+  mtimeMs: number;
+  recordedAt: number;
+}
+
+/** How long a write is remembered; watcher batches arrive well within this */
+const JOURNAL_TTL_MS = 30_000;
+
+const recentWrites = new Map<string, JournalEntry>();
+
+function prune(now: number): void {
+  recentWrites.forEach((entry, filePath) => {
+    if (now - entry.recordedAt > JOURNAL_TTL_MS) {
+      recentWrites.delete(filePath);
+    }
+  });
+}
+
+/** Remember that `filePath` was just written and now has `stats` */
+export function recordOwnWrite(filePath: string, stats: { size: number; mtimeMs: number }): void {
+  const now = Date.now();
+  prune(now);
+  recentWrites.set(path.resolve(filePath), { size: stats.size, mtimeMs: stats.mtimeMs, recordedAt: now });
+}
+
+/** Whether `filePath` is still exactly as this process last wrote it */
+export function isOwnWrite(filePath: string, stats: { size: number; mtimeMs: number }): boolean {
+  const entry = recentWrites.get(path.resolve(filePath));
+  if (!entry) {
+    return false;
+  }
+  if (Date.now() - entry.recordedAt > JOURNAL_TTL_MS) {
+    recentWrites.delete(path.resolve(filePath));
+    return false;
+  }
+  return entry.size === stats.size && entry.mtimeMs === stats.mtimeMs;
+}
+
+/** Forget every recorded write (tests) */
+export function clearWriteJournal(): void {
+  recentWrites.clear();
+}
@@ -0,0 +1,101 @@
+import { parentPort, workerData, threadId } from 'worker_threads';
+import { CodegenDocumentMissingError, CodegenTaskRunner, type CodegenRequest } from '../utils/codegenTasks';
+import { beginSpan, drainTraceEvents, enableTracing, isTracingEnabled } from 'daedalus-parser/tracing';
+
+// Slot the main thread writes a request's seq into to stop that request
+const cancelFlag: Int32Array | undefined = workerData?.cancelFlag;
+// Streamed batches of the current request the main thread has handed on
+const consumedChunks: Int32Array | undefined = workerData?.consumedChunks;
+const maxUnconsumedChunks: number = workerData?.maxUnconsumedChunks ?? Infinity;
+
+if (workerData?.trace) {
+  enableTracing({ tid: threadId, threadName: `codegen worker ${threadId}` });
+}
+
+// Streamed output is posted in batches of roughly this many characters
+const CHUNK_BATCH_SIZE = 64 * 1024;
+
+// Upper bound on one wait for the consumer; cancellation also wakes the wait
+const CONSUMER_WAIT_MS = 1000;
+
+const runner = new CodegenTaskRunner();
+
+class CodegenAbort extends Error {}
+
+/**
+ * Block until the consumer has taken enough batches that `posted` is within
+ * the pool's limit, checking for cancellation after every wake-up
+ */
+function waitForConsumer(posted: number, checkpoint: () => void) {
+  if (!consumedChunks) {
+    return;
+  }
+  for (;;) {
+    const consumed = Atomics.load(consumedChunks, 0);
+    if (posted - consumed < maxUnconsumedChunks) {
+      return;
+    }
+    Atomics.wait(consumedChunks, 0, consumed, CONSUMER_WAIT_MS);
+    checkpoint();
+  }
+}
+
+/** Spans recorded for this reply ride along with it */
+function withTraceEvents<T extends object>(payload: T): T {
+  return isTracingEnabled() ? { ...payload, traceEvents: drainTraceEvents() } : payload;
+}
+
+if (parentPort) {
+  parentPort.on('message', async (message: { id: string; seq: number; request: CodegenRequest }) => {
+    const { id, seq, request } = message;
+    const endSpan = beginSpan(`codegen.${request.type}`);
+    const checkpoint = () => {
+      if (cancelFlag !== undefined && Atomics.load(cancelFlag, 0) === seq) {
+        throw new CodegenAbort('Code generation cancelled');
+      }
+    };
+
+    try {
+      checkpoint();
+      if (request.type === 'generateChunks') {
+        let batch = '';
+        let posted = 0;
+        const postBatch = () => {
+          waitForConsumer(posted, checkpoint);
+          parentPort!.postMessage({ id, chunk: batch });
+          posted++;
+          batch = '';
+        };
+        for (const chunk of runner.chunks(request, checkpoint)) {
+          batch += chunk;
+          if (batch.length >= CHUNK_BATCH_SIZE) {
+            postBatch();
+          }
+        }
+        if (batch) {
+          postBatch();
+        }
+        endSpan();
+        parentPort!.postMessage(withTraceEvents({ id, done: true }));
+        return;
+      }
+
+      const result = await runner.run(request, checkpoint);
+      endSpan();
+      parentPort!.postMessage(withTraceEvents({ id, result }));
+    } catch (error) {
+      const cancelled = error instanceof CodegenAbort;
+      const documentMissing = error instanceof CodegenDocumentMissingError;
+      if (!cancelled && !documentMissing) {
+        console.error('[Worker] Error during code generation:', error);
+      }
+      endSpan({ error: true });
+      parentPort!.postMessage(withTraceEvents({
+        id,
+        error: error instanceof Error ? error.message : 'Unknown worker error',
+        cancelled,
+        documentMissing
+      }));
+    }
+  });
+}
@@ -1,27 +1,41 @@
-import { parentPort } from 'worker_threads';
-import { promises as fs } from 'fs';
-import { extractFileMetadataFromSource } from '../utils/semanticMetadataUtils';
+import { parentPort, workerData, threadId } from 'worker_threads';
+import { extractFileMetadata } from '../utils/semanticMetadataUtils';
+import { configureParseCache } from '../utils/parseCache';
+import { drainTraceEvents, enableTracing, isTracingEnabled, traceAsync } from 'daedalus-parser/tracing';
+
+if (workerData?.trace) {
+  enableTracing({ tid: threadId, threadName: `metadata worker ${threadId}` });
+}
+configureParseCache(workerData?.parseCache);
+
+/** Spans recorded for this reply ride along with it */
+function withTraceEvents<T extends object>(payload: T): T {
+  return isTracingEnabled() ? { ...payload, traceEvents: drainTraceEvents() } : payload;
+}
 
 if (parentPort) {
   parentPort.on('message', async (message: { id: string; filePath: string }) => {
     const { id, filePath } = message;
 
     try {
-      const content = await fs.readFile(filePath, 'utf-8');
-      const { dialogs, instances, prototypes, isQuestFile } = extractFileMetadataFromSource(content, filePath);
+      const { dialogs, instances, prototypes, isQuestFile } = await traceAsync(
+        'metadata.processFile',
+        () => extractFileMetadata(filePath),
+        { filePath }
+      );
 
-      parentPort!.postMessage({
+      parentPort!.postMessage(withTraceEvents({
         id,
         dialogs,
         instances,
         prototypes,
         isQuestFile
-      });
+      }));
     } catch (error) {
-      parentPort!.postMessage({
+      parentPort!.postMessage(withTraceEvents({
         id,
         error: error instanceof Error ? error.message : String(error)
-      });
+      }));
     }
   });
 }
@@ -1,5 +1,19 @@
-import { parentPort } from 'worker_threads';
+import { parentPort, workerData, threadId } from 'worker_threads';
 import { SemanticModelBuilderVisitor } from 'daedalus-parser/semantic-visitor';
+import {
+  decodeSemanticModel,
+  encodeSemanticModel,
+  type SemanticModel,
+  type SemanticModelWire
+} from 'daedalus-parser/semantic-model';
+import {
+  PARSE_CANCELLED,
+  PARSE_TIMEOUT,
+  formatParseAbortMessage,
+  type ParseAbortCode
+} from '../../shared/parseJobs';
+import { beginSpan, drainTraceEvents, enableTracing, isTracingEnabled, traceSpan } from 'daedalus-parser/tracing';
+import { contentHash, useParseCache, type ParseCacheOptions } from '../utils/parseCache';
 
 // @ts-ignore - CommonJS module
 const DaedalusParser = require('daedalus-parser');
@@ -9,39 +23,136 @@ const DaedalusParser = require('daedalus-parser');
 // This avoids "Invalid argument" errors caused by mismatched tree-sitter versions.
 const daedalusWrapper = new DaedalusParser();
 
+// Slot the main thread writes a job's seq into to stop that job
+const cancelFlag: Int32Array | undefined = workerData?.cancelFlag;
+
+if (workerData?.trace) {
+  enableTracing({ tid: threadId, threadName: `parser worker ${threadId}` });
+}
+
+/**
+ * Post a reply along with the spans recorded for it. The postMessage span
+ * (structured clone of the model) can only end after the message is sent,
+ * so it stays buffered and rides along with the next reply.
+ */
+function reply(payload: { id: string; result?: unknown; error?: string }) {
+  if (!isTracingEnabled()) {
+    parentPort!.postMessage(payload);
+    return;
+  }
+  const traceEvents = drainTraceEvents();
+  traceSpan('worker.postMessage', () => parentPort!.postMessage({ ...payload, traceEvents }));
+}
+
+/**
+ * Model of a cache entry, stored in the compact wire format. An entry the
+ * decoder rejects (other wire version, unknown action type) counts as a miss
+ * and is overwritten after parsing.
+ */
+function readCachedModel(entry: SemanticModelWire | undefined) {
+  if (!entry) {
+    return undefined;
+  }
+  try {
+    return decodeSemanticModel(entry);
+  } catch {
+    return undefined;
+  }
+}
+
+class ParseAbort extends Error {
+  constructor(readonly code: ParseAbortCode, reason: string) {
+    super(formatParseAbortMessage(code, reason));
+  }
+}
+
 if (parentPort) {
-  parentPort.on('message', (message: { id: string; sourceCode: string }) => {
+  parentPort.on('message', async (message: {
+    id: string;
+    seq?: number;
+    sourceCode: string;
+    timeoutMs?: number;
+    parseCache?: ParseCacheOptions;
+  }) => {
+    const endSpan = beginSpan('worker.parseSource', { bytes: message.sourceCode?.length });
     try {
-      const { id, sourceCode } = message;
+      const { id, seq, sourceCode, timeoutMs } = message;
 
       if (typeof sourceCode !== 'string') {
         throw new Error(`Invalid sourceCode type: ${typeof sourceCode}`);
       }
 
+      // Hashing, reading and serializing cache entries stays off the main thread
+      const cache = useParseCache(message.parseCache);
+      const hash = cache ? contentHash(sourceCode) : '';
+      const cached = cache ? readCachedModel(await cache.get<SemanticModelWire>('model', hash)) : undefined;
+      if (cached) {
+        endSpan({ cached: true });
+        reply({ id, result: cached });
+        return;
+      }
+      // Stored after replying; entries are shared by every path with this text, so no paths are attached here
+      const store = async (model: SemanticModel) => {
+        await cache?.set('model', hash, encodeSemanticModel(model)).catch(() => undefined);
+      };
+
+      const deadline = timeoutMs && timeoutMs > 0 ? Date.now() + timeoutMs : Infinity;
+      const isCancelled = () => cancelFlag !== undefined && seq !== undefined && Atomics.load(cancelFlag, 0) === seq;
+      // Between stages: the C parse checks on its own, the JS passes only here
+      const checkpoint = () => {
+        if (isCancelled()) {
+          throw new ParseAbort(PARSE_CANCELLED, 'Parse cancelled');
+        }
+        if (Date.now() > deadline) {
+          throw new ParseAbort(PARSE_TIMEOUT, `Parse exceeded ${timeoutMs}ms`);
+        }
+      };
+
       // Perform parsing using the wrapper's high-level parse method
       // This ensures that options like bufferSize are correctly applied for large files
-      const parseResult = daedalusWrapper.parse(sourceCode);
+      let parseResult;
+      try {
+        parseResult = daedalusWrapper.parse(sourceCode, {
+          timeoutMicros: Number.isFinite(deadline) ? timeoutMs! * 1000 : 0,
+          shouldCancel: cancelFlag ? isCancelled : undefined
+        });
+      } catch (error: any) {
+        if (error?.code === PARSE_CANCELLED || error?.code === PARSE_TIMEOUT) {
+          throw new ParseAbort(error.code, error.message);
+        }
+        throw error;
+      }
       const tree = parseResult.tree;
       const visitor = new SemanticModelBuilderVisitor();
 
       // Check for syntax errors first
+      checkpoint();
       visitor.checkForSyntaxErrors(tree.rootNode as any, sourceCode);
 
       // If there are syntax errors, return the model with errors immediately
       if (visitor.semanticModel.hasErrors) {
-        parentPort!.postMessage({ id, result: visitor.semanticModel });
+        endSpan({ hasErrors: true });
+        reply({ id, result: visitor.semanticModel });
+        await store(visitor.semanticModel);
         return;
       }
 
       // Otherwise, proceed with semantic analysis
+      checkpoint();
       visitor.pass1_createObjects(tree.rootNode as any);
+      checkpoint();
       visitor.pass2_analyzeAndLink(tree.rootNode as any);
 
       // Return the semantic model
-      parentPort!.postMessage({ id, result: visitor.semanticModel });
+      endSpan();
+      reply({ id, result: visitor.semanticModel });
+      await store(visitor.semanticModel);
     } catch (error) {
-      console.error('[Worker] Error during parsing:', error);
-      parentPort!.postMessage({
+      if (!(error instanceof ParseAbort)) {
+        console.error('[Worker] Error during parsing:', error);
+      }
+      endSpan({ error: true });
+      reply({
         id: message.id,
         error: error instanceof Error ? error.message : 'Unknown worker error'
       });
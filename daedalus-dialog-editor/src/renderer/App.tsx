@@ -36,7 +36,7 @@ const themeOptions: Array<{ value: ThemeMode; label: string; icon: JSX.Element }
 
 const App: React.FC = () => {
   const { openFile, activeFile, openFiles, resetEditorSession } = useEditorStore();
-  const { openProject, projectPath, projectName, isIngesting, allDialogFiles, parsedFiles, isIngestedFilesOpen, setIngestedFilesOpen } = useProjectStore();
+  const { openProject, projectPath, projectName, isIngesting, allDialogFiles, parsedFiles, indexProgress, isIngestedFilesOpen, setIngestedFilesOpen } = useProjectStore();
   const { isAutoSaving, lastAutoSaveTime } = useAutoSave();
 
   const activeFileState = activeFile ? openFiles.get(activeFile) : null;
@@ -53,8 +53,8 @@ const App: React.FC = () => {
     return (parsedFiles.size / total) * 100;
   }, [allDialogFiles.length, parsedFiles.size]);
 
-  const overlayTotalFiles = isIngesting ? allDialogFiles.length : 0;
-  const overlayParsedFiles = isIngesting ? parsedFiles.size : 0;
+  const overlayTotalFiles = isIngesting ? allDialogFiles.length : (indexProgress?.discoveredFiles ?? 0);
+  const overlayParsedFiles = isIngesting ? parsedFiles.size : (indexProgress?.processedFiles ?? 0);
   const showProjectOpeningOverlay = isProjectOpening || (!!projectPath && isIngesting);
 
   const hasUnsavedChanges = useMemo(
@@ -177,6 +177,7 @@ const DialogDetailsEditor: React.FC<DialogDetailsEditorProps> = ({
           onClose={() => uiState.setSourceViewOpen(false)}
           dialogName={dialogName}
           semanticModel={semanticModel}
+          filePath={fileState ? filePath : null}
         />
       )}
 
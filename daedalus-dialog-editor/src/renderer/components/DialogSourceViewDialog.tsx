@@ -15,19 +15,23 @@ import { Close as CloseIcon, ContentCopy as CopyIcon, OpenInNew as OpenInNewIcon
 import Editor from '@monaco-editor/react';
 import { useEditorStore } from '../store/editorStore';
 import { SemanticModel } from '../types/global';
+import { generateDialogCode } from '../utils/modelSync';
 
 interface DialogSourceViewDialogProps {
   open: boolean;
   onClose: () => void;
   dialogName: string;
   semanticModel: SemanticModel;
+  /** The open file the model belongs to; lets the preview reuse the worker's copy */
+  filePath?: string | null;
 }
 
 const DialogSourceViewDialog: React.FC<DialogSourceViewDialogProps> = ({
   open,
   onClose,
   dialogName,
-  semanticModel
+  semanticModel,
+  filePath
 }) => {
   const [code, setCode] = useState<string>('');
   const [isLoading, setIsLoading] = useState(false);
@@ -36,7 +40,10 @@ const DialogSourceViewDialog: React.FC<DialogSourceViewDialogProps> = ({
   useEffect(() => {
     if (open && dialogName && semanticModel) {
       setIsLoading(true);
-      window.editorAPI.generateDialogCode(semanticModel, dialogName, codeSettings)
+      const generated = filePath
+        ? generateDialogCode(filePath, semanticModel, dialogName, codeSettings)
+        : window.editorAPI.generateDialogCode(semanticModel, dialogName, codeSettings);
+      generated
         .then((generatedCode) => {
           setCode(generatedCode);
         })
@@ -49,7 +56,7 @@ const DialogSourceViewDialog: React.FC<DialogSourceViewDialogProps> = ({
           setIsLoading(false);
         });
     }
-  }, [open, dialogName, semanticModel, codeSettings]);
+  }, [open, dialogName, semanticModel, filePath, codeSettings]);
 
   const handleCopy = () => {
     navigator.clipboard.writeText(code);
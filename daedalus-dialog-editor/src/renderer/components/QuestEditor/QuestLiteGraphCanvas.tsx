@@ -1,8 +1,9 @@
 import React, { useEffect, useMemo, useRef, useState } from 'react';
 import { Box, Button, Paper, Stack, TextField, Typography } from '@mui/material';
-import { LGraph, LGraphCanvas, LGraphNode } from 'litegraph.js';
+import { LGraph, LGraphCanvas, LGraphNode, LiteGraph } from 'litegraph.js';
 import type { QuestGraphConditionType, QuestGraphEdge, QuestGraphNode } from '../../types/questGraph';
 import { validateConditionExpressionSyntax } from './commands/conditionExpressionCodec';
+import { QuadTree, type Bounds } from './spatialIndex';
 
 interface QuestLiteGraphCanvasProps {
   nodes: QuestGraphNode[];
@@ -76,6 +77,10 @@ const CONDITION_PANEL_PREVIEW_MAX_LENGTH = 34;
 const CONDITION_PANEL_MIN_WIDTH = 250;
 const CONDITION_PANEL_MIN_HEIGHT = 118;
 const DIALOG_INLINE_PANEL_HEIGHT = 86;
+// Below this zoom the inline condition panels are unreadable and skipped
+const PREVIEW_MIN_SCALE = 0.6;
+// Below this zoom nodes draw as flat glyphs and links as batched straight lines
+const LOD_GLYPH_SCALE = 0.35;
 const drawRoundedRect = (
   ctx: CanvasRenderingContext2D,
   x: number,
@@ -105,11 +110,15 @@ const attachConditionPreviewRenderer = (
 ): void => {
   const runtimeNodeAny = runtimeNode as any;
   const previousOnDrawForeground = runtimeNodeAny.onDrawForeground;
-  runtimeNodeAny.onDrawForeground = function onDrawForeground(ctx: CanvasRenderingContext2D) {
+  runtimeNodeAny.onDrawForeground = function onDrawForeground(
+    ctx: CanvasRenderingContext2D,
+    graphCanvas?: ExtendedLGraphCanvas
+  ) {
     if (typeof previousOnDrawForeground === 'function') {
-      previousOnDrawForeground.call(this, ctx);
+      previousOnDrawForeground.call(this, ctx, graphCanvas);
     }
     if (!ctx || runtimeNodeAny.flags?.collapsed) return;
+    if ((graphCanvas?.ds?.scale ?? 1) < PREVIEW_MIN_SCALE) return;
 
     const panelX = 10;
     const panelY = Math.max(36, Math.floor(options?.panelY ?? 52));
@@ -141,6 +150,139 @@ const attachConditionPreviewRenderer = (
   };
 };
 
+interface CulledEdge {
+  x1: number;
+  y1: number;
+  x2: number;
+  y2: number;
+}
+
+interface ViewportCulling {
+  /** Mark the spatial index stale (graph rebuilt or nodes moved). */
+  invalidate: () => void;
+}
+
+/**
+ * Replace LiteGraph's linear visibility scan with quadtree queries over node
+ * and link bounds, and switch to flat glyphs and batched straight links when
+ * zoomed far out. Selected and dragged nodes are always drawn.
+ */
+const installViewportCulling = (graphCanvas: ExtendedLGraphCanvas, graph: LGraph): ViewportCulling => {
+  const canvasAny = graphCanvas as any;
+  const graphAny = graph as any;
+  let nodeIndex: QuadTree<LGraphNode> | null = null;
+  let edgeIndex: QuadTree<CulledEdge> | null = null;
+  let drawOrder = new Map<LGraphNode, number>();
+  let dirty = true;
+  const scratchBounds = new Float32Array(4);
+
+  const rebuild = () => {
+    const runtimeNodes: LGraphNode[] = graphAny._nodes || [];
+    drawOrder = new Map(runtimeNodes.map((node, index) => [node, index]));
+    nodeIndex = QuadTree.fromItems(runtimeNodes, (node) => node.getBounding(scratchBounds) as Bounds);
+
+    const culledEdges: CulledEdge[] = [];
+    Object.values(graphAny.links || {}).forEach((link: any) => {
+      if (!link) return;
+      const origin = graph.getNodeById(link.origin_id) as any;
+      const target = graph.getNodeById(link.target_id) as any;
+      if (!origin || !target) return;
+      const start = origin.getConnectionPos(false, link.origin_slot);
+      const end = target.getConnectionPos(true, link.target_slot);
+      culledEdges.push({ x1: start[0], y1: start[1], x2: end[0], y2: end[1] });
+    });
+    edgeIndex = QuadTree.fromItems(culledEdges, (edge) => [
+      Math.min(edge.x1, edge.x2),
+      Math.min(edge.y1, edge.y2),
+      Math.abs(edge.x2 - edge.x1),
+      Math.abs(edge.y2 - edge.y1)
+    ]);
+    dirty = false;
+  };
+
+  const ensureIndex = () => {
+    // While a node is dragged its bounds change every frame
+    if (dirty || !nodeIndex || canvasAny.node_dragged) {
+      rebuild();
+    }
+  };
+
+  const originalComputeVisibleNodes = canvasAny.computeVisibleNodes;
+  canvasAny.computeVisibleNodes = function computeVisibleNodes(nodes?: LGraphNode[], out?: LGraphNode[]) {
+    if (nodes || !this.visible_area) {
+      return originalComputeVisibleNodes.call(this, nodes, out);
+    }
+
+    ensureIndex();
+    const visible: LGraphNode[] = out || [];
+    visible.length = 0;
+    nodeIndex!.query(this.visible_area, visible);
+
+    const included = new Set(visible);
+    const pinned: LGraphNode[] = [...Object.values(this.selected_nodes || {}) as LGraphNode[]];
+    if (this.node_dragged) pinned.push(this.node_dragged);
+    pinned.forEach((node) => {
+      if (!included.has(node) && drawOrder.has(node)) {
+        included.add(node);
+        visible.push(node);
+      }
+    });
+
+    // Keep LiteGraph's z-order (graph insertion order)
+    visible.sort((left, right) => (drawOrder.get(left) ?? 0) - (drawOrder.get(right) ?? 0));
+    return visible;
+  };
+
+  const originalDrawConnections = canvasAny.drawConnections;
+  canvasAny.drawConnections = function drawConnections(ctx: CanvasRenderingContext2D) {
+    const scale = this.ds?.scale ?? 1;
+    if (scale >= LOD_GLYPH_SCALE || !this.visible_area) {
+      return originalDrawConnections.call(this, ctx);
+    }
+
+    ensureIndex();
+    const visibleEdges = edgeIndex!.query(this.visible_area);
+    if (visibleEdges.length === 0) return;
+
+    ctx.save();
+    ctx.strokeStyle = 'rgba(170, 170, 170, 0.55)';
+    ctx.lineWidth = 1 / scale;
+    ctx.beginPath();
+    visibleEdges.forEach((edge) => {
+      ctx.moveTo(edge.x1, edge.y1);
+      ctx.lineTo(edge.x2, edge.y2);
+    });
+    ctx.stroke();
+    ctx.restore();
+  };
+
+  const originalDrawNode = canvasAny.drawNode;
+  canvasAny.drawNode = function drawNode(node: LGraphNode, ctx: CanvasRenderingContext2D) {
+    const scale = this.ds?.scale ?? 1;
+    if (scale >= LOD_GLYPH_SCALE) {
+      return originalDrawNode.call(this, node, ctx);
+    }
+
+    const nodeAny = node as any;
+    const titleHeight = LiteGraph.NODE_TITLE_HEIGHT;
+    const width = nodeAny.size?.[0] ?? 220;
+    const height = (nodeAny.size?.[1] ?? 90) + titleHeight;
+    ctx.fillStyle = nodeAny.color || '#2d4f7c';
+    ctx.fillRect(0, -titleHeight, width, height);
+    if (this.selected_nodes?.[nodeAny.id]) {
+      ctx.strokeStyle = '#ffffff';
+      ctx.lineWidth = 2 / scale;
+      ctx.strokeRect(0, -titleHeight, width, height);
+    }
+  };
+
+  return {
+    invalidate: () => {
+      dirty = true;
+    }
+  };
+};
+
 const isJsdomEnvironment = (): boolean => (
   typeof navigator !== 'undefined' && /jsdom/i.test(navigator.userAgent || '')
 );
@@ -160,6 +302,7 @@ const QuestLiteGraphCanvas: React.FC<QuestLiteGraphCanvasProps> = ({
   const canvasRef = useRef<HTMLCanvasElement | null>(null);
   const graphRef = useRef<LGraph | null>(null);
   const graphCanvasRef = useRef<ExtendedLGraphCanvas | null>(null);
+  const cullingRef = useRef<ViewportCulling | null>(null);
   const nodeMapRef = useRef<Map<string, QuestGraphNode>>(new Map());
   const questIdToRuntimeNodeRef = useRef<Map<string, LGraphNode>>(new Map());
   const edgeMapRef = useRef<Map<string, QuestGraphEdge>>(new Map());
@@ -170,6 +313,9 @@ const QuestLiteGraphCanvas: React.FC<QuestLiteGraphCanvasProps> = ({
   const [expressionEditorError, setExpressionEditorError] = useState<string | null>(null);
 
   useEffect(() => {
+    // Overlays are only rendered as DOM in jsdom; the real canvas draws them itself,
+    // so avoid re-rendering the component four times a second there
+    if (!isJsdomEnvironment()) return;
     const handle = window.setInterval(() => {
       setOverlayTick((value) => value + 1);
     }, 250);
@@ -238,7 +384,10 @@ const QuestLiteGraphCanvas: React.FC<QuestLiteGraphCanvasProps> = ({
       return false;
     };
 
+    const culling = installViewportCulling(graphCanvas, graph);
+
     graphCanvas.onNodeMoved = (selectedNode: LGraphNode) => {
+      culling.invalidate();
       if (!Array.isArray(selectedNode.pos)) return;
       const questNode = nodeMapRef.current.get(String(selectedNode.id));
       if (!questNode) return;
@@ -250,6 +399,7 @@ const QuestLiteGraphCanvas: React.FC<QuestLiteGraphCanvasProps> = ({
 
     graphRef.current = graph;
     graphCanvasRef.current = graphCanvas;
+    cullingRef.current = culling;
 
     const resizeCanvasToContainer = () => {
       const container = containerRef.current;
@@ -282,6 +432,7 @@ const QuestLiteGraphCanvas: React.FC<QuestLiteGraphCanvasProps> = ({
       graphCanvas.clear();
       graphRef.current = null;
       graphCanvasRef.current = null;
+      cullingRef.current = null;
     };
   }, [onEdgeClick, onNodeClick, onNodeDoubleClick, onNodeMove, onPaneClick]);
 
@@ -460,6 +611,7 @@ const QuestLiteGraphCanvas: React.FC<QuestLiteGraphCanvasProps> = ({
       edgeMapRef.current.set(edge.id, edge);
     });
 
+    cullingRef.current?.invalidate();
     graph.start();
     graphCanvasRef.current?.draw(true, true);
   }, [nodes, edges]);
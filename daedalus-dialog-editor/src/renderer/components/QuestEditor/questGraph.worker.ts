@@ -0,0 +1,64 @@
+/**
+ * Quest graph worker - builds and lays out quest graphs off the renderer thread.
+ *
+ * Patches are applied as soon as they arrive; builds are deferred by a task so
+ * that a burst of requests only builds the most recent one. When a build needs
+ * a full layout, its nodes are posted first so the canvas need not wait for it.
+ */
+
+import type { QuestGraphWorkerRequest, QuestGraphWorkerResponse } from '../../types/questGraph';
+import { QuestGraphService } from './questGraphService';
+
+// The renderer tsconfig only ships DOM typings, so describe the worker scope locally
+const workerScope = self as unknown as {
+  postMessage: (message: QuestGraphWorkerResponse) => void;
+  onmessage: ((event: MessageEvent<QuestGraphWorkerRequest>) => void) | null;
+};
+
+const service = new QuestGraphService();
+let latestRequest: QuestGraphWorkerRequest | null = null;
+let buildScheduled = false;
+
+const post = (response: QuestGraphWorkerResponse) => {
+  workerScope.postMessage(response);
+};
+
+const runLatestBuild = () => {
+  buildScheduled = false;
+  const request = latestRequest;
+  latestRequest = null;
+  if (!request) return;
+
+  try {
+    post({
+      type: 'result',
+      requestId: request.requestId,
+      graph: service.build(request.questName, request.options, request.overviewQuests, (graph) => {
+        post({ type: 'partial', requestId: request.requestId, graph });
+      })
+    });
+  } catch (error) {
+    post({
+      type: 'error',
+      requestId: request.requestId,
+      message: error instanceof Error ? error.message : String(error)
+    });
+  }
+};
+
+workerScope.onmessage = (event) => {
+  const request = event.data;
+  if (request.type !== 'build') return;
+
+  service.applyPatch(request.patch);
+
+  if (latestRequest) {
+    post({ type: 'superseded', requestId: latestRequest.requestId });
+  }
+  latestRequest = request;
+
+  if (!buildScheduled) {
+    buildScheduled = true;
+    setTimeout(runLatestBuild, 0);
+  }
+};
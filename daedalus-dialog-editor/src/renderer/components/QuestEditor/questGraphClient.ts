@@ -0,0 +1,135 @@
+/**
+ * Quest graph client - sends model patches to the quest graph worker and
+ * resolves with the built graph. Falls back to building on the renderer
+ * thread when workers are unavailable (tests, restricted environments).
+ */
+
+import QuestGraphWorker from './questGraph.worker?worker';
+import type { SemanticModel } from '../../types/global';
+import type {
+  QuestGraphBuildOptions,
+  QuestGraphData,
+  QuestGraphWorkerRequest,
+  QuestGraphWorkerResponse
+} from '../../types/questGraph';
+import { QuestGraphService, diffQuestGraphModel, type QuestGraphBuilder, type QuestOverviewBuilder } from './questGraphService';
+
+export interface QuestGraphClientOptions {
+  /** Builders used for the in-thread fallback (default to the questGraphUtils builders) */
+  buildGraph?: QuestGraphBuilder;
+  buildOverview?: QuestOverviewBuilder;
+  /** Set to false to always build on the calling thread */
+  useWorker?: boolean;
+}
+
+interface PendingBuild {
+  resolve: (graph: QuestGraphData | null) => void;
+  reject: (error: Error) => void;
+  onPartial?: (graph: QuestGraphData) => void;
+}
+
+const createWorker = (): Worker | null => {
+  if (typeof Worker === 'undefined') {
+    return null;
+  }
+  try {
+    return new QuestGraphWorker();
+  } catch (error) {
+    console.warn('[QuestGraph] Falling back to in-thread graph building:', error);
+    return null;
+  }
+};
+
+export class QuestGraphClient {
+  private worker: Worker | null = null;
+  private workerFailed = false;
+  private fallbackService: QuestGraphService | null = null;
+  private lastModel: SemanticModel | null = null;
+  private nextRequestId = 0;
+  private readonly pending = new Map<number, PendingBuild>();
+
+  constructor(private readonly options: QuestGraphClientOptions = {}) {
+    this.workerFailed = options.useWorker === false;
+  }
+
+  /**
+   * Build the graph for `questName` (or the overview of `overviewQuests`).
+   * Resolves with `null` when a newer build request superseded this one
+   * before it ran. When a full layout has to run, `onPartial` first receives
+   * the graph with provisional positions.
+   */
+  build(
+    semanticModel: SemanticModel,
+    questName: string | null,
+    options?: QuestGraphBuildOptions,
+    overviewQuests?: string[],
+    onPartial?: (graph: QuestGraphData) => void
+  ): Promise<QuestGraphData | null> {
+    const patch = diffQuestGraphModel(this.lastModel, semanticModel);
+    this.lastModel = semanticModel;
+
+    const worker = this.getWorker();
+    if (!worker) {
+      if (!this.fallbackService) {
+        this.fallbackService = new QuestGraphService(this.options.buildGraph, this.options.buildOverview);
+      }
+      this.fallbackService.applyPatch(patch);
+      return Promise.resolve(this.fallbackService.build(questName, options, overviewQuests, onPartial));
+    }
+
+    const requestId = ++this.nextRequestId;
+    return new Promise((resolve, reject) => {
+      this.pending.set(requestId, { resolve, reject, onPartial });
+      const request: QuestGraphWorkerRequest = { type: 'build', requestId, patch, questName, options, overviewQuests };
+      worker.postMessage(request);
+    });
+  }
+
+  dispose(): void {
+    this.worker?.terminate();
+    this.worker = null;
+    // The next build has to resend the full model to a fresh worker
+    this.lastModel = null;
+    this.pending.forEach(({ resolve }) => resolve(null));
+    this.pending.clear();
+  }
+
+  private getWorker(): Worker | null {
+    if (this.worker || this.workerFailed) {
+      return this.worker;
+    }
+
+    const worker = createWorker();
+    if (!worker) {
+      this.workerFailed = true;
+      return null;
+    }
+
+    worker.onmessage = (event: MessageEvent<QuestGraphWorkerResponse>) => {
+      const response = event.data;
+      const pending = this.pending.get(response.requestId);
+      if (!pending) return;
+      if (response.type === 'partial') {
+        pending.onPartial?.(response.graph);
+        return;
+      }
+      this.pending.delete(response.requestId);
+
+      if (response.type === 'result') {
+        pending.resolve(response.graph);
+      } else if (response.type === 'superseded') {
+        pending.resolve(null);
+      } else {
+        pending.reject(new Error(response.message));
+      }
+    };
+    worker.onerror = (event) => {
+      console.error('[QuestGraph] Worker error:', event.message);
+      this.pending.forEach(({ reject }) => reject(new Error(event.message || 'Quest graph worker failed')));
+      this.pending.clear();
+    };
+
+    this.worker = worker;
+    return worker;
+  }
+}
@@ -0,0 +1,26 @@
+/**
+ * Quest graph markers - presentation added to built quest graphs on the
+ * renderer side, so the graph builder (which runs in a worker) stays free of
+ * reactflow.
+ */
+
+import { MarkerType } from 'reactflow';
+import type { QuestGraphEdge } from '../../types/questGraph';
+
+const ARROW_MARKER = { type: MarkerType.ArrowClosed };
+
+/** Built graphs are cached and shared, so each edge list is marked once */
+const markedEdges = new WeakMap<QuestGraphEdge[], QuestGraphEdge[]>();
+
+/**
+ * Return `edges` with a closed arrow head on every edge. The input is left
+ * untouched.
+ */
+export const withArrowMarkers = (edges: QuestGraphEdge[]): QuestGraphEdge[] => {
+  let marked = markedEdges.get(edges);
+  if (!marked) {
+    marked = edges.map((edge) => ({ ...edge, markerEnd: ARROW_MARKER }));
+    markedEdges.set(edges, marked);
+  }
+  return marked;
+};
@@ -0,0 +1,300 @@
+/**
+ * Quest graph service
+ *
+ * Keeps a patched copy of the quest-relevant model slice (dialogs, functions,
+ * variables) and caches built graphs per quest. A patch drops only the graphs
+ * of quests its functions and dialogs touch. Runs inside the quest graph
+ * worker, and on the renderer thread when workers are unavailable.
+ */
+
+import type { SemanticModel } from '../../types/global';
+import type {
+  QuestGraphBuildOptions,
+  QuestGraphData,
+  QuestGraphModelPatch
+} from '../../types/questGraph';
+import {
+  buildQuestGraph,
+  buildQuestOverviewGraph,
+  getDialogContextForFunction,
+  getFunctionQuestFacts,
+  type FunctionQuestFacts
+} from './questGraphUtils';
+
+const MAX_CACHED_GRAPHS = 32;
+
+const createEmptyModel = (): SemanticModel => ({
+  dialogs: {},
+  functions: {},
+  variables: {},
+  hasErrors: false,
+  errors: []
+});
+
+const applyRecordPatch = <T>(
+  current: Record<string, T>,
+  changed: Record<string, T> | undefined,
+  removed: string[] | undefined
+): Record<string, T> => {
+  if (!changed && !removed?.length) {
+    return current;
+  }
+  // Unchanged entries keep their identity so per-function caches stay warm
+  const next = { ...current, ...changed };
+  removed?.forEach((name) => { delete next[name]; });
+  return next;
+};
+
+/**
+ * Compute the patch that turns `previous` into `next`. Entries are compared
+ * by reference, which matches how the editor stores produce new models.
+ */
+export const diffQuestGraphModel = (
+  previous: SemanticModel | null,
+  next: SemanticModel
+): QuestGraphModelPatch => {
+  if (!previous) {
+    return {
+      reset: true,
+      dialogs: next.dialogs || {},
+      functions: next.functions || {},
+      variables: next.variables || {}
+    };
+  }
+
+  const patch: QuestGraphModelPatch = { reset: false };
+
+  const diffRecord = <T>(prev: Record<string, T> = {}, curr: Record<string, T> = {}) => {
+    if (prev === curr) return null;
+    const changed: Record<string, T> = {};
+    const removed: string[] = [];
+    let hasChanges = false;
+    for (const [name, value] of Object.entries(curr)) {
+      if (prev[name] !== value) {
+        changed[name] = value;
+        hasChanges = true;
+      }
+    }
+    for (const name of Object.keys(prev)) {
+      if (!(name in curr)) {
+        removed.push(name);
+        hasChanges = true;
+      }
+    }
+    return hasChanges ? { changed, removed } : null;
+  };
+
+  const dialogDiff = diffRecord(previous.dialogs, next.dialogs);
+  if (dialogDiff) {
+    patch.dialogs = dialogDiff.changed;
+    patch.removedDialogs = dialogDiff.removed;
+  }
+
+  const functionDiff = diffRecord(previous.functions, next.functions);
+  if (functionDiff) {
+    patch.functions = functionDiff.changed;
+    patch.removedFunctions = functionDiff.removed;
+  }
+
+  if (previous.variables !== next.variables) {
+    patch.variables = next.variables || {};
+  }
+
+  return patch;
+};
+
+export const isEmptyQuestGraphPatch = (patch: QuestGraphModelPatch): boolean =>
+  !patch.reset &&
+  !patch.dialogs &&
+  !patch.removedDialogs?.length &&
+  !patch.functions &&
+  !patch.removedFunctions?.length &&
+  !patch.variables;
+
+export type QuestGraphBuilder = typeof buildQuestGraph;
+export type QuestOverviewBuilder = typeof buildQuestOverviewGraph;
+
+type SemanticFunction = SemanticModel['functions'][string];
+
+/** What a built graph was derived from; changes elsewhere leave it valid */
+interface GraphDependencies {
+  /** Lower-cased names of the functions behind its nodes and of their dialogs' condition functions */
+  functions: Set<string>;
+  /** Node labels, which Npc_KnowsInfo conditions of other functions may refer to */
+  labels: Set<string>;
+  topics: Set<string>;
+  /** MIS_ variables of the graph's quests */
+  questVariables: Set<string>;
+  /** Variables the nodes' conditions read; their producers become nodes too */
+  readVariables: Set<string>;
+}
+
+interface CachedGraph {
+  graph: QuestGraphData;
+  dependencies: GraphDependencies;
+}
+
+const intersects = (values: Set<string>, other: Set<string>): boolean => {
+  for (const value of values) {
+    if (other.has(value)) return true;
+  }
+  return false;
+};
+
+/** Facts of a function merged with those of its dialog's condition function */
+const getEffectiveFacts = (func: SemanticFunction, model: SemanticModel): FunctionQuestFacts[] => {
+  const facts = [getFunctionQuestFacts(func)];
+  const conditionName = getDialogContextForFunction(func.name, model).conditionFunctionName;
+  const conditionFunc = conditionName ? model.functions[conditionName] : undefined;
+  if (conditionFunc && conditionFunc !== func) {
+    facts.push(getFunctionQuestFacts(conditionFunc));
+  }
+  return facts;
+};
+
+const collectDependencies = (
+  model: SemanticModel,
+  graph: QuestGraphData,
+  questNames: string[]
+): GraphDependencies => {
+  const dependencies: GraphDependencies = {
+    functions: new Set(),
+    labels: new Set(),
+    topics: new Set(questNames),
+    questVariables: new Set(questNames.map((questName) => questName.replace('TOPIC_', 'MIS_'))),
+    readVariables: new Set()
+  };
+
+  graph.nodes.forEach((node) => {
+    dependencies.labels.add(node.data.label);
+    const functionName = node.data.provenance?.functionName;
+    const func = functionName ? model.functions[functionName] : undefined;
+    if (!func) return;
+
+    dependencies.functions.add(func.name.toLowerCase());
+    const conditionName = getDialogContextForFunction(func.name, model).conditionFunctionName;
+    if (conditionName) {
+      dependencies.functions.add(conditionName.toLowerCase());
+    }
+    getEffectiveFacts(func, model).forEach((facts) => {
+      facts.conditionVariables.forEach((variable) => dependencies.readVariables.add(variable));
+    });
+  });
+  return dependencies;
+};
+
+/** Whether the graph could change when `func` (in `model`) is added, edited or removed */
+const functionAffects = (func: SemanticFunction, model: SemanticModel, dependencies: GraphDependencies): boolean => {
+  if (dependencies.functions.has(func.name.toLowerCase())) {
+    return true;
+  }
+  return getEffectiveFacts(func, model).some((facts) =>
+    intersects(facts.topics, dependencies.topics) ||
+    intersects(facts.conditionVariables, dependencies.questVariables) ||
+    intersects(facts.writtenVariables, dependencies.questVariables) ||
+    intersects(facts.writtenVariables, dependencies.readVariables) ||
+    intersects(facts.knownDialogs, dependencies.labels)
+  );
+};
+
+/** Whether the graph could change when `dialog` (in `model`) is added, edited or removed */
+const dialogAffects = (
+  dialog: SemanticModel['dialogs'][string],
+  model: SemanticModel,
+  dependencies: GraphDependencies
+): boolean => {
+  if (dependencies.labels.has(dialog.name)) {
+    return true;
+  }
+  return [dialog.properties?.information, dialog.properties?.condition].some((reference) => {
+    const name = typeof reference === 'string' ? reference : reference?.name;
+    if (!name) return false;
+    const func = model.functions[name];
+    return dependencies.functions.has(name.toLowerCase()) || (!!func && functionAffects(func, model, dependencies));
+  });
+};
+
+export class QuestGraphService {
+  constructor(
+    private readonly buildGraph: QuestGraphBuilder = buildQuestGraph,
+    private readonly buildOverview: QuestOverviewBuilder = buildQuestOverviewGraph
+  ) {}
+
+  private model: SemanticModel = createEmptyModel();
+  private readonly graphCache = new Map<string, CachedGraph>();
+
+  applyPatch(patch: QuestGraphModelPatch): void {
+    if (isEmptyQuestGraphPatch(patch)) {
+      return;
+    }
+
+    const previous = this.model;
+    const base = patch.reset ? createEmptyModel() : previous;
+    this.model = {
+      ...base,
+      dialogs: applyRecordPatch(base.dialogs, patch.dialogs, patch.removedDialogs),
+      functions: applyRecordPatch(base.functions, patch.functions, patch.removedFunctions),
+      variables: patch.variables ?? base.variables
+    };
+
+    if (patch.reset || patch.variables) {
+      this.graphCache.clear();
+      return;
+    }
+    this.invalidate(previous, patch);
+  }
+
+  /**
+   * Build (or reuse) the graph for `questName` against the current model, or
+   * the all-quests overview when `overviewQuests` is given. `onPartial`
+   * receives the graph before layout when a full layout has to run.
+   */
+  build(
+    questName: string | null,
+    options?: QuestGraphBuildOptions,
+    overviewQuests?: string[],
+    onPartial?: (graph: QuestGraphData) => void
+  ): QuestGraphData {
+    const subject = overviewQuests ? `overview:${overviewQuests.join(',')}` : `quest:${questName ?? ''}`;
+    const key = `${subject}\u0000${JSON.stringify(options || {})}`;
+    const cached = this.graphCache.get(key);
+    if (cached) {
+      // Refresh recency
+      this.graphCache.delete(key);
+      this.graphCache.set(key, cached);
+      return cached.graph;
+    }
+
+    const graph = overviewQuests
+      ? this.buildOverview(this.model, overviewQuests, options)
+      : this.buildGraph(this.model, questName, options, onPartial);
+    const questNames = overviewQuests ?? (questName ? [questName] : []);
+    this.graphCache.set(key, { graph, dependencies: collectDependencies(this.model, graph, questNames) });
+    if (this.graphCache.size > MAX_CACHED_GRAPHS) {
+      this.graphCache.delete(this.graphCache.keys().next().value!);
+    }
+    return graph;
+  }
+
+  /** Drop the cached graphs the changed dialogs and functions (before or after `patch`) could affect */
+  private invalidate(previous: SemanticModel, patch: QuestGraphModelPatch): void {
+    const changedFunctions = [...Object.keys(patch.functions ?? {}), ...(patch.removedFunctions ?? [])];
+    const changedDialogs = [...Object.keys(patch.dialogs ?? {}), ...(patch.removedDialogs ?? [])];
+
+    this.graphCache.forEach(({ dependencies }, key) => {
+      const affected = [previous, this.model].some((model) =>
+        changedFunctions.some((name) => {
+          const func = model.functions[name];
+          return !!func && functionAffects(func, model, dependencies);
+        }) ||
+        changedDialogs.some((name) => {
+          const dialog = model.dialogs[name];
+          return !!dialog && dialogAffects(dialog, model, dependencies);
+        })
+      );
+      if (affected) {
+        this.graphCache.delete(key);
+      }
+    });
+  }
+}
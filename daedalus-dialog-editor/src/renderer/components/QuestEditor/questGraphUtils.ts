@@ -1,5 +1,12 @@
+/**
+ * Quest graph building and layout
+ *
+ * Pure data: runs in the quest graph worker, so nothing here may import
+ * React or reactflow. Presentation details such as edge arrow markers are
+ * added by the UI (see questGraphMarkers).
+ */
+
 import dagre from 'dagre';
-import { MarkerType } from 'reactflow';
 import type { DialogAction, DialogCondition, SemanticModel } from '../../types/global';
 import type {
   QuestGraphBuildOptions,
@@ -196,25 +203,95 @@ const getFunctionRefName = (candidate: unknown): string | undefined => {
   return undefined;
 };
 
-const getDialogContextForFunction = (
+interface DialogFunctionContext {
+  npc: string;
+  dialogName?: string;
+  conditionFunctionName?: string;
+}
+
+// Information-function -> dialog lookup, built once per dialogs object instead of
+// scanning every dialog for every function (keyed weakly so edits invalidate it).
+const dialogContextIndexCache = new WeakMap<object, Map<string, DialogFunctionContext>>();
+
+const getDialogContextIndex = (semanticModel: SemanticModel): Map<string, DialogFunctionContext> => {
+  const dialogs = semanticModel.dialogs || {};
+  const cached = dialogContextIndexCache.get(dialogs);
+  if (cached) return cached;
+
+  const index = new Map<string, DialogFunctionContext>();
+  for (const [dialogName, dialog] of Object.entries(dialogs)) {
+    const infoName = getFunctionRefName(dialog.properties.information);
+    if (typeof infoName !== 'string') continue;
+    const key = infoName.toLowerCase();
+    // First declaration wins, matching the previous linear scan
+    if (index.has(key)) continue;
+    index.set(key, {
+      npc: (dialog.properties.npc as string) || 'Unknown',
+      dialogName,
+      conditionFunctionName: getFunctionRefName(dialog.properties.condition)
+    });
+  }
+
+  dialogContextIndexCache.set(dialogs, index);
+  return index;
+};
+
+export const getDialogContextForFunction = (
   funcName: string,
   semanticModel: SemanticModel
-): { npc: string; dialogName?: string; conditionFunctionName?: string } => {
-  for (const [dialogName, dialog] of Object.entries(semanticModel.dialogs || {})) {
-    const infoName = getFunctionRefName(dialog.properties.information);
-    if (
-      typeof infoName === 'string' &&
-      infoName.toLowerCase() === funcName.toLowerCase()
-    ) {
-      return {
-        npc: (dialog.properties.npc as string) || 'Unknown',
-        dialogName,
-        conditionFunctionName: getFunctionRefName(dialog.properties.condition)
-      };
+): DialogFunctionContext => {
+  return getDialogContextIndex(semanticModel).get(funcName.toLowerCase()) || { npc: 'Global/Other' };
+};
+
+type SemanticFunction = NonNullable<SemanticModel['functions']>[string];
+
+/** Quest-independent facts about one function, cached per function object. */
+export interface FunctionQuestFacts {
+  assignments: Array<[variable: string, value: string]>;
+  topics: Set<string>;
+  writtenVariables: Set<string>;
+  conditionVariables: Set<string>;
+  /** Dialogs its Npc_KnowsInfo conditions refer to */
+  knownDialogs: Set<string>;
+}
+
+const functionQuestFactsCache = new WeakMap<object, FunctionQuestFacts>();
+
+export const getFunctionQuestFacts = (func: SemanticFunction): FunctionQuestFacts => {
+  const cached = functionQuestFactsCache.get(func);
+  if (cached) return cached;
+
+  const facts: FunctionQuestFacts = {
+    assignments: [],
+    topics: new Set(),
+    writtenVariables: new Set(),
+    conditionVariables: new Set(),
+    knownDialogs: new Set()
+  };
+
+  func.actions?.forEach((action: DialogAction) => {
+    if (action.type === 'SetVariableAction') {
+      facts.writtenVariables.add(action.variableName);
+      if (action.operator === '=') {
+        facts.assignments.push([action.variableName, String(action.value)]);
+      }
     }
-  }
+    if ('topic' in action && typeof action.topic === 'string') {
+      facts.topics.add(action.topic);
+    }
+  });
+
+  func.conditions?.forEach((cond: DialogCondition) => {
+    const conditionType = inferConditionType(cond);
+    if (conditionType === 'VariableCondition' && 'variableName' in cond) {
+      facts.conditionVariables.add(cond.variableName);
+    } else if (conditionType === 'NpcKnowsInfoCondition' && 'dialogRef' in cond) {
+      facts.knownDialogs.add(cond.dialogRef);
+    }
+  });
 
-  return { npc: 'Global/Other' };
+  functionQuestFactsCache.set(func, facts);
+  return facts;
 };
 
 const getEffectiveConditionEntriesForFunction = (
@@ -333,7 +410,23 @@ const identifyQuestNodes = (
   };
 
   Object.values(semanticModel.functions || {}).forEach((func) => {
+    const facts = getFunctionQuestFacts(func);
+    facts.assignments.forEach(([variable, value]) => addProducer(variable, value, func.name));
+
+    // Skip the detailed scan for functions that can't touch the selected quest
     const context = getDialogContextForFunction(func.name, semanticModel);
+    const conditionFunc = context.conditionFunctionName
+      ? semanticModel.functions?.[context.conditionFunctionName]
+      : undefined;
+    if (
+      !facts.topics.has(questName) &&
+      !facts.writtenVariables.has(misVarName) &&
+      !facts.conditionVariables.has(misVarName) &&
+      !(conditionFunc && getFunctionQuestFacts(conditionFunc).conditionVariables.has(misVarName))
+    ) {
+      return;
+    }
+
     const effectiveConditionEntries = getEffectiveConditionEntriesForFunction(func.name, semanticModel);
     let isRelevant = false;
     let type: InternalNodeData['type'] = 'check';
@@ -346,11 +439,6 @@ const identifyQuestNodes = (
     const nonQuestConditionKinds = new Set<string>();
 
     func.actions?.forEach((action: DialogAction) => {
-      if (action.type === 'SetVariableAction' && action.operator === '=') {
-        const value = String(action.value);
-        addProducer(action.variableName, value, func.name);
-      }
-
       if ('topic' in action && action.topic === questName) {
         isRelevant = true;
         touchesSelectedQuest = true;
@@ -633,7 +721,6 @@ const buildQuestEdges = (
         targetHandle,
         label: action.text,
         type: 'smoothstep',
-        markerEnd: { type: MarkerType.ArrowClosed },
         style: { stroke: CHOICE_EDGE_COLOR, strokeWidth: 2, strokeDasharray: '5,5' },
         labelStyle: { fill: CHOICE_EDGE_COLOR, fontSize: 10 },
         data: {
@@ -698,7 +785,6 @@ const buildQuestEdges = (
         targetHandle: 'in-condition-' + conditionPosition,
         label: `requires ${shortenExpression(expression || conditionLabel, 40)}`,
         type: 'smoothstep',
-        markerEnd: { type: MarkerType.ArrowClosed },
         style: { stroke: '#ffb74d', strokeWidth: 2 },
         labelStyle: { fill: '#ffb74d', fontSize: 10 },
         data: {
@@ -736,7 +822,6 @@ const buildQuestEdges = (
             targetHandle: 'in-condition-' + conditionPosition,
             label: `requires knows ${producerDialogName}`,
             type: 'smoothstep',
-            markerEnd: { type: MarkerType.ArrowClosed },
             style: { stroke: '#b1b1b7', strokeWidth: 2, strokeDasharray: '3,3' },
             labelStyle: { fill: '#b1b1b7', fontSize: 10 },
             data: {
@@ -778,7 +863,6 @@ const buildQuestEdges = (
             label: `requires ${variableName} == ${rawValue}`,
             type: 'smoothstep',
             animated: true,
-            markerEnd: { type: MarkerType.ArrowClosed },
             style: { stroke: '#2196f3', strokeWidth: 2, strokeDasharray: '3,3' },
             labelStyle: { fill: '#2196f3', fontSize: 10 },
             data: {
@@ -838,7 +922,6 @@ const buildQuestEdges = (
         targetHandle: 'in-condition-0',
         label: 'requires entry trigger',
         type: 'smoothstep',
-        markerEnd: { type: MarkerType.ArrowClosed },
         style: { stroke: '#81c784', strokeWidth: 2, strokeDasharray: '3,3' },
         labelStyle: { fill: '#81c784', fontSize: 10 },
         data: {
@@ -951,17 +1034,56 @@ const filterGraph = (
   return { nodeDataMap: selectedNodeDataMap, edges: selectedEdges };
 };
 
-const calculateDagreLayout = (
-  semanticModel: SemanticModel,
+interface LayoutBox {
+  x: number;
+  y: number;
+  width: number;
+  height: number;
+}
+
+interface CachedLayout {
+  topologyKey: string;
+  boxes: Map<string, LayoutBox>;
+  /** Swimlane of each laid-out node; a node that moved to another lane is placed anew */
+  npcs: Map<string, string>;
+}
+
+const MAX_CACHED_LAYOUTS = 32;
+
+// Last layout per quest. Edits that leave the graph topology unchanged
+// (texts, descriptions, condition values) reuse the previous positions instead
+// of running a full layout again; edits that add or remove a few nodes keep
+// the others where they were (see placeNewNodes).
+const layoutCache = new Map<string, CachedLayout>();
+
+const getLayoutTopologyKey = (
   nodeDataMap: Map<string, InternalNodeData>,
-  edges: QuestGraphEdge[],
-  misVarName: string
-): QuestGraphNode[] => {
-  const NODE_WIDTH = 280;
-  const NODE_HEIGHT = 132;
+  edges: QuestGraphEdge[]
+): string => {
+  const nodeKeys = Array.from(nodeDataMap.values(), (data) => `${data.id}@${data.npc}`).sort();
+  const edgeKeys = edges
+    .filter((edge) => nodeDataMap.has(edge.source) && nodeDataMap.has(edge.target))
+    .map((edge) => `${edge.source}>${edge.target}`)
+    .sort();
+  return `${nodeKeys.join('|')}#${edgeKeys.join('|')}`;
+};
+
+export const clearQuestLayoutCache = (): void => {
+  layoutCache.clear();
+};
+
+const NODE_WIDTH = 280;
+const NODE_HEIGHT = 132;
+const RANK_SEP = 180;
+const NODE_SEP = 120;
+const SWIMLANE_PADDING = 40;
 
+const runDagreLayout = (
+  nodeDataMap: Map<string, InternalNodeData>,
+  edges: QuestGraphEdge[]
+): Map<string, LayoutBox> => {
   const g = new dagre.graphlib.Graph({ compound: true });
-  g.setGraph({ rankdir: 'LR', align: 'UL', ranksep: 180, nodesep: 120, edgesep: 60, marginx: 40, marginy: 40 });
+  g.setGraph({ rankdir: 'LR', align: 'UL', ranksep: RANK_SEP, nodesep: NODE_SEP, edgesep: 60, marginx: 40, marginy: 40 });
   g.setDefaultEdgeLabel(() => ({}));
 
   const npcNodes = new Map<string, string[]>();
@@ -992,9 +1114,186 @@ const calculateDagreLayout = (
 
   dagre.layout(g);
 
-  const nodes: QuestGraphNode[] = [];
+  const boxes = new Map<string, LayoutBox>();
   g.nodes().forEach((nodeId) => {
     const node = g.node(nodeId);
+    boxes.set(nodeId, { x: node.x, y: node.y, width: node.width, height: node.height });
+  });
+  return boxes;
+};
+
+const boxesCollide = (a: LayoutBox, b: LayoutBox): boolean =>
+  Math.abs(a.x - b.x) < (a.width + b.width + RANK_SEP) / 2 &&
+  Math.abs(a.y - b.y) < (a.height + b.height + NODE_SEP) / 2;
+
+/** Fit a swimlane box around the nodes of each NPC, as Dagre's compound layout does */
+const addSwimlaneBoxes = (nodeDataMap: Map<string, InternalNodeData>, boxes: Map<string, LayoutBox>): void => {
+  const bounds = new Map<string, { left: number; top: number; right: number; bottom: number }>();
+  nodeDataMap.forEach((data, id) => {
+    const box = boxes.get(id);
+    if (!box) return;
+    const left = box.x - box.width / 2;
+    const top = box.y - box.height / 2;
+    const right = box.x + box.width / 2;
+    const bottom = box.y + box.height / 2;
+    const lane = bounds.get(data.npc);
+    bounds.set(data.npc, lane
+      ? {
+        left: Math.min(lane.left, left),
+        top: Math.min(lane.top, top),
+        right: Math.max(lane.right, right),
+        bottom: Math.max(lane.bottom, bottom)
+      }
+      : { left, top, right, bottom });
+  });
+
+  bounds.forEach((lane, npc) => {
+    boxes.set(`swimlane-${npc}`, {
+      x: (lane.left + lane.right) / 2,
+      y: (lane.top + lane.bottom) / 2,
+      width: lane.right - lane.left + 2 * SWIMLANE_PADDING,
+      height: lane.bottom - lane.top + 2 * SWIMLANE_PADDING
+    });
+  });
+};
+
+/**
+ * Dagre has no incremental mode, so after a topology change keep every node
+ * that is still in the graph (in the same swimlane) at its previous position
+ * and place only the new ones: a rank after a laid-out predecessor, a rank
+ * before a laid-out successor, or else below their swimlane; then down until
+ * they clear the other nodes. Returns null when most of the graph is new and
+ * a full layout serves better.
+ */
+const placeNewNodes = (
+  previous: CachedLayout,
+  nodeDataMap: Map<string, InternalNodeData>,
+  edges: QuestGraphEdge[]
+): Map<string, LayoutBox> | null => {
+  const boxes = new Map<string, LayoutBox>();
+  const pending: string[] = [];
+  nodeDataMap.forEach((data, id) => {
+    const box = previous.boxes.get(id);
+    if (box && previous.npcs.get(id) === data.npc) {
+      boxes.set(id, box);
+    } else {
+      pending.push(id);
+    }
+  });
+  if (boxes.size === 0 || pending.length > boxes.size) {
+    return null;
+  }
+
+  const placed = Array.from(boxes.values());
+  const findAnchor = (id: string): { x: number; y: number } | null => {
+    const predecessor = edges.find((edge) => edge.target === id && boxes.has(edge.source));
+    if (predecessor) {
+      const box = boxes.get(predecessor.source)!;
+      return { x: box.x + NODE_WIDTH + RANK_SEP, y: box.y };
+    }
+    const successor = edges.find((edge) => edge.source === id && boxes.has(edge.target));
+    if (successor) {
+      const box = boxes.get(successor.target)!;
+      return { x: box.x - NODE_WIDTH - RANK_SEP, y: box.y };
+    }
+    return null;
+  };
+  const belowSwimlane = (npc: string): { x: number; y: number } => {
+    const lane = Array.from(boxes.entries())
+      .filter(([id]) => nodeDataMap.get(id)?.npc === npc)
+      .map(([, box]) => box);
+    // A new NPC opens a new swimlane below all others
+    const reference = lane.length > 0 ? lane : placed;
+    return {
+      x: Math.min(...reference.map((box) => box.x)),
+      y: Math.max(...reference.map((box) => box.y)) + NODE_HEIGHT + NODE_SEP + (lane.length > 0 ? 0 : 2 * SWIMLANE_PADDING)
+    };
+  };
+
+  while (pending.length > 0) {
+    // Nodes connected to the placed ones first, so chains of new nodes line up
+    const connected = pending.findIndex((id) => findAnchor(id) !== null);
+    const [id] = pending.splice(Math.max(connected, 0), 1);
+    const position = findAnchor(id) ?? belowSwimlane(nodeDataMap.get(id)!.npc);
+
+    const box: LayoutBox = { x: position.x, y: position.y, width: NODE_WIDTH, height: NODE_HEIGHT };
+    while (placed.some((other) => boxesCollide(box, other))) {
+      box.y += NODE_HEIGHT + NODE_SEP;
+    }
+    boxes.set(id, box);
+    placed.push(box);
+  }
+
+  addSwimlaneBoxes(nodeDataMap, boxes);
+  return boxes;
+};
+
+/** Provisional positions, one row per swimlane, shown while a full layout runs */
+const placeInSwimlaneRows = (nodeDataMap: Map<string, InternalNodeData>): Map<string, LayoutBox> => {
+  const boxes = new Map<string, LayoutBox>();
+  const rows = new Map<string, number>();
+  const columns = new Map<string, number>();
+  nodeDataMap.forEach((data, id) => {
+    if (!rows.has(data.npc)) {
+      rows.set(data.npc, rows.size);
+    }
+    const column = columns.get(data.npc) ?? 0;
+    columns.set(data.npc, column + 1);
+    boxes.set(id, {
+      x: column * (NODE_WIDTH + RANK_SEP),
+      y: rows.get(data.npc)! * (NODE_HEIGHT + NODE_SEP + 2 * SWIMLANE_PADDING),
+      width: NODE_WIDTH,
+      height: NODE_HEIGHT
+    });
+  });
+  addSwimlaneBoxes(nodeDataMap, boxes);
+  return boxes;
+};
+
+/**
+ * Positions for the graph's nodes, reusing or extending the layout cached
+ * under `layoutKey`. `onFullLayout` runs before a full Dagre layout starts.
+ */
+const calculateLayout = (
+  nodeDataMap: Map<string, InternalNodeData>,
+  edges: QuestGraphEdge[],
+  layoutKey?: string,
+  onFullLayout?: () => void
+): Map<string, LayoutBox> => {
+  if (!layoutKey) {
+    onFullLayout?.();
+    return runDagreLayout(nodeDataMap, edges);
+  }
+
+  const topologyKey = getLayoutTopologyKey(nodeDataMap, edges);
+  const cached = layoutCache.get(layoutKey);
+  let boxes: Map<string, LayoutBox> | null = null;
+  if (cached) {
+    boxes = cached.topologyKey === topologyKey ? cached.boxes : placeNewNodes(cached, nodeDataMap, edges);
+    // Refresh recency
+    layoutCache.delete(layoutKey);
+  }
+  if (!boxes) {
+    onFullLayout?.();
+    boxes = runDagreLayout(nodeDataMap, edges);
+  }
+
+  const npcs = new Map(Array.from(nodeDataMap, ([id, data]) => [id, data.npc]));
+  layoutCache.set(layoutKey, { topologyKey, boxes, npcs });
+  if (layoutCache.size > MAX_CACHED_LAYOUTS) {
+    layoutCache.delete(layoutCache.keys().next().value!);
+  }
+  return boxes;
+};
+
+const createQuestGraphNodes = (
+  semanticModel: SemanticModel,
+  nodeDataMap: Map<string, InternalNodeData>,
+  boxes: Map<string, LayoutBox>,
+  misVarName: string
+): QuestGraphNode[] => {
+  const nodes: QuestGraphNode[] = [];
+  boxes.forEach((node, nodeId) => {
     if (nodeId.startsWith('swimlane-')) {
       nodes.push({
         id: nodeId,
@@ -1073,10 +1372,15 @@ const calculateDagreLayout = (
   return nodes;
 };
 
+/**
+ * Build and lay out the graph of `questName`. When a full layout has to run,
+ * `onPartial` first receives the graph with provisional positions.
+ */
 export const buildQuestGraph = (
   semanticModel: SemanticModel,
   questName: string | null,
-  options?: QuestGraphBuildOptions
+  options?: QuestGraphBuildOptions,
+  onPartial?: (graph: QuestGraphData) => void
 ): QuestGraphData => {
   if (!questName || !semanticModel) {
     return { nodes: [], edges: [] };
@@ -1090,15 +1394,102 @@ export const buildQuestGraph = (
   );
   const { edges } = buildQuestEdges(semanticModel, nodeDataMap, producersByVariableAndValue, misVarName);
   const filtered = filterGraph(nodeDataMap, edges, options);
-  const nodes = calculateDagreLayout(semanticModel, filtered.nodeDataMap, filtered.edges, misVarName);
+  const graphEdges = filtered.edges.filter(
+    (edge) => filtered.nodeDataMap.has(edge.source) && filtered.nodeDataMap.has(edge.target)
+  );
+  const layoutKey = `${questName}\u0000${JSON.stringify(options || {})}`;
+  const boxes = calculateLayout(filtered.nodeDataMap, filtered.edges, layoutKey, onPartial && (() => onPartial({
+    nodes: createQuestGraphNodes(semanticModel, filtered.nodeDataMap, placeInSwimlaneRows(filtered.nodeDataMap), misVarName),
+    edges: graphEdges
+  })));
+
+  return {
+    nodes: createQuestGraphNodes(semanticModel, filtered.nodeDataMap, boxes, misVarName),
+    edges: graphEdges
+  };
+};
+
+/** Separates the quest name from the original node/edge id in overview graphs */
+export const QUEST_OVERVIEW_ID_SEPARATOR = '::';
+const QUEST_OVERVIEW_BAND_GAP = 240;
 
+/**
+ * Split an overview node id back into its quest and original node id.
+ */
+export const parseQuestOverviewNodeId = (nodeId: string): { questName: string; nodeId: string } | null => {
+  const separatorIndex = nodeId.indexOf(QUEST_OVERVIEW_ID_SEPARATOR);
+  if (separatorIndex < 0) return null;
   return {
-    nodes,
-    edges: filtered.edges.filter(
-      (edge) => filtered.nodeDataMap.has(edge.source) && filtered.nodeDataMap.has(edge.target)
-    )
+    questName: nodeId.slice(0, separatorIndex),
+    nodeId: nodeId.slice(separatorIndex + QUEST_OVERVIEW_ID_SEPARATOR.length)
   };
 };
 
+/**
+ * Build one graph containing every quest in `questNames`, each laid out on
+ * its own horizontal band. Node and edge ids are prefixed with the quest name.
+ */
+export const buildQuestOverviewGraph = (
+  semanticModel: SemanticModel,
+  questNames: Iterable<string>,
+  options?: QuestGraphBuildOptions
+): QuestGraphData => {
+  const nodes: QuestGraphNode[] = [];
+  const edges: QuestGraphEdge[] = [];
+  let bandTop = 0;
+
+  Array.from(new Set(questNames)).sort().forEach((questName) => {
+    const graph = buildQuestGraph(semanticModel, questName, options);
+    if (graph.nodes.length === 0) return;
+
+    let minX = Infinity;
+    let minY = Infinity;
+    let maxX = -Infinity;
+    let maxY = -Infinity;
+    graph.nodes.forEach((node) => {
+      const width = typeof node.style?.width === 'number' ? node.style.width : NODE_WIDTH;
+      const height = typeof node.style?.height === 'number' ? node.style.height : NODE_HEIGHT;
+      minX = Math.min(minX, node.position.x);
+      minY = Math.min(minY, node.position.y);
+      maxX = Math.max(maxX, node.position.x + width);
+      maxY = Math.max(maxY, node.position.y + height);
+    });
+
+    const prefix = `${questName}${QUEST_OVERVIEW_ID_SEPARATOR}`;
+    nodes.push({
+      id: `${prefix}band`,
+      type: 'group',
+      position: { x: -40, y: bandTop - 40 },
+      style: {
+        width: maxX - minX + 80,
+        height: maxY - minY + 80,
+        backgroundColor: 'rgba(255, 255, 255, 0.01)',
+        border: '1px solid #333',
+        zIndex: -2
+      },
+      data: { label: questName, npc: questName, kind: 'topic' },
+      selectable: false,
+      draggable: false
+    });
+
+    graph.nodes.forEach((node) => {
+      nodes.push({
+        ...node,
+        id: `${prefix}${node.id}`,
+        position: { x: node.position.x - minX, y: node.position.y - minY + bandTop }
+      });
+    });
+    graph.edges.forEach((edge) => {
+      edges.push({
+        ...edge,
+        id: `${prefix}${edge.id}`,
+        source: `${prefix}${edge.source}`,
+        target: `${prefix}${edge.target}`
+      });
+    });
 
+    bandTop += maxY - minY + QUEST_OVERVIEW_BAND_GAP;
+  });
 
+  return { nodes, edges };
+};
@@ -0,0 +1,130 @@
+/**
+ * Spatial index for quest graph canvases
+ *
+ * A static region quadtree over axis-aligned bounds, rebuilt whenever node
+ * positions change. Used to find the nodes and edges inside the viewport
+ * without testing every item on every frame.
+ */
+
+/** [x, y, width, height], matching LiteGraph's bounding arrays */
+export type Bounds = readonly [number, number, number, number] | Float32Array;
+
+const MAX_ITEMS_PER_NODE = 16;
+const MAX_DEPTH = 10;
+
+export const boundsOverlap = (a: Bounds, b: Bounds): boolean => (
+  a[0] <= b[0] + b[2] &&
+  a[0] + a[2] >= b[0] &&
+  a[1] <= b[1] + b[3] &&
+  a[1] + a[3] >= b[1]
+);
+
+const boundsContain = (outer: Bounds, inner: Bounds): boolean => (
+  inner[0] >= outer[0] &&
+  inner[1] >= outer[1] &&
+  inner[0] + inner[2] <= outer[0] + outer[2] &&
+  inner[1] + inner[3] <= outer[1] + outer[3]
+);
+
+interface QuadTreeEntry<T> {
+  item: T;
+  bounds: Bounds;
+}
+
+class QuadTreeNode<T> {
+  readonly entries: QuadTreeEntry<T>[] = [];
+  children: QuadTreeNode<T>[] | null = null;
+
+  constructor(readonly bounds: Bounds, readonly depth: number) {}
+
+  insert(entry: QuadTreeEntry<T>): void {
+    if (this.children) {
+      const child = this.children.find((candidate) => boundsContain(candidate.bounds, entry.bounds));
+      if (child) {
+        child.insert(entry);
+        return;
+      }
+      // Straddles a split line: keep it at this level
+      this.entries.push(entry);
+      return;
+    }
+
+    this.entries.push(entry);
+    if (this.entries.length > MAX_ITEMS_PER_NODE && this.depth < MAX_DEPTH) {
+      this.split();
+    }
+  }
+
+  query(area: Bounds, out: T[]): void {
+    for (const entry of this.entries) {
+      if (boundsOverlap(area, entry.bounds)) {
+        out.push(entry.item);
+      }
+    }
+    if (!this.children) return;
+    for (const child of this.children) {
+      if (boundsOverlap(area, child.bounds)) {
+        child.query(area, out);
+      }
+    }
+  }
+
+  private split(): void {
+    const [x, y, width, height] = this.bounds;
+    const halfWidth = width / 2;
+    const halfHeight = height / 2;
+    const depth = this.depth + 1;
+    this.children = [
+      new QuadTreeNode<T>([x, y, halfWidth, halfHeight], depth),
+      new QuadTreeNode<T>([x + halfWidth, y, halfWidth, halfHeight], depth),
+      new QuadTreeNode<T>([x, y + halfHeight, halfWidth, halfHeight], depth),
+      new QuadTreeNode<T>([x + halfWidth, y + halfHeight, halfWidth, halfHeight], depth)
+    ];
+
+    const entries = this.entries.splice(0, this.entries.length);
+    entries.forEach((entry) => this.insert(entry));
+  }
+}
+
+export class QuadTree<T> {
+  private readonly root: QuadTreeNode<T> | null;
+  readonly size: number;
+
+  private constructor(entries: QuadTreeEntry<T>[]) {
+    this.size = entries.length;
+    if (entries.length === 0) {
+      this.root = null;
+      return;
+    }
+
+    let minX = Infinity;
+    let minY = Infinity;
+    let maxX = -Infinity;
+    let maxY = -Infinity;
+    entries.forEach(({ bounds }) => {
+      minX = Math.min(minX, bounds[0]);
+      minY = Math.min(minY, bounds[1]);
+      maxX = Math.max(maxX, bounds[0] + bounds[2]);
+      maxY = Math.max(maxY, bounds[1] + bounds[3]);
+    });
+
+    this.root = new QuadTreeNode<T>([minX, minY, Math.max(1, maxX - minX), Math.max(1, maxY - minY)], 0);
+    entries.forEach((entry) => this.root!.insert(entry));
+  }
+
+  static fromItems<T>(items: Iterable<T>, getBounds: (item: T) => Bounds): QuadTree<T> {
+    const entries: QuadTreeEntry<T>[] = [];
+    for (const item of items) {
+      const bounds = getBounds(item);
+      // Copy so later mutation of a shared bounding buffer doesn't corrupt the index
+      entries.push({ item, bounds: [bounds[0], bounds[1], bounds[2], bounds[3]] });
+    }
+    return new QuadTree(entries);
+  }
+
+  /** Items whose bounds overlap `area` (unordered). */
+  query(area: Bounds, out: T[] = []): T[] {
+    this.root?.query(area, out);
+    return out;
+  }
+}
@@ -9,14 +9,17 @@ import {
 } from '@mui/material';
 import { Undo as UndoIcon, Redo as RedoIcon } from '@mui/icons-material';
 import type { SemanticModel } from '../types/global';
-import type { QuestGraphBuildOptions, QuestGraphEdge, QuestGraphNode } from '../types/questGraph';
+import type { QuestGraphBuildOptions, QuestGraphData, QuestGraphEdge, QuestGraphNode } from '../types/questGraph';
 import { useNavigation } from '../hooks/useNavigation';
 import { useEditorStore } from '../store/editorStore';
 import { useProjectStore } from '../store/projectStore';
+import { generateCode } from '../utils/modelSync';
 import {
   analyzeQuestGuardrails,
   buildQuestGraph,
+  buildQuestOverviewGraph,
   findDialogNameForFunction,
+  getUsedQuestTopics,
   getQuestGuardrailDeltaWarnings,
   isQuestGuardrailWarningBlocking,
   type QuestGraphCommand
@@ -25,6 +28,9 @@ import { QuestEditingService } from '../quest/application';
 import QuestInspectorPanel from './QuestEditor/Inspector/QuestInspectorPanel';
 import QuestDiffPreviewDialog from './QuestEditor/Inspector/QuestDiffPreviewDialog';
 import QuestLiteGraphCanvas from './QuestEditor/QuestLiteGraphCanvas';
+import { QuestGraphClient } from './QuestEditor/questGraphClient';
+import { parseQuestOverviewNodeId } from './QuestEditor/questGraphUtils';
+import { withArrowMarkers } from './QuestEditor/questGraphMarkers';
 
 interface QuestFlowProps {
   semanticModel: SemanticModel;
@@ -103,6 +109,17 @@ const QuestFlow: React.FC<QuestFlowProps> = ({ semanticModel, questName, writabl
   const [commandError, setCommandError] = useState<string | null>(null);
   const [commandBusy, setCommandBusy] = useState(false);
   const [pendingPreview, setPendingPreview] = useState<PendingDiffPreview | null>(null);
+  // Graph building and layout run in a worker; the client keeps it fed with model patches
+  const [graphClient] = useState(() => new QuestGraphClient({
+    buildGraph: buildQuestGraph,
+    buildOverview: buildQuestOverviewGraph
+  }));
+  const [showOverview, setShowOverview] = useState(false);
+  const overviewQuests = useMemo(
+    () => (showOverview ? Array.from(getUsedQuestTopics(semanticModel)).sort() : undefined),
+    [showOverview, semanticModel]
+  );
+  useEffect(() => () => graphClient.dispose(), [graphClient]);
   const graphOptions = useMemo<QuestGraphBuildOptions>(() => ({
     onlySelectedQuest: true,
     hideInferredEdges: false,
@@ -134,22 +151,37 @@ const QuestFlow: React.FC<QuestFlowProps> = ({ semanticModel, questName, writabl
     [semanticModel, questName]
   );
 
-  const refreshGraph = useCallback(() => {
-    const { nodes: newNodes, edges: newEdges } = buildQuestGraph(semanticModel, questName, graphOptions);
-    const nextNodes = [...newNodes];
-    if (questName && activeFile) {
-      const positionOverrides = getQuestNodePositions(activeFile, questName);
-      if (positionOverrides.size > 0) {
-        for (const node of nextNodes) {
-          const override = positionOverrides.get(node.id);
-          if (!override || node.type === 'group') continue;
-          node.position = { x: override.x, y: override.y };
+  const refreshGraph = useCallback(async () => {
+    const showGraph = ({ nodes: newNodes, edges: newEdges }: QuestGraphData) => {
+      const nextNodes = [...newNodes];
+      if (questName && activeFile && !overviewQuests) {
+        const positionOverrides = getQuestNodePositions(activeFile, questName);
+        if (positionOverrides.size > 0) {
+          // Graphs may be served from the builder's cache, so never mutate its nodes
+          nextNodes.forEach((node, index) => {
+            const override = positionOverrides.get(node.id);
+            if (!override || node.type === 'group') return;
+            nextNodes[index] = { ...node, position: { x: override.x, y: override.y } };
+          });
         }
       }
+      setNodes(nextNodes);
+      setEdges(withArrowMarkers(newEdges));
+    };
+
+    let graph;
+    try {
+      // Show the nodes while a full layout is still running
+      graph = await graphClient.build(semanticModel, questName, graphOptions, overviewQuests, showGraph);
+    } catch (error) {
+      console.error('[QuestFlow] Failed to build quest graph:', error);
+      return;
     }
-    setNodes(nextNodes);
-    setEdges(newEdges);
-  }, [semanticModel, questName, graphOptions, setNodes, setEdges, activeFile, getQuestNodePositions]);
+    // A newer refresh superseded this one
+    if (!graph) return;
+
+    showGraph(graph);
+  }, [graphClient, semanticModel, questName, graphOptions, overviewQuests, setNodes, setEdges, activeFile, getQuestNodePositions]);
 
   useEffect(() => {
     const handler = setTimeout(refreshGraph, 150);
@@ -159,18 +191,21 @@ const QuestFlow: React.FC<QuestFlowProps> = ({ semanticModel, questName, writabl
   const onNodeClick = useCallback((event: React.MouseEvent, node: QuestGraphNode) => {
     if (node.type === 'group') return;
     event.preventDefault();
+    // The overview is read-only; its prefixed ids don't map to inspector commands
+    if (overviewQuests) return;
     setSelectedNodeId(node.id);
     setSelectedEdgeId(null);
     setCommandError(null);
-  }, []);
+  }, [overviewQuests]);
 
   const onNodeDoubleClick = useCallback((_: React.MouseEvent, node: QuestGraphNode) => {
     if (node.type === 'group') return;
-    const dialogName = findDialogNameForFunction(semanticModel, node.id);
+    const nodeId = parseQuestOverviewNodeId(node.id)?.nodeId ?? node.id;
+    const dialogName = findDialogNameForFunction(semanticModel, nodeId);
     if (dialogName) {
       navigateToDialog(dialogName);
     } else {
-      navigateToSymbol(node.id);
+      navigateToSymbol(nodeId);
     }
   }, [semanticModel, navigateToDialog, navigateToSymbol]);
 
@@ -261,10 +296,12 @@ const QuestFlow: React.FC<QuestFlowProps> = ({ semanticModel, questName, writabl
     const beforeEntries = await Promise.all(
       updates.map(async (entry) => {
         const stateForFile = useEditorStore.getState().getFileState(entry.filePath);
-        const modelForCode = stateForFile?.semanticModel || entry.updatedModel;
         return {
           filePath: entry.filePath,
-          code: await window.editorAPI.generateCode(modelForCode, codeSettings)
+          // The open model is what the worker already holds; the proposed one is a one-off
+          code: stateForFile
+            ? await generateCode(entry.filePath, stateForFile.semanticModel, codeSettings)
+            : await window.editorAPI.generateCode(entry.updatedModel, codeSettings)
         };
       })
     );
@@ -565,8 +602,9 @@ const QuestFlow: React.FC<QuestFlowProps> = ({ semanticModel, questName, writabl
     nodeType?: string,
     ownerFilePath?: string
   ) => {
+    if (overviewQuests) return;
     void persistNodeMove(nodeId, position, nodeType, ownerFilePath);
-  }, [persistNodeMove]);
+  }, [overviewQuests, persistNodeMove]);
 
   const handleSetMisState = useCallback(async (payload: { functionName: string; variableName: string; value: string }) => {
     await runQuestCommandWithPreview({
@@ -717,6 +755,17 @@ const QuestFlow: React.FC<QuestFlowProps> = ({ semanticModel, questName, writabl
             >
               Redo
             </Button>
+            <Button
+              size="small"
+              variant={showOverview ? 'contained' : 'text'}
+              onClick={() => {
+                setShowOverview((value) => !value);
+                setSelectedNodeId(null);
+                setSelectedEdgeId(null);
+              }}
+            >
+              {showOverview ? 'Selected quest' : 'All quests'}
+            </Button>
             {entrySurfaceNodes.length > 0 && (
               <Typography variant="caption" sx={{ alignSelf: 'center', color: '#90caf9' }}>
                 Entry surfaces: {entrySurfaceNodes.length}
@@ -3,6 +3,7 @@ import Editor, { OnMount } from '@monaco-editor/react';
 import { Box, CircularProgress, Typography, Paper, Fab, Tooltip } from '@mui/material';
 import { Save as SaveIcon } from '@mui/icons-material';
 import { useEditorStore } from '../store/editorStore';
+import { generateCode } from '../utils/modelSync';
 import type { ParseError } from '../types/global';
 
 interface SourceCodeEditorProps {
@@ -41,7 +42,7 @@ const SourceCodeEditor: React.FC<SourceCodeEditorProps> = ({ filePath }) => {
     // If dirty (visual changes), generate code from model
     if (fileState.isDirty && fileState.workingCode === undefined) {
       setIsLoading(true);
-      window.editorAPI.generateCode(fileState.semanticModel, codeSettings)
+      generateCode(filePath, fileState.semanticModel, codeSettings)
         .then((code) => {
           if (!isInternalChange.current) {
             setEditorValue(code);
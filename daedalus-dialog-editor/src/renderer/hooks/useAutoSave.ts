@@ -1,5 +1,6 @@
 import { useEffect, useRef, useState, useCallback } from 'react';
 import { useEditorStore } from '../store/editorStore';
+import { saveModel } from '../utils/modelSync';
 
 interface AutoSaveStatus {
   isAutoSaving: boolean;
@@ -48,7 +49,8 @@ export function useAutoSave(): AutoSaveStatus {
           const fileState = state.openFiles.get(filePath);
           if (fileState) {
             try {
-              const result = await window.editorAPI.saveFile(
+              // Ships only the declarations edited since this file's last save
+              const result = await saveModel(
                 filePath,
                 fileState.semanticModel,
                 state.codeSettings
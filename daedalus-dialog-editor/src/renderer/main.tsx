@@ -4,6 +4,7 @@ import { ThemeProvider } from '@mui/material/styles';
 import CssBaseline from '@mui/material/CssBaseline';
 import App from './App';
 import { mockEditorAPI } from './utils/mockAPI';
+import { initRendererTracing } from './utils/rendererTracing';
 import { themes, THEME_STORAGE_KEY, ThemeMode } from './theme';
 import { ThemeModeContext } from './themeContext';
 
@@ -12,6 +13,8 @@ if (!window.editorAPI) {
   window.editorAPI = mockEditorAPI;
 }
 
+void initRendererTracing();
+
 const getInitialTheme = (): ThemeMode => {
   const stored = localStorage.getItem(THEME_STORAGE_KEY);
   if (stored === 'light' || stored === 'dark' || stored === 'gothic') {
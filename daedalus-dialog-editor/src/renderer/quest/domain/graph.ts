@@ -1 +1,5 @@
-export { buildQuestGraph } from '../../components/QuestEditor/questGraphUtils';
+export {
+  buildQuestGraph,
+  buildQuestOverviewGraph,
+  parseQuestOverviewNodeId
+} from '../../components/QuestEditor/questGraphUtils';
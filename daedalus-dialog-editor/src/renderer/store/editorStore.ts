@@ -4,6 +4,9 @@ import { enableMapSet } from 'immer';
 import { createDialogLineId } from '../components/actionFactory';
 import { collectDialogLineActions } from '../components/nestedActionUtils';
 import { useProjectStore } from './projectStore';
+import { PARSE_CANCELLED, isParseAbortError } from '../../shared/parseJobs';
+import { traceAsync } from 'daedalus-parser/tracing';
+import { generateCode, releaseModel, saveModel, validateModel } from '../utils/modelSync';
 import type {
   SemanticModel,
   Dialog,
@@ -448,6 +451,7 @@ export const useEditorStore = create<EditorStore>()(immer((set, get) => ({
   },
 
   closeFile: (filePath: string) => {
+    releaseModel(filePath);
     set((state) => {
       state.openFiles.delete(filePath);
       state.questHistory.delete(filePath);
@@ -681,7 +685,8 @@ export const useEditorStore = create<EditorStore>()(immer((set, get) => ({
       throw new Error('File not open');
     }
 
-    const validationResult = await window.editorAPI.validateModel(
+    const validationResult = await validateModel(
+      filePath,
       fileState.semanticModel,
       state.codeSettings
     );
@@ -706,12 +711,12 @@ export const useEditorStore = create<EditorStore>()(immer((set, get) => ({
 
     try {
       // Save with validation (main process handles validation)
-      const result = await window.editorAPI.saveFile(
+      const result = await traceAsync('editor.saveFile', () => saveModel(
         filePath,
         fileState.semanticModel,
         state.codeSettings,
         { forceOnErrors: options?.forceOnErrors }
-      );
+      ), { filePath });
 
       // If validation failed and we didn't force save
       if (!result.success && result.validationResult) {
@@ -759,7 +764,7 @@ export const useEditorStore = create<EditorStore>()(immer((set, get) => ({
     }
 
     // Generate code in main process
-    return window.editorAPI.generateCode(fileState.semanticModel, state.codeSettings);
+    return generateCode(filePath, fileState.semanticModel, state.codeSettings);
   },
 
   setWorkingCode: (filePath: string, code: string | undefined) => {
@@ -782,8 +787,20 @@ export const useEditorStore = create<EditorStore>()(immer((set, get) => ({
       // 1. Write file
       await window.editorAPI.writeFile(filePath, code);
 
-      // 2. Parse and update model
-      const model = await window.editorAPI.parseSource(code);
+      // 2. Parse and update model. A newer save of the same file supersedes this parse.
+      let model: SemanticModel;
+      try {
+        model = await traceAsync(
+          'editor.saveSource.parse',
+          () => window.editorAPI.parseSource(code, { supersedeKey: `source:${filePath}` }),
+          { filePath, bytes: code.length }
+        );
+      } catch (error) {
+        if (isParseAbortError(error, PARSE_CANCELLED)) {
+          return;
+        }
+        throw error;
+      }
 
       // 3. Ensure action IDs if valid
       const processedModel = model.hasErrors ? model : ensureActionIds(model);
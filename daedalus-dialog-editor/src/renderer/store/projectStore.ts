@@ -10,12 +10,10 @@
 
 import { create } from 'zustand';
 import { enableMapSet } from 'immer';
-import type { DialogMetadata, SemanticModel } from '../types/global';
-import {
-  getCanonicalQuestKey,
-  getQuestMisVariableName,
-  isCaseInsensitiveMatch
-} from '../utils/questIdentity';
+import type { DialogMetadata, ProjectFileDelta, ProjectIndexBatch, ProjectIndexProgress, SemanticModel } from '../types/global';
+import { QuestSymbolIndex, type QuestSymbolReference } from '../utils/questSymbolIndex';
+import { ClassHierarchyIndex, instanceDeclarationsFromModel } from '../../shared/classHierarchy';
+import { beginSpan, traceAsync, traceSpan } from 'daedalus-parser/tracing';
 
 // Enable Map/Set support in Immer
 enableMapSet();
@@ -26,6 +24,22 @@ export interface ParsedFileCache {
   lastParsed: Date;
 }
 
+/**
+ * Producer/consumer index of quest symbols across `parsedFiles`. Synced by
+ * model identity, so only files whose semantic model changed are re-indexed.
+ */
+const questSymbolIndex = new QuestSymbolIndex();
+
+/**
+ * Prototype/instance hierarchy of the open project, restored from the index
+ * snapshot and updated as file models change. Classifies instances that
+ * derive from C_NPC/C_ITEM through prototypes (e.g. `Npc_Default`).
+ */
+const classHierarchy = new ClassHierarchyIndex();
+
+/** Id of the active external-change watch, if any */
+let activeWatchId: string | null = null;
+
 /** Empty semantic model factory */
 function createEmptySemanticModel(): SemanticModel {
   return {
@@ -42,6 +56,53 @@ function createEmptySemanticModel(): SemanticModel {
   };
 }
 
+function createIngestionErrorModel(message: string): SemanticModel {
+  return {
+    ...createEmptySemanticModel(),
+    hasErrors: true,
+    errors: [{
+      type: 'ingestion_error',
+      message
+    }]
+  };
+}
+
+/** Inject file path into constants and variables for tracking */
+function attachModelFilePath(semanticModel: SemanticModel, filePath: string): void {
+  if (semanticModel.constants) {
+    Object.values(semanticModel.constants).forEach(c => { c.filePath = filePath; });
+  }
+  if (semanticModel.variables) {
+    Object.values(semanticModel.variables).forEach(v => { v.filePath = filePath; });
+  }
+}
+
+/**
+ * Merge unsorted `added` names into the sorted `sorted` list. Only the new
+ * names are sorted, so streaming a project keeps each batch linear in the
+ * list size. Returns `sorted` itself when nothing is added.
+ */
+function mergeSortedNames(sorted: string[], added: string[]): string[] {
+  if (added.length === 0) {
+    return sorted;
+  }
+  const incoming = [...added].sort();
+  const merged: string[] = new Array(sorted.length + incoming.length);
+  let i = 0;
+  let j = 0;
+  let k = 0;
+  while (i < sorted.length && j < incoming.length) {
+    merged[k++] = incoming[j] < sorted[i] ? incoming[j++] : sorted[i++];
+  }
+  while (i < sorted.length) {
+    merged[k++] = sorted[i++];
+  }
+  while (j < incoming.length) {
+    merged[k++] = incoming[j++];
+  }
+  return merged;
+}
+
 interface ProjectState {
   // Project metadata
   projectPath: string | null;
@@ -65,6 +126,9 @@ interface ProjectState {
   // Loading state
   isLoading: boolean;
   loadError: string | null;
+
+  // Progress of the project index while it is being streamed in
+  indexProgress: ProjectIndexProgress | null;
   
   // Background ingestion
   isIngesting: boolean;
@@ -84,6 +148,16 @@ interface ProjectActions {
   // Close project
   closeProject: () => void;
 
+  // Follow external changes to project files (no-op without watcher support)
+  startProjectWatch: () => void;
+  stopProjectWatch: () => void;
+
+  // Apply externally changed/removed files to the index and parsed file cache
+  applyProjectChanges: (deltas: ProjectFileDelta[]) => void;
+
+  // Re-parse files and replace their cached semantic models
+  refreshFiles: (filePaths: string[]) => Promise<void>;
+
   // Select an NPC
   selectNpc: (npcId: string) => void;
 
@@ -105,6 +179,9 @@ interface ProjectActions {
   // Get usage data for a specific quest across the entire project
   getQuestUsage: (questName: string) => SemanticModel;
 
+  // Get every function writing or testing a quest symbol (TOPIC_/MIS_ name)
+  getQuestSymbolReferences: (symbol: string) => QuestSymbolReference[];
+
   // Create a new quest
   createQuest: (title: string, internalName: string, topicFilePath: string, variableFilePath: string) => Promise<void>;
 
@@ -151,20 +228,76 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
   selectedNpc: null,
   isLoading: false,
   loadError: null,
+  indexProgress: null,
   isIngesting: false,
   abortIngestion: null,
   isIngestedFilesOpen: false,
 
   // Actions
   openProject: async (folderPath: string) => {
+    get().stopProjectWatch();
     set({ isLoading: true, loadError: null });
+    const endOpenSpan = beginSpan('project.open', { folderPath });
 
     try {
       // Ensure the path is allowed in the backend (especially for recent projects)
       await window.editorAPI.addAllowedPath(folderPath);
 
-      // Build project index via IPC
-      const rawIndex = await window.editorAPI.buildProjectIndex(folderPath);
+      // Build project index via IPC, merging streamed batches as they arrive
+      // so NPCs and dialogs show up before the whole project has been indexed
+      let rawIndex;
+      if (window.editorAPI.streamProjectIndex) {
+        let indexComplete = false;
+        set({ npcList: [], dialogIndex: new Map(), indexProgress: null });
+
+        const applyBatch = (batch: ProjectIndexBatch) => {
+          if (indexComplete) {
+            return;
+          }
+          set((state) => {
+            if (batch.dialogs.length === 0 && batch.npcs.length === 0) {
+              return { indexProgress: batch.progress };
+            }
+
+            // Group first so each NPC's dialog list is copied once per batch
+            const addedByNpc = new Map<string, DialogMetadata[]>();
+            batch.dialogs.forEach((dialog) => {
+              const added = addedByNpc.get(dialog.npc);
+              if (added) {
+                added.push(dialog);
+              } else {
+                addedByNpc.set(dialog.npc, [dialog]);
+              }
+            });
+
+            const dialogIndex = new Map(state.dialogIndex);
+            addedByNpc.forEach((added, npc) => {
+              const existing = dialogIndex.get(npc);
+              dialogIndex.set(npc, existing ? existing.concat(added) : added);
+            });
+            batch.npcs.forEach((npc) => {
+              if (!dialogIndex.has(npc)) {
+                dialogIndex.set(npc, []);
+              }
+            });
+
+            return {
+              npcList: mergeSortedNames(state.npcList, batch.npcs),
+              dialogIndex,
+              indexProgress: batch.progress
+            };
+          });
+        };
+
+        try {
+          const streamProjectIndex = window.editorAPI.streamProjectIndex;
+          rawIndex = await traceAsync('project.index', () => streamProjectIndex(folderPath, applyBatch));
+        } finally {
+          indexComplete = true;
+        }
+      } else {
+        rawIndex = await traceAsync('project.index', () => window.editorAPI.buildProjectIndex(folderPath));
+      }
 
       // Convert the plain object back to Map (IPC serialization loses Map type)
       const dialogsByNpc = new Map<string, DialogMetadata[]>();
@@ -182,6 +315,8 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
         }
       }
 
+      classHierarchy.restore(rawIndex.classHierarchy);
+
       // Extract project name from path
       const pathParts = folderPath.split(/[\\/]/);
       const projectName = pathParts[pathParts.length - 1];
@@ -197,16 +332,22 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
         allDialogFiles: rawIndex.allFiles || [],
         questFiles: rawIndex.questFiles || [],
         isLoading: false,
+        indexProgress: null,
         parsedFiles: new Map(), // Clear any previous cache
         selectedNpc: null
       });
 
+      endOpenSpan({ npcs: rawIndex.npcs?.length ?? 0, files: rawIndex.allFiles?.length ?? 0 });
+
       // Start background ingestion
       get().startBackgroundIngestion();
+      get().startProjectWatch();
 
     } catch (error) {
+      endOpenSpan({ error: true });
       set({
         isLoading: false,
+        indexProgress: null,
         loadError: error instanceof Error ? error.message : 'Unknown error'
       });
     }
@@ -221,7 +362,14 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
     }
 
     const controller = new AbortController();
-    set({ isIngesting: true, abortIngestion: () => controller.abort() });
+    const ingestionId = `ingest-${Date.now()}-${Math.random().toString(36).slice(2)}`;
+    set({
+      isIngesting: true,
+      abortIngestion: () => {
+        controller.abort();
+        window.editorAPI.cancelIngestion?.(ingestionId);
+      }
+    });
 
     // Prioritize quest files, then the rest
     const priorityFiles = new Set([...questFiles]);
@@ -232,19 +380,48 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
     const pendingUpdates = new Map<string, ParsedFileCache>();
     const flushUpdates = () => {
       if (pendingUpdates.size > 0) {
-        set((state) => {
-          const newCache = new Map(state.parsedFiles);
-          pendingUpdates.forEach((value, key) => newCache.set(key, value));
-          return { parsedFiles: newCache };
-        });
+        traceSpan('project.ingest.flush', () => {
+          set((state) => {
+            const newCache = new Map(state.parsedFiles);
+            pendingUpdates.forEach((value, key) => newCache.set(key, value));
+            return { parsedFiles: newCache };
+          });
+          // Index while ingesting so switching quests afterwards is a lookup
+          questSymbolIndex.sync(get().parsedFiles);
+        }, { files: pendingUpdates.size });
         pendingUpdates.clear();
       }
     };
     
     const flushInterval = setInterval(flushUpdates, 500);
+    const endIngestSpan = beginSpan('project.ingest', { files: ingestionQueue.length });
 
     // Process in background
     try {
+      if (window.editorAPI.ingestProjectFiles) {
+        // Hand the whole queue to the main process; results arrive in chunks
+        // with file paths already attached to constants and variables
+        const { parsedFiles } = get();
+        const filesToIngest = ingestionQueue.filter(f => !parsedFiles.has(f));
+
+        await window.editorAPI.ingestProjectFiles(ingestionId, filesToIngest, (results) => {
+          if (controller.signal.aborted) return;
+
+          const lastParsed = new Date();
+          results.forEach(({ filePath, semanticModel, error }) => {
+            if (error) {
+              console.warn(`Background ingestion failed for ${filePath}:`, error);
+            }
+            pendingUpdates.set(filePath, {
+              filePath,
+              semanticModel: semanticModel ?? createIngestionErrorModel(error ?? 'Unknown error'),
+              lastParsed
+            });
+          });
+        });
+        return;
+      }
+
       // Concurrency limit for parallel ingestion
       // Increased to 20 to utilize backend worker pool (max 8 workers)
       const CONCURRENCY_LIMIT = 20;
@@ -264,14 +441,7 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
           try {
             // Parse the file directly to avoid state update in getSemanticModel
             const semanticModel = await window.editorAPI.parseDialogFile(filePath);
-
-            // Inject file path into constants and variables for tracking
-            if (semanticModel.constants) {
-              Object.values(semanticModel.constants).forEach(c => { c.filePath = filePath; });
-            }
-            if (semanticModel.variables) {
-              Object.values(semanticModel.variables).forEach(v => { v.filePath = filePath; });
-            }
+            attachModelFilePath(semanticModel, filePath);
 
             // Add to batch
             pendingUpdates.set(filePath, {
@@ -288,14 +458,7 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
             // Add error to batch
             pendingUpdates.set(filePath, {
                filePath,
-               semanticModel: {
-                 ...createEmptySemanticModel(),
-                 hasErrors: true,
-                 errors: [{
-                    type: 'ingestion_error',
-                    message: e instanceof Error ? e.message : String(e)
-                 }]
-               },
+               semanticModel: createIngestionErrorModel(e instanceof Error ? e.message : String(e)),
                lastParsed: new Date()
             });
           }
@@ -310,6 +473,7 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
       clearInterval(flushInterval);
       // Final flush
       flushUpdates();
+      endIngestSpan({ aborted: controller.signal.aborted });
       
       if (!controller.signal.aborted) {
         set({ isIngesting: false, abortIngestion: null });
@@ -323,6 +487,9 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
     if (abortIngestion) {
       abortIngestion();
     }
+    get().stopProjectWatch();
+    questSymbolIndex.clear();
+    classHierarchy.clear();
 
     set({
       projectPath: null,
@@ -334,11 +501,186 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
       mergedSemanticModel: createEmptySemanticModel(),
       selectedNpc: null,
       loadError: null,
+      indexProgress: null,
       isIngesting: false,
       abortIngestion: null
     });
   },
 
+  startProjectWatch: () => {
+    const { projectPath, stopProjectWatch } = get();
+    if (!projectPath || !window.editorAPI.watchProject) return;
+
+    stopProjectWatch();
+    const watchId = `watch-${Date.now()}-${Math.random().toString(36).slice(2)}`;
+    activeWatchId = watchId;
+
+    window.editorAPI.watchProject(
+      watchId,
+      projectPath,
+      (deltas) => {
+        // Includes lost events: the watcher reconciles them into ordinary deltas
+        if (activeWatchId === watchId) {
+          get().applyProjectChanges(deltas);
+        }
+      }
+    ).catch((error) => {
+      console.warn('Project watch ended:', error);
+    });
+  },
+
+  stopProjectWatch: () => {
+    if (activeWatchId) {
+      window.editorAPI.unwatchProject?.(activeWatchId);
+      activeWatchId = null;
+    }
+  },
+
+  applyProjectChanges: (deltas: ProjectFileDelta[]) => {
+    if (!get().projectPath || deltas.length === 0) return;
+
+    const changedPaths = new Set(deltas.map((delta) => delta.filePath));
+    const candidateNpcs = new Set<string>();
+
+    deltas.forEach(({ filePath, metadata }) => {
+      const affected = metadata
+        ? classHierarchy.setFileDeclarations(filePath, { prototypes: metadata.prototypes, instances: metadata.instances })
+        : classHierarchy.removeFile(filePath);
+      affected.forEach((name) => candidateNpcs.add(name));
+    });
+
+    const { selectedNpc, dialogIndex: previousDialogIndex } = get();
+    const selectedNpcAffected = Boolean(
+      selectedNpc && (previousDialogIndex.get(selectedNpc) || []).some((dialog) => changedPaths.has(dialog.filePath))
+    );
+
+    set((state) => {
+      // Drop dialogs of changed files; untouched NPCs keep their array identity
+      const dialogIndex = new Map<string, DialogMetadata[]>();
+      state.dialogIndex.forEach((dialogs, npc) => {
+        const kept = dialogs.filter((dialog) => !changedPaths.has(dialog.filePath));
+        if (kept.length !== dialogs.length) {
+          candidateNpcs.add(npc);
+          dialogIndex.set(npc, kept);
+        } else {
+          dialogIndex.set(npc, dialogs);
+        }
+      });
+
+      const copied = new Set<string>();
+      deltas.forEach(({ metadata }) => {
+        metadata?.dialogs.forEach((dialog) => {
+          candidateNpcs.add(dialog.npc);
+          const existing = dialogIndex.get(dialog.npc) || [];
+          if (copied.has(dialog.npc)) {
+            existing.push(dialog);
+          } else {
+            copied.add(dialog.npc);
+            dialogIndex.set(dialog.npc, [...existing, dialog]);
+          }
+        });
+      });
+
+      // Same rule as the project index: C_NPC instances plus anyone owning dialogs
+      const npcSet = new Set(state.npcList);
+      candidateNpcs.forEach((name) => {
+        const hasDialogs = (dialogIndex.get(name)?.length ?? 0) > 0;
+        if (hasDialogs || classHierarchy.getBaseClass(name) === 'C_NPC') {
+          npcSet.add(name);
+          if (!dialogIndex.has(name)) dialogIndex.set(name, []);
+        } else {
+          npcSet.delete(name);
+          dialogIndex.delete(name);
+        }
+      });
+
+      const removedPaths = new Set(deltas.filter((delta) => !delta.metadata).map((delta) => delta.filePath));
+      const knownFiles = new Set(state.allDialogFiles);
+      const addedFiles = deltas
+        .filter((delta) => delta.metadata && !knownFiles.has(delta.filePath))
+        .map((delta) => delta.filePath);
+      const allDialogFiles = removedPaths.size > 0 || addedFiles.length > 0
+        ? [...state.allDialogFiles.filter((filePath) => !removedPaths.has(filePath)), ...addedFiles]
+        : state.allDialogFiles;
+
+      const questFiles = [
+        ...state.questFiles.filter((filePath) => !changedPaths.has(filePath)),
+        ...deltas.filter((delta) => delta.metadata?.isQuestFile).map((delta) => delta.filePath)
+      ];
+
+      let parsedFiles = state.parsedFiles;
+      if (Array.from(removedPaths).some((filePath) => parsedFiles.has(filePath))) {
+        parsedFiles = new Map(parsedFiles);
+        removedPaths.forEach((filePath) => parsedFiles.delete(filePath));
+      }
+
+      return {
+        dialogIndex,
+        npcList: npcSet.size === state.npcList.length && state.npcList.every((npc) => npcSet.has(npc))
+          ? state.npcList
+          : Array.from(npcSet).sort(),
+        allDialogFiles,
+        questFiles,
+        parsedFiles,
+        selectedNpc: state.selectedNpc && npcSet.has(state.selectedNpc) ? state.selectedNpc : null
+      };
+    });
+
+    // Cached models of changed files are replaced once re-parsed; until then the old ones stay visible
+    const changedFiles = deltas.filter((delta) => delta.metadata).map((delta) => delta.filePath);
+    get().refreshFiles(changedFiles).then(() => {
+      const { selectedNpc: currentNpc } = get();
+      if (selectedNpcAffected && currentNpc && currentNpc === selectedNpc) {
+        get().loadAndMergeNpcModels(currentNpc);
+      }
+    });
+  },
+
+  refreshFiles: async (filePaths: string[]) => {
+    const { projectPath } = get();
+    if (filePaths.length === 0) return;
+
+    const lastParsed = new Date();
+    const refreshed: ParsedFileCache[] = [];
+
+    if (window.editorAPI.ingestProjectFiles) {
+      const refreshId = `refresh-${Date.now()}-${Math.random().toString(36).slice(2)}`;
+      await window.editorAPI.ingestProjectFiles(refreshId, filePaths, (results) => {
+        results.forEach(({ filePath, semanticModel, error }) => {
+          refreshed.push({
+            filePath,
+            semanticModel: semanticModel ?? createIngestionErrorModel(error ?? 'Unknown error'),
+            lastParsed
+          });
+        });
+      });
+    } else {
+      await Promise.all(filePaths.map(async (filePath) => {
+        try {
+          const semanticModel = await window.editorAPI.parseDialogFile(filePath);
+          attachModelFilePath(semanticModel, filePath);
+          refreshed.push({ filePath, semanticModel, lastParsed });
+        } catch (e) {
+          refreshed.push({
+            filePath,
+            semanticModel: createIngestionErrorModel(e instanceof Error ? e.message : String(e)),
+            lastParsed
+          });
+        }
+      }));
+    }
+
+    // Project was closed or switched meanwhile
+    if (get().projectPath !== projectPath || refreshed.length === 0) return;
+
+    set((state) => {
+      const newCache = new Map(state.parsedFiles);
+      refreshed.forEach((entry) => newCache.set(entry.filePath, entry));
+      return { parsedFiles: newCache };
+    });
+    questSymbolIndex.sync(get().parsedFiles);
+  },
+
   selectNpc: (npcId: string) => {
     set({ selectedNpc: npcId });
   },
@@ -360,14 +702,7 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
 
     // Parse file via IPC
     const semanticModel = await window.editorAPI.parseDialogFile(filePath);
-
-    // Inject file path into constants and variables for tracking
-    if (semanticModel.constants) {
-      Object.values(semanticModel.constants).forEach(c => { c.filePath = filePath; });
-    }
-    if (semanticModel.variables) {
-      Object.values(semanticModel.variables).forEach(v => { v.filePath = filePath; });
-    }
+    attachModelFilePath(semanticModel, filePath);
 
     // Cache the result
     set((state) => {
@@ -384,6 +719,7 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
   },
 
   mergeSemanticModels: (models: SemanticModel[]) => {
+    const endSpan = beginSpan('project.mergeSemanticModels', { models: models.length });
     const mergedModel: SemanticModel = createEmptySemanticModel();
 
     const modelsWithErrors = models.filter(model => model?.hasErrors);
@@ -425,7 +761,18 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
       }
     });
 
+    // The parser only sees direct C_NPC/C_ITEM parents; resolve prototype chains project-wide
+    Object.values(mergedModel.instances!).forEach((instance) => {
+      const baseClass = classHierarchy.getBaseClass(instance.name);
+      if (baseClass === 'C_NPC' && !mergedModel.npcs![instance.name]) {
+        mergedModel.npcs![instance.name] = instance;
+      } else if (baseClass === 'C_ITEM' && !mergedModel.items![instance.name]) {
+        mergedModel.items![instance.name] = instance;
+      }
+    });
+
     set({ mergedSemanticModel: mergedModel });
+    endSpan();
   },
 
   loadQuestData: async () => {
@@ -441,121 +788,13 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
   },
 
   getQuestUsage: (questName: string) => {
-    const { parsedFiles } = get();
-    const result = createEmptySemanticModel();
-    const misVarName = getQuestMisVariableName(questName);
-    const relevantFunctionKeys = new Set<string>();
-    const functionLookup = new Map<string, { name: string; func: any; filePath: string }>();
-
-    // Pass 1: Identify all relevant functions and add definitions
-    for (const [filePath, fileData] of parsedFiles.entries()) {
-        const model = fileData.semanticModel;
-
-        // Constants & Variables
-        const topicKey = Object.keys(model.constants || {}).find((key) => isCaseInsensitiveMatch(key, questName));
-        if (topicKey && model.constants) {
-             result.constants = result.constants || {};
-             result.constants[topicKey] = model.constants[topicKey];
-        }
-        const misKey = Object.keys(model.variables || {}).find((key) => isCaseInsensitiveMatch(key, misVarName));
-        if (misKey && model.variables) {
-             result.variables = result.variables || {};
-             result.variables[misKey] = model.variables[misKey];
-        }
-
-        // Functions
-        if (model.functions) {
-             Object.values(model.functions).forEach((func) => {
-                 const funcKey = getCanonicalQuestKey(func.name);
-                 if (!functionLookup.has(funcKey)) {
-                     functionLookup.set(funcKey, {
-                         name: func.name,
-                         func,
-                         filePath: func.filePath || filePath
-                     });
-                 }
-             });
-
-             Object.values(model.functions).forEach(func => {
-                 let isRelevant = false;
-
-                 // Check Actions
-                 if (func.actions) {
-                     for (const action of func.actions) {
-                         // Topic references
-                         if ('topic' in action && isCaseInsensitiveMatch(action.topic, questName)) {
-                             isRelevant = true;
-                             break;
-                         }
-                         // Explicit MIS writers (writer-only quest handlers)
-                         if (action.type === 'SetVariableAction' && isCaseInsensitiveMatch(action.variableName, misVarName)) {
-                             isRelevant = true;
-                             break;
-                         }
-                     }
-                 }
-
-                 // Check Conditions
-                 if (!isRelevant && func.conditions) {
-                     for (const cond of func.conditions) {
-                         if ('variableName' in cond && isCaseInsensitiveMatch(cond.variableName, misVarName)) {
-                             isRelevant = true;
-                             break;
-                         }
-                     }
-                 }
-
-                 if (isRelevant) {
-                     relevantFunctionKeys.add(getCanonicalQuestKey(func.name));
-                     result.functions[func.name] = {
-                       ...func,
-                       filePath: func.filePath || filePath
-                     };
-                 }
-             });
-        }
-    }
-
-    // Pass 2: Identify dialogs that use relevant functions and include one-hop linked condition functions.
-    for (const fileData of parsedFiles.values()) {
-        const model = fileData.semanticModel;
-
-        if (model.dialogs) {
-            Object.values(model.dialogs).forEach(dialog => {
-                const info = dialog.properties.information;
-                const cond = dialog.properties.condition;
-
-                const infoName = typeof info === 'string' ? info : (typeof info === 'object' ? info.name : null);
-                const condName = typeof cond === 'string' ? cond : (typeof cond === 'object' ? cond.name : null);
-                const infoKey = infoName ? getCanonicalQuestKey(infoName) : null;
-                const condKey = condName ? getCanonicalQuestKey(condName) : null;
-                const infoIsRelevant = Boolean(infoKey && relevantFunctionKeys.has(infoKey));
-
-                // One-hop closure: include linked condition functions for already relevant dialog info functions.
-                if (infoIsRelevant && condName && condKey && !relevantFunctionKeys.has(condKey)) {
-                    const linkedConditionFunc = functionLookup.get(condKey);
-                    if (linkedConditionFunc) {
-                        relevantFunctionKeys.add(condKey);
-                        result.functions[linkedConditionFunc.name] = {
-                            ...linkedConditionFunc.func,
-                            filePath: linkedConditionFunc.func.filePath || linkedConditionFunc.filePath
-                        };
-                    }
-                }
-
-                const dialogUsesRelevantFunction = Boolean(
-                    (infoKey && relevantFunctionKeys.has(infoKey)) ||
-                    (condKey && relevantFunctionKeys.has(condKey))
-                );
-
-                if (dialogUsesRelevantFunction) {
-                    result.dialogs[dialog.name] = dialog;
-                }
-            });
-        }
-    }
+    questSymbolIndex.sync(get().parsedFiles);
+    return questSymbolIndex.getQuestUsage(questName, createEmptySemanticModel);
+  },
 
-    return result;
+  getQuestSymbolReferences: (symbol: string) => {
+    questSymbolIndex.sync(get().parsedFiles);
+    return questSymbolIndex.getReferences(symbol);
   },
 
   createQuest: async (title: string, internalName: string, topicFilePath: string, variableFilePath: string) => {
@@ -784,6 +1023,7 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
   },
 
   clearCache: () => {
+    questSymbolIndex.clear();
     set({ parsedFiles: new Map() });
   },
 
@@ -800,6 +1040,13 @@ export const useProjectStore = create<ProjectStore>((set, get) => ({
     });
     
     set({ parsedFiles: newCache });
+    questSymbolIndex.updateFile(filePath, model);
+
+    // Prototypes aren't part of the semantic model; keep the ones the index already knows
+    classHierarchy.setFileDeclarations(filePath, {
+      prototypes: classHierarchy.getFileDeclarations(filePath)?.prototypes ?? [],
+      instances: instanceDeclarationsFromModel(model)
+    });
   },
 
   addDialogToIndex: (metadata: DialogMetadata) => {
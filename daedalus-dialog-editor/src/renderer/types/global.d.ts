@@ -8,6 +8,11 @@
 export type {
   DialogMetadata,
   ProjectIndex,
+  ProjectIndexBatch,
+  ProjectIndexProgress,
+  IngestedFileResult,
+  ProjectFileDelta,
+  ProjectFileMetadata,
   CodeGenerationSettings,
   DialogLineAction,
   ChoiceAction,
@@ -63,11 +68,17 @@ import type {
   SemanticModel,
   CodeGenerationSettings,
   ProjectIndex,
+  ProjectIndexBatch,
+  IngestedFileResult,
+  ProjectFileDelta,
   ValidationResult,
   ValidationOptions,
   SaveResult,
   RecentProject
 } from '../../shared/types';
+import type { ParseRequestOptions } from '../../shared/parseJobs';
+import type { TraceEvent } from 'daedalus-parser/tracing';
+import type { ModelDelta, ModelDeltaSaveResult, ModelTask, ModelTaskResult } from '../../shared/modelDelta';
 
 // ============================================================================
 // Editor API (renderer-specific)
@@ -80,7 +91,7 @@ export interface SaveOptions {
 
 export interface EditorAPI {
   // Parser API - runs in main process (has access to native modules)
-  parseSource: (sourceCode: string) => Promise<SemanticModel>;
+  parseSource: (sourceCode: string, options?: ParseRequestOptions) => Promise<SemanticModel>;
 
   // Validation API - validates model before saving
   validateModel: (model: SemanticModel, settings: CodeGenerationSettings, options?: ValidationOptions) => Promise<ValidationResult>;
@@ -89,6 +100,11 @@ export interface EditorAPI {
   generateCode: (model: SemanticModel, settings: CodeGenerationSettings) => Promise<string>;
   generateDialogCode: (model: SemanticModel, dialogName: string, settings: CodeGenerationSettings) => Promise<string>;
   saveFile: (filePath: string, model: SemanticModel, settings: CodeGenerationSettings, options?: SaveOptions) => Promise<SaveResult>;
+  // Delta saves against the main process copy of the model (see utils/modelSync)
+  saveModelDelta?: (filePath: string, delta: ModelDelta, settings: CodeGenerationSettings, options?: SaveOptions) => Promise<ModelDeltaSaveResult>;
+  // Previews and validation against the same copy (see utils/modelSync)
+  runModelTask?: (filePath: string, delta: ModelDelta, task: ModelTask) => Promise<ModelTaskResult>;
+  releaseModel?: (filePath: string) => void;
 
   // File I/O API
   readFile: (filePath: string) => Promise<string>;
@@ -99,12 +115,29 @@ export interface EditorAPI {
   // Project API
   openProjectFolderDialog: () => Promise<string | null>;
   buildProjectIndex: (folderPath: string) => Promise<ProjectIndex>;
+  streamProjectIndex?: (folderPath: string, onBatch: (batch: ProjectIndexBatch) => void) => Promise<ProjectIndex>;
   parseDialogFile: (filePath: string) => Promise<SemanticModel>;
+  ingestProjectFiles?: (
+    ingestionId: string,
+    filePaths: string[],
+    onResults: (results: IngestedFileResult[], processedFiles: number, totalFiles: number) => void
+  ) => Promise<{ processedFiles: number; cancelled: boolean }>;
+  cancelIngestion?: (ingestionId: string) => void;
+  watchProject?: (
+    watchId: string,
+    folderPath: string,
+    onChanges: (deltas: ProjectFileDelta[]) => void
+  ) => Promise<void>;
+  unwatchProject?: (watchId: string) => void;
   addAllowedPath: (folderPath: string) => Promise<void>;
 
   // Settings API
   getRecentProjects: () => Promise<RecentProject[]>;
   addRecentProject: (projectPath: string, projectName: string) => Promise<void>;
+
+  // Tracing API (DAEDALUS_TRACE): renderer spans are forwarded to the main process trace
+  getTraceConfig?: () => Promise<{ enabled: boolean }>;
+  recordTraceEvents?: (events: TraceEvent[]) => void;
 }
 
 declare global {
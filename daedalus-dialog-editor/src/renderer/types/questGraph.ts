@@ -1,5 +1,5 @@
 import type { Edge, Node } from 'reactflow';
-import type { DialogCondition } from './global';
+import type { DialogCondition, SemanticModel } from './global';
 
 export type QuestGraphNodeKind =
   | 'topic'
@@ -93,3 +93,33 @@ export interface QuestGraphData {
   edges: QuestGraphEdge[];
 }
 
+
+/**
+ * Changes to the slice of the semantic model the quest graph reads.
+ * Entries are replaced by name; `reset` discards the previous model.
+ */
+export interface QuestGraphModelPatch {
+  reset: boolean;
+  dialogs?: SemanticModel['dialogs'];
+  removedDialogs?: string[];
+  functions?: SemanticModel['functions'];
+  removedFunctions?: string[];
+  variables?: SemanticModel['variables'];
+}
+
+export type QuestGraphWorkerRequest = {
+  type: 'build';
+  requestId: number;
+  patch: QuestGraphModelPatch;
+  questName: string | null;
+  options?: QuestGraphBuildOptions;
+  /** When set, build the all-quests overview for these quests instead */
+  overviewQuests?: string[];
+};
+
+export type QuestGraphWorkerResponse =
+  | { type: 'result'; requestId: number; graph: QuestGraphData }
+  /** The graph before a full layout, with provisional positions; the result follows */
+  | { type: 'partial'; requestId: number; graph: QuestGraphData }
+  | { type: 'superseded'; requestId: number }
+  | { type: 'error'; requestId: number; message: string };
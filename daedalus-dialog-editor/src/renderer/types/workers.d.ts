@@ -0,0 +1,7 @@
+// Vite `?worker` imports resolve to a constructor for a dedicated worker
+declare module '*?worker' {
+  const WorkerFactory: {
+    new (): Worker;
+  };
+  export default WorkerFactory;
+}
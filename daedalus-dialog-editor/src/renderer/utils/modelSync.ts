@@ -0,0 +1,156 @@
+import type {
+  CodeGenerationSettings,
+  EditorAPI,
+  SaveOptions,
+  SaveResult,
+  SemanticModel,
+  ValidationOptions,
+  ValidationResult
+} from '../types/global';
+import { diffModels, type ModelDelta, type ModelTask } from '../../shared/modelDelta';
+
+interface SyncedModel {
+  version: number;
+  /** The model as the main process last received it */
+  model: SemanticModel;
+}
+
+// Per file: what the main process holds, and the request currently in flight
+const syncedModels = new Map<string, SyncedModel>();
+const requestChains = new Map<string, Promise<unknown>>();
+
+/**
+ * Save a model, sending the main process only the declarations changed since
+ * the previous request for the file. The first request for a file, and any
+ * request after the two sides got out of step, sends the full model. Falls
+ * back to a whole-model save when the API has no delta support (browser mock).
+ *
+ * Saves, previews and validations of one file are serialized so each delta
+ * builds on the last.
+ */
+export function saveModel(
+  filePath: string,
+  model: SemanticModel,
+  settings: CodeGenerationSettings,
+  options?: SaveOptions,
+  api: EditorAPI = window.editorAPI
+): Promise<SaveResult> {
+  if (!api.saveModelDelta) {
+    return options ? api.saveFile(filePath, model, settings, options) : api.saveFile(filePath, model, settings);
+  }
+
+  const saveModelDelta = api.saveModelDelta;
+  return enqueue(filePath, async () => {
+    const { needsFullModel: _needsFullModel, ...saveResult } = await sendModel(filePath, model, (delta) =>
+      saveModelDelta(filePath, delta, settings, options));
+    return saveResult;
+  });
+}
+
+/**
+ * Generate the code of an open file. Like saves, only changed declarations
+ * cross IPC, and the codegen worker regenerates only those.
+ */
+export function generateCode(
+  filePath: string,
+  model: SemanticModel,
+  settings: CodeGenerationSettings,
+  api: EditorAPI = window.editorAPI
+): Promise<string> {
+  return runModelTask(filePath, model, { type: 'generateCode', settings }, api,
+    () => api.generateCode(model, settings));
+}
+
+/** Generate one dialog of an open file and its functions; see generateCode */
+export function generateDialogCode(
+  filePath: string,
+  model: SemanticModel,
+  dialogName: string,
+  settings: CodeGenerationSettings,
+  api: EditorAPI = window.editorAPI
+): Promise<string> {
+  return runModelTask(filePath, model, { type: 'generateDialogCode', dialogName, settings }, api,
+    () => api.generateDialogCode(model, dialogName, settings));
+}
+
+/** Validate an open file's model; see generateCode */
+export function validateModel(
+  filePath: string,
+  model: SemanticModel,
+  settings: CodeGenerationSettings,
+  options?: ValidationOptions,
+  api: EditorAPI = window.editorAPI
+): Promise<ValidationResult> {
+  return runModelTask(filePath, model, { type: 'validate', settings, options }, api,
+    () => api.validateModel(model, settings, options));
+}
+
+/** Forget a closed file here and in the main process */
+export function releaseModel(filePath: string, api: EditorAPI = window.editorAPI): void {
+  if (syncedModels.delete(filePath)) {
+    api.releaseModel?.(filePath);
+  }
+}
+
+function runModelTask<T>(
+  filePath: string,
+  model: SemanticModel,
+  task: ModelTask,
+  api: EditorAPI,
+  fallback: () => Promise<T>
+): Promise<T> {
+  if (!api.runModelTask) {
+    return fallback();
+  }
+
+  const run = api.runModelTask;
+  return enqueue(filePath, async () => {
+    const { result } = await sendModel(filePath, model, (delta) => run(filePath, delta, task));
+    return result as T;
+  });
+}
+
+/** Run `request` once the file's earlier requests have settled */
+function enqueue<T>(filePath: string, request: () => Promise<T>): Promise<T> {
+  const previous = requestChains.get(filePath);
+  const run = (previous ? previous.catch(() => undefined) : Promise.resolve()).then(request);
+
+  requestChains.set(filePath, run);
+  const cleanup = () => {
+    if (requestChains.get(filePath) === run) {
+      requestChains.delete(filePath);
+    }
+  };
+  run.then(cleanup, cleanup);
+  return run;
+}
+
+/**
+ * Send `model` as a delta against what the main process holds for the file,
+ * and the full model when it asks for it
+ */
+async function sendModel<R extends { needsFullModel?: boolean }>(
+  filePath: string,
+  model: SemanticModel,
+  send: (delta: ModelDelta) => Promise<R>
+): Promise<R> {
+  const base = syncedModels.get(filePath);
+  const version = (base?.version ?? 0) + 1;
+  const fullDelta: ModelDelta = { baseVersion: 0, version, full: model };
+  const delta: ModelDelta = base
+    ? { baseVersion: base.version, version, ...diffModels(base.model, model) }
+    : fullDelta;
+
+  try {
+    let result = await send(delta);
+    if (result.needsFullModel) {
+      result = await send(fullDelta);
+    }
+    syncedModels.set(filePath, { version, model });
+    return result;
+  } catch (error) {
+    // The main process may or may not have applied the delta; resync on the next request
+    syncedModels.delete(filePath);
+    throw error;
+  }
+}
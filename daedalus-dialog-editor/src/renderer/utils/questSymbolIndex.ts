@@ -0,0 +1,357 @@
+/**
+ * Quest symbol index - project-wide producer/consumer lookup for quest symbols
+ *
+ * For every topic and variable referenced by a function (TOPIC_* via Log_*
+ * actions, MIS_* via assignments and conditions) the index records which
+ * functions write or test it, per file. Files are re-indexed only when their
+ * semantic model object changes, so keeping the index in sync with the parsed
+ * file cache costs one reference comparison per file.
+ */
+
+import type { Dialog, DialogFunction, SemanticModel } from '../types/global';
+import { getCanonicalQuestKey, getQuestMisVariableName } from './questIdentity';
+
+export interface QuestSymbolReference {
+  functionName: string;
+  filePath: string;
+  /** `writes` for actions that set/update the symbol, `reads` for conditions testing it */
+  role: 'writes' | 'reads';
+  /** Action or condition type that produced the reference */
+  via: string;
+  operator?: string;
+  value?: string;
+}
+
+interface IndexedFunction {
+  key: string;
+  func: DialogFunction;
+  filePath: string;
+  ordinal: number;
+}
+
+interface IndexedDialog {
+  dialog: Dialog;
+  infoKey: string | null;
+  condKey: string | null;
+  filePath: string;
+  ordinal: number;
+}
+
+interface FileRecord {
+  model: SemanticModel;
+  functions: IndexedFunction[];
+  dialogs: IndexedDialog[];
+  referencesBySymbol: Map<string, QuestSymbolReference[]>;
+  functionsBySymbol: Map<string, IndexedFunction[]>;
+  constantNames: Map<string, string>;
+  variableNames: Map<string, string>;
+}
+
+export interface ParsedFileModelSource {
+  semanticModel: SemanticModel;
+}
+
+const getFunctionRefKey = (ref: unknown): string | null => {
+  if (typeof ref === 'string') return getCanonicalQuestKey(ref);
+  if (ref && typeof ref === 'object' && typeof (ref as { name?: unknown }).name === 'string') {
+    return getCanonicalQuestKey((ref as { name: string }).name);
+  }
+  return null;
+};
+
+const addToListMap = <K, V>(map: Map<K, V[]>, key: K, value: V) => {
+  const list = map.get(key);
+  if (list) {
+    list.push(value);
+  } else {
+    map.set(key, [value]);
+  }
+};
+
+const indexFile = (filePath: string, model: SemanticModel): FileRecord => {
+  const record: FileRecord = {
+    model,
+    functions: [],
+    dialogs: [],
+    referencesBySymbol: new Map(),
+    functionsBySymbol: new Map(),
+    constantNames: new Map(),
+    variableNames: new Map()
+  };
+
+  // First declaration per canonical name wins, as with a case-insensitive find()
+  Object.keys(model.constants || {}).forEach((name) => {
+    const key = getCanonicalQuestKey(name);
+    if (!record.constantNames.has(key)) record.constantNames.set(key, name);
+  });
+  Object.keys(model.variables || {}).forEach((name) => {
+    const key = getCanonicalQuestKey(name);
+    if (!record.variableNames.has(key)) record.variableNames.set(key, name);
+  });
+
+  Object.values(model.functions || {}).forEach((func, ordinal) => {
+    const indexed: IndexedFunction = { key: getCanonicalQuestKey(func.name), func, filePath, ordinal };
+    record.functions.push(indexed);
+
+    const symbols = new Set<string>();
+    const addReference = (symbol: string, reference: Omit<QuestSymbolReference, 'functionName' | 'filePath'>) => {
+      const symbolKey = getCanonicalQuestKey(symbol);
+      symbols.add(symbolKey);
+      addToListMap(record.referencesBySymbol, symbolKey, { functionName: func.name, filePath, ...reference });
+    };
+
+    func.actions?.forEach((action) => {
+      if ('topic' in action && action.topic) {
+        addReference(String(action.topic), {
+          role: 'writes',
+          via: action.type,
+          value: action.type === 'LogSetTopicStatus' ? String(action.status) : undefined
+        });
+      }
+      if (action.type === 'SetVariableAction' && action.variableName) {
+        addReference(action.variableName, {
+          role: 'writes',
+          via: action.type,
+          operator: action.operator,
+          value: String(action.value)
+        });
+      }
+    });
+
+    func.conditions?.forEach((condition) => {
+      if ('variableName' in condition && condition.variableName) {
+        addReference(condition.variableName, {
+          role: 'reads',
+          via: condition.type,
+          operator: 'operator' in condition ? String(condition.operator) : undefined,
+          value: 'value' in condition ? String(condition.value) : undefined
+        });
+      }
+    });
+
+    symbols.forEach((symbolKey) => addToListMap(record.functionsBySymbol, symbolKey, indexed));
+  });
+
+  Object.values(model.dialogs || {}).forEach((dialog, ordinal) => {
+    record.dialogs.push({
+      dialog,
+      infoKey: getFunctionRefKey(dialog.properties?.information),
+      condKey: getFunctionRefKey(dialog.properties?.condition),
+      filePath,
+      ordinal
+    });
+  });
+
+  return record;
+};
+
+export class QuestSymbolIndex {
+  private readonly files = new Map<string, FileRecord>();
+  private readonly functionsByKey = new Map<string, Map<string, IndexedFunction>>();
+  private readonly dialogsByFunctionKey = new Map<string, Set<IndexedDialog>>();
+  private fileOrder = new Map<string, number>();
+
+  /**
+   * Bring the index in line with `parsedFiles`: re-index files whose model
+   * object changed, drop files that disappeared, and adopt the map's order.
+   */
+  sync(parsedFiles: ReadonlyMap<string, ParsedFileModelSource>): void {
+    for (const filePath of Array.from(this.files.keys())) {
+      if (!parsedFiles.has(filePath)) {
+        this.removeFile(filePath);
+      }
+    }
+
+    const fileOrder = new Map<string, number>();
+    let position = 0;
+    parsedFiles.forEach((entry, filePath) => {
+      fileOrder.set(filePath, position++);
+      if (this.files.get(filePath)?.model !== entry.semanticModel) {
+        this.updateFile(filePath, entry.semanticModel);
+      }
+    });
+    this.fileOrder = fileOrder;
+  }
+
+  updateFile(filePath: string, model: SemanticModel): void {
+    this.removeFile(filePath);
+
+    const record = indexFile(filePath, model);
+    this.files.set(filePath, record);
+    if (!this.fileOrder.has(filePath)) {
+      this.fileOrder.set(filePath, this.fileOrder.size);
+    }
+
+    record.functions.forEach((indexed) => {
+      let byFile = this.functionsByKey.get(indexed.key);
+      if (!byFile) {
+        byFile = new Map();
+        this.functionsByKey.set(indexed.key, byFile);
+      }
+      if (!byFile.has(filePath)) {
+        byFile.set(filePath, indexed);
+      }
+    });
+
+    record.dialogs.forEach((indexed) => {
+      [indexed.infoKey, indexed.condKey].forEach((key) => {
+        if (!key) return;
+        let dialogs = this.dialogsByFunctionKey.get(key);
+        if (!dialogs) {
+          dialogs = new Set();
+          this.dialogsByFunctionKey.set(key, dialogs);
+        }
+        dialogs.add(indexed);
+      });
+    });
+  }
+
+  removeFile(filePath: string): void {
+    const record = this.files.get(filePath);
+    if (!record) return;
+
+    record.functions.forEach((indexed) => {
+      const byFile = this.functionsByKey.get(indexed.key);
+      if (byFile?.get(filePath) === indexed) {
+        byFile.delete(filePath);
+        if (byFile.size === 0) this.functionsByKey.delete(indexed.key);
+      }
+    });
+
+    record.dialogs.forEach((indexed) => {
+      [indexed.infoKey, indexed.condKey].forEach((key) => {
+        if (!key) return;
+        const dialogs = this.dialogsByFunctionKey.get(key);
+        dialogs?.delete(indexed);
+        if (dialogs && dialogs.size === 0) this.dialogsByFunctionKey.delete(key);
+      });
+    });
+
+    this.files.delete(filePath);
+  }
+
+  clear(): void {
+    this.files.clear();
+    this.functionsByKey.clear();
+    this.dialogsByFunctionKey.clear();
+    this.fileOrder = new Map();
+  }
+
+  /**
+   * All writers and readers of `symbol` (case-insensitive), in project order.
+   */
+  getReferences(symbol: string): QuestSymbolReference[] {
+    const symbolKey = getCanonicalQuestKey(symbol);
+    const references: QuestSymbolReference[] = [];
+    this.forEachFileInOrder((record) => {
+      const fileReferences = record.referencesBySymbol.get(symbolKey);
+      if (fileReferences) references.push(...fileReferences);
+    });
+    return references;
+  }
+
+  /**
+   * Slice of the project relevant to one quest: its topic constant, MIS
+   * variable, every function writing or testing either, the dialogs using
+   * those functions and their linked condition functions.
+   */
+  getQuestUsage(questName: string, createEmptyModel: () => SemanticModel): SemanticModel {
+    const result = createEmptyModel();
+    const topicKey = getCanonicalQuestKey(questName);
+    const misKey = getCanonicalQuestKey(getQuestMisVariableName(questName));
+    const relevantFunctionKeys = new Set<string>();
+
+    this.forEachFileInOrder((record, filePath) => {
+      const topicName = record.constantNames.get(topicKey);
+      if (topicName) {
+        result.constants = result.constants || {};
+        result.constants[topicName] = record.model.constants![topicName];
+      }
+      const misName = record.variableNames.get(misKey);
+      if (misName) {
+        result.variables = result.variables || {};
+        result.variables[misName] = record.model.variables![misName];
+      }
+
+      const relevant = [
+        ...(record.functionsBySymbol.get(topicKey) || []),
+        ...(topicKey === misKey ? [] : record.functionsBySymbol.get(misKey) || [])
+      ].sort((left, right) => left.ordinal - right.ordinal);
+
+      let previous: IndexedFunction | null = null;
+      relevant.forEach((indexed) => {
+        if (indexed === previous) return;
+        previous = indexed;
+        relevantFunctionKeys.add(indexed.key);
+        result.functions[indexed.func.name] = {
+          ...indexed.func,
+          filePath: indexed.func.filePath || filePath
+        };
+      });
+    });
+
+    // Candidate dialogs: those referencing a relevant function, plus those
+    // reachable through linked condition functions. This over-approximates;
+    // the ordered replay below decides what is actually included.
+    const candidates = new Set<IndexedDialog>();
+    const pendingKeys = Array.from(relevantFunctionKeys);
+    const visitedKeys = new Set(pendingKeys);
+    while (pendingKeys.length > 0) {
+      const key = pendingKeys.pop()!;
+      this.dialogsByFunctionKey.get(key)?.forEach((indexed) => {
+        candidates.add(indexed);
+        if (indexed.infoKey && visitedKeys.has(indexed.infoKey) && indexed.condKey && !visitedKeys.has(indexed.condKey)) {
+          visitedKeys.add(indexed.condKey);
+          pendingKeys.push(indexed.condKey);
+        }
+      });
+    }
+
+    const orderedCandidates = Array.from(candidates).sort((left, right) => (
+      (this.fileOrder.get(left.filePath) ?? 0) - (this.fileOrder.get(right.filePath) ?? 0) ||
+      left.ordinal - right.ordinal
+    ));
+
+    orderedCandidates.forEach(({ dialog, infoKey, condKey }) => {
+      const infoIsRelevant = Boolean(infoKey && relevantFunctionKeys.has(infoKey));
+
+      if (infoIsRelevant && condKey && !relevantFunctionKeys.has(condKey)) {
+        const linkedConditionFunc = this.findFunction(condKey);
+        if (linkedConditionFunc) {
+          relevantFunctionKeys.add(condKey);
+          result.functions[linkedConditionFunc.func.name] = {
+            ...linkedConditionFunc.func,
+            filePath: linkedConditionFunc.func.filePath || linkedConditionFunc.filePath
+          };
+        }
+      }
+
+      if ((infoKey && relevantFunctionKeys.has(infoKey)) || (condKey && relevantFunctionKeys.has(condKey))) {
+        result.dialogs[dialog.name] = dialog;
+      }
+    });
+
+    return result;
+  }
+
+  /** First definition of a function in project order */
+  private findFunction(key: string): IndexedFunction | null {
+    const byFile = this.functionsByKey.get(key);
+    if (!byFile) return null;
+
+    let best: IndexedFunction | null = null;
+    byFile.forEach((indexed, filePath) => {
+      if (!best || (this.fileOrder.get(filePath) ?? 0) < (this.fileOrder.get(best.filePath) ?? 0)) {
+        best = indexed;
+      }
+    });
+    return best;
+  }
+
+  private forEachFileInOrder(callback: (record: FileRecord, filePath: string) => void): void {
+    const ordered = Array.from(this.files.keys()).sort(
+      (left, right) => (this.fileOrder.get(left) ?? 0) - (this.fileOrder.get(right) ?? 0)
+    );
+    ordered.forEach((filePath) => callback(this.files.get(filePath)!, filePath));
+  }
+}
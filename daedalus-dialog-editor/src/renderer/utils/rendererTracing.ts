@@ -0,0 +1,35 @@
+import type { EditorAPI } from '../types/global';
+import { drainTraceEvents, enableTracing } from 'daedalus-parser/tracing';
+
+// Renderer spans are shipped to the main process, which writes the session trace
+const FLUSH_INTERVAL_MS = 1000;
+
+/**
+ * Turn on renderer tracing when the main process records a trace
+ * (DAEDALUS_TRACE). Returns a function that stops forwarding.
+ */
+export async function initRendererTracing(api: EditorAPI = window.editorAPI): Promise<() => void> {
+  if (!api.getTraceConfig || !api.recordTraceEvents) {
+    return () => undefined;
+  }
+  const { enabled } = await api.getTraceConfig();
+  if (!enabled) {
+    return () => undefined;
+  }
+
+  enableTracing({ threadName: 'renderer' });
+  const flush = () => {
+    const events = drainTraceEvents();
+    if (events.length > 0) {
+      api.recordTraceEvents!(events);
+    }
+  };
+  const interval = window.setInterval(flush, FLUSH_INTERVAL_MS);
+  window.addEventListener('beforeunload', flush);
+
+  return () => {
+    window.clearInterval(interval);
+    window.removeEventListener('beforeunload', flush);
+    flush();
+  };
+}
@@ -0,0 +1,322 @@
+/**
+ * ClassHierarchyIndex - project-wide prototype/instance inheritance index
+ *
+ * Daedalus types form a forest rooted at engine classes (C_NPC, C_ITEM,
+ * C_INFO, ...); prototypes and instances hang below them, usually several
+ * levels deep (`instance BAU_900 (Npc_Default)`). The index keeps the parent
+ * edges per file and memoizes each type's ancestor chain, so classifying an
+ * instance is a map lookup. Replacing a file's declarations only invalidates
+ * the memoized chains below the types that file declares.
+ */
+
+import type { ClassHierarchySnapshot, FileTypeDeclarations, SemanticModel, TypeDeclaration } from './types';
+
+interface DeclarationEntry {
+  name: string;
+  parentKey: string;
+  isInstance: boolean;
+  filePath: string;
+  line: number;
+}
+
+const EMPTY_ANCESTORS: readonly string[] = [];
+
+function normalizeTypeName(value: string): string {
+  return value.trim().toUpperCase();
+}
+
+/**
+ * Order of redefinitions of one type: by file path, then source line. The
+ * last entry is effective, as a later definition overrides an earlier one,
+ * and the result does not depend on the order files are registered in.
+ */
+function compareEntries(a: DeclarationEntry, b: DeclarationEntry): number {
+  if (a.filePath !== b.filePath) {
+    return a.filePath < b.filePath ? -1 : 1;
+  }
+  return a.line - b.line;
+}
+
+const copyDeclaration = ({ name, parent, line }: TypeDeclaration): TypeDeclaration =>
+  (line === undefined ? { name, parent } : { name, parent, line });
+
+/**
+ * Instance declarations of a semantic model, matching what the metadata
+ * extraction at project open reports for the same source: every `instance`,
+ * dialogs included. Prototypes are not part of semantic models.
+ */
+export function instanceDeclarationsFromModel(model: SemanticModel): TypeDeclaration[] {
+  const declarations: TypeDeclaration[] = [];
+  Object.values(model.dialogs || {}).forEach((dialog) => {
+    if (dialog.parent) {
+      declarations.push({ name: dialog.name, parent: dialog.parent });
+    }
+  });
+  Object.values(model.instances || {}).forEach((instance) => {
+    if (instance.parent) {
+      declarations.push(copyDeclaration({
+        name: instance.name,
+        parent: instance.parent,
+        line: instance.position?.startLine
+      }));
+    }
+  });
+  return declarations;
+}
+
+export class ClassHierarchyIndex {
+  private readonly files = new Map<string, FileTypeDeclarations>();
+  /** Declarations per type in `compareEntries` order; the last one is effective */
+  private readonly declarations = new Map<string, DeclarationEntry[]>();
+  /** Types (prototypes and instances) whose effective parent is the key */
+  private readonly children = new Map<string, Set<string>>();
+  /** Memoized ancestor chains, nearest parent first, ending at the root class */
+  private readonly ancestorCache = new Map<string, readonly string[]>();
+
+  static fromSnapshot(snapshot: ClassHierarchySnapshot | null | undefined): ClassHierarchyIndex {
+    const index = new ClassHierarchyIndex();
+    index.restore(snapshot);
+    return index;
+  }
+
+  /** Replace the whole index with a snapshot; unknown versions leave it empty */
+  restore(snapshot: ClassHierarchySnapshot | null | undefined): void {
+    this.clear();
+    if (snapshot?.version !== 1) {
+      return;
+    }
+    Object.entries(snapshot.files).forEach(([filePath, declarations]) => {
+      this.setFileDeclarations(filePath, declarations);
+    });
+  }
+
+  toSnapshot(): ClassHierarchySnapshot {
+    const files: Record<string, FileTypeDeclarations> = {};
+    this.files.forEach((declarations, filePath) => {
+      files[filePath] = declarations;
+    });
+    return { version: 1, files };
+  }
+
+  /**
+   * Replace everything `filePath` declares.
+   *
+   * Returns the names of instances whose ancestor chain may have changed,
+   * including instances declared in other files below a changed prototype.
+   */
+  setFileDeclarations(filePath: string, declarations: FileTypeDeclarations): string[] {
+    const touched = new Set<string>();
+    this.detachFile(filePath, touched);
+
+    const stored: FileTypeDeclarations = {
+      prototypes: declarations.prototypes.map(copyDeclaration),
+      instances: declarations.instances.map(copyDeclaration)
+    };
+    this.files.set(filePath, stored);
+
+    const attach = (declaration: TypeDeclaration, isInstance: boolean) => {
+      const key = normalizeTypeName(declaration.name);
+      const entry: DeclarationEntry = {
+        name: declaration.name,
+        parentKey: normalizeTypeName(declaration.parent),
+        isInstance,
+        filePath,
+        line: declaration.line ?? 0
+      };
+      const entries = this.declarations.get(key);
+      if (!entries) {
+        this.declarations.set(key, [entry]);
+        this.linkChild(entry.parentKey, key);
+        touched.add(key);
+        return;
+      }
+
+      // Insert after every entry that doesn't sort after it, keeping list order on ties
+      const previous = entries[entries.length - 1];
+      let at = entries.length;
+      while (at > 0 && compareEntries(entries[at - 1], entry) > 0) {
+        at--;
+      }
+      entries.splice(at, 0, entry);
+      if (at === entries.length - 1) {
+        this.unlinkChild(previous.parentKey, key);
+        this.linkChild(entry.parentKey, key);
+        touched.add(key);
+      }
+    };
+    stored.prototypes.forEach((declaration) => attach(declaration, false));
+    stored.instances.forEach((declaration) => attach(declaration, true));
+
+    return this.invalidate(touched);
+  }
+
+  getFileDeclarations(filePath: string): FileTypeDeclarations | undefined {
+    return this.files.get(filePath);
+  }
+
+  /** Forget a file; returns affected instance names as for setFileDeclarations */
+  removeFile(filePath: string): string[] {
+    const touched = new Set<string>();
+    this.detachFile(filePath, touched);
+    return this.invalidate(touched);
+  }
+
+  clear(): void {
+    this.files.clear();
+    this.declarations.clear();
+    this.children.clear();
+    this.ancestorCache.clear();
+  }
+
+  has(name: string): boolean {
+    return this.declarations.has(normalizeTypeName(name));
+  }
+
+  /**
+   * Ancestors of `name` (normalized), nearest first. The last element is the
+   * root class unless the chain is cyclic.
+   */
+  getAncestors(name: string): readonly string[] {
+    const key = normalizeTypeName(name);
+    const cached = this.ancestorCache.get(key);
+    if (cached) {
+      return cached;
+    }
+
+    // Walk up until a memoized or undeclared type, then fill the caches top-down
+    const chain: string[] = [];
+    const onChain = new Set<string>();
+    let current = key;
+    let tail: readonly string[] = EMPTY_ANCESTORS;
+    while (true) {
+      const memoized = this.ancestorCache.get(current);
+      if (memoized) {
+        tail = memoized;
+        break;
+      }
+      const entry = this.getEffective(current);
+      if (!entry || onChain.has(current)) {
+        break;
+      }
+      chain.push(current);
+      onChain.add(current);
+      current = entry.parentKey;
+    }
+
+    // `current` is now the root class, a memoized type, or where a cycle closes
+    if (onChain.has(current)) {
+      // Malformed (cyclic) chain: keep the distinct types, no root class
+      chain.forEach((chainKey, i) => this.ancestorCache.set(chainKey, chain.slice(i + 1)));
+    } else {
+      let ancestors: readonly string[] = [current, ...tail];
+      for (let i = chain.length - 1; i >= 0; i--) {
+        this.ancestorCache.set(chain[i], ancestors);
+        ancestors = [chain[i], ...ancestors];
+      }
+    }
+
+    return this.ancestorCache.get(key) ?? EMPTY_ANCESTORS;
+  }
+
+  /**
+   * Topmost known type above `name`: its engine class (e.g. `C_NPC`) once all
+   * prototypes in between are declared. Null if `name` is undeclared or cyclic.
+   */
+  getBaseClass(name: string): string | null {
+    const key = normalizeTypeName(name);
+    if (!this.getEffective(key)) {
+      return null;
+    }
+    const ancestors = this.getAncestors(key);
+    const root = ancestors[ancestors.length - 1];
+    return root && !this.getEffective(root) ? root : null;
+  }
+
+  /** Whether `name` is `baseName` or derives from it */
+  isSubtypeOf(name: string, baseName: string): boolean {
+    const key = normalizeTypeName(name);
+    const baseKey = normalizeTypeName(baseName);
+    return key === baseKey || this.getAncestors(key).includes(baseKey);
+  }
+
+  /** Declared instance names whose root class is `baseClass` */
+  getInstancesOf(baseClass: string): string[] {
+    const baseKey = normalizeTypeName(baseClass);
+    const names: string[] = [];
+    this.declarations.forEach((entries, key) => {
+      const entry = entries[entries.length - 1];
+      if (entry.isInstance && this.getBaseClass(key) === baseKey) {
+        names.push(entry.name);
+      }
+    });
+    return names;
+  }
+
+  private getEffective(key: string): DeclarationEntry | undefined {
+    const entries = this.declarations.get(key);
+    return entries?.[entries.length - 1];
+  }
+
+  private linkChild(parentKey: string, childKey: string): void {
+    let set = this.children.get(parentKey);
+    if (!set) {
+      set = new Set();
+      this.children.set(parentKey, set);
+    }
+    set.add(childKey);
+  }
+
+  private unlinkChild(parentKey: string, childKey: string): void {
+    const set = this.children.get(parentKey);
+    if (!set) return;
+    set.delete(childKey);
+    if (set.size === 0) this.children.delete(parentKey);
+  }
+
+  private detachFile(filePath: string, touched: Set<string>): void {
+    const previous = this.files.get(filePath);
+    if (!previous) return;
+    this.files.delete(filePath);
+
+    [...previous.prototypes, ...previous.instances].forEach(({ name }) => {
+      const key = normalizeTypeName(name);
+      const entries = this.declarations.get(key);
+      if (!entries) return;
+
+      const effective = entries[entries.length - 1];
+      const remaining = entries.filter((entry) => entry.filePath !== filePath);
+      if (remaining.length === entries.length) return;
+
+      if (effective.filePath === filePath) {
+        this.unlinkChild(effective.parentKey, key);
+        if (remaining.length > 0) this.linkChild(remaining[remaining.length - 1].parentKey, key);
+        touched.add(key);
+      }
+      if (remaining.length > 0) {
+        this.declarations.set(key, remaining);
+      } else {
+        this.declarations.delete(key);
+      }
+    });
+  }
+
+  /** Drop memoized chains at and below `roots`; returns the instances among them */
+  private invalidate(roots: Set<string>): string[] {
+    const instances: string[] = [];
+    const visited = new Set<string>();
+    const stack = Array.from(roots);
+    while (stack.length > 0) {
+      const key = stack.pop()!;
+      if (visited.has(key)) continue;
+      visited.add(key);
+
+      this.ancestorCache.delete(key);
+      const entry = this.getEffective(key);
+      if (entry?.isInstance) {
+        instances.push(entry.name);
+      }
+      this.children.get(key)?.forEach((child) => stack.push(child));
+    }
+    return instances;
+  }
+}
@@ -0,0 +1,155 @@
+/**
+ * Declaration-level deltas between two versions of a semantic model
+ *
+ * The renderer's models are immutable with structural sharing (Immer), so
+ * an unchanged dialog or function keeps its identity from one version to
+ * the next. Comparing entries by reference finds what an edit touched
+ * without walking the declarations; only those entries cross IPC.
+ *
+ * The declaration maps in MODEL_SECTIONS are diffed entry by entry. Every
+ * other top-level key (declarationOrder, hasErrors, errors, and any key the
+ * parser adds later) is sent whole when its identity changed.
+ */
+
+import type { CodeGenerationSettings, SemanticModel, ValidationOptions, ValidationResult } from './types';
+
+export const MODEL_SECTIONS = [
+  'dialogs',
+  'functions',
+  'constants',
+  'variables',
+  'instances',
+  'items',
+  'npcs',
+  'animations'
+] as const;
+
+export type ModelSection = typeof MODEL_SECTIONS[number];
+
+/** Top-level model values other than the declaration maps */
+export type ModelFields = Partial<Omit<SemanticModel, ModelSection>>;
+
+export interface ModelSectionDelta {
+  /** Entries added or replaced */
+  set?: Record<string, unknown>;
+  removed?: string[];
+}
+
+export interface ModelDelta {
+  /** Version the changes apply to; ignored when `full` is sent */
+  baseVersion: number;
+  /** Version of the model after applying the delta */
+  version: number;
+  /** Complete model, sent when the receiver has no usable base */
+  full?: SemanticModel;
+  sections?: Partial<Record<ModelSection, ModelSectionDelta>>;
+  /** Other top-level values that changed, replaced whole */
+  fields?: ModelFields;
+  /** Other top-level keys the new version no longer has */
+  removedFields?: string[];
+}
+
+export interface ModelDeltaSaveResult {
+  success: boolean;
+  encoding?: string;
+  validationResult?: ValidationResult;
+  /** The receiver's copy is missing or at another version; resend the full model */
+  needsFullModel?: boolean;
+}
+
+/**
+ * Generation work on an open file's model. The renderer sends it with a delta
+ * instead of the whole model, so the codegen worker runs it on its own copy
+ * and serves unchanged declarations from its generated-code cache.
+ */
+export type ModelTask =
+  | { type: 'generateCode'; settings: CodeGenerationSettings }
+  | { type: 'generateDialogCode'; dialogName: string; settings: CodeGenerationSettings }
+  | { type: 'validate'; settings: CodeGenerationSettings; options?: ValidationOptions };
+
+export interface ModelTaskResult {
+  /** Generated code, or the ValidationResult of a `validate` task */
+  result?: unknown;
+  /** The receiver's copy is missing or at another version; resend the full model */
+  needsFullModel?: boolean;
+}
+
+/** Changes from `previous` to `next`, compared entry by entry by identity */
+export function diffModels(
+  previous: SemanticModel,
+  next: SemanticModel
+): Pick<ModelDelta, 'sections' | 'fields' | 'removedFields'> {
+  const delta: Pick<ModelDelta, 'sections' | 'fields' | 'removedFields'> = {};
+
+  for (const section of MODEL_SECTIONS) {
+    const before = (previous[section] ?? {}) as Record<string, unknown>;
+    const after = (next[section] ?? {}) as Record<string, unknown>;
+    if (before === after) {
+      continue;
+    }
+
+    const sectionDelta: ModelSectionDelta = {};
+    for (const name in after) {
+      if (before[name] !== after[name] || !(name in before)) {
+        (sectionDelta.set ??= {})[name] = after[name];
+      }
+    }
+    for (const name in before) {
+      if (!(name in after)) {
+        (sectionDelta.removed ??= []).push(name);
+      }
+    }
+    if (sectionDelta.set || sectionDelta.removed) {
+      (delta.sections ??= {})[section] = sectionDelta;
+    }
+  }
+
+  const previousValues = previous as unknown as Record<string, unknown>;
+  const nextValues = next as unknown as Record<string, unknown>;
+  const fields: Record<string, unknown> = {};
+  for (const key in nextValues) {
+    if (!isModelSection(key) && (previousValues[key] !== nextValues[key] || !(key in previousValues))) {
+      fields[key] = nextValues[key];
+    }
+  }
+  if (Object.keys(fields).length > 0) {
+    delta.fields = fields as ModelFields;
+  }
+  for (const key in previousValues) {
+    if (!isModelSection(key) && !(key in nextValues)) {
+      (delta.removedFields ??= []).push(key);
+    }
+  }
+  return delta;
+}
+
+/** A new model with the delta's changes applied; `model` is left untouched */
+export function applyModelDelta(model: SemanticModel, delta: ModelDelta): SemanticModel {
+  if (delta.full) {
+    return delta.full;
+  }
+
+  const next: SemanticModel = { ...model };
+  for (const section of MODEL_SECTIONS) {
+    const sectionDelta = delta.sections?.[section];
+    if (!sectionDelta) {
+      continue;
+    }
+    const entries: Record<string, any> = { ...(model[section] ?? {}) };
+    for (const name of sectionDelta.removed ?? []) {
+      delete entries[name];
+    }
+    Object.assign(entries, sectionDelta.set);
+    (next as any)[section] = entries;
+  }
+
+  for (const key of delta.removedFields ?? []) {
+    delete (next as any)[key];
+  }
+  Object.assign(next, delta.fields);
+  return next;
+}
+
+function isModelSection(key: string): key is ModelSection {
+  return (MODEL_SECTIONS as readonly string[]).includes(key);
+}
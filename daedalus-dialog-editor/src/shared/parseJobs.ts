@@ -0,0 +1,33 @@
+/**
+ * Shared vocabulary for cancellable parse jobs
+ *
+ * Errors crossing IPC lose their class and custom fields, so cancellation and
+ * timeouts are recognized by a code embedded in the message.
+ */
+
+export const PARSE_CANCELLED = 'PARSE_CANCELLED';
+export const PARSE_TIMEOUT = 'PARSE_TIMEOUT';
+
+export type ParseAbortCode = typeof PARSE_CANCELLED | typeof PARSE_TIMEOUT;
+
+export interface ParseRequestOptions {
+  /**
+   * Requests sharing a key supersede each other: queued older requests are
+   * dropped and a running one is stopped, so only the latest version is parsed.
+   */
+  supersedeKey?: string;
+  /** Give up after this many milliseconds */
+  timeoutMs?: number;
+}
+
+export function formatParseAbortMessage(code: ParseAbortCode, reason: string): string {
+  return `${reason} [${code}]`;
+}
+
+export function isParseAbortError(error: unknown, code?: ParseAbortCode): boolean {
+  const message = error instanceof Error ? error.message : typeof error === 'string' ? error : '';
+  if (code) {
+    return message.includes(`[${code}]`);
+  }
+  return message.includes(`[${PARSE_CANCELLED}]`) || message.includes(`[${PARSE_TIMEOUT}]`);
+}
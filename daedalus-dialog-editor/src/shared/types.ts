@@ -17,8 +17,92 @@ export interface ProjectIndex {
   dialogsByNpc: Map<string, DialogMetadata[]>;
   allFiles: string[];
   questFiles: string[];
+  /** Prototype/instance declarations per file, for rebuilding the class hierarchy */
+  classHierarchy?: ClassHierarchySnapshot;
 }
 
+/** `prototype`/`instance` declaration and the type it derives from */
+export interface TypeDeclaration {
+  name: string;
+  parent: string;
+  /** 1-based source line; orders redefinitions within a file */
+  line?: number;
+}
+
+export interface FileTypeDeclarations {
+  prototypes: TypeDeclaration[];
+  instances: TypeDeclaration[];
+}
+
+/** Serializable form of a ClassHierarchyIndex */
+export interface ClassHierarchySnapshot {
+  version: 1;
+  files: Record<string, FileTypeDeclarations>;
+}
+
+export interface ProjectIndexProgress {
+  discoveredFiles: number;
+  processedFiles: number;
+  scanComplete: boolean;
+}
+
+/**
+ * Incremental slice of a project index, emitted while the index is being built.
+ * Each batch only contains entries that were not part of a previous batch.
+ */
+export interface ProjectIndexBatch {
+  npcs: string[];
+  dialogs: DialogMetadata[];
+  files: string[];
+  questFiles: string[];
+  progress: ProjectIndexProgress;
+}
+
+/**
+ * Streamed while the index is built. The complete index and any error arrive
+ * through the invoke itself, so they are not repeated on the port.
+ */
+export type ProjectIndexStreamMessage = { type: 'batch'; batch: ProjectIndexBatch };
+
+/**
+ * Result of parsing one project file during background ingestion.
+ * Constants and variables in `semanticModel` already carry `filePath`.
+ */
+export interface IngestedFileResult {
+  filePath: string;
+  semanticModel: SemanticModel | null;
+  error?: string;
+}
+
+/** Streamed during ingestion; failures reject the invoke instead */
+export type ProjectIngestionMessage =
+  { type: 'results'; results: IngestedFileResult[]; processedFiles: number; totalFiles: number };
+
+/** Index-relevant facts extracted from one project file */
+export interface ProjectFileMetadata {
+  dialogs: DialogMetadata[];
+  instances: TypeDeclaration[];
+  prototypes: TypeDeclaration[];
+  isQuestFile: boolean;
+}
+
+/**
+ * External change to one project file. `metadata` is null when the file was
+ * deleted (or renamed away).
+ */
+export interface ProjectFileDelta {
+  filePath: string;
+  metadata: ProjectFileMetadata | null;
+}
+
+/**
+ * Streamed while a project is watched. Lost events are reconciled by the
+ * watcher itself and arrive as ordinary changes.
+ */
+export type ProjectWatchMessage =
+  | { type: 'changes'; deltas: ProjectFileDelta[] }
+  | { type: 'error'; message: string };
+
 export interface RecentProject {
   path: string;
   name: string;
@@ -388,6 +472,8 @@ export interface GlobalInstance {
 export interface SemanticModel {
   dialogs: Record<string, Dialog>;
   functions: Record<string, DialogFunction>;
+  /** Source order of dialogs and functions; code generation follows it */
+  declarationOrder?: Array<{ type: 'dialog' | 'function'; name: string }>;
   constants?: Record<string, GlobalConstant>;
   variables?: Record<string, GlobalVariable>;
   instances?: Record<string, GlobalInstance>;
@@ -0,0 +1,144 @@
+/**
+ * Test suite for CodegenWorkerPool (inline mode, as used under Jest)
+ * @jest-environment node
+ */
+
+import { CodegenCancelledError, CodegenWorkerPool } from '../src/main/services/CodegenWorkerPool';
+import { CodegenDocumentMissingError } from '../src/main/utils/codegenTasks';
+import { GeneratedCodeCache } from 'daedalus-parser/semantic-code-generator';
+
+describe('CodegenWorkerPool', () => {
+  const settings = {
+    indentChar: '\t' as const,
+    includeComments: true,
+    sectionHeaders: true,
+    uppercaseKeywords: true
+  };
+
+  const model = {
+    dialogs: {
+      DIA_Test: {
+        name: 'DIA_Test',
+        parent: 'C_INFO',
+        properties: { npc: 'TestNpc', nr: 1 }
+      }
+    },
+    functions: {},
+    hasErrors: false,
+    errors: []
+  };
+
+  let pool: CodegenWorkerPool;
+
+  beforeEach(() => {
+    pool = new CodegenWorkerPool();
+  });
+
+  afterEach(() => {
+    pool.terminate();
+  });
+
+  it('generates code for a model', async () => {
+    const code = await pool.run<string>({ type: 'generateCode', model, settings });
+    expect(typeof code).toBe('string');
+  });
+
+  it('validates without the round-trip parse when asked to', async () => {
+    const result = await pool.run({ type: 'validate', model, settings, options: { skipSyntaxValidation: true } });
+    expect(result).toEqual(expect.objectContaining({ isValid: true, errors: [] }));
+  });
+
+  it('streams the same code it generates in one piece', async () => {
+    const code = await pool.run<string>({ type: 'generateCode', model, settings });
+    let streamed = '';
+    for await (const chunk of pool.stream({ type: 'generateChunks', model, settings })) {
+      streamed += chunk;
+    }
+    expect(streamed).toBe(code);
+  });
+
+  it('saves deltas against the copy of the file it keeps', async () => {
+    const options = { skipValidation: true };
+    const first = await pool.run({
+      type: 'prepareSave',
+      document: { key: '/mod/DIA_Test.d', delta: { baseVersion: 0, version: 1, full: model } },
+      settings,
+      options
+    });
+    const renamed = { ...model.dialogs.DIA_Test, properties: { npc: 'OtherNpc', nr: 1 } };
+    const second = await pool.run({
+      type: 'prepareSave',
+      document: { key: '/mod/DIA_Test.d', delta: { baseVersion: 1, version: 2, sections: { dialogs: { set: { DIA_Test: renamed } } } } },
+      settings,
+      options
+    });
+
+    expect(first).toEqual(expect.objectContaining({ blocked: false }));
+    expect(second).toEqual(expect.objectContaining({ blocked: false }));
+    expect((second as any).code).toContain('OtherNpc');
+  });
+
+  it('reuses generated fragments across previews of a kept document', async () => {
+    const getOrRender = GeneratedCodeCache.prototype.getOrRender;
+    let renders = 0;
+    const spy = jest.spyOn(GeneratedCodeCache.prototype, 'getOrRender').mockImplementation(
+      function (this: GeneratedCodeCache, declaration: object, variant: string, render: () => string) {
+        return getOrRender.call(this, declaration, variant, () => {
+          renders++;
+          return render();
+        });
+      }
+    );
+
+    try {
+      // A whole model arrives as a fresh structured clone every time, so nothing is reused
+      await pool.run({ type: 'generateCode', model: structuredClone(model), settings });
+      const perModel = renders;
+      expect(perModel).toBeGreaterThan(0);
+      await pool.run({ type: 'generateCode', model: structuredClone(model), settings });
+      expect(renders).toBe(2 * perModel);
+
+      // Against the kept copy, an unchanged model renders nothing the second time
+      const key = '/mod/Preview.d';
+      const first = await pool.run<string>({
+        type: 'generateCode',
+        document: { key, delta: { baseVersion: 0, version: 1, full: structuredClone(model) } },
+        settings
+      });
+      expect(renders).toBe(3 * perModel);
+      const second = await pool.run<string>({
+        type: 'generateCode',
+        document: { key, delta: { baseVersion: 1, version: 2 } },
+        settings
+      });
+      expect(renders).toBe(3 * perModel);
+      expect(second).toBe(first);
+    } finally {
+      spy.mockRestore();
+    }
+  });
+
+  it('asks for the full model when it has no copy at the base version', async () => {
+    await expect(pool.run({
+      type: 'prepareSave',
+      document: { key: '/mod/Unknown.d', delta: { baseVersion: 3, version: 4, sections: {} } },
+      settings,
+      options: { skipValidation: true }
+    })).rejects.toBeInstanceOf(CodegenDocumentMissingError);
+  });
+
+  it('rejects requests whose signal is already aborted', async () => {
+    const controller = new AbortController();
+    controller.abort();
+
+    await expect(pool.run({ type: 'generateCode', model, settings }, { signal: controller.signal }))
+      .rejects.toBeInstanceOf(CodegenCancelledError);
+
+    const stream = pool.stream({ type: 'generateChunks', model, settings }, { signal: controller.signal });
+    await expect((async () => {
+      for await (const _chunk of stream) {
+        // drain
+      }
+    })()).rejects.toBeInstanceOf(CodegenCancelledError);
+  });
+});
@@ -0,0 +1,156 @@
+/**
+ * Test suite for CodegenWorkerPool with real worker threads
+ *
+ * Runs the compiled worker (npm run build:main, or npm run test:workers),
+ * so it exercises the message protocol, the shared cancellation and
+ * stream-credit slots, and worker respawns that inline mode skips.
+ * @jest-environment node
+ */
+
+import * as fs from 'fs';
+import { CodegenCancelledError, CodegenWorkerPool, MAX_UNCONSUMED_CHUNKS } from '../src/main/services/CodegenWorkerPool';
+import { resolveWorkerPath } from '../src/main/utils/workerRuntime';
+
+const workerPath = resolveWorkerPath('codegen.worker.js');
+const describeCompiled = fs.existsSync(workerPath) ? describe : describe.skip;
+
+const settings = {
+  indentChar: '\t' as const,
+  includeComments: true,
+  sectionHeaders: true,
+  uppercaseKeywords: true
+};
+
+/** A model whose generated code spans many 64 KB stream batches */
+const createModel = (dialogCount: number) => {
+  const dialogs: Record<string, unknown> = {};
+  for (let i = 0; i < dialogCount; i++) {
+    const name = `DIA_Worker_${i}`;
+    dialogs[name] = {
+      name,
+      parent: 'C_INFO',
+      properties: { npc: 'TestNpc', nr: i, description: `Line ${i} ${'x'.repeat(400)}` }
+    };
+  }
+  return { dialogs, functions: {}, hasErrors: false, errors: [] };
+};
+
+const smallModel = createModel(1);
+const largeModel = createModel(4000);
+
+const delay = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+describeCompiled('CodegenWorkerPool (compiled worker)', () => {
+  let pool: CodegenWorkerPool;
+
+  afterEach(() => {
+    pool.terminate();
+  });
+
+  /** Chunk messages the pool received from its workers so far */
+  const countChunkMessages = (target: CodegenWorkerPool) => {
+    const counter = { chunks: 0 };
+    const handleMessage = (target as any).handleMessage.bind(target);
+    (target as any).handleMessage = (slot: unknown, message: { chunk?: string }) => {
+      if (message.chunk !== undefined) {
+        counter.chunks++;
+      }
+      handleMessage(slot, message);
+    };
+    return counter;
+  };
+
+  it('dispatches requests to workers and returns their results', async () => {
+    pool = new CodegenWorkerPool(2, { workerPath });
+    const inline = new CodegenWorkerPool();
+    try {
+      const [first, second] = await Promise.all([
+        pool.run<string>({ type: 'generateCode', model: smallModel, settings }),
+        pool.run<string>({ type: 'generateCode', model: largeModel, settings })
+      ]);
+      expect(first).toBe(await inline.run<string>({ type: 'generateCode', model: smallModel, settings }));
+      expect(second).toContain('DIA_Worker_3999');
+    } finally {
+      inline.terminate();
+    }
+  });
+
+  it('runs jobs with one affinity key in order on the same worker', async () => {
+    pool = new CodegenWorkerPool(2, { workerPath });
+    const workersUsed: number[] = [];
+    const handleMessage = (pool as any).handleMessage.bind(pool);
+    (pool as any).handleMessage = (slot: { index: number }, message: unknown) => {
+      workersUsed.push(slot.index);
+      handleMessage(slot, message);
+    };
+
+    const finished: string[] = [];
+    const submit = (label: string, model: unknown) =>
+      pool.run({ type: 'generateCode', model, settings }, { affinityKey: '/mod/DIA_Worker.d' })
+        .then(() => { finished.push(label); });
+
+    // The large job would finish last if the key did not serialize them
+    await Promise.all([submit('large', largeModel), submit('small', smallModel), submit('small again', smallModel)]);
+
+    expect(finished).toEqual(['large', 'small', 'small again']);
+    expect(new Set(workersUsed).size).toBe(1);
+  });
+
+  it('streams the generated code in order without running far ahead of the consumer', async () => {
+    pool = new CodegenWorkerPool(1, { workerPath });
+    const counter = countChunkMessages(pool);
+    const code = await pool.run<string>({ type: 'generateCode', model: largeModel, settings });
+
+    const iterator = pool.stream({ type: 'generateChunks', model: largeModel, settings })[Symbol.asyncIterator]();
+    let streamed = (await iterator.next()).value as string;
+
+    // The worker waits for the consumer once it is MAX_UNCONSUMED_CHUNKS batches ahead
+    await delay(300);
+    expect(counter.chunks).toBeLessThanOrEqual(MAX_UNCONSUMED_CHUNKS + 1);
+
+    for (let result = await iterator.next(); !result.done; result = await iterator.next()) {
+      streamed += result.value;
+    }
+    expect(streamed).toBe(code);
+    expect(counter.chunks).toBeGreaterThan(MAX_UNCONSUMED_CHUNKS + 1);
+  });
+
+  it('stops a running job through the shared cancel flag and frees its worker', async () => {
+    pool = new CodegenWorkerPool(1, { workerPath });
+    const controller = new AbortController();
+    const stream = pool.stream({ type: 'generateChunks', model: largeModel, settings }, { signal: controller.signal });
+    const iterator = stream[Symbol.asyncIterator]();
+    await iterator.next();
+
+    // The worker is now blocked waiting for the consumer; only the flag can stop it
+    controller.abort();
+    await expect(iterator.next()).rejects.toBeInstanceOf(CodegenCancelledError);
+
+    // With a single worker, this only runs once the cancelled job has replied
+    await expect(pool.run<string>({ type: 'generateCode', model: smallModel, settings }))
+      .resolves.toContain('DIA_Worker_0');
+  });
+
+  it('cancels the stream when the consumer stops reading', async () => {
+    pool = new CodegenWorkerPool(1, { workerPath });
+    for await (const _chunk of pool.stream({ type: 'generateChunks', model: largeModel, settings })) {
+      break;
+    }
+    await expect(pool.run<string>({ type: 'generateCode', model: smallModel, settings }))
+      .resolves.toContain('DIA_Worker_0');
+  });
+
+  it('fails the running job and replaces a worker that exits', async () => {
+    pool = new CodegenWorkerPool(1, { workerPath });
+    const iterator = pool.stream({ type: 'generateChunks', model: largeModel, settings })[Symbol.asyncIterator]();
+    await iterator.next();
+
+    const [slot] = (pool as any).workers;
+    await slot.worker.terminate();
+    await expect(iterator.next()).rejects.toThrow(/Codegen worker exited/);
+
+    expect((pool as any).workers[0]).not.toBe(slot);
+    await expect(pool.run<string>({ type: 'generateCode', model: smallModel, settings }))
+      .resolves.toContain('DIA_Worker_0');
+  });
+});
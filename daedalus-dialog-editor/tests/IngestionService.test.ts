@@ -0,0 +1,238 @@
+/**
+ * Test suite for IngestionService - batched background parsing of project files
+ * @jest-environment node
+ */
+
+import { jest } from '@jest/globals';
+import { IngestionService } from '../src/main/services/IngestionService';
+import type { IngestedFileResult, SemanticModel } from '../src/shared/types';
+
+const createModel = (content: string): SemanticModel => ({
+  dialogs: {},
+  functions: {},
+  constants: { [`C_${content}`]: { name: `C_${content}`, type: 'int', value: 1 } as any },
+  variables: {},
+  instances: {},
+  hasErrors: false,
+  errors: []
+});
+
+interface Deferred {
+  content: string;
+  resolve: (model: SemanticModel) => void;
+  reject: (error: Error) => void;
+}
+
+/**
+ * Parser stub whose parses stay pending until the test settles them, so the
+ * test controls completion order and can observe how many run at once.
+ */
+class StubParserService {
+  readonly pending: Deferred[] = [];
+  readonly started: string[] = [];
+  readonly signals: Array<AbortSignal | undefined> = [];
+  readonly useParseCache: Array<boolean | undefined> = [];
+  maxInFlight = 0;
+  private inFlight = 0;
+
+  parseSource = (
+    content: string,
+    options: { signal?: AbortSignal; useParseCache?: boolean } = {}
+  ): Promise<SemanticModel> => {
+    this.started.push(content);
+    this.signals.push(options.signal);
+    this.useParseCache.push(options.useParseCache);
+    this.inFlight++;
+    this.maxInFlight = Math.max(this.maxInFlight, this.inFlight);
+    return new Promise<SemanticModel>((resolve, reject) => {
+      this.pending.push({ content, resolve, reject });
+    }).finally(() => { this.inFlight--; });
+  };
+
+  /** Resolve the pending parse of `content` */
+  complete(content: string) {
+    this.take(content).resolve(createModel(content));
+  }
+
+  fail(content: string, message: string) {
+    this.take(content).reject(new Error(message));
+  }
+
+  private take(content: string): Deferred {
+    const index = this.pending.findIndex((deferred) => deferred.content === content);
+    if (index < 0) {
+      throw new Error(`No pending parse for ${content}`);
+    }
+    return this.pending.splice(index, 1)[0];
+  }
+}
+
+/** File service stub: a path's content is its base name */
+const fileService = {
+  readFile: jest.fn(async (filePath: string) => filePath.replace(/^.*\//, '').replace(/\.d$/, ''))
+};
+
+/** Let queued promise continuations run; works under fake timers too */
+const flushPromises = async () => {
+  for (let i = 0; i < 50; i++) {
+    await Promise.resolve();
+  }
+};
+
+describe('IngestionService', () => {
+  let parser: StubParserService;
+  let service: IngestionService;
+
+  beforeEach(() => {
+    parser = new StubParserService();
+    service = new IngestionService(fileService as any, parser as any);
+    fileService.readFile.mockClear();
+  });
+
+  it('never runs more than `concurrency` parses at once and schedules files in order', async () => {
+    const files = ['/p/A.d', '/p/B.d', '/p/C.d', '/p/D.d', '/p/E.d'];
+    const run = service.ingestFiles(files, () => {}, { concurrency: 2, chunkSize: 100 });
+
+    await flushPromises();
+    expect(parser.started).toEqual(['A', 'B']);
+
+    // A finished slot picks up the next file in list order
+    parser.complete('B');
+    await flushPromises();
+    expect(parser.started).toEqual(['A', 'B', 'C']);
+
+    for (const content of ['A', 'C']) {
+      parser.complete(content);
+      await flushPromises();
+    }
+    expect(parser.started).toEqual(['A', 'B', 'C', 'D', 'E']);
+    parser.complete('D');
+    parser.complete('E');
+
+    await expect(run).resolves.toEqual({ processedFiles: 5, cancelled: false });
+    expect(parser.maxInFlight).toBe(2);
+  });
+
+  it('reports progress in chunks and attaches file paths', async () => {
+    const files = ['/p/A.d', '/p/B.d', '/p/C.d'];
+    const chunks: Array<{ results: IngestedFileResult[]; processedFiles: number }> = [];
+    const run = service.ingestFiles(
+      files,
+      (results, processedFiles) => chunks.push({ results, processedFiles }),
+      { concurrency: 3, chunkSize: 2, flushIntervalMs: 60_000 }
+    );
+
+    await flushPromises();
+    parser.complete('C');
+    await flushPromises();
+    expect(chunks).toHaveLength(0);
+
+    parser.complete('A');
+    await flushPromises();
+    expect(chunks.map((chunk) => chunk.processedFiles)).toEqual([2]);
+    expect(chunks[0].results.map((result) => result.filePath)).toEqual(['/p/C.d', '/p/A.d']);
+
+    // The remainder is flushed when the run ends, not when the interval fires
+    parser.complete('B');
+    await run;
+    expect(chunks.map((chunk) => chunk.processedFiles)).toEqual([2, 3]);
+
+    const model = chunks[1].results[0].semanticModel!;
+    expect(model.constants!.C_B.filePath).toBe('/p/B.d');
+  });
+
+  it('lets the parser worker serve files through the parse cache', async () => {
+    const run = service.ingestFiles(['/p/A.d', '/p/B.d'], () => {}, { concurrency: 2 });
+
+    await flushPromises();
+    parser.complete('A');
+    parser.complete('B');
+    await run;
+
+    // The lookup, hashing and JSON work happen in the worker; only the model comes back
+    expect(parser.useParseCache).toEqual([true, true]);
+  });
+
+  it('flushes a partial chunk after the flush interval', async () => {
+    jest.useFakeTimers();
+    try {
+      const chunks: IngestedFileResult[][] = [];
+      const run = service.ingestFiles(['/p/A.d', '/p/B.d'], (results) => chunks.push(results), {
+        concurrency: 2,
+        chunkSize: 10,
+        flushIntervalMs: 100
+      });
+
+      await flushPromises();
+      parser.complete('A');
+      await flushPromises();
+      expect(chunks).toHaveLength(0);
+
+      jest.advanceTimersByTime(100);
+      expect(chunks.map((chunk) => chunk.map((result) => result.filePath))).toEqual([['/p/A.d']]);
+
+      parser.complete('B');
+      await run;
+      expect(chunks).toHaveLength(2);
+    } finally {
+      jest.useRealTimers();
+    }
+  });
+
+  it('turns read, validation and parse failures into per-file errors', async () => {
+    const results: IngestedFileResult[] = [];
+    const run = service.ingestFiles(['/p/A.d', '/outside/B.d', '/p/C.d'], (chunk) => results.push(...chunk), {
+      concurrency: 3,
+      validatePath: (filePath) => {
+        if (filePath.startsWith('/outside/')) {
+          throw new Error('Path outside project');
+        }
+      }
+    });
+
+    await flushPromises();
+    parser.fail('A', 'Parse worker crashed');
+    parser.complete('C');
+
+    await expect(run).resolves.toEqual({ processedFiles: 3, cancelled: false });
+    const byPath = new Map(results.map((result) => [result.filePath, result]));
+    expect(byPath.get('/p/A.d')).toEqual({ filePath: '/p/A.d', semanticModel: null, error: 'Parse worker crashed' });
+    expect(byPath.get('/outside/B.d')!.error).toBe('Path outside project');
+    expect(byPath.get('/p/C.d')!.semanticModel).not.toBeNull();
+    expect(fileService.readFile).not.toHaveBeenCalledWith('/outside/B.d');
+  });
+
+  it('stops scheduling on abort and drops results still in flight', async () => {
+    const controller = new AbortController();
+    const chunks: IngestedFileResult[][] = [];
+    const files = ['/p/A.d', '/p/B.d', '/p/C.d', '/p/D.d'];
+    const run = service.ingestFiles(files, (results) => chunks.push(results), {
+      concurrency: 2,
+      chunkSize: 1,
+      signal: controller.signal
+    });
+
+    await flushPromises();
+    parser.complete('A');
+    await flushPromises();
+    expect(chunks).toHaveLength(1);
+    expect(parser.started).toEqual(['A', 'B', 'C']);
+
+    // The parser receives the signal, so it can cancel the work itself
+    expect(parser.signals.every((signal) => signal === controller.signal)).toBe(true);
+
+    controller.abort();
+    parser.complete('B');
+    parser.complete('C');
+
+    await expect(run).resolves.toEqual({ processedFiles: 1, cancelled: true });
+    expect(chunks).toHaveLength(1);
+    expect(parser.started).not.toContain('D');
+  });
+
+  it('resolves immediately for an empty file list', async () => {
+    const onChunk = jest.fn();
+    await expect(service.ingestFiles([], onChunk)).resolves.toEqual({ processedFiles: 0, cancelled: false });
+    expect(onChunk).not.toHaveBeenCalled();
+  });
+});
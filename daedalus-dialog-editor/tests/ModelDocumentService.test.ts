@@ -0,0 +1,71 @@
+/**
+ * Test suite for ModelDocumentService - the main process copies of open models
+ * @jest-environment node
+ */
+
+import { ModelDocumentService } from '../src/main/services/ModelDocumentService';
+import type { SemanticModel } from '../src/shared/types';
+
+const createModel = (npc: string): SemanticModel => ({
+  dialogs: {
+    DIA_Test: { name: 'DIA_Test', parent: 'C_INFO', properties: { npc, nr: 1 } } as any
+  },
+  functions: {},
+  declarationOrder: [{ type: 'dialog', name: 'DIA_Test' }],
+  hasErrors: false,
+  errors: []
+});
+
+describe('ModelDocumentService', () => {
+  it('keeps the full model as the base for later deltas', () => {
+    const documents = new ModelDocumentService();
+    const model = createModel('Npc');
+
+    expect(documents.apply('a.d', { baseVersion: 0, version: 1, full: model })).toBe(model);
+    const reordered = documents.apply('a.d', {
+      baseVersion: 1,
+      version: 2,
+      fields: { declarationOrder: [] }
+    });
+
+    expect(reordered!.declarationOrder).toEqual([]);
+    expect(reordered!.dialogs).toBe(model.dialogs);
+    expect(model.declarationOrder).toHaveLength(1);
+  });
+
+  it('replaces its copy whenever a full model arrives, whatever the held version', () => {
+    const documents = new ModelDocumentService();
+    documents.apply('a.d', { baseVersion: 0, version: 5, full: createModel('Old') });
+
+    const model = createModel('New');
+    expect(documents.apply('a.d', { baseVersion: 0, version: 1, full: model })).toBe(model);
+    expect(documents.getVersion('a.d')).toBe(1);
+  });
+
+  it('drops the least recently updated copy beyond its capacity', () => {
+    const documents = new ModelDocumentService(2);
+    documents.apply('a.d', { baseVersion: 0, version: 1, full: createModel('A') });
+    documents.apply('b.d', { baseVersion: 0, version: 1, full: createModel('B') });
+    // Updating a.d makes b.d the oldest
+    documents.apply('a.d', { baseVersion: 1, version: 2 });
+    documents.apply('c.d', { baseVersion: 0, version: 1, full: createModel('C') });
+
+    expect(documents.getVersion('a.d')).toBe(2);
+    expect(documents.getVersion('b.d')).toBeUndefined();
+    expect(documents.getVersion('c.d')).toBe(1);
+
+    // An evicted file's next delta asks for the full model
+    expect(documents.apply('b.d', { baseVersion: 1, version: 2 })).toBeNull();
+  });
+
+  it('forgets every copy on clear, e.g. when the renderer reloads', () => {
+    const documents = new ModelDocumentService();
+    documents.apply('a.d', { baseVersion: 0, version: 1, full: createModel('A') });
+    documents.apply('b.d', { baseVersion: 0, version: 1, full: createModel('B') });
+
+    documents.clear();
+
+    expect(documents.getVersion('a.d')).toBeUndefined();
+    expect(documents.getVersion('b.d')).toBeUndefined();
+  });
+});
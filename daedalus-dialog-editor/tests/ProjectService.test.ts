@@ -11,6 +11,7 @@
 import * as fs from 'fs';
 import * as path from 'path';
 import * as os from 'os';
+import type { ProjectIndexBatch } from '../src/shared/types';
 
 describe('ProjectService', () => {
   let tempDir: string;
@@ -94,6 +95,44 @@ describe('ProjectService', () => {
       expect(files).toContain(path.join(dialogDir, 'DIA_Lower.d'));
       expect(files).toContain(path.join(dialogDir, 'DIA_Upper.D'));
     });
+
+    it('should skip entries matching ignore patterns', async () => {
+      const scriptsDir = path.join(tempDir, '_work', 'Data', 'Scripts');
+      const backupDir = path.join(tempDir, '_work', 'Backup');
+      fs.mkdirSync(scriptsDir, { recursive: true });
+      fs.mkdirSync(backupDir, { recursive: true });
+      fs.mkdirSync(path.join(tempDir, '.git'), { recursive: true });
+
+      fs.writeFileSync(path.join(scriptsDir, 'DIA_Keep.d'), '// keep');
+      fs.writeFileSync(path.join(scriptsDir, 'DIA_Keep.bak.d'), '// ignored by name');
+      fs.writeFileSync(path.join(backupDir, 'DIA_Old.d'), '// ignored by path');
+      fs.writeFileSync(path.join(tempDir, '.git', 'ignored.d'), '// ignored by default');
+
+      const service = new ProjectService();
+      const files = await service.scanDirectory(tempDir, {
+        ignore: ['.git', '*.bak.d', '_work/backup']
+      });
+
+      expect(files).toEqual([path.join(scriptsDir, 'DIA_Keep.d')]);
+    });
+
+    it('should not loop on symlinked directory cycles', async () => {
+      const nestedDir = path.join(tempDir, 'Story');
+      fs.mkdirSync(nestedDir, { recursive: true });
+      fs.writeFileSync(path.join(nestedDir, 'Story_Globals.d'), '// globals');
+
+      try {
+        fs.symlinkSync(tempDir, path.join(nestedDir, 'loop'), 'dir');
+      } catch {
+        // Symlinks may require elevated privileges (e.g. on Windows); nothing to verify then.
+        return;
+      }
+
+      const service = new ProjectService();
+      const files = await service.scanDirectory(tempDir, { concurrency: 2 });
+
+      expect(files).toEqual([path.join(nestedDir, 'Story_Globals.d')]);
+    });
   });
 
   describe('extractDialogMetadata', () => {
@@ -343,6 +382,48 @@ INSTANCE VLK_99064_Schurfer (Npc_Default)
       expect(index.allFiles).toContain(path.join(npcDir, 'VLK_99064_Schurfer.d'));
     });
 
+    it('streams batches that add up to the final index', async () => {
+      const storyDir = path.join(tempDir, 'Story');
+      const npcDir = path.join(storyDir, 'NPC');
+      fs.mkdirSync(npcDir, { recursive: true });
+
+      // Instance is discovered before the prototype that makes it an NPC
+      fs.writeFileSync(path.join(npcDir, 'VLK_100_Miner.d'), `
+INSTANCE VLK_100_Miner (Npc_Miner)
+{
+    name = "Miner";
+};
+      `);
+      fs.writeFileSync(path.join(storyDir, 'Prototypes.d'), `
+PROTOTYPE Npc_Miner(Npc_Default) {};
+PROTOTYPE Npc_Default(C_NPC) {};
+      `);
+      fs.writeFileSync(path.join(storyDir, 'DIA_Miner.d'), `
+INSTANCE DIA_Miner_Hello (C_INFO)
+{
+    npc = VLK_100_Miner;
+};
+      `);
+
+      const batches: ProjectIndexBatch[] = [];
+      const service = new ProjectService();
+      const index = await service.buildProjectIndex(tempDir, undefined, (batch) => batches.push(batch));
+
+      expect(batches.length).toBeGreaterThan(0);
+      const lastProgress = batches[batches.length - 1].progress;
+      expect(lastProgress).toEqual({ discoveredFiles: 3, processedFiles: 3, scanComplete: true });
+
+      const streamedNpcs = batches.flatMap((batch) => batch.npcs).sort();
+      const streamedFiles = batches.flatMap((batch) => batch.files).sort();
+      const streamedDialogs = batches.flatMap((batch) => batch.dialogs).map((dialog) => dialog.dialogName);
+
+      expect(streamedNpcs).toEqual(index.npcs);
+      expect(index.npcs).toEqual(['VLK_100_Miner']);
+      expect(streamedFiles).toEqual([...index.allFiles].sort());
+      expect(streamedDialogs).toEqual(['DIA_Miner_Hello']);
+      expect(index.dialogsByNpc.get('VLK_100_Miner')).toHaveLength(1);
+    });
+
     it('should detect quest files containing TOPIC_ constants or MIS_ variables', async () => {
       const storyDir = path.join(tempDir, 'Story');
       fs.mkdirSync(storyDir, { recursive: true });
@@ -0,0 +1,115 @@
+/**
+ * Test suite for ProjectWatcher - external change tracking for open projects
+ * @jest-environment node
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import * as os from 'os';
+import { ProjectWatcher } from '../src/main/services/ProjectWatcherService';
+import { clearWriteJournal, recordOwnWrite } from '../src/main/utils/writeJournal';
+import type { ProjectFileDelta } from '../src/shared/types';
+
+const waitFor = async (predicate: () => boolean, timeoutMs = 5000) => {
+  const start = Date.now();
+  while (!predicate()) {
+    if (Date.now() - start > timeoutMs) {
+      throw new Error('Timed out waiting for watcher batch');
+    }
+    await new Promise((resolve) => setTimeout(resolve, 20));
+  }
+};
+
+describe('ProjectWatcher', () => {
+  let tempDir: string;
+  let watcher: ProjectWatcher | null;
+
+  beforeEach(() => {
+    tempDir = fs.mkdtempSync(path.join(os.tmpdir(), 'gothic-watch-'));
+    watcher = null;
+  });
+
+  afterEach(() => {
+    watcher?.close();
+    clearWriteJournal();
+    fs.rmSync(tempDir, { recursive: true, force: true });
+  });
+
+  it('coalesces changes into metadata deltas and reports deleted directories', async () => {
+    const npcDir = path.join(tempDir, 'NPC');
+    fs.mkdirSync(npcDir);
+    fs.writeFileSync(path.join(npcDir, 'Old.d'), 'INSTANCE PC_Old (C_NPC) {};');
+
+    const batches: ProjectFileDelta[][] = [];
+    watcher = new ProjectWatcher(tempDir, {
+      onChanges: (deltas) => batches.push(deltas),
+      onError: (error) => { throw error; }
+    }, { debounceMs: 50 });
+    await watcher.start();
+
+    const dialogPath = path.join(tempDir, 'DIA_Test.d');
+    fs.writeFileSync(dialogPath, 'INSTANCE DIA_Test (C_INFO) { npc = PC_Test; };');
+    fs.appendFileSync(dialogPath, '\n');
+    fs.writeFileSync(path.join(tempDir, 'notes.txt'), 'ignored');
+
+    await waitFor(() => batches.some((batch) => batch.some((delta) => delta.filePath === dialogPath)));
+    const delta = batches.flat().find((entry) => entry.filePath === dialogPath)!;
+    expect(delta.metadata?.dialogs).toEqual([{ dialogName: 'DIA_Test', npc: 'PC_Test', filePath: dialogPath }]);
+    expect(batches.flat().some((entry) => entry.filePath.endsWith('notes.txt'))).toBe(false);
+
+    batches.length = 0;
+    fs.rmSync(npcDir, { recursive: true, force: true });
+
+    await waitFor(() => batches.flat().some((entry) => entry.filePath === path.join(npcDir, 'Old.d')));
+    expect(batches.flat().find((entry) => entry.filePath === path.join(npcDir, 'Old.d'))?.metadata).toBeNull();
+  });
+
+  const startWatcher = async (batches: ProjectFileDelta[][]) => {
+    watcher = new ProjectWatcher(tempDir, {
+      onChanges: (deltas) => batches.push(deltas),
+      onError: (error) => { throw error; }
+    }, { debounceMs: 50 });
+    await watcher.start();
+  };
+
+  const settle = () => new Promise((resolve) => setTimeout(resolve, 400));
+
+  it('does not report files the app saved itself', async () => {
+    const dialogPath = path.join(tempDir, 'DIA_Own.d');
+    fs.writeFileSync(dialogPath, 'INSTANCE DIA_Own (C_INFO) { npc = PC_Own; };');
+    const batches: ProjectFileDelta[][] = [];
+    await startWatcher(batches);
+
+    fs.writeFileSync(dialogPath, 'INSTANCE DIA_Own (C_INFO) { npc = PC_Saved; };');
+    recordOwnWrite(dialogPath, fs.statSync(dialogPath));
+    await settle();
+    expect(batches.flat()).toEqual([]);
+
+    // A later external edit is reported again
+    fs.writeFileSync(dialogPath, 'INSTANCE DIA_Own (C_INFO) { npc = PC_External; };\n');
+    await waitFor(() => batches.flat().some((delta) => delta.filePath === dialogPath));
+    expect(batches.flat().find((delta) => delta.filePath === dialogPath)?.metadata?.dialogs[0].npc).toBe('PC_External');
+  });
+
+  it('rescans by comparing stats instead of re-reading every file', async () => {
+    const keptPath = path.join(tempDir, 'Kept.d');
+    const goneDir = path.join(tempDir, 'Gone');
+    fs.writeFileSync(keptPath, 'INSTANCE PC_Kept (C_NPC) {};');
+    fs.mkdirSync(goneDir);
+    fs.writeFileSync(path.join(goneDir, 'Gone.d'), 'INSTANCE PC_Gone (C_NPC) {};');
+    const batches: ProjectFileDelta[][] = [];
+    await startWatcher(batches);
+
+    // Nothing changed since the watch started: a rescan reports nothing
+    watcher!.rescan();
+    await settle();
+    expect(batches.flat()).toEqual([]);
+
+    fs.rmSync(goneDir, { recursive: true, force: true });
+    watcher!.rescan();
+    await waitFor(() => batches.flat().some((delta) => delta.filePath === path.join(goneDir, 'Gone.d')));
+    const deltas = batches.flat();
+    expect(deltas.find((delta) => delta.filePath === path.join(goneDir, 'Gone.d'))?.metadata).toBeNull();
+    expect(deltas.some((delta) => delta.filePath === keptPath)).toBe(false);
+  });
+});
@@ -0,0 +1,79 @@
+/**
+ * Test suite for TraceService and the shared span API
+ * @jest-environment node
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import * as os from 'os';
+import { TraceService } from '../src/main/services/TraceService';
+import {
+  beginSpan,
+  disableTracing,
+  drainTraceEvents,
+  traceAsync,
+  traceSpan,
+  type TraceEvent
+} from 'daedalus-parser/tracing';
+
+describe('TraceService', () => {
+  let tempDir: string;
+
+  beforeEach(() => {
+    tempDir = fs.mkdtempSync(path.join(os.tmpdir(), 'daedalus-trace-'));
+    drainTraceEvents();
+  });
+
+  afterEach(() => {
+    disableTracing();
+    drainTraceEvents();
+    fs.rmSync(tempDir, { recursive: true, force: true });
+  });
+
+  it('stays off unless DAEDALUS_TRACE is set', () => {
+    expect(TraceService.fromEnv({})).toBeNull();
+    expect(TraceService.fromEnv({ DAEDALUS_TRACE: '0' })).toBeNull();
+
+    expect(traceSpan('ignored', () => 'value')).toBe('value');
+    beginSpan('ignored')();
+    expect(drainTraceEvents()).toEqual([]);
+  });
+
+  it('writes main, worker and renderer spans into one Chrome trace', async () => {
+    const service = TraceService.fromEnv({ DAEDALUS_TRACE: tempDir })!;
+    expect(service).not.toBeNull();
+
+    await traceAsync('ipc.parser:parseSource', async () => {
+      traceSpan('parser.queueWait', () => undefined);
+    });
+    const workerEvents: TraceEvent[] = [{ name: 'worker.parseSource', ph: 'X', ts: 1, dur: 2, pid: process.pid, tid: 4 }];
+    service.record(workerEvents, process.pid, 'main');
+    service.record([{ name: 'project.open', ph: 'X', ts: 1, dur: 5, pid: 0, tid: 0 }], 4242, 'renderer');
+
+    const tracePath = service.writeSession(path.join(tempDir, 'unused'));
+    expect(path.dirname(tracePath)).toBe(tempDir);
+
+    const trace = JSON.parse(fs.readFileSync(tracePath, 'utf8'));
+    const names = trace.traceEvents.map((event: TraceEvent) => event.name);
+    expect(names).toEqual(expect.arrayContaining([
+      'thread_name',
+      'process_name',
+      'ipc.parser:parseSource',
+      'parser.queueWait',
+      'worker.parseSource',
+      'project.open'
+    ]));
+
+    const rendererSpan = trace.traceEvents.find((event: TraceEvent) => event.name === 'project.open');
+    expect(rendererSpan.pid).toBe(4242);
+    const processNames = trace.traceEvents
+      .filter((event: TraceEvent) => event.name === 'process_name')
+      .map((event: TraceEvent) => event.args?.name);
+    expect(processNames).toEqual(expect.arrayContaining(['main', 'renderer']));
+
+    const outer = trace.traceEvents.find((event: TraceEvent) => event.name === 'ipc.parser:parseSource');
+    const inner = trace.traceEvents.find((event: TraceEvent) => event.name === 'parser.queueWait');
+    expect(inner.ts).toBeGreaterThanOrEqual(outer.ts);
+    expect(inner.ts + inner.dur).toBeLessThanOrEqual(outer.ts + outer.dur);
+  });
+});
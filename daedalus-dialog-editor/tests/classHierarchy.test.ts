@@ -0,0 +1,148 @@
+import { ClassHierarchyIndex, instanceDeclarationsFromModel } from '../src/shared/classHierarchy';
+import type { SemanticModel } from '../src/shared/types';
+
+describe('ClassHierarchyIndex', () => {
+  const buildIndex = () => {
+    const index = new ClassHierarchyIndex();
+    index.setFileDeclarations('/Story/Prototypes.d', {
+      prototypes: [
+        { name: 'Npc_Default', parent: 'C_NPC' },
+        { name: 'Npc_Miner', parent: 'Npc_Default' },
+        { name: 'ItemPR_Default', parent: 'C_Item' }
+      ],
+      instances: []
+    });
+    index.setFileDeclarations('/Story/NPC/Bennet.d', {
+      prototypes: [],
+      instances: [
+        { name: 'SLD_809_Bennet', parent: 'Npc_Default' },
+        { name: 'VLK_900_Miner', parent: 'npc_miner' }
+      ]
+    });
+    index.setFileDeclarations('/Items/Food.d', {
+      prototypes: [],
+      instances: [{ name: 'ItFo_Apple', parent: 'ItemPR_Default' }]
+    });
+    return index;
+  };
+
+  it('resolves ancestor chains and root classes case-insensitively', () => {
+    const index = buildIndex();
+
+    expect(index.getAncestors('VLK_900_Miner')).toEqual(['NPC_MINER', 'NPC_DEFAULT', 'C_NPC']);
+    expect(index.getBaseClass('vlk_900_miner')).toBe('C_NPC');
+    expect(index.getBaseClass('ItFo_Apple')).toBe('C_ITEM');
+    expect(index.isSubtypeOf('VLK_900_Miner', 'Npc_Default')).toBe(true);
+    expect(index.isSubtypeOf('ItFo_Apple', 'C_NPC')).toBe(false);
+    expect(index.getInstancesOf('C_NPC').sort()).toEqual(['SLD_809_Bennet', 'VLK_900_Miner']);
+  });
+
+  it('reports instances in other files when a prototype changes', () => {
+    const index = buildIndex();
+    expect(index.getBaseClass('VLK_900_Miner')).toBe('C_NPC');
+
+    const affected = index.setFileDeclarations('/Story/Prototypes.d', {
+      prototypes: [
+        { name: 'Npc_Default', parent: 'C_NPC' },
+        { name: 'Npc_Miner', parent: 'C_Item' },
+        { name: 'ItemPR_Default', parent: 'C_Item' }
+      ],
+      instances: []
+    });
+
+    expect(affected.sort()).toEqual(['ItFo_Apple', 'SLD_809_Bennet', 'VLK_900_Miner']);
+    expect(index.getBaseClass('VLK_900_Miner')).toBe('C_ITEM');
+    expect(index.getBaseClass('SLD_809_Bennet')).toBe('C_NPC');
+  });
+
+  it('resolves instances once their prototype is declared', () => {
+    const index = new ClassHierarchyIndex();
+    index.setFileDeclarations('/a.d', { prototypes: [], instances: [{ name: 'Hero', parent: 'Npc_Default' }] });
+    expect(index.getBaseClass('Hero')).toBe('NPC_DEFAULT');
+
+    const affected = index.setFileDeclarations('/b.d', { prototypes: [{ name: 'Npc_Default', parent: 'C_NPC' }], instances: [] });
+    expect(affected).toEqual(['Hero']);
+    expect(index.getBaseClass('Hero')).toBe('C_NPC');
+
+    index.removeFile('/b.d');
+    expect(index.getBaseClass('Hero')).toBe('NPC_DEFAULT');
+  });
+
+  it('does not loop on cyclic prototypes', () => {
+    const index = new ClassHierarchyIndex();
+    index.setFileDeclarations('/cycle.d', {
+      prototypes: [
+        { name: 'A', parent: 'B' },
+        { name: 'B', parent: 'A' }
+      ],
+      instances: [{ name: 'X', parent: 'A' }]
+    });
+
+    expect(index.getBaseClass('X')).toBeNull();
+    expect(index.getAncestors('X')).toEqual(['A', 'B']);
+  });
+
+  it('round-trips through a snapshot', () => {
+    const restored = ClassHierarchyIndex.fromSnapshot(JSON.parse(JSON.stringify(buildIndex().toSnapshot())));
+
+    expect(restored.getBaseClass('VLK_900_Miner')).toBe('C_NPC');
+    expect(restored.getFileDeclarations('/Items/Food.d')?.instances).toEqual([{ name: 'ItFo_Apple', parent: 'ItemPR_Default' }]);
+  });
+
+  it('lets the last redefinition win regardless of registration order', () => {
+    const files: Array<[string, { prototypes: any[]; instances: any[] }]> = [
+      ['/Story/A.d', { prototypes: [{ name: 'Npc_Guard', parent: 'C_NPC', line: 3 }], instances: [] }],
+      ['/Story/B.d', { prototypes: [{ name: 'Npc_Guard', parent: 'C_Item', line: 1 }], instances: [] }],
+      ['/Story/NPC/Guard.d', { prototypes: [], instances: [{ name: 'Guard_1', parent: 'Npc_Guard', line: 1 }] }]
+    ];
+
+    for (const order of [files, [...files].reverse()]) {
+      const index = new ClassHierarchyIndex();
+      order.forEach(([filePath, declarations]) => index.setFileDeclarations(filePath, declarations));
+      // B.d sorts after A.d, so its definition is effective
+      expect(index.getBaseClass('Guard_1')).toBe('C_ITEM');
+
+      // Removing the effective definition falls back to the previous one
+      expect(index.removeFile('/Story/B.d')).toEqual(['Guard_1']);
+      expect(index.getBaseClass('Guard_1')).toBe('C_NPC');
+    }
+  });
+
+  it('orders redefinitions within a file by line', () => {
+    const index = new ClassHierarchyIndex();
+    index.setFileDeclarations('/Story/Prototypes.d', {
+      prototypes: [
+        { name: 'Npc_Guard', parent: 'C_Item', line: 20 },
+        { name: 'Npc_Guard', parent: 'C_NPC', line: 40 }
+      ],
+      instances: [{ name: 'Guard_1', parent: 'Npc_Guard', line: 60 }]
+    });
+
+    expect(index.getBaseClass('Guard_1')).toBe('C_NPC');
+  });
+
+  it('extracts every instance of a semantic model, dialogs included', () => {
+    const model = {
+      dialogs: { DIA_Bennet_Hallo: { name: 'DIA_Bennet_Hallo', parent: 'C_INFO', properties: {} } },
+      functions: {},
+      instances: {
+        SLD_809_Bennet: {
+          name: 'SLD_809_Bennet',
+          parent: 'Npc_Default',
+          position: { startLine: 12, startColumn: 1, endLine: 30, endColumn: 3 }
+        },
+        ItFo_Apple: { name: 'ItFo_Apple', parent: 'C_Item' }
+      },
+      npcs: {},
+      items: {},
+      hasErrors: false,
+      errors: []
+    } as unknown as SemanticModel;
+
+    expect(instanceDeclarationsFromModel(model)).toEqual([
+      { name: 'DIA_Bennet_Hallo', parent: 'C_INFO' },
+      { name: 'SLD_809_Bennet', parent: 'Npc_Default', line: 12 },
+      { name: 'ItFo_Apple', parent: 'C_Item' }
+    ]);
+  });
+});
@@ -122,4 +122,59 @@ describe('projectStore - ingestion', () => {
     expect(finalState.parsedFiles.size).toBeLessThan(100);
     // expect(finalState.isIngesting).toBe(false); // See note in thought process: manual abort doesn't reset flag
   });
+
+  test('should use the batched ingestion API when available', async () => {
+    const files = ['quest.d', 'a.d', 'b.d', 'broken.d'];
+    const parseDialogFileMock = jest.fn();
+    const ingestProjectFilesMock = jest.fn(async (
+      _ingestionId: string,
+      filePaths: string[],
+      onResults: (results: any[], processedFiles: number, totalFiles: number) => void
+    ) => {
+      const results = filePaths.map((filePath) => filePath === 'broken.d'
+        ? { filePath, semanticModel: null, error: 'Parse error' }
+        : {
+          filePath,
+          semanticModel: {
+            dialogs: {},
+            functions: {},
+            constants: { TOPIC_X: { name: 'TOPIC_X', type: 'string', value: '"X"', filePath } },
+            variables: {},
+            instances: {},
+            hasErrors: false,
+            errors: []
+          }
+        });
+      onResults(results.slice(0, 2), 2, filePaths.length);
+      onResults(results.slice(2), filePaths.length, filePaths.length);
+      return { processedFiles: filePaths.length, cancelled: false };
+    });
+
+    const api = (window as any).editorAPI;
+    const originalParse = api.parseDialogFile;
+    api.parseDialogFile = parseDialogFileMock;
+    api.ingestProjectFiles = ingestProjectFilesMock;
+
+    try {
+      useProjectStore.setState({
+        allDialogFiles: files,
+        questFiles: ['quest.d'],
+        parsedFiles: new Map()
+      });
+
+      await useProjectStore.getState().startBackgroundIngestion();
+
+      const finalState = useProjectStore.getState();
+      expect(ingestProjectFilesMock).toHaveBeenCalledTimes(1);
+      expect(ingestProjectFilesMock.mock.calls[0][1]).toEqual(['quest.d', 'a.d', 'b.d', 'broken.d']);
+      expect(parseDialogFileMock).not.toHaveBeenCalled();
+      expect(finalState.parsedFiles.size).toBe(4);
+      expect(finalState.parsedFiles.get('a.d')?.semanticModel.constants.TOPIC_X.filePath).toBe('a.d');
+      expect(finalState.parsedFiles.get('broken.d')?.semanticModel.hasErrors).toBe(true);
+      expect(finalState.isIngesting).toBe(false);
+    } finally {
+      delete api.ingestProjectFiles;
+      api.parseDialogFile = originalParse;
+    }
+  });
 });
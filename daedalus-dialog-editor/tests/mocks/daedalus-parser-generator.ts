@@ -42,4 +42,14 @@ export class SemanticCodeGenerator {
     visit(model);
     return output;
   }
+  *generateSemanticModelChunks(model: any) {
+    yield this.generateSemanticModel(model);
+  }
+}
+
+export class GeneratedCodeCache {
+  getOrRender(_declaration: object, _variant: string, render: () => string): string {
+    return render();
+  }
+  clear(): void {}
 }
@@ -25,4 +25,14 @@ export class SemanticCodeGenerator {
     }
     return output;
   }
+  *generateSemanticModelChunks(model: any) {
+    yield this.generateSemanticModel(model);
+  }
+}
+
+export class GeneratedCodeCache {
+  getOrRender(_declaration: object, _variant: string, render: () => string): string {
+    return render();
+  }
+  clear(): void {}
 }
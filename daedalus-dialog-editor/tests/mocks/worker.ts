@@ -0,0 +1,9 @@
+/**
+ * Stand-in for Vite `?worker` imports under Jest, where web workers don't exist.
+ * Constructing it throws so callers take their in-thread fallback.
+ */
+export default class UnavailableWorker {
+  constructor() {
+    throw new Error('Web workers are not available in the test environment');
+  }
+}
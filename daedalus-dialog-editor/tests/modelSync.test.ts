@@ -0,0 +1,208 @@
+/**
+ * Tests for delta saves: model diffing, the main process document copy and
+ * the renderer-side sync client
+ */
+
+import { describe, test, expect, jest } from '@jest/globals';
+import { applyModelDelta, diffModels, type ModelDelta, type ModelTask } from '../src/shared/modelDelta';
+import { ModelDocumentService } from '../src/main/services/ModelDocumentService';
+import { generateCode, releaseModel, saveModel } from '../src/renderer/utils/modelSync';
+import type { EditorAPI, SemanticModel } from '../src/renderer/types/global';
+
+const settings = {
+  indentChar: '\t' as const,
+  includeComments: true,
+  sectionHeaders: true,
+  uppercaseKeywords: true
+};
+
+const createModel = (): SemanticModel => ({
+  dialogs: {
+    DIA_A: { name: 'DIA_A', parent: 'C_INFO', properties: { npc: 'NpcA', nr: 1 } } as any,
+    DIA_B: { name: 'DIA_B', parent: 'C_INFO', properties: { npc: 'NpcB', nr: 2 } } as any
+  },
+  functions: {
+    DIA_A_Info: { name: 'DIA_A_Info', returnType: 'VOID', actions: [], conditions: [], calls: [] } as any
+  },
+  hasErrors: false,
+  errors: []
+});
+
+/** What an Immer update of one dialog produces: a new dialogs map, other entries shared */
+const withDialog = (model: SemanticModel, name: string, npc: string): SemanticModel => ({
+  ...model,
+  dialogs: { ...model.dialogs, [name]: { ...model.dialogs[name], properties: { ...model.dialogs[name].properties, npc } } }
+});
+
+describe('diffModels / applyModelDelta', () => {
+  test('carries only the entries whose identity changed', () => {
+    const before = createModel();
+    const after = withDialog(before, 'DIA_A', 'Changed');
+
+    const delta = diffModels(before, after);
+    expect(Object.keys(delta.sections!)).toEqual(['dialogs']);
+    expect(Object.keys(delta.sections!.dialogs!.set!)).toEqual(['DIA_A']);
+    expect(delta.sections!.dialogs!.removed).toBeUndefined();
+
+    const applied = applyModelDelta(before, { baseVersion: 1, version: 2, ...delta });
+    expect(applied).toEqual(after);
+    expect(before.dialogs.DIA_A.properties.npc).toBe('NpcA');
+  });
+
+  test('records removals and additions', () => {
+    const before = createModel();
+    const { DIA_B: _removed, ...dialogs } = before.dialogs;
+    const after: SemanticModel = {
+      ...before,
+      dialogs,
+      functions: { ...before.functions, DIA_New: { name: 'DIA_New', returnType: 'INT' } as any }
+    };
+
+    const delta = diffModels(before, after);
+    expect(delta.sections!.dialogs!.removed).toEqual(['DIA_B']);
+    expect(Object.keys(delta.sections!.functions!.set!)).toEqual(['DIA_New']);
+    expect(applyModelDelta(before, { baseVersion: 1, version: 2, ...delta })).toEqual(after);
+  });
+
+  test('carries every other top-level value whose identity changed', () => {
+    const before: SemanticModel = {
+      ...createModel(),
+      declarationOrder: [{ type: 'dialog', name: 'DIA_A' }, { type: 'dialog', name: 'DIA_B' }]
+    };
+    const { hasErrors: _hasErrors, ...withoutHasErrors } = before;
+    const after = {
+      ...withoutHasErrors,
+      declarationOrder: [{ type: 'dialog' as const, name: 'DIA_B' }, { type: 'dialog' as const, name: 'DIA_A' }],
+      futureField: 1
+    } as unknown as SemanticModel;
+
+    const delta = diffModels(before, after);
+    expect(delta.sections).toBeUndefined();
+    expect(delta.fields).toEqual({ declarationOrder: after.declarationOrder, futureField: 1 });
+    expect(delta.removedFields).toEqual(['hasErrors']);
+    expect(applyModelDelta(before, { baseVersion: 1, version: 2, ...delta })).toEqual(after);
+  });
+});
+
+describe('ModelDocumentService', () => {
+  test('applies deltas in version order and asks for the full model otherwise', () => {
+    const documents = new ModelDocumentService();
+    const model = createModel();
+    const edited = withDialog(model, 'DIA_A', 'Changed');
+    const delta: ModelDelta = { baseVersion: 1, version: 2, ...diffModels(model, edited) };
+
+    expect(documents.apply('a.d', delta)).toBeNull();
+
+    documents.apply('a.d', { baseVersion: 0, version: 1, full: model });
+    expect(documents.apply('a.d', delta)).toEqual(edited);
+    expect(documents.getVersion('a.d')).toBe(2);
+
+    // Replaying the same delta no longer matches the held version
+    expect(documents.apply('a.d', delta)).toBeNull();
+
+    documents.release('a.d');
+    expect(documents.getVersion('a.d')).toBeUndefined();
+  });
+});
+
+describe('saveModel', () => {
+  const createApi = () => {
+    const documents = new ModelDocumentService();
+    const sent: ModelDelta[] = [];
+    const saveModelDelta = jest.fn(async (filePath: string, delta: ModelDelta) => {
+      sent.push(delta);
+      return documents.apply(filePath, delta) ? { success: true } : { success: false, needsFullModel: true };
+    });
+    const runModelTask = jest.fn(async (filePath: string, delta: ModelDelta, _task: ModelTask) => {
+      sent.push(delta);
+      return documents.apply(filePath, delta) ? { result: 'code' } : { needsFullModel: true };
+    });
+    const api = {
+      saveFile: jest.fn(),
+      generateCode: jest.fn(),
+      saveModelDelta,
+      runModelTask,
+      releaseModel: jest.fn((filePath: string) => documents.release(filePath))
+    } as unknown as EditorAPI;
+    return { api, documents, sent };
+  };
+
+  test('sends the full model once, then deltas', async () => {
+    const { api, sent } = createApi();
+    const model = createModel();
+    const edited = withDialog(model, 'DIA_B', 'Edited');
+
+    await expect(saveModel('sync-a.d', model, settings, undefined, api)).resolves.toEqual({ success: true });
+    await expect(saveModel('sync-a.d', edited, settings, undefined, api)).resolves.toEqual({ success: true });
+
+    expect(sent[0].full).toBe(model);
+    expect(sent[1].full).toBeUndefined();
+    expect(sent[1].baseVersion).toBe(sent[0].version);
+    expect(Object.keys(sent[1].sections!.dialogs!.set!)).toEqual(['DIA_B']);
+    expect(api.saveFile).not.toHaveBeenCalled();
+  });
+
+  test('resends the full model when the main process lost its copy', async () => {
+    const { api, documents, sent } = createApi();
+    const model = createModel();
+
+    await saveModel('sync-b.d', model, settings, undefined, api);
+    documents.clear();
+    await expect(saveModel('sync-b.d', withDialog(model, 'DIA_A', 'X'), settings, undefined, api))
+      .resolves.toEqual({ success: true });
+
+    expect(sent.map((delta) => !!delta.full)).toEqual([true, false, true]);
+  });
+
+  test('delta-saves a reordered model', async () => {
+    const { api, documents, sent } = createApi();
+    const model: SemanticModel = {
+      ...createModel(),
+      declarationOrder: [{ type: 'dialog', name: 'DIA_A' }, { type: 'function', name: 'DIA_A_Info' }, { type: 'dialog', name: 'DIA_B' }]
+    };
+    const reordered: SemanticModel = { ...model, declarationOrder: [...model.declarationOrder!].reverse() };
+
+    await saveModel('sync-order.d', model, settings, undefined, api);
+    await expect(saveModel('sync-order.d', reordered, settings, undefined, api)).resolves.toEqual({ success: true });
+
+    expect(sent[1].full).toBeUndefined();
+    expect(sent[1].sections).toBeUndefined();
+    expect(sent[1].fields).toEqual({ declarationOrder: reordered.declarationOrder });
+    // The main process copy the next save generates from has the new order
+    expect(documents.apply('sync-order.d', { baseVersion: 2, version: 3 })!.declarationOrder)
+      .toEqual(reordered.declarationOrder);
+  });
+
+  test('serializes concurrent saves of one file', async () => {
+    const { api, sent } = createApi();
+    const model = createModel();
+    const first = withDialog(model, 'DIA_A', 'First');
+    const second = withDialog(first, 'DIA_A', 'Second');
+
+    await saveModel('sync-c.d', model, settings, undefined, api);
+    await Promise.all([
+      saveModel('sync-c.d', first, settings, undefined, api),
+      saveModel('sync-c.d', second, settings, undefined, api)
+    ]);
+
+    expect(sent.map((delta) => delta.version)).toEqual([1, 2, 3]);
+    expect(sent.every((delta, index) => index === 0 || delta.baseVersion === sent[index - 1].version)).toBe(true);
+
+    releaseModel('sync-c.d', api);
+    expect(api.releaseModel).toHaveBeenCalledWith('sync-c.d');
+  });
+
+  test('previews share the copy saves keep, so an unchanged model sends an empty delta', async () => {
+    const { api, sent } = createApi();
+    const model = createModel();
+
+    await saveModel('sync-d.d', model, settings, undefined, api);
+    await expect(generateCode('sync-d.d', model, settings, api)).resolves.toBe('code');
+    await expect(generateCode('sync-d.d', model, settings, api)).resolves.toBe('code');
+
+    expect(sent.map((delta) => !!delta.full)).toEqual([true, false, false]);
+    expect(sent[1]).toEqual({ baseVersion: 1, version: 2 });
+    expect(sent[2]).toEqual({ baseVersion: 2, version: 3 });
+    expect(api.generateCode).not.toHaveBeenCalled();
+  });
+});
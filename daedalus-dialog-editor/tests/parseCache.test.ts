@@ -0,0 +1,122 @@
+/**
+ * Test suite for the content-addressed parse cache shared across projects
+ * @jest-environment node
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { configureParseCache, contentHash, getParseCache, ParseCache, useParseCache } from '../src/main/utils/parseCache';
+import { extractFileMetadata } from '../src/main/utils/semanticMetadataUtils';
+
+describe('ParseCache', () => {
+  let cacheDir: string;
+
+  beforeEach(() => {
+    cacheDir = fs.mkdtempSync(path.join(os.tmpdir(), 'parse-cache-'));
+  });
+
+  afterEach(() => {
+    configureParseCache(null);
+    fs.rmSync(cacheDir, { recursive: true, force: true });
+  });
+
+  /** Entry files of a namespace, relative to its directory */
+  const entryFiles = (namespace: string) => fs.readdirSync(path.join(cacheDir, namespace))
+    .flatMap((shard) => fs.readdirSync(path.join(cacheDir, namespace, shard)).map((name) => path.join(shard, name)))
+    .filter((name) => name.endsWith('.json'));
+
+  it('stores values by content hash and misses on unknown or corrupted entries', async () => {
+    const cache = new ParseCache({ directory: cacheDir, namespace: 'test' });
+    const hash = contentHash('instance Hero (C_NPC) {};');
+
+    expect(await cache.get('metadata', hash)).toBeUndefined();
+    await cache.set('metadata', hash, { isQuestFile: true });
+    expect(await cache.get('metadata', hash)).toEqual({ isQuestFile: true });
+    expect(await cache.get('model', hash)).toBeUndefined();
+
+    const [file] = entryFiles('test');
+    fs.writeFileSync(path.join(cacheDir, 'test', file), '{"trunc');
+    expect(await cache.get('metadata', hash)).toBeUndefined();
+    expect(entryFiles('test')).toEqual([]);
+  });
+
+  it('drops long unused namespaces and evicts least recently used entries over budget', async () => {
+    const stale = new ParseCache({ directory: cacheDir, namespace: 'old-parser' });
+    await stale.set('metadata', contentHash('old'), {});
+    const [staleFile] = entryFiles('old-parser');
+    fs.utimesSync(path.join(cacheDir, 'old-parser', staleFile), 1_000, 1_000);
+    // Another editor build still in use: kept, and counted toward the budget
+    const sibling = new ParseCache({ directory: cacheDir, namespace: 'other-build' });
+    await sibling.set('metadata', contentHash('sibling'), {});
+
+    const cache = new ParseCache({ directory: cacheDir, namespace: 'current', maxBytes: 3500 });
+    const payload = 'x'.repeat(1000);
+    const hashes = ['a', 'b', 'c', 'd'].map(contentHash);
+    for (const hash of hashes) {
+      await cache.set('model', hash, { payload });
+    }
+    // Last use order: b (oldest), d, a, c
+    const lastUsed = [3, 1, 4, 2];
+    const files = entryFiles('current');
+    expect(files).toHaveLength(4);
+    for (const file of files) {
+      const hash = path.basename(file).split('.')[0];
+      const seconds = 1_000_000 + lastUsed[hashes.indexOf(hash)] * 1000;
+      fs.utimesSync(path.join(cacheDir, 'current', file), seconds, seconds);
+    }
+
+    const result = await cache.prune();
+
+    expect(fs.existsSync(path.join(cacheDir, 'old-parser'))).toBe(false);
+    expect(entryFiles('other-build')).toHaveLength(1);
+    // The stale entry, then 4 entries of ~1KB over a 3.5KB budget: pruned down to 80% of it
+    expect(result.removedFiles).toBe(3);
+    expect(result.totalBytes).toBeLessThanOrEqual(3500 * 0.8);
+    expect(await cache.get('model', hashes[1])).toBeUndefined();
+    expect(await cache.get('model', hashes[3])).toBeUndefined();
+    expect(await cache.get('model', hashes[0])).toEqual({ payload });
+    expect(await cache.get('model', hashes[2])).toEqual({ payload });
+  });
+
+  it('serves metadata of identical files in another project without parsing', async () => {
+    const cache = configureParseCache({ directory: cacheDir, namespace: 'test' })!;
+    const source = 'instance DIA_Hero_Hello (C_INFO) { npc = Hero; };';
+    const firstProject = fs.mkdtempSync(path.join(os.tmpdir(), 'mod-a-'));
+    const secondProject = fs.mkdtempSync(path.join(os.tmpdir(), 'mod-b-'));
+    const firstFile = path.join(firstProject, 'DIA_Hero.d');
+    const secondFile = path.join(secondProject, 'DIA_Hero.d');
+    fs.writeFileSync(firstFile, source);
+    fs.writeFileSync(secondFile, source);
+
+    try {
+      const parsed = await extractFileMetadata(firstFile);
+      expect(parsed.dialogs).toEqual([{ dialogName: 'DIA_Hero_Hello', npc: 'Hero', filePath: firstFile }]);
+
+      // Prove the second read comes from the cache: tamper with the entry
+      const hash = contentHash(source);
+      const cached = await cache.get<any>('metadata', hash);
+      expect(cached.dialogs[0].filePath).toBeUndefined();
+      await cache.set('metadata', hash, { ...cached, dialogs: [{ dialogName: 'DIA_Hero_Hello', npc: 'FromCache' }] });
+
+      const reused = await extractFileMetadata(secondFile);
+      expect(reused.dialogs).toEqual([{ dialogName: 'DIA_Hero_Hello', npc: 'FromCache', filePath: secondFile }]);
+    } finally {
+      fs.rmSync(firstProject, { recursive: true, force: true });
+      fs.rmSync(secondProject, { recursive: true, force: true });
+    }
+  });
+
+  it('sets up the worker cache from job options once and keeps it while they match', () => {
+    expect(useParseCache(undefined)).toBeNull();
+
+    const options = new ParseCache({ directory: cacheDir, namespace: 'test' }).options;
+    const cache = useParseCache(options);
+    expect(cache).toBe(getParseCache());
+    expect(useParseCache({ ...options })).toBe(cache);
+
+    const upgraded = useParseCache({ ...options, namespace: 'next' });
+    expect(upgraded).not.toBe(cache);
+    expect(upgraded!.namespace).toBe('next');
+  });
+});
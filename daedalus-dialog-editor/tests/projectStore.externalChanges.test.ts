@@ -0,0 +1,79 @@
+import { describe, test, expect, beforeEach, jest } from '@jest/globals';
+import { useProjectStore } from '../src/renderer/store/projectStore';
+import type { SemanticModel } from '../src/renderer/types/global';
+
+const createModel = (): SemanticModel => ({
+  dialogs: {},
+  functions: {},
+  constants: {},
+  variables: {},
+  instances: {},
+  hasErrors: false,
+  errors: []
+});
+
+describe('projectStore - external changes', () => {
+  beforeEach(() => {
+    useProjectStore.getState().closeProject();
+    jest.clearAllMocks();
+  });
+
+  test('applies file deltas to the index and re-parses only changed files', async () => {
+    const staleModel = createModel();
+    const untouchedModel = createModel();
+    const parseDialogFileMock = jest.fn(async (_filePath: string) => createModel());
+    (window as any).editorAPI.parseDialogFile = parseDialogFileMock;
+
+    const bennetDialogs = [{ dialogName: 'DIA_Bennet_Hallo', npc: 'Bennet', filePath: '/p/Bennet.d' }];
+    const lareesDialogs = [{ dialogName: 'DIA_Lares_Hallo', npc: 'Lares', filePath: '/p/Lares.d' }];
+    useProjectStore.setState({
+      projectPath: '/p',
+      npcList: ['Bennet', 'Lares'],
+      dialogIndex: new Map([['Bennet', bennetDialogs], ['Lares', lareesDialogs]]),
+      allDialogFiles: ['/p/Bennet.d', '/p/Lares.d', '/p/Old.d'],
+      questFiles: ['/p/Old.d'],
+      parsedFiles: new Map([
+        ['/p/Bennet.d', { filePath: '/p/Bennet.d', semanticModel: staleModel, lastParsed: new Date() }],
+        ['/p/Lares.d', { filePath: '/p/Lares.d', semanticModel: untouchedModel, lastParsed: new Date() }],
+        ['/p/Old.d', { filePath: '/p/Old.d', semanticModel: createModel(), lastParsed: new Date() }]
+      ])
+    });
+
+    useProjectStore.getState().applyProjectChanges([
+      {
+        filePath: '/p/Bennet.d',
+        metadata: {
+          dialogs: [{ dialogName: 'DIA_Bennet_Trade', npc: 'Bennet', filePath: '/p/Bennet.d' }],
+          instances: [],
+          prototypes: [],
+          isQuestFile: false
+        }
+      },
+      { filePath: '/p/Old.d', metadata: null },
+      {
+        filePath: '/p/Npcs.d',
+        metadata: {
+          dialogs: [],
+          instances: [{ name: 'Gorn', parent: 'Npc_Default' }],
+          prototypes: [{ name: 'Npc_Default', parent: 'C_NPC' }],
+          isQuestFile: true
+        }
+      }
+    ]);
+
+    const state = useProjectStore.getState();
+    expect(state.npcList).toEqual(['Bennet', 'Gorn', 'Lares']);
+    expect(state.dialogIndex.get('Bennet')!.map((dialog) => dialog.dialogName)).toEqual(['DIA_Bennet_Trade']);
+    expect(state.dialogIndex.get('Lares')).toBe(lareesDialogs);
+    expect(state.allDialogFiles).toEqual(['/p/Bennet.d', '/p/Lares.d', '/p/Npcs.d']);
+    expect(state.questFiles).toEqual(['/p/Npcs.d']);
+    expect(state.parsedFiles.has('/p/Old.d')).toBe(false);
+
+    await new Promise((resolve) => setTimeout(resolve, 0));
+
+    expect(parseDialogFileMock.mock.calls.map(([filePath]) => filePath).sort()).toEqual(['/p/Bennet.d', '/p/Npcs.d']);
+    const refreshed = useProjectStore.getState().parsedFiles;
+    expect(refreshed.get('/p/Bennet.d')!.semanticModel).not.toBe(staleModel);
+    expect(refreshed.get('/p/Lares.d')!.semanticModel).toBe(untouchedModel);
+  });
+});
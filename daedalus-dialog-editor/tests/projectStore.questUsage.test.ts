@@ -242,4 +242,56 @@ describe('ProjectStore - getQuestUsage', () => {
     expect(conditionRequiresEdges.length).toBeGreaterThan(0);
     expect(externalEntryEdges).toHaveLength(0);
   });
+
+  it('keeps the quest symbol index in sync with file model updates', () => {
+    const writerPath = '/dialogs/writer.d';
+    const readerPath = '/dialogs/reader.d';
+    const writer = createEmptyModel();
+    writer.functions = {
+      DIA_Test_Start: {
+        name: 'DIA_Test_Start',
+        returnType: 'VOID',
+        actions: [{ type: 'SetVariableAction', variableName: 'MIS_TEST', operator: '=', value: 'LOG_RUNNING' }],
+        conditions: [],
+        calls: []
+      }
+    };
+    const reader = createEmptyModel();
+    reader.functions = {
+      DIA_Test_Done_Condition: {
+        name: 'DIA_Test_Done_Condition',
+        returnType: 'INT',
+        actions: [],
+        conditions: [{ type: 'VariableCondition', variableName: 'mis_test', negated: false, operator: '==', value: 'LOG_RUNNING' }],
+        calls: []
+      }
+    };
+
+    useProjectStore.setState({
+      parsedFiles: new Map([
+        [writerPath, { filePath: writerPath, semanticModel: writer, lastParsed: new Date('2026-02-17T00:00:00Z') }],
+        [readerPath, { filePath: readerPath, semanticModel: reader, lastParsed: new Date('2026-02-17T00:00:00Z') }]
+      ])
+    });
+
+    const references = useProjectStore.getState().getQuestSymbolReferences('MIS_Test');
+    expect(references.map((ref) => [ref.functionName, ref.role])).toEqual([
+      ['DIA_Test_Start', 'writes'],
+      ['DIA_Test_Done_Condition', 'reads']
+    ]);
+    expect(Object.keys(useProjectStore.getState().getQuestUsage('TOPIC_TEST').functions)).toEqual([
+      'DIA_Test_Start',
+      'DIA_Test_Done_Condition'
+    ]);
+
+    // Replacing a file's model drops its stale references
+    useProjectStore.getState().updateFileModel(writerPath, createEmptyModel());
+
+    expect(useProjectStore.getState().getQuestSymbolReferences('MIS_TEST').map((ref) => ref.functionName)).toEqual([
+      'DIA_Test_Done_Condition'
+    ]);
+    expect(Object.keys(useProjectStore.getState().getQuestUsage('TOPIC_TEST').functions)).toEqual([
+      'DIA_Test_Done_Condition'
+    ]);
+  });
 });
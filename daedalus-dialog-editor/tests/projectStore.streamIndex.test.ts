@@ -0,0 +1,78 @@
+import { describe, test, expect, beforeEach, jest } from '@jest/globals';
+import { useProjectStore } from '../src/renderer/store/projectStore';
+import type { ProjectIndexBatch } from '../src/renderer/types/global';
+
+const progress = { discoveredFiles: 2, processedFiles: 1, scanComplete: false };
+
+describe('projectStore - streamed project index', () => {
+  beforeEach(() => {
+    useProjectStore.getState().closeProject();
+    jest.clearAllMocks();
+  });
+
+  test('merges batches into a sorted NPC list while the index is built', async () => {
+    const snapshots: Array<{ npcList: string[]; dialogs: Record<string, string[]> }> = [];
+    const takeSnapshot = () => {
+      const state = useProjectStore.getState();
+      snapshots.push({
+        npcList: state.npcList,
+        dialogs: Object.fromEntries(
+          [...state.dialogIndex].map(([npc, dialogs]) => [npc, dialogs.map(d => d.dialogName)])
+        )
+      });
+    };
+
+    const batches: ProjectIndexBatch[] = [
+      {
+        npcs: ['Xardas', 'Bennet'],
+        dialogs: [
+          { dialogName: 'DIA_Xardas_Hallo', npc: 'Xardas', filePath: '/p/Xardas.d' },
+          { dialogName: 'DIA_Xardas_Job', npc: 'Xardas', filePath: '/p/Xardas.d' }
+        ],
+        files: ['/p/Xardas.d', '/p/Bennet.d'],
+        questFiles: [],
+        progress
+      },
+      {
+        npcs: ['Lares', 'Abuyin'],
+        dialogs: [
+          { dialogName: 'DIA_Xardas_End', npc: 'Xardas', filePath: '/p/Xardas2.d' },
+          { dialogName: 'DIA_Lares_Hallo', npc: 'Lares', filePath: '/p/Lares.d' }
+        ],
+        files: ['/p/Lares.d'],
+        questFiles: [],
+        progress: { ...progress, processedFiles: 2, scanComplete: true }
+      }
+    ];
+
+    const api = (window as any).editorAPI;
+    const original = api.streamProjectIndex;
+    api.streamProjectIndex = jest.fn(async (_folderPath: string, onBatch: (batch: ProjectIndexBatch) => void) => {
+      batches.forEach((batch) => {
+        onBatch(batch);
+        takeSnapshot();
+      });
+      return {
+        npcs: ['Abuyin', 'Bennet', 'Lares', 'Xardas'],
+        dialogsByNpc: {},
+        allFiles: [],
+        questFiles: []
+      };
+    });
+
+    try {
+      await useProjectStore.getState().openProject('/p');
+    } finally {
+      api.streamProjectIndex = original;
+    }
+
+    expect(snapshots[0].npcList).toEqual(['Bennet', 'Xardas']);
+    expect(snapshots[1].npcList).toEqual(['Abuyin', 'Bennet', 'Lares', 'Xardas']);
+    expect(snapshots[1].dialogs).toEqual({
+      Abuyin: [],
+      Bennet: [],
+      Lares: ['DIA_Lares_Hallo'],
+      Xardas: ['DIA_Xardas_Hallo', 'DIA_Xardas_Job', 'DIA_Xardas_End']
+    });
+  });
+});
@@ -0,0 +1,250 @@
+import * as fs from 'fs';
+import * as path from 'path';
+import { buildQuestGraph } from '../src/renderer/quest/domain/graph';
+import { clearQuestLayoutCache } from '../src/renderer/components/QuestEditor/questGraphUtils';
+import {
+  QuestGraphService,
+  diffQuestGraphModel,
+  isEmptyQuestGraphPatch
+} from '../src/renderer/components/QuestEditor/questGraphService';
+import { QuestGraphClient } from '../src/renderer/components/QuestEditor/questGraphClient';
+import type { SemanticModel } from '../src/renderer/types/global';
+
+const QUEST = 'TOPIC_SHEEP';
+const MIS = 'MIS_SHEEP';
+const OTHER_QUEST = 'TOPIC_WOLF';
+
+const createModel = (): SemanticModel => ({
+  dialogs: {
+    DIA_Start: { name: 'DIA_Start', properties: { information: 'DIA_Start_Info', npc: 'NPC_Farmer' } },
+    DIA_Done: { name: 'DIA_Done', properties: { information: 'DIA_Done_Info', npc: 'NPC_Farmer' } }
+  },
+  functions: {
+    DIA_Start_Info: {
+      name: 'DIA_Start_Info',
+      actions: [{ type: 'CreateTopic', topic: QUEST, topicType: 'LOG_MISSION' }],
+      conditions: []
+    },
+    DIA_Done_Info: {
+      name: 'DIA_Done_Info',
+      actions: [{ type: 'LogSetTopicStatus', topic: QUEST, status: 'LOG_SUCCESS' }],
+      conditions: [{ type: 'VariableCondition', variableName: MIS, operator: '==', value: 1 }]
+    },
+    Unrelated_Func: {
+      name: 'Unrelated_Func',
+      actions: [{ type: 'SetVariableAction', variableName: 'OTHER', operator: '=', value: 1 }],
+      conditions: []
+    },
+    DIA_Wolf_Info: {
+      name: 'DIA_Wolf_Info',
+      actions: [{ type: 'CreateTopic', topic: OTHER_QUEST, topicType: 'LOG_MISSION' }],
+      conditions: []
+    }
+  },
+  variables: {},
+  hasErrors: false,
+  errors: []
+} as unknown as SemanticModel);
+
+describe('questGraphService', () => {
+  it('builds the same graph from patches as from the full model', () => {
+    const model = createModel();
+    const service = new QuestGraphService();
+    service.applyPatch(diffQuestGraphModel(null, model));
+
+    expect(service.build(QUEST)).toEqual(buildQuestGraph(model, QUEST));
+  });
+
+  it('diffs models by entry identity', () => {
+    const model = createModel();
+    const edited: SemanticModel = {
+      ...model,
+      functions: {
+        ...model.functions,
+        DIA_Done_Info: { ...model.functions.DIA_Done_Info, actions: [] }
+      }
+    };
+    delete (edited.functions as Record<string, unknown>).Unrelated_Func;
+
+    const patch = diffQuestGraphModel(model, edited);
+    expect(patch.reset).toBe(false);
+    expect(Object.keys(patch.functions || {})).toEqual(['DIA_Done_Info']);
+    expect(patch.removedFunctions).toEqual(['Unrelated_Func']);
+    expect(patch.dialogs).toBeUndefined();
+    expect(isEmptyQuestGraphPatch(diffQuestGraphModel(edited, edited))).toBe(true);
+  });
+
+  it('reuses cached graphs until the model changes', () => {
+    const model = createModel();
+    const builder = jest.fn(buildQuestGraph);
+    const service = new QuestGraphService(builder);
+    service.applyPatch(diffQuestGraphModel(null, model));
+
+    const first = service.build(QUEST);
+    expect(service.build(QUEST)).toBe(first);
+    expect(builder).toHaveBeenCalledTimes(1);
+
+    const edited: SemanticModel = {
+      ...model,
+      functions: {
+        ...model.functions,
+        DIA_Done_Info: {
+          ...model.functions.DIA_Done_Info,
+          actions: [{ type: 'LogSetTopicStatus', topic: QUEST, status: 'LOG_FAILED' }]
+        }
+      } as SemanticModel['functions']
+    };
+    service.applyPatch(diffQuestGraphModel(model, edited));
+
+    const rebuilt = service.build(QUEST);
+    expect(builder).toHaveBeenCalledTimes(2);
+    expect(rebuilt).toEqual(buildQuestGraph(edited, QUEST));
+    const doneNode = rebuilt.nodes.find((node) => node.id === 'DIA_Done_Info');
+    expect(doneNode?.data.type).toBe('failed');
+  });
+
+  it('rebuilds only the graphs of quests a patch touches', () => {
+    const model = createModel();
+    const builder = jest.fn(buildQuestGraph);
+    const service = new QuestGraphService(builder);
+    service.applyPatch(diffQuestGraphModel(null, model));
+
+    const sheep = service.build(QUEST);
+    const wolf = service.build(OTHER_QUEST);
+    expect(builder).toHaveBeenCalledTimes(2);
+
+    const withFunction = (current: SemanticModel, func: SemanticModel['functions'][string]): SemanticModel => ({
+      ...current,
+      functions: { ...current.functions, [func.name]: func }
+    });
+
+    // Neither quest reads or writes OTHER
+    const unrelated = withFunction(model, { ...model.functions.Unrelated_Func, actions: [] });
+    service.applyPatch(diffQuestGraphModel(model, unrelated));
+    expect(service.build(QUEST)).toBe(sheep);
+    expect(service.build(OTHER_QUEST)).toBe(wolf);
+
+    const wolfEdited = withFunction(unrelated, {
+      ...unrelated.functions.DIA_Wolf_Info,
+      actions: [
+        ...unrelated.functions.DIA_Wolf_Info.actions,
+        { type: 'LogEntry', topic: OTHER_QUEST, text: 'Wolves!' }
+      ]
+    } as SemanticModel['functions'][string]);
+    service.applyPatch(diffQuestGraphModel(unrelated, wolfEdited));
+    expect(service.build(QUEST)).toBe(sheep);
+    expect(service.build(OTHER_QUEST)).not.toBe(wolf);
+    expect(builder).toHaveBeenCalledTimes(3);
+
+    // A new function that starts writing the quest's variable joins its graph
+    const joined = withFunction(wolfEdited, {
+      name: 'Sheep_Trigger',
+      actions: [{ type: 'SetVariableAction', variableName: MIS, operator: '=', value: 2 }],
+      conditions: []
+    } as unknown as SemanticModel['functions'][string]);
+    service.applyPatch(diffQuestGraphModel(wolfEdited, joined));
+    expect(service.build(QUEST)).toEqual(buildQuestGraph(joined, QUEST));
+    expect(service.build(QUEST).nodes.some((node) => node.id === 'Sheep_Trigger')).toBe(true);
+  });
+
+  it('keeps laid-out nodes in place when nodes are added', () => {
+    clearQuestLayoutCache();
+    const model = createModel();
+    const before = buildQuestGraph(model, QUEST);
+
+    const edited: SemanticModel = {
+      ...model,
+      dialogs: {
+        ...model.dialogs,
+        DIA_Report: { name: 'DIA_Report', properties: { information: 'DIA_Report_Info', npc: 'NPC_Farmer' } }
+      },
+      functions: {
+        ...model.functions,
+        DIA_Report_Info: {
+          name: 'DIA_Report_Info',
+          actions: [{ type: 'LogEntry', topic: QUEST, text: 'Found the sheep' }],
+          conditions: [{ type: 'VariableCondition', variableName: MIS, operator: '==', value: 1 }]
+        }
+      }
+    } as unknown as SemanticModel;
+    const onPartial = jest.fn();
+    const after = buildQuestGraph(edited, QUEST, undefined, onPartial);
+
+    const positions = (nodes: typeof before.nodes) =>
+      new Map(nodes.filter((node) => node.type !== 'group').map((node) => [node.id, node.position]));
+    const previous = positions(before.nodes);
+    const next = positions(after.nodes);
+    previous.forEach((position, id) => expect(next.get(id)).toEqual(position));
+
+    const added = after.nodes.find((node) => node.id === 'DIA_Report_Info')!;
+    expect(added).toBeDefined();
+    const overlaps = after.nodes.some((node) => node.type !== 'group' && node.id !== added.id &&
+      Math.abs(node.position.x - added.position.x) < 280 && Math.abs(node.position.y - added.position.y) < 132);
+    expect(overlaps).toBe(false);
+    // Placing a few nodes is quick; only full layouts post a partial graph first
+    expect(onPartial).not.toHaveBeenCalled();
+  });
+
+  it('posts the graph before a full layout', () => {
+    clearQuestLayoutCache();
+    const model = createModel();
+    const onPartial = jest.fn();
+
+    const graph = buildQuestGraph(model, QUEST, undefined, onPartial);
+
+    expect(onPartial).toHaveBeenCalledTimes(1);
+    const partial = onPartial.mock.calls[0][0] as typeof graph;
+    expect(partial.edges).toEqual(graph.edges);
+    expect(partial.nodes.map((node) => node.id).sort()).toEqual(graph.nodes.map((node) => node.id).sort());
+
+    buildQuestGraph(model, QUEST, undefined, onPartial);
+    expect(onPartial).toHaveBeenCalledTimes(1);
+  });
+
+  it('falls back to in-thread building when workers are unavailable', async () => {
+    const model = createModel();
+    const client = new QuestGraphClient();
+
+    const graph = await client.build(model, QUEST);
+    expect(graph).toEqual(buildQuestGraph(model, QUEST));
+    client.dispose();
+  });
+});
+
+describe('quest graph worker bundle', () => {
+  /**
+   * Runtime (non type-only) imports reachable from `entry` through relative
+   * imports, i.e. the packages the worker bundle pulls in
+   */
+  const collectRuntimePackages = (entry: string): Set<string> => {
+    const packages = new Set<string>();
+    const seen = new Set<string>();
+    const visit = (file: string) => {
+      if (seen.has(file)) return;
+      seen.add(file);
+      const source = fs.readFileSync(file, 'utf8');
+      for (const match of source.matchAll(/^import\s+(type\s+)?[^;]*?from\s+'([^']+)'/gm)) {
+        const [, typeOnly, specifier] = match;
+        if (typeOnly) continue;
+        if (!specifier.startsWith('.')) {
+          packages.add(specifier);
+          continue;
+        }
+        const base = path.resolve(path.dirname(file), specifier);
+        const resolved = ['.ts', '.tsx', '/index.ts'].map((ext) => base + ext).find((candidate) => fs.existsSync(candidate));
+        if (resolved) visit(resolved);
+      }
+    };
+    visit(entry);
+    return packages;
+  };
+
+  test('does not pull React or reactflow into the worker', () => {
+    const packages = collectRuntimePackages(
+      path.resolve(__dirname, '../src/renderer/components/QuestEditor/questGraph.worker.ts')
+    );
+    expect(packages.has('dagre')).toBe(true);
+    expect(packages.has('reactflow')).toBe(false);
+    expect(packages.has('react')).toBe(false);
+  });
+});
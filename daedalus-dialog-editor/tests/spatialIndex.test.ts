@@ -0,0 +1,74 @@
+import { QuadTree, boundsOverlap, type Bounds } from '../src/renderer/components/QuestEditor/spatialIndex';
+import { buildQuestOverviewGraph, parseQuestOverviewNodeId } from '../src/renderer/quest/domain/graph';
+import type { SemanticModel } from '../src/renderer/types/global';
+
+describe('QuadTree', () => {
+  const grid = (): Array<{ id: string; bounds: Bounds }> => {
+    const items: Array<{ id: string; bounds: Bounds }> = [];
+    for (let row = 0; row < 40; row++) {
+      for (let col = 0; col < 40; col++) {
+        items.push({ id: `${row}-${col}`, bounds: [col * 300, row * 200, 220, 120] });
+      }
+    }
+    return items;
+  };
+
+  it('returns exactly the items overlapping the query area', () => {
+    const items = grid();
+    const tree = QuadTree.fromItems(items, (item) => item.bounds);
+    const viewport: Bounds = [1000, 900, 1280, 720];
+
+    const expected = items.filter((item) => boundsOverlap(viewport, item.bounds)).map((item) => item.id).sort();
+    const actual = tree.query(viewport).map((item) => item.id).sort();
+
+    expect(tree.size).toBe(1600);
+    expect(actual).toEqual(expected);
+    expect(actual.length).toBeLessThan(40);
+  });
+
+  it('keeps items that straddle split lines queryable', () => {
+    const items = [
+      ...grid(),
+      { id: 'wide', bounds: [-50, 3000, 12000, 40] as Bounds }
+    ];
+    const tree = QuadTree.fromItems(items, (item) => item.bounds);
+
+    expect(tree.query([5000, 3010, 10, 10]).map((item) => item.id)).toContain('wide');
+    expect(tree.query([-1000, -1000, 10, 10])).toEqual([]);
+  });
+
+  it('handles an empty item set', () => {
+    expect(QuadTree.fromItems([], () => [0, 0, 0, 0]).query([0, 0, 100, 100])).toEqual([]);
+  });
+});
+
+describe('buildQuestOverviewGraph', () => {
+  const model = {
+    dialogs: {
+      DIA_A: { name: 'DIA_A', properties: { information: 'DIA_A_Info', npc: 'NPC_A' } },
+      DIA_B: { name: 'DIA_B', properties: { information: 'DIA_B_Info', npc: 'NPC_B' } }
+    },
+    functions: {
+      DIA_A_Info: { name: 'DIA_A_Info', actions: [{ type: 'CreateTopic', topic: 'TOPIC_A', topicType: 'LOG_MISSION' }], conditions: [] },
+      DIA_B_Info: { name: 'DIA_B_Info', actions: [{ type: 'CreateTopic', topic: 'TOPIC_B', topicType: 'LOG_MISSION' }], conditions: [] }
+    },
+    variables: {},
+    hasErrors: false,
+    errors: []
+  } as unknown as SemanticModel;
+
+  it('stacks quests on separate bands with prefixed ids', () => {
+    const overview = buildQuestOverviewGraph(model, ['TOPIC_B', 'TOPIC_A']);
+    const bands = overview.nodes.filter((node) => node.id.endsWith('::band'));
+    expect(bands.map((node) => node.data.label)).toEqual(['TOPIC_A', 'TOPIC_B']);
+    expect(bands[1].position.y).toBeGreaterThan(bands[0].position.y);
+
+    const questANode = overview.nodes.find((node) => node.id === 'TOPIC_A::DIA_A_Info');
+    expect(questANode).toBeDefined();
+    expect(parseQuestOverviewNodeId(questANode!.id)).toEqual({ questName: 'TOPIC_A', nodeId: 'DIA_A_Info' });
+    overview.edges.forEach((edge) => {
+      expect(overview.nodes.some((node) => node.id === edge.source)).toBe(true);
+      expect(overview.nodes.some((node) => node.id === edge.target)).toBe(true);
+    });
+  });
+});
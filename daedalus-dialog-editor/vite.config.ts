@@ -13,9 +13,17 @@ export default defineConfig({
   plugins: [react()],
   root: path.join(__dirname, 'src/renderer'),
   base: './',
+  // daedalus-parser/tracing is a linked CommonJS workspace package; both the dev
+  // server and the build have to convert it to ESM explicitly
+  optimizeDeps: {
+    include: ['daedalus-parser/tracing'],
+  },
   build: {
     outDir: path.join(__dirname, 'dist/renderer'),
     emptyOutDir: true,
+    commonjsOptions: {
+      include: [/daedalus-parser/, /node_modules/],
+    },
     rollupOptions: {
       input: {
         main: fileURLToPath(new URL('./src/renderer/index.html', import.meta.url)),
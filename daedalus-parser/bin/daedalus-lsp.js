@@ -0,0 +1,34 @@
+#!/usr/bin/env node
+
+const { DaedalusLanguageServer } = require('../src/lsp/server');
+
+function printUsage() {
+  console.log(`
+Usage: daedalus-lsp [--stdio]
+
+Runs the Daedalus language server over stdin/stdout. Point your editor's
+LSP client at this command for .d files. The server indexes every .d file
+under the workspace folders and provides diagnostics, go to definition,
+references, document symbols and completion.
+`);
+}
+
+function main() {
+  const args = process.argv.slice(2);
+  if (args.includes('--help') || args.includes('-h')) {
+    printUsage();
+    return;
+  }
+
+  // stdout carries the protocol; route stray console output to stderr
+  console.log = console.error;
+  console.info = console.error;
+
+  new DaedalusLanguageServer({
+    input: process.stdin,
+    output: process.stdout,
+    onExit: (code) => process.exit(code)
+  });
+}
+
+main();
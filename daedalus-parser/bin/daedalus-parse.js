@@ -1,17 +1,28 @@
 #!/usr/bin/env node
 
 const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { Worker, isMainThread, parentPort, workerData } = require('worker_threads');
 const DaedalusParser = require('../src/core/parser');
 
+const BATCH_EXTENSION = '.d';
+const BATCH_SKIPPED_DIRECTORIES = new Set(['.git', '.svn', 'node_modules']);
+const GLOB_CHARS = /[*?]/;
+
 function printUsage() {
   console.log(`
 Usage: npm run parse <file> [options]
+       npm run parse <file|directory|glob>... --batch [--jobs <n>]
 
 Options:
   --json          Output as JSON
   --declarations  Show only declarations
   --comments      Show only comments
   --stats         Show parsing statistics
+  --batch         Parse many files in parallel and stream NDJSON records
+                  (implied by directories, globs or several inputs)
+  --jobs <n>      Worker threads for batch mode (default: CPU count)
   --help         Show this help
 
 Examples:
@@ -20,6 +31,13 @@ Examples:
   npm run parse examples/DEV_2130_Szmyk.d --declarations
   npm run parse examples/DIA_DEV_2130_Szmyk.d --comments
   npm run parse examples/DIA_DEV_2130_Szmyk.d --stats
+  npm run parse -- examples --batch --jobs 4
+  npm run parse -- "mods/**/DIA_*.d"
+
+Batch mode writes one JSON object per line: a "file" record per parsed file
+(declarations, syntax errors, timings) in completion order, then a "summary"
+record with aggregate throughput, p50/p95/p99 per-file latency and peak RSS.
+It exits with status 1 if any file is missing, unreadable or has syntax errors.
 `);
 }
 
@@ -37,6 +55,307 @@ function formatTime(ms) {
   return `${(ms / 1000).toFixed(2)}s`;
 }
 
+/**
+ * Convert a glob (`*`, `?`, `**`) over forward-slash paths into a RegExp
+ */
+function globToRegExp(pattern) {
+  let source = '';
+  for (let i = 0; i < pattern.length; i++) {
+    const char = pattern[i];
+    if (char === '*' && pattern[i + 1] === '*') {
+      // '**/' spans zero or more directories
+      if (pattern[i + 2] === '/') {
+        source += '(?:.*/)?';
+        i += 2;
+      } else {
+        source += '.*';
+        i += 1;
+      }
+    } else if (char === '*') {
+      source += '[^/]*';
+    } else if (char === '?') {
+      source += '[^/]';
+    } else {
+      source += char.replace(/[.+^${}()|[\]\\]/g, '\\$&');
+    }
+  }
+  return new RegExp(`^${source}$`, process.platform === 'win32' ? 'i' : '');
+}
+
+function toSlashPath(filePath) {
+  return filePath.split(path.sep).join('/');
+}
+
+/**
+ * List files below `rootDir`, skipping VCS and dependency directories
+ */
+function walkFiles(rootDir, onFile) {
+  const stack = [rootDir];
+  while (stack.length > 0) {
+    const dir = stack.pop();
+    let entries;
+    try {
+      entries = fs.readdirSync(dir, { withFileTypes: true });
+    } catch {
+      continue;
+    }
+    for (const entry of entries) {
+      const fullPath = path.join(dir, entry.name);
+      if (entry.isDirectory()) {
+        if (!BATCH_SKIPPED_DIRECTORIES.has(entry.name)) {
+          stack.push(fullPath);
+        }
+      } else if (entry.isFile()) {
+        onFile(fullPath);
+      }
+    }
+  }
+}
+
+function isDaedalusFile(filePath) {
+  return path.extname(filePath).toLowerCase() === BATCH_EXTENSION;
+}
+
+/**
+ * Expand files, directories and globs into a sorted, de-duplicated file list
+ * @returns {{files: string[], missing: string[]}}
+ */
+function collectBatchFiles(inputs) {
+  const files = new Set();
+  const missing = [];
+
+  inputs.forEach((input) => {
+    if (GLOB_CHARS.test(input)) {
+      const pattern = toSlashPath(path.resolve(input));
+      const segments = pattern.split('/');
+      const firstGlob = segments.findIndex((segment) => GLOB_CHARS.test(segment));
+      const baseDir = segments.slice(0, firstGlob).join('/') || '/';
+      const matcher = globToRegExp(pattern);
+      const before = files.size;
+      walkFiles(baseDir, (filePath) => {
+        if (matcher.test(toSlashPath(filePath))) {
+          files.add(filePath);
+        }
+      });
+      if (files.size === before) {
+        missing.push(input);
+      }
+      return;
+    }
+
+    const fullPath = path.resolve(input);
+    let stats;
+    try {
+      stats = fs.statSync(fullPath);
+    } catch {
+      missing.push(input);
+      return;
+    }
+    if (stats.isDirectory()) {
+      walkFiles(fullPath, (filePath) => {
+        if (isDaedalusFile(filePath)) {
+          files.add(filePath);
+        }
+      });
+    } else {
+      files.add(fullPath);
+    }
+  });
+
+  return { files: Array.from(files).sort(), missing };
+}
+
+/**
+ * Parse one file inside a batch worker into a serializable record
+ */
+function parseBatchFile(parser, filePath) {
+  const startTime = process.hrtime.bigint();
+  const elapsedMs = () => Number(process.hrtime.bigint() - startTime) / 1_000_000;
+
+  try {
+    const result = parser.parseFile(filePath);
+    const declarations = parser.extractDeclarations(result).map((decl) => {
+      const { node: _node, startPosition, endPosition: _endPosition, ...fields } = decl;
+      return { ...fields, line: startPosition.row + 1, column: startPosition.column + 1 };
+    });
+    const errors = (result.errors || []).map((error) => ({
+      type: error.type,
+      message: error.message,
+      line: error.position.row + 1,
+      column: error.position.column + 1
+    }));
+    const record = {
+      type: 'file',
+      file: filePath,
+      status: result.hasErrors ? 'error' : 'ok',
+      encoding: result.encoding,
+      sourceLength: result.sourceLength,
+      parseTime: result.parseTime,
+      declarations,
+      errors
+    };
+    DaedalusParser.disposeResult(result);
+    record.latency = elapsedMs();
+    return record;
+  } catch (error) {
+    return { type: 'file', file: filePath, status: 'failed', message: error.message, latency: elapsedMs() };
+  }
+}
+
+function runBatchWorker() {
+  // One parser per thread, reused for every file this worker receives
+  const parser = DaedalusParser.acquire();
+  parentPort.on('message', (filePath) => {
+    parentPort.postMessage(parseBatchFile(parser, filePath));
+  });
+}
+
+/**
+ * Nearest-rank percentile of an ascending list
+ */
+function percentile(sortedValues, p) {
+  if (sortedValues.length === 0) {
+    return 0;
+  }
+  const rank = Math.ceil((p / 100) * sortedValues.length);
+  return sortedValues[Math.min(sortedValues.length, Math.max(rank, 1)) - 1];
+}
+
+function writeRecord(record) {
+  process.stdout.write(`${JSON.stringify(record)}\n`);
+}
+
+/**
+ * Fan files out over worker threads, streaming a record per file as it completes
+ * @returns {Promise<number>} Process exit code
+ */
+function runBatch(inputs, jobs) {
+  const startTime = process.hrtime.bigint();
+  const { files, missing } = collectBatchFiles(inputs);
+  missing.forEach((input) => writeRecord({ type: 'file', file: input, status: 'missing' }));
+
+  const latencies = [];
+  const counts = { ok: 0, error: 0, failed: 0, missing: missing.length };
+  let totalBytes = 0;
+  let nextIndex = 0;
+  const workerCount = Math.max(0, Math.min(jobs, files.length));
+
+  const finish = () => {
+    const wallTimeMs = Number(process.hrtime.bigint() - startTime) / 1_000_000;
+    latencies.sort((a, b) => a - b);
+    writeRecord({
+      type: 'summary',
+      files: files.length,
+      ...counts,
+      workers: workerCount,
+      totalBytes,
+      wallTimeMs,
+      filesPerSecond: files.length / Math.max(wallTimeMs, Number.EPSILON) * 1000,
+      throughput: totalBytes / Math.max(wallTimeMs, Number.EPSILON) * 1000,
+      latency: {
+        p50: percentile(latencies, 50),
+        p95: percentile(latencies, 95),
+        p99: percentile(latencies, 99),
+        max: latencies.length > 0 ? latencies[latencies.length - 1] : 0
+      },
+      // maxRSS covers the whole process, worker threads included
+      peakRssBytes: process.resourceUsage().maxRSS * 1024
+    });
+    return counts.error + counts.failed + counts.missing > 0 ? 1 : 0;
+  };
+
+  if (workerCount === 0) {
+    return Promise.resolve(finish());
+  }
+
+  return new Promise((resolve) => {
+    let active = 0;
+
+    const record = (result) => {
+      counts[result.status] += 1;
+      totalBytes += result.sourceLength || 0;
+      latencies.push(result.latency);
+      writeRecord(result);
+    };
+
+    const startWorker = () => {
+      const worker = new Worker(__filename, { workerData: { batchWorker: true } });
+      let current = null;
+      active += 1;
+
+      const feed = () => {
+        if (nextIndex < files.length) {
+          current = files[nextIndex++];
+          worker.postMessage(current);
+        } else {
+          current = null;
+          worker.terminate();
+        }
+      };
+
+      worker.on('message', (result) => {
+        record(result);
+        feed();
+      });
+      worker.on('error', (error) => {
+        // The file in flight took the thread down; report it and carry on with a fresh worker
+        if (current) {
+          record({ type: 'file', file: current, status: 'failed', message: error.message, latency: 0 });
+          current = null;
+        }
+        if (nextIndex < files.length) {
+          startWorker();
+        }
+      });
+      worker.on('exit', () => {
+        active -= 1;
+        if (active === 0) {
+          resolve(finish());
+        }
+      });
+
+      feed();
+    };
+
+    for (let i = 0; i < workerCount; i++) {
+      startWorker();
+    }
+  });
+}
+
+function parseJobsOption(args) {
+  const index = args.findIndex((arg) => arg === '--jobs' || arg.startsWith('--jobs='));
+  if (index === -1) {
+    return typeof os.availableParallelism === 'function' ? os.availableParallelism() : os.cpus().length;
+  }
+  const value = args[index].includes('=') ? args[index].split('=')[1] : args[index + 1];
+  const jobs = parseInt(value, 10);
+  if (!Number.isInteger(jobs) || jobs < 1) {
+    console.error(`Error: --jobs expects a positive integer, got '${value}'`);
+    process.exit(1);
+  }
+  return jobs;
+}
+
+function getPositionalArgs(args) {
+  return args.filter((arg, i) => !arg.startsWith('--') && args[i - 1] !== '--jobs');
+}
+
+function isBatchInvocation(args, inputs) {
+  if (args.includes('--batch') || inputs.length > 1) {
+    return true;
+  }
+  const [input] = inputs;
+  if (GLOB_CHARS.test(input)) {
+    return true;
+  }
+  try {
+    return fs.statSync(input).isDirectory();
+  } catch {
+    return false;
+  }
+}
+
 function main() {
   const args = process.argv.slice(2);
 
@@ -45,6 +364,14 @@ function main() {
     process.exit(0);
   }
 
+  const inputs = getPositionalArgs(args);
+  if (inputs.length > 0 && isBatchInvocation(args, inputs)) {
+    runBatch(inputs, parseJobsOption(args)).then((exitCode) => {
+      process.exitCode = exitCode;
+    });
+    return;
+  }
+
   const filePath = args[0];
   const options = {
     json: args.includes('--json'),
@@ -176,6 +503,8 @@ function main() {
   }
 }
 
-if (require.main === module) {
+if (!isMainThread && workerData && workerData.batchWorker) {
+  runBatchWorker();
+} else if (require.main === module) {
   main();
 }
@@ -1,4 +1,10 @@
 {
+  "variables": {
+    # Set by `make pgo`: link a prebuilt (profile-instrumented or optimized)
+    # parser object instead of compiling src/parser.c, with extra link flags
+    "parser_object%": "<!(node -p \"process.env.DAEDALUS_PARSER_OBJECT || ''\")",
+    "parser_ldflags%": "<!(node -p \"process.env.DAEDALUS_PARSER_LDFLAGS || ''\")",
+  },
   "targets": [
     {
       "target_name": "tree_sitter_daedalus_binding",
@@ -10,10 +16,26 @@
       ],
       "sources": [
         "bindings/node/binding.cc",
-        "src/parser.c",
         # NOTE: if your language has an external scanner, add it here.
       ],
       "conditions": [
+        ["parser_object==''", {
+          "sources": [
+            "src/parser.c",
+          ],
+        }, {
+          "libraries": [
+            "<(parser_object)",
+          ],
+          "ldflags": [
+            "<@(parser_ldflags)",
+          ],
+          "xcode_settings": {
+            "OTHER_LDFLAGS": [
+              "<@(parser_ldflags)",
+            ],
+          },
+        }],
         ["OS!='win'", {
           "cflags_c": [
             "-std=c11",
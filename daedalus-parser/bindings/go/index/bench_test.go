@@ -0,0 +1,79 @@
+package index
+
+import (
+	"context"
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+// Run with `go test -bench . -cpu 1,2,4,8` to see throughput per GOMAXPROCS.
+
+// corpusFiles lists the .d files in examples/ and reference/.
+func corpusFiles(b *testing.B) (paths []string, sources [][]byte, totalBytes int64) {
+	b.Helper()
+	for _, dir := range corpusDirs {
+		matches, err := filepath.Glob(filepath.Join(dir, "*.d"))
+		if err != nil {
+			b.Fatal(err)
+		}
+		for _, path := range matches {
+			source, err := os.ReadFile(path)
+			if err != nil {
+				b.Fatal(err)
+			}
+			paths = append(paths, path)
+			sources = append(sources, source)
+			totalBytes += int64(len(source))
+		}
+	}
+	if len(paths) == 0 {
+		b.Skip("no corpus files found")
+	}
+	return paths, sources, totalBytes
+}
+
+// BenchmarkParseCorpus parses the whole corpus per iteration, spread across
+// goroutines with a shared pool.
+func BenchmarkParseCorpus(b *testing.B) {
+	_, sources, totalBytes := corpusFiles(b)
+	pool := NewParserPool(0)
+	defer pool.Close()
+
+	b.SetBytes(totalBytes)
+	b.ResetTimer()
+	b.RunParallel(func(pb *testing.PB) {
+		ctx := context.Background()
+		for pb.Next() {
+			for _, source := range sources {
+				tree, err := pool.Parse(ctx, source)
+				if err != nil {
+					b.Error(err)
+					return
+				}
+				tree.Close()
+			}
+		}
+	})
+}
+
+// BenchmarkIndexFiles indexes the corpus repeated to mod size (reading,
+// parsing and extracting) with one worker per GOMAXPROCS.
+func BenchmarkIndexFiles(b *testing.B) {
+	const copies = 32
+	paths, _, totalBytes := corpusFiles(b)
+	var batch []string
+	for i := 0; i < copies; i++ {
+		batch = append(batch, paths...)
+	}
+	pool := NewParserPool(0)
+	defer pool.Close()
+
+	b.SetBytes(totalBytes * copies)
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		if _, err := IndexFiles(context.Background(), batch, Options{Pool: pool}); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
@@ -0,0 +1,127 @@
+package index
+
+import (
+	"strings"
+
+	sitter "github.com/smacker/go-tree-sitter"
+)
+
+// Position is a zero-based row and byte column in a source file.
+type Position struct {
+	Row    uint32 `json:"row"`
+	Column uint32 `json:"column"`
+}
+
+// Range spans a declaration from its keyword to its closing brace or semicolon.
+type Range struct {
+	Start Position `json:"start"`
+	End   Position `json:"end"`
+}
+
+// Instance is an `instance Name (Parent)` declaration. Dialogs are instances
+// of C_INFO; see IsDialog.
+type Instance struct {
+	Name   string `json:"name"`
+	Parent string `json:"parent"`
+	Range  Range  `json:"range"`
+}
+
+// IsDialog reports whether the instance is a dialog (parent C_INFO).
+func (i Instance) IsDialog() bool {
+	return strings.EqualFold(i.Parent, "C_INFO")
+}
+
+// Prototype is a `prototype Name (Class)` declaration.
+type Prototype struct {
+	Name   string `json:"name"`
+	Parent string `json:"parent"`
+	Range  Range  `json:"range"`
+}
+
+// Function is a `func Type Name (...)` declaration.
+type Function struct {
+	Name       string `json:"name"`
+	ReturnType string `json:"returnType"`
+	Range      Range  `json:"range"`
+}
+
+// Constant is a top-level `const Type Name = Value;` declaration. Value is
+// the initializer's source text.
+type Constant struct {
+	Name  string `json:"name"`
+	Type  string `json:"type"`
+	Value string `json:"value"`
+	Range Range  `json:"range"`
+}
+
+// Variable is a top-level `var Type Name;` declaration, e.g. MIS_ quest states.
+type Variable struct {
+	Name  string `json:"name"`
+	Type  string `json:"type"`
+	Range Range  `json:"range"`
+}
+
+// FileDeclarations holds the top-level declarations of one file, in source order.
+type FileDeclarations struct {
+	Path       string      `json:"path"`
+	Instances  []Instance  `json:"instances,omitempty"`
+	Prototypes []Prototype `json:"prototypes,omitempty"`
+	Functions  []Function  `json:"functions,omitempty"`
+	Constants  []Constant  `json:"constants,omitempty"`
+	Variables  []Variable  `json:"variables,omitempty"`
+	// HasErrors is set when the file has syntax errors; declarations that
+	// parsed are still reported.
+	HasErrors bool `json:"hasErrors"`
+	// Err is set when the file could not be read or parsed at all.
+	Err error `json:"-"`
+}
+
+// ExtractDeclarations collects the top-level declarations under root.
+// source must be the text root was parsed from.
+func ExtractDeclarations(root *sitter.Node, source []byte) FileDeclarations {
+	var decls FileDeclarations
+	decls.HasErrors = root.HasError()
+
+	count := int(root.NamedChildCount())
+	for i := 0; i < count; i++ {
+		node := root.NamedChild(i)
+		name := fieldText(node, "name", source)
+		if name == "" {
+			continue
+		}
+		rng := nodeRange(node)
+
+		switch node.Type() {
+		case "instance_declaration":
+			decls.Instances = append(decls.Instances, Instance{Name: name, Parent: fieldText(node, "parent", source), Range: rng})
+		case "prototype_declaration":
+			decls.Prototypes = append(decls.Prototypes, Prototype{Name: name, Parent: fieldText(node, "parent", source), Range: rng})
+		case "function_declaration":
+			decls.Functions = append(decls.Functions, Function{Name: name, ReturnType: fieldText(node, "return_type", source), Range: rng})
+		case "variable_declaration":
+			varType := fieldText(node, "type", source)
+			if strings.EqualFold(fieldText(node, "keyword", source), "const") {
+				decls.Constants = append(decls.Constants, Constant{Name: name, Type: varType, Value: fieldText(node, "value", source), Range: rng})
+			} else {
+				decls.Variables = append(decls.Variables, Variable{Name: name, Type: varType, Range: rng})
+			}
+		}
+	}
+	return decls
+}
+
+func fieldText(node *sitter.Node, field string, source []byte) string {
+	child := node.ChildByFieldName(field)
+	if child == nil {
+		return ""
+	}
+	return child.Content(source)
+}
+
+func nodeRange(node *sitter.Node) Range {
+	start, end := node.StartPoint(), node.EndPoint()
+	return Range{
+		Start: Position{Row: start.Row, Column: start.Column},
+		End:   Position{Row: end.Row, Column: end.Column},
+	}
+}
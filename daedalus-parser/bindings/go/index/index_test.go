@@ -0,0 +1,143 @@
+package index
+
+import (
+	"context"
+	"os"
+	"path/filepath"
+	"sync"
+	"testing"
+)
+
+// Sample scripts shipped with the parser
+var corpusDirs = []string{"../../../examples", "../../../reference"}
+
+func TestExtractDeclarations(t *testing.T) {
+	source := []byte(`const string TOPIC_Trade = "Trade";
+var int MIS_Trade;
+prototype Mst_Default_Wolf (C_NPC) { name = "Wolf"; };
+instance DIA_Trader_Hello (C_INFO) { npc = Trader; };
+func int DIA_Trader_Hello_Condition() { return TRUE; };
+`)
+	decls := IndexSource(context.Background(), NewParserPool(1), "trader.d", source)
+	if decls.Err != nil || decls.HasErrors {
+		t.Fatalf("unexpected errors: %v, hasErrors=%v", decls.Err, decls.HasErrors)
+	}
+
+	if len(decls.Constants) != 1 || decls.Constants[0] != (Constant{
+		Name: "TOPIC_Trade", Type: "string", Value: `"Trade"`,
+		Range: Range{Start: Position{0, 0}, End: Position{0, 35}},
+	}) {
+		t.Errorf("constants = %+v", decls.Constants)
+	}
+	if len(decls.Variables) != 1 || decls.Variables[0].Name != "MIS_Trade" || decls.Variables[0].Type != "int" {
+		t.Errorf("variables = %+v", decls.Variables)
+	}
+	if len(decls.Prototypes) != 1 || decls.Prototypes[0].Name != "Mst_Default_Wolf" || decls.Prototypes[0].Parent != "C_NPC" {
+		t.Errorf("prototypes = %+v", decls.Prototypes)
+	}
+	if len(decls.Instances) != 1 || !decls.Instances[0].IsDialog() || decls.Instances[0].Range.Start.Row != 3 {
+		t.Errorf("instances = %+v", decls.Instances)
+	}
+	if len(decls.Functions) != 1 || decls.Functions[0].ReturnType != "int" {
+		t.Errorf("functions = %+v", decls.Functions)
+	}
+}
+
+func TestIndexDirectory(t *testing.T) {
+	dir := t.TempDir()
+	write := func(name, content string) {
+		path := filepath.Join(dir, name)
+		if err := os.MkdirAll(filepath.Dir(path), 0o755); err != nil {
+			t.Fatal(err)
+		}
+		if err := os.WriteFile(path, []byte(content), 0o644); err != nil {
+			t.Fatal(err)
+		}
+	}
+	write("Story/Hero.D", "instance Hero (C_NPC) { name = \"Hero\"; };\n")
+	write("Broken.d", "func void Broken() { var int x = ; };\n")
+	write("notes.txt", "not daedalus")
+	write("node_modules/skipped.d", "instance Skipped (C_NPC) {};\n")
+
+	index, err := IndexDirectory(context.Background(), dir, Options{Workers: 4})
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	want := []string{filepath.Join(dir, "Broken.d"), filepath.Join(dir, "Story", "Hero.D")}
+	if len(index.Files) != len(want) {
+		t.Fatalf("indexed %d files, want %d: %+v", len(index.Files), len(want), index.Files)
+	}
+	for i, file := range index.Files {
+		if file.Path != want[i] {
+			t.Errorf("file %d = %s, want %s", i, file.Path, want[i])
+		}
+	}
+	if !index.Files[0].HasErrors {
+		t.Error("Broken.d should report syntax errors")
+	}
+	if hero := index.Files[1]; len(hero.Instances) != 1 || hero.Instances[0].Name != "Hero" || hero.Instances[0].IsDialog() {
+		t.Errorf("Hero.D instances = %+v", hero.Instances)
+	}
+}
+
+func TestIndexDirectoryCancelled(t *testing.T) {
+	ctx, cancel := context.WithCancel(context.Background())
+	cancel()
+	if _, err := IndexDirectory(ctx, corpusDirs[0], Options{}); err == nil {
+		t.Error("expected a cancellation error")
+	}
+}
+
+func TestIndexCorpus(t *testing.T) {
+	pool := NewParserPool(0)
+	defer pool.Close()
+
+	var farim *FileDeclarations
+	for _, dir := range corpusDirs {
+		index, err := IndexDirectory(context.Background(), dir, Options{Pool: pool})
+		if err != nil {
+			t.Fatal(err)
+		}
+		for i, file := range index.Files {
+			if file.Err != nil {
+				t.Errorf("%s: %v", file.Path, file.Err)
+			}
+			if filepath.Base(file.Path) == "DIA_Farim.d" {
+				farim = &index.Files[i]
+			}
+		}
+	}
+
+	if farim == nil {
+		t.Fatal("reference/DIA_Farim.d was not indexed")
+	}
+	if len(farim.Instances) != 3 || farim.Instances[0].Name != "DIA_99003_Farim" || !farim.Instances[0].IsDialog() {
+		t.Errorf("DIA_Farim.d instances = %+v", farim.Instances)
+	}
+	if len(farim.Functions) == 0 {
+		t.Error("DIA_Farim.d should declare functions")
+	}
+}
+
+func TestParserPoolConcurrentUse(t *testing.T) {
+	pool := NewParserPool(2)
+	defer pool.Close()
+	source := []byte("instance Hero (C_NPC) { name = \"Hero\"; };\n")
+
+	var wg sync.WaitGroup
+	for g := 0; g < 16; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < 50; i++ {
+				decls := IndexSource(context.Background(), pool, "hero.d", source)
+				if decls.Err != nil || len(decls.Instances) != 1 {
+					t.Errorf("parse %d: %+v", i, decls)
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+}
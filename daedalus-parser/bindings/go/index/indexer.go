@@ -0,0 +1,158 @@
+package index
+
+import (
+	"context"
+	"io/fs"
+	"os"
+	"path/filepath"
+	"runtime"
+	"sort"
+	"strings"
+	"sync"
+)
+
+var skippedDirectories = map[string]bool{".git": true, ".svn": true, "node_modules": true}
+
+// Options configures IndexDirectory and IndexFiles.
+type Options struct {
+	// Workers is the number of files parsed at once; <= 0 means runtime.GOMAXPROCS(0).
+	Workers int
+	// Pool supplies parsers; nil uses a pool private to the call. Share one
+	// pool between calls to reuse parsers.
+	Pool *ParserPool
+}
+
+// Index is the set of declarations found in a project.
+type Index struct {
+	// Files are sorted by path, so the index does not depend on the order
+	// files finished parsing in.
+	Files []FileDeclarations
+}
+
+// IndexDirectory parses every .d file under root concurrently. Files are
+// parsed while the directory walk is still running. Unreadable files are
+// reported through FileDeclarations.Err rather than failing the call.
+func IndexDirectory(ctx context.Context, root string, opts Options) (*Index, error) {
+	paths := make(chan string)
+	walkErr := make(chan error, 1)
+	go func() {
+		defer close(paths)
+		walkErr <- filepath.WalkDir(root, func(path string, entry fs.DirEntry, err error) error {
+			if err != nil {
+				if path == root {
+					return err
+				}
+				return nil // Unreadable subdirectory; index the rest
+			}
+			if entry.IsDir() {
+				if path != root && skippedDirectories[entry.Name()] {
+					return filepath.SkipDir
+				}
+				return nil
+			}
+			if !isDaedalusFile(path) {
+				return nil
+			}
+			select {
+			case paths <- path:
+				return nil
+			case <-ctx.Done():
+				return ctx.Err()
+			}
+		})
+	}()
+
+	files := indexPaths(ctx, paths, opts)
+	if err := <-walkErr; err != nil {
+		return nil, err
+	}
+	if err := ctx.Err(); err != nil {
+		return nil, err
+	}
+	return newIndex(files), nil
+}
+
+// IndexFiles parses the given files concurrently.
+func IndexFiles(ctx context.Context, filePaths []string, opts Options) (*Index, error) {
+	paths := make(chan string)
+	go func() {
+		defer close(paths)
+		for _, path := range filePaths {
+			select {
+			case paths <- path:
+			case <-ctx.Done():
+				return
+			}
+		}
+	}()
+
+	files := indexPaths(ctx, paths, opts)
+	if err := ctx.Err(); err != nil {
+		return nil, err
+	}
+	return newIndex(files), nil
+}
+
+// IndexSource parses one file's text with a pooled parser.
+func IndexSource(ctx context.Context, pool *ParserPool, path string, source []byte) FileDeclarations {
+	tree, err := pool.Parse(ctx, source)
+	if err != nil {
+		return FileDeclarations{Path: path, Err: err}
+	}
+	defer tree.Close()
+
+	decls := ExtractDeclarations(tree.RootNode(), source)
+	decls.Path = path
+	return decls
+}
+
+func indexPaths(ctx context.Context, paths <-chan string, opts Options) []FileDeclarations {
+	workers := opts.Workers
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+	pool := opts.Pool
+	if pool == nil {
+		pool = NewParserPool(workers)
+		defer pool.Close()
+	}
+
+	var (
+		mu    sync.Mutex
+		files []FileDeclarations
+		wg    sync.WaitGroup
+	)
+	for i := 0; i < workers; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			// Per-worker results, merged once, keep the workers off the lock
+			var local []FileDeclarations
+			for path := range paths {
+				if ctx.Err() != nil {
+					continue // Drain so the producer can finish
+				}
+				source, err := os.ReadFile(path)
+				if err != nil {
+					local = append(local, FileDeclarations{Path: path, Err: err})
+					continue
+				}
+				local = append(local, IndexSource(ctx, pool, path, source))
+			}
+			mu.Lock()
+			files = append(files, local...)
+			mu.Unlock()
+		}()
+	}
+	wg.Wait()
+	return files
+}
+
+func newIndex(files []FileDeclarations) *Index {
+	sort.Slice(files, func(i, j int) bool { return files[i].Path < files[j].Path })
+	return &Index{Files: files}
+}
+
+func isDaedalusFile(path string) bool {
+	return strings.EqualFold(filepath.Ext(path), ".d")
+}
@@ -0,0 +1,95 @@
+// Package index parses Daedalus scripts concurrently and extracts their
+// top-level declarations (instances, prototypes, functions, constants and
+// variables) into Go structs.
+//
+//	idx, err := index.IndexDirectory(ctx, "Scripts/Content", index.Options{})
+//	for _, file := range idx.Files {
+//		for _, inst := range file.Instances {
+//			if inst.IsDialog() { ... }
+//		}
+//	}
+//
+// Files are parsed by one goroutine per GOMAXPROCS with parsers from a
+// ParserPool, so throughput scales with the available cores.
+package index
+
+import (
+	"context"
+	"runtime"
+	"sync/atomic"
+
+	sitter "github.com/smacker/go-tree-sitter"
+	tree_sitter_daedalus "github.com/tree-sitter/tree-sitter-daedalus"
+)
+
+var language = sitter.NewLanguage(tree_sitter_daedalus.Language())
+
+// ParserPool hands out Daedalus parsers to concurrent goroutines.
+//
+// A tree-sitter parser must not be used by two goroutines at once, and
+// creating one per file repeats language setup and reallocates its parse
+// stacks. The pool keeps up to a fixed number of idle parsers; parsers
+// returned beyond that bound are closed.
+type ParserPool struct {
+	idle   chan *sitter.Parser
+	closed atomic.Bool
+}
+
+// NewParserPool returns a pool keeping at most maxIdle idle parsers.
+// maxIdle <= 0 means runtime.GOMAXPROCS(0).
+func NewParserPool(maxIdle int) *ParserPool {
+	if maxIdle <= 0 {
+		maxIdle = runtime.GOMAXPROCS(0)
+	}
+	return &ParserPool{idle: make(chan *sitter.Parser, maxIdle)}
+}
+
+// Get takes an idle parser, creating one if none is idle. Hand it back
+// with Put.
+func (p *ParserPool) Get() *sitter.Parser {
+	select {
+	case parser := <-p.idle:
+		return parser
+	default:
+		parser := sitter.NewParser()
+		parser.SetLanguage(language)
+		return parser
+	}
+}
+
+// Put returns a parser obtained from Get.
+func (p *ParserPool) Put(parser *sitter.Parser) {
+	// Clear state left by a cancelled parse; allocated capacity is kept
+	parser.Reset()
+	if p.closed.Load() {
+		parser.Close()
+		return
+	}
+	select {
+	case p.idle <- parser:
+	default:
+		parser.Close()
+	}
+}
+
+// Parse parses source with a pooled parser. The caller owns the returned
+// tree and must Close it.
+func (p *ParserPool) Parse(ctx context.Context, source []byte) (*sitter.Tree, error) {
+	parser := p.Get()
+	defer p.Put(parser)
+	return parser.ParseCtx(ctx, nil, source)
+}
+
+// Close closes the idle parsers. Parsers still checked out are closed when
+// they are put back.
+func (p *ParserPool) Close() {
+	p.closed.Store(true)
+	for {
+		select {
+		case parser := <-p.idle:
+			parser.Close()
+		default:
+			return
+		}
+	}
+}
@@ -0,0 +1,107 @@
+"""Tests for parse_many() and the _index extension behind it.
+
+Skipped when the package was built without the tree-sitter runtime; see
+the Python section of README.md.
+"""
+
+from os.path import join
+from tempfile import TemporaryDirectory
+from unittest import TestCase, skipIf
+
+import tree_sitter_daedalus
+from tree_sitter_daedalus import parse_many
+
+DIALOG = """instance DIA_Smith_Hello (C_INFO)
+{
+    npc = Smith;
+};
+
+func int DIA_Smith_Hello_Condition()
+{
+    return TRUE;
+};
+"""
+
+
+@skipIf(tree_sitter_daedalus._parse_many is None, "built without the tree-sitter runtime")
+class ParseManyTest(TestCase):
+    def setUp(self):
+        self._directory = TemporaryDirectory()
+        self.addCleanup(self._directory.cleanup)
+
+    def write(self, name, data):
+        path = join(self._directory.name, name)
+        with open(path, "wb") as file:
+            file.write(data)
+        return path
+
+    def parse_one(self, data, encoding="auto"):
+        [(_, declarations, has_errors, error)] = parse_many([self.write("file.d", data)], encoding)
+        self.assertIsNone(error)
+        return declarations, has_errors
+
+    def test_reads_utf8(self):
+        declarations, has_errors = self.parse_one('const string TOPIC_Smith = "Grüße";'.encode("utf-8"))
+        self.assertFalse(has_errors)
+        self.assertEqual(declarations, (("const", "TOPIC_Smith", "string", '"Grüße"', 0, 0),))
+
+    def test_reads_windows_1252(self):
+        data = 'const string TOPIC_Smith = "Grüße €";'.encode("cp1252")
+        for encoding in ("auto", "windows-1252", "cp1252"):
+            declarations, _ = self.parse_one(data, encoding)
+            self.assertEqual(declarations[0][3], '"Grüße €"', encoding)
+
+    def test_reads_windows_1250(self):
+        data = 'const string TOPIC_Zolw = "Żółw";'.encode("cp1250")
+        declarations, _ = self.parse_one(data, "windows-1250")
+        self.assertEqual(declarations[0][3], '"Żółw"')
+        # Without the hint, non-UTF-8 files are read as Windows-1252
+        declarations, _ = self.parse_one(data)
+        self.assertEqual(declarations[0][3], '"¯ó³w"')
+
+    def test_skips_utf8_bom(self):
+        declarations, has_errors = self.parse_one(b"\xef\xbb\xbf" + DIALOG.encode("utf-8"))
+        self.assertFalse(has_errors)
+        self.assertEqual(
+            declarations,
+            (
+                ("instance", "DIA_Smith_Hello", "C_INFO", None, 0, 3),
+                ("function", "DIA_Smith_Hello_Condition", "int", None, 5, 8),
+            ),
+        )
+
+    def test_reports_unreadable_files_per_path(self):
+        good = self.write("good.d", DIALOG.encode("utf-8"))
+        missing = join(self._directory.name, "missing.d")
+        results = parse_many([missing, good])
+
+        path, declarations, has_errors, error = results[0]
+        self.assertEqual(path, missing)
+        self.assertEqual(declarations, ())
+        self.assertFalse(has_errors)
+        self.assertIsInstance(error, FileNotFoundError)
+        self.assertEqual(error.filename, missing)
+        self.assertEqual(len(results[1][1]), 2)
+
+    def test_keeps_declarations_of_files_with_errors(self):
+        declarations, has_errors = self.parse_one(b"var int MIS_Smith;\n\nfunc void Broken( {\n")
+        self.assertTrue(has_errors)
+        self.assertIn(("var", "MIS_Smith", "int", None, 0, 0), declarations)
+
+    def test_batch_across_threads_keeps_path_order(self):
+        paths = [
+            self.write(f"DIA_{i:03}.d", DIALOG.replace("Smith", f"Smith{i}").encode("utf-8"))
+            for i in range(64)
+        ]
+        results = parse_many(paths, threads=4)
+
+        self.assertEqual([result[0] for result in results], paths)
+        for i, (_, declarations, has_errors, error) in enumerate(results):
+            self.assertIsNone(error)
+            self.assertFalse(has_errors)
+            self.assertEqual(declarations[0][1], f"DIA_Smith{i}_Hello")
+        self.assertEqual(results, parse_many(paths, threads=1))
+
+    def test_rejects_unknown_encodings(self):
+        with self.assertRaises(ValueError):
+            parse_many([], "latin-2")
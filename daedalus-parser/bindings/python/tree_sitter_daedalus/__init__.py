@@ -1,5 +1,45 @@
 "Daedalus grammar for tree-sitter"
 
+from os import cpu_count, fspath
+
 from ._binding import language
 
-__all__ = ["language"]
+try:
+    from ._index import parse_many as _parse_many
+except ImportError:  # Built without the tree-sitter runtime; see setup.py
+    _parse_many = None
+
+_ENCODINGS = {
+    "auto": "auto",
+    "utf-8": "utf-8",
+    "utf8": "utf-8",
+    "windows-1250": "windows-1250",
+    "cp1250": "windows-1250",
+    "windows-1252": "windows-1252",
+    "cp1252": "windows-1252",
+}
+
+
+def parse_many(paths, encoding="auto", threads=None):
+    """Parse files in parallel and extract their top-level declarations.
+
+    Files are read, transcoded to UTF-8, parsed and scanned on native threads
+    with the GIL released. "auto" reads UTF-8 files as such and anything
+    else as windows-1252; pass "windows-1250" for Central European mods.
+
+    Returns one ``(path, declarations, has_errors, error)`` tuple per path, in
+    order. Each declaration is ``(kind, name, detail, value, start_row,
+    end_row)``: kind is "instance", "prototype", "function", "const" or
+    "var"; detail is the parent, return type or type; value is the
+    initializer of a const and None otherwise. error is the OSError of a
+    file that could not be read, else None.
+    """
+    if _parse_many is None:
+        raise RuntimeError("tree_sitter_daedalus was built without the tree-sitter runtime")
+    name = _ENCODINGS.get(encoding.lower().replace("_", "-"))
+    if name is None:
+        raise ValueError(f"unsupported encoding: {encoding}")
+    return _parse_many([fspath(path) for path in paths], name, threads or cpu_count() or 1)
+
+
+__all__ = ["language", "parse_many"]
@@ -1 +1,12 @@
+from os import PathLike
+from typing import Iterable, List, Optional, Tuple, Union
+
+Declaration = Tuple[str, str, str, Optional[str], int, int]
+FileDeclarations = Tuple[str, Tuple[Declaration, ...], bool, Optional[OSError]]
+
 def language() -> int: ...
+def parse_many(
+    paths: Iterable[Union[str, PathLike[str]]],
+    encoding: str = "auto",
+    threads: Optional[int] = None,
+) -> List[FileDeclarations]: ...
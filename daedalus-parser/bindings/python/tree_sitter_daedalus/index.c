@@ -0,0 +1,725 @@
+/*
+ * Batch parsing for Python: parse_many() reads, transcodes and parses a list
+ * of files on a pool of native threads with the GIL released, and extracts
+ * the top-level declarations of each file. Python objects are only created
+ * once all files are done, back under the GIL.
+ */
+
+#include <Python.h>
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tree_sitter/api.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef wchar_t PathChar;
+#else
+#include <pthread.h>
+typedef char PathChar;
+#endif
+
+const TSLanguage *tree_sitter_daedalus(void);
+
+typedef enum {
+    ENCODING_AUTO,
+    ENCODING_UTF8,
+    ENCODING_WINDOWS_1250,
+    ENCODING_WINDOWS_1252,
+} Encoding;
+
+typedef enum {
+    KIND_INSTANCE,
+    KIND_PROTOTYPE,
+    KIND_FUNCTION,
+    KIND_CONST,
+    KIND_VAR,
+    KIND_COUNT,
+} DeclarationKind;
+
+static const char *const KIND_NAMES[KIND_COUNT] = {"instance", "prototype", "function", "const", "var"};
+
+/* Interned kind strings shared by all result tuples */
+static PyObject *kind_objects[KIND_COUNT];
+
+/* Code points of bytes 0x80-0xFF. Undefined bytes map to the C1 control of the same value. */
+static const uint16_t WINDOWS_1250[128] = {
+    0x20AC, 0x0081, 0x201A, 0x0083, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x0088, 0x2030, 0x0160, 0x2039, 0x015A, 0x0164, 0x017D, 0x0179,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x0098, 0x2122, 0x0161, 0x203A, 0x015B, 0x0165, 0x017E, 0x017A,
+    0x00A0, 0x02C7, 0x02D8, 0x0141, 0x00A4, 0x0104, 0x00A6, 0x00A7,
+    0x00A8, 0x00A9, 0x015E, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x017B,
+    0x00B0, 0x00B1, 0x02DB, 0x0142, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+    0x00B8, 0x0105, 0x015F, 0x00BB, 0x013D, 0x02DD, 0x013E, 0x017C,
+    0x0154, 0x00C1, 0x00C2, 0x0102, 0x00C4, 0x0139, 0x0106, 0x00C7,
+    0x010C, 0x00C9, 0x0118, 0x00CB, 0x011A, 0x00CD, 0x00CE, 0x010E,
+    0x0110, 0x0143, 0x0147, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x00D7,
+    0x0158, 0x016E, 0x00DA, 0x0170, 0x00DC, 0x00DD, 0x0162, 0x00DF,
+    0x0155, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x013A, 0x0107, 0x00E7,
+    0x010D, 0x00E9, 0x0119, 0x00EB, 0x011B, 0x00ED, 0x00EE, 0x010F,
+    0x0111, 0x0144, 0x0148, 0x00F3, 0x00F4, 0x0151, 0x00F6, 0x00F7,
+    0x0159, 0x016F, 0x00FA, 0x0171, 0x00FC, 0x00FD, 0x0163, 0x02D9,
+};
+
+static const uint16_t WINDOWS_1252[128] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+    0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+    0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+    0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+    0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+    0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+    0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+    0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+    0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+    0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+    0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+    0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+    0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF,
+};
+
+/* Symbols and fields of the grammar, looked up once at import */
+static struct {
+    const TSLanguage *language;
+    TSSymbol instance_declaration;
+    TSSymbol prototype_declaration;
+    TSSymbol function_declaration;
+    TSSymbol variable_declaration;
+    TSFieldId name;
+    TSFieldId parent;
+    TSFieldId return_type;
+    TSFieldId type;
+    TSFieldId value;
+    TSFieldId keyword;
+} grammar;
+
+/* A byte range in FileResult.strings */
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+} Slice;
+
+typedef struct {
+    DeclarationKind kind;
+    Slice name;
+    Slice detail;
+    Slice value;
+    bool has_value;
+    uint32_t start_row;
+    uint32_t end_row;
+} Declaration;
+
+typedef struct {
+    Declaration *declarations;
+    uint32_t count;
+    uint32_t capacity;
+    /* Text of all slices, UTF-8; sources are freed as soon as a file is extracted */
+    char *strings;
+    size_t strings_length;
+    size_t strings_capacity;
+    bool has_errors;
+    /* errno of a failed read, or ENOMEM */
+    int error;
+} FileResult;
+
+typedef struct {
+    PathChar **paths;
+    size_t count;
+    Encoding encoding;
+    FileResult *results;
+    /* Next unclaimed file; workers take one at a time so large files do not leave threads idle */
+#ifdef _MSC_VER
+    volatile LONG next;
+#else
+    size_t next;
+#endif
+} Batch;
+
+static size_t claim_next(Batch *batch) {
+#ifdef _MSC_VER
+    return (size_t)(InterlockedIncrement(&batch->next) - 1);
+#else
+    return __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+/* Source decoding */
+
+static bool is_ascii(const unsigned char *bytes, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (bytes[i] & 0x80) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool is_utf8(const unsigned char *bytes, size_t length) {
+    size_t i = 0;
+    while (i < length) {
+        unsigned char lead = bytes[i];
+        size_t extra;
+        if (lead < 0x80) {
+            i++;
+            continue;
+        } else if (lead >= 0xC2 && lead <= 0xDF) {
+            extra = 1;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            extra = 2;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            extra = 3;
+        } else {
+            return false;
+        }
+        if (length - i <= extra) {
+            return false;
+        }
+        for (size_t j = 1; j <= extra; j++) {
+            if ((bytes[i + j] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += extra + 1;
+    }
+    return true;
+}
+
+/*
+ * Transcode a single-byte code page to UTF-8. Returns a new buffer, or NULL
+ * when out of memory.
+ */
+static char *decode_code_page(const unsigned char *bytes, size_t length, const uint16_t *table,
+                              size_t *out_length) {
+    /* Every code point in the tables fits in three UTF-8 bytes */
+    char *out = malloc(length * 3 + 1);
+    if (!out) {
+        return NULL;
+    }
+    size_t o = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint16_t code_point = bytes[i] < 0x80 ? bytes[i] : table[bytes[i] - 0x80];
+        if (code_point < 0x80) {
+            out[o++] = (char)code_point;
+        } else if (code_point < 0x800) {
+            out[o++] = (char)(0xC0 | (code_point >> 6));
+            out[o++] = (char)(0x80 | (code_point & 0x3F));
+        } else {
+            out[o++] = (char)(0xE0 | (code_point >> 12));
+            out[o++] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+            out[o++] = (char)(0x80 | (code_point & 0x3F));
+        }
+    }
+    *out_length = o;
+    return out;
+}
+
+/* Read a whole file. Returns NULL and sets *error on failure. */
+static unsigned char *read_file(const PathChar *path, size_t *length, int *error) {
+#ifdef _WIN32
+    FILE *file = _wfopen(path, L"rb");
+#else
+    FILE *file = fopen(path, "rb");
+#endif
+    if (!file) {
+        *error = errno;
+        return NULL;
+    }
+
+    size_t capacity = 64 * 1024;
+    size_t used = 0;
+    unsigned char *buffer = malloc(capacity);
+    while (buffer) {
+        used += fread(buffer + used, 1, capacity - used, file);
+        if (used < capacity) {
+            break;
+        }
+        capacity *= 2;
+        unsigned char *grown = realloc(buffer, capacity);
+        if (!grown) {
+            free(buffer);
+        }
+        buffer = grown;
+    }
+
+    if (!buffer) {
+        *error = ENOMEM;
+    } else if (ferror(file)) {
+        *error = errno ? errno : EIO;
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(file);
+    *length = used;
+    return buffer;
+}
+
+/*
+ * The UTF-8 text of a file's bytes. Returns `bytes` itself when no
+ * transcoding is needed, otherwise a new buffer (NULL when out of memory).
+ */
+static const char *to_utf8(const unsigned char *bytes, size_t length, Encoding encoding,
+                           size_t *out_length) {
+    if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        *out_length = length - 3;
+        return (const char *)bytes + 3;
+    }
+    *out_length = length;
+    if (encoding == ENCODING_UTF8 || is_ascii(bytes, length)) {
+        return (const char *)bytes;
+    }
+    if (encoding == ENCODING_AUTO) {
+        /* Most Gothic scripts are Windows-1252; mods saved by newer editors are UTF-8 */
+        if (is_utf8(bytes, length)) {
+            return (const char *)bytes;
+        }
+        encoding = ENCODING_WINDOWS_1252;
+    }
+    const uint16_t *table = encoding == ENCODING_WINDOWS_1250 ? WINDOWS_1250 : WINDOWS_1252;
+    return decode_code_page(bytes, length, table, out_length);
+}
+
+/* Extraction */
+
+static bool add_string(FileResult *result, const char *text, uint32_t length, Slice *slice) {
+    if (result->strings_length + length > result->strings_capacity) {
+        size_t capacity = result->strings_capacity ? result->strings_capacity * 2 : 4096;
+        while (capacity < result->strings_length + length) {
+            capacity *= 2;
+        }
+        char *grown = realloc(result->strings, capacity);
+        if (!grown) {
+            return false;
+        }
+        result->strings = grown;
+        result->strings_capacity = capacity;
+    }
+    memcpy(result->strings + result->strings_length, text, length);
+    slice->offset = (uint32_t)result->strings_length;
+    slice->length = length;
+    result->strings_length += length;
+    return true;
+}
+
+/* Copy the text of a node's field; a missing field gives an empty slice */
+static bool add_field(FileResult *result, TSNode node, TSFieldId field, const char *source, Slice *slice) {
+    TSNode child = ts_node_child_by_field_id(node, field);
+    if (ts_node_is_null(child)) {
+        slice->offset = 0;
+        slice->length = 0;
+        return true;
+    }
+    uint32_t start = ts_node_start_byte(child);
+    return add_string(result, source + start, ts_node_end_byte(child) - start, slice);
+}
+
+static bool is_const_keyword(TSNode node, const char *source) {
+    TSNode keyword = ts_node_child_by_field_id(node, grammar.keyword);
+    if (ts_node_is_null(keyword)) {
+        return false;
+    }
+    uint32_t start = ts_node_start_byte(keyword);
+    if (ts_node_end_byte(keyword) - start != 5) {
+        return false;
+    }
+    for (uint32_t i = 0; i < 5; i++) {
+        char c = source[start + i];
+        if (c >= 'A' && c <= 'Z') {
+            c = (char)(c - 'A' + 'a');
+        }
+        if (c != "const"[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Returns false when out of memory */
+static bool extract_declarations(TSNode root, const char *source, FileResult *result) {
+    result->has_errors = ts_node_has_error(root);
+
+    uint32_t child_count = ts_node_named_child_count(root);
+    for (uint32_t i = 0; i < child_count; i++) {
+        TSNode node = ts_node_named_child(root, i);
+        TSSymbol symbol = ts_node_symbol(node);
+        Declaration declaration = {0};
+        TSFieldId detail_field;
+
+        if (symbol == grammar.instance_declaration) {
+            declaration.kind = KIND_INSTANCE;
+            detail_field = grammar.parent;
+        } else if (symbol == grammar.prototype_declaration) {
+            declaration.kind = KIND_PROTOTYPE;
+            detail_field = grammar.parent;
+        } else if (symbol == grammar.function_declaration) {
+            declaration.kind = KIND_FUNCTION;
+            detail_field = grammar.return_type;
+        } else if (symbol == grammar.variable_declaration) {
+            declaration.kind = is_const_keyword(node, source) ? KIND_CONST : KIND_VAR;
+            detail_field = grammar.type;
+        } else {
+            continue;
+        }
+
+        if (ts_node_is_null(ts_node_child_by_field_id(node, grammar.name))) {
+            continue;
+        }
+        if (!add_field(result, node, grammar.name, source, &declaration.name) ||
+            !add_field(result, node, detail_field, source, &declaration.detail)) {
+            return false;
+        }
+        if (declaration.kind == KIND_CONST) {
+            declaration.has_value = true;
+            if (!add_field(result, node, grammar.value, source, &declaration.value)) {
+                return false;
+            }
+        }
+        declaration.start_row = ts_node_start_point(node).row;
+        declaration.end_row = ts_node_end_point(node).row;
+
+        if (result->count == result->capacity) {
+            uint32_t capacity = result->capacity ? result->capacity * 2 : 32;
+            Declaration *grown = realloc(result->declarations, capacity * sizeof(Declaration));
+            if (!grown) {
+                return false;
+            }
+            result->declarations = grown;
+            result->capacity = capacity;
+        }
+        result->declarations[result->count++] = declaration;
+    }
+    return true;
+}
+
+static void index_file(TSParser *parser, const PathChar *path, Encoding encoding, FileResult *result) {
+    size_t length;
+    unsigned char *bytes = read_file(path, &length, &result->error);
+    if (!bytes) {
+        return;
+    }
+
+    size_t text_length;
+    const char *text = to_utf8(bytes, length, encoding, &text_length);
+    if (!text) {
+        result->error = ENOMEM;
+    } else if (text_length > UINT32_MAX) {
+        result->error = EFBIG;
+    } else {
+        /* Without a timeout or cancellation flag, parsing always returns a tree */
+        TSTree *tree = ts_parser_parse_string(parser, NULL, text, (uint32_t)text_length);
+        if (!extract_declarations(ts_tree_root_node(tree), text, result)) {
+            result->error = ENOMEM;
+        }
+        ts_tree_delete(tree);
+    }
+
+    if (text && (const unsigned char *)text != bytes && (const unsigned char *)text != bytes + 3) {
+        free((void *)text);
+    }
+    free(bytes);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI run_worker(LPVOID argument) {
+#else
+static void *run_worker(void *argument) {
+#endif
+    Batch *batch = argument;
+    TSParser *parser = ts_parser_new();
+    ts_parser_set_language(parser, grammar.language);
+    for (size_t i = claim_next(batch); i < batch->count; i = claim_next(batch)) {
+        index_file(parser, batch->paths[i], batch->encoding, &batch->results[i]);
+    }
+    ts_parser_delete(parser);
+    return 0;
+}
+
+/* Run the batch on `threads` threads, the calling one included */
+static void run_batch(Batch *batch, Py_ssize_t threads) {
+    if ((size_t)threads > batch->count) {
+        threads = (Py_ssize_t)batch->count;
+    }
+    Py_ssize_t started = 0;
+#ifdef _WIN32
+    HANDLE *handles = threads > 1 ? calloc((size_t)threads - 1, sizeof(HANDLE)) : NULL;
+    for (; handles && started < threads - 1; started++) {
+        handles[started] = CreateThread(NULL, 0, run_worker, batch, 0, NULL);
+        if (!handles[started]) {
+            break; /* Fewer threads; the files are still all claimed */
+        }
+    }
+    run_worker(batch);
+    for (Py_ssize_t i = 0; i < started; i++) {
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+    }
+    free(handles);
+#else
+    pthread_t *handles = threads > 1 ? calloc((size_t)threads - 1, sizeof(pthread_t)) : NULL;
+    for (; handles && started < threads - 1; started++) {
+        if (pthread_create(&handles[started], NULL, run_worker, batch) != 0) {
+            break; /* Fewer threads; the files are still all claimed */
+        }
+    }
+    run_worker(batch);
+    for (Py_ssize_t i = 0; i < started; i++) {
+        pthread_join(handles[i], NULL);
+    }
+    free(handles);
+#endif
+}
+
+/* Python conversion */
+
+static PyObject *slice_object(const FileResult *result, Slice slice) {
+    return PyUnicode_DecodeUTF8(result->strings + slice.offset, slice.length, "replace");
+}
+
+static PyObject *declaration_tuple(const FileResult *result, const Declaration *declaration) {
+    PyObject *tuple = PyTuple_New(6);
+    if (!tuple) {
+        return NULL;
+    }
+    PyObject *value = Py_None;
+    if (declaration->has_value) {
+        value = slice_object(result, declaration->value);
+    } else {
+        Py_INCREF(value);
+    }
+    PyObject *items[6] = {
+        kind_objects[declaration->kind],
+        slice_object(result, declaration->name),
+        slice_object(result, declaration->detail),
+        value,
+        PyLong_FromUnsignedLong(declaration->start_row),
+        PyLong_FromUnsignedLong(declaration->end_row),
+    };
+    Py_INCREF(items[0]);
+
+    bool failed = false;
+    for (Py_ssize_t i = 0; i < 6; i++) {
+        if (!items[i]) {
+            failed = true;
+        } else {
+            PyTuple_SetItem(tuple, i, items[i]);
+        }
+    }
+    if (failed) {
+        Py_DECREF(tuple);
+        return NULL;
+    }
+    return tuple;
+}
+
+static PyObject *file_tuple(PyObject *path, const FileResult *result) {
+    PyObject *declarations = PyTuple_New(result->count);
+    if (!declarations) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < result->count; i++) {
+        PyObject *declaration = declaration_tuple(result, &result->declarations[i]);
+        if (!declaration) {
+            Py_DECREF(declarations);
+            return NULL;
+        }
+        PyTuple_SetItem(declarations, i, declaration);
+    }
+
+    PyObject *error = Py_None;
+    if (result->error) {
+        error = PyObject_CallFunction(PyExc_OSError, "isO", result->error, strerror(result->error), path);
+        if (!error) {
+            Py_DECREF(declarations);
+            return NULL;
+        }
+    } else {
+        Py_INCREF(error);
+    }
+
+    PyObject *has_errors = PyBool_FromLong(result->has_errors);
+    Py_INCREF(path);
+    PyObject *tuple = PyTuple_New(4);
+    if (!tuple) {
+        Py_DECREF(path);
+        Py_DECREF(declarations);
+        Py_DECREF(has_errors);
+        Py_DECREF(error);
+        return NULL;
+    }
+    PyTuple_SetItem(tuple, 0, path);
+    PyTuple_SetItem(tuple, 1, declarations);
+    PyTuple_SetItem(tuple, 2, has_errors);
+    PyTuple_SetItem(tuple, 3, error);
+    return tuple;
+}
+
+static bool parse_encoding(const char *name, Encoding *encoding) {
+    static const struct {
+        const char *name;
+        Encoding encoding;
+    } names[] = {
+        {"auto", ENCODING_AUTO},
+        {"utf-8", ENCODING_UTF8},
+        {"windows-1250", ENCODING_WINDOWS_1250},
+        {"windows-1252", ENCODING_WINDOWS_1252},
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i].name) == 0) {
+            *encoding = names[i].encoding;
+            return true;
+        }
+    }
+    return false;
+}
+
+static PyObject *_index_parse_many(PyObject *self, PyObject *args) {
+    PyObject *paths;
+    const char *encoding_name;
+    Py_ssize_t threads;
+    if (!PyArg_ParseTuple(args, "O!sn", &PyList_Type, &paths, &encoding_name, &threads)) {
+        return NULL;
+    }
+
+    Batch batch = {0};
+    if (!parse_encoding(encoding_name, &batch.encoding)) {
+        PyErr_Format(PyExc_ValueError, "unsupported encoding: %s", encoding_name);
+        return NULL;
+    }
+    if (threads < 1) {
+        PyErr_SetString(PyExc_ValueError, "threads must be at least 1");
+        return NULL;
+    }
+
+    Py_ssize_t count = PyList_Size(paths);
+    PyObject *list = NULL;
+    /* Native paths, kept alive for the workers */
+#ifndef _WIN32
+    PyObject *encoded = PyList_New(count);
+    if (!encoded) {
+        return NULL;
+    }
+#endif
+    batch.count = (size_t)count;
+    batch.paths = PyMem_Calloc(count ? (size_t)count : 1, sizeof(PathChar *));
+    batch.results = calloc(count ? (size_t)count : 1, sizeof(FileResult));
+    if (!batch.paths || !batch.results) {
+        PyErr_NoMemory();
+        goto cleanup;
+    }
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *path = PyList_GetItem(paths, i);
+        if (!PyUnicode_Check(path)) {
+            PyErr_SetString(PyExc_TypeError, "paths must be strings");
+            goto cleanup;
+        }
+#ifdef _WIN32
+        batch.paths[i] = PyUnicode_AsWideCharString(path, NULL);
+        if (!batch.paths[i]) {
+            goto cleanup;
+        }
+#else
+        PyObject *bytes = PyUnicode_EncodeFSDefault(path);
+        if (!bytes) {
+            goto cleanup;
+        }
+        PyList_SetItem(encoded, i, bytes);
+        batch.paths[i] = PyBytes_AsString(bytes);
+#endif
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    run_batch(&batch, threads);
+    Py_END_ALLOW_THREADS
+
+    list = PyList_New(count);
+    if (!list) {
+        goto cleanup;
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        if (batch.results[i].error == ENOMEM) {
+            Py_CLEAR(list);
+            PyErr_NoMemory();
+            goto cleanup;
+        }
+        PyObject *tuple = file_tuple(PyList_GetItem(paths, i), &batch.results[i]);
+        if (!tuple) {
+            Py_CLEAR(list);
+            goto cleanup;
+        }
+        PyList_SetItem(list, i, tuple);
+    }
+
+cleanup:
+    if (batch.results) {
+        for (size_t i = 0; i < batch.count; i++) {
+            free(batch.results[i].declarations);
+            free(batch.results[i].strings);
+        }
+        free(batch.results);
+    }
+#ifdef _WIN32
+    if (batch.paths) {
+        for (size_t i = 0; i < batch.count; i++) {
+            PyMem_Free(batch.paths[i]);
+        }
+    }
+#else
+    Py_DECREF(encoded);
+#endif
+    PyMem_Free(batch.paths);
+    return list;
+}
+
+static PyMethodDef methods[] = {
+    {"parse_many", _index_parse_many, METH_VARARGS,
+     "Parse files on native threads and extract their top-level declarations."},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef module = {
+    .m_base = PyModuleDef_HEAD_INIT,
+    .m_name = "_index",
+    .m_doc = NULL,
+    .m_size = -1,
+    .m_methods = methods
+};
+
+static TSSymbol symbol_for_name(const char *name) {
+    return ts_language_symbol_for_name(grammar.language, name, (uint32_t)strlen(name), true);
+}
+
+static TSFieldId field_for_name(const char *name) {
+    return ts_language_field_id_for_name(grammar.language, name, (uint32_t)strlen(name));
+}
+
+PyMODINIT_FUNC PyInit__index(void) {
+    grammar.language = tree_sitter_daedalus();
+    grammar.instance_declaration = symbol_for_name("instance_declaration");
+    grammar.prototype_declaration = symbol_for_name("prototype_declaration");
+    grammar.function_declaration = symbol_for_name("function_declaration");
+    grammar.variable_declaration = symbol_for_name("variable_declaration");
+    grammar.name = field_for_name("name");
+    grammar.parent = field_for_name("parent");
+    grammar.return_type = field_for_name("return_type");
+    grammar.type = field_for_name("type");
+    grammar.value = field_for_name("value");
+    grammar.keyword = field_for_name("keyword");
+
+    for (int i = 0; i < KIND_COUNT; i++) {
+        if (!kind_objects[i]) {
+            kind_objects[i] = PyUnicode_InternFromString(KIND_NAMES[i]);
+            if (!kind_objects[i]) {
+                return NULL;
+            }
+        }
+    }
+    return PyModule_Create(&module);
+}
@@ -0,0 +1,112 @@
+//! Throughput of the declaration indexer over examples/ and reference/.
+//!
+//! Run with `cargo bench --bench index`. Criterion reports bytes/s for the `parse` and `index`
+//! groups and files/s for `index_files`, which runs the same thread counts over the same corpus.
+//! The corpus size printed first gives the average file size behind the two rates.
+
+use std::path::Path;
+
+use criterion::measurement::WallTime;
+use criterion::{
+    criterion_group, criterion_main, BenchmarkGroup, BenchmarkId, Criterion, Throughput,
+};
+use tree_sitter_daedalus::index::{
+    find_sources, index_source, index_sources, new_parser, Encoding, IndexOptions, Source,
+};
+
+/// The corpus is repeated to the size of a mod so thread start-up does not dominate.
+const COPIES: usize = 32;
+
+fn corpus() -> Vec<Source> {
+    let root = Path::new(env!("CARGO_MANIFEST_DIR"));
+    let mut sources = Vec::new();
+    for dir in ["examples", "reference"] {
+        let Ok(paths) = find_sources(&root.join(dir)) else {
+            continue;
+        };
+        for _ in 0..COPIES {
+            for path in &paths {
+                // Safety: the corpus is part of the checkout and not modified while benchmarking
+                sources.push(unsafe { Source::map(path) }.expect("Error mapping corpus file"));
+            }
+        }
+    }
+    sources
+}
+
+fn thread_counts() -> Vec<usize> {
+    let available = std::thread::available_parallelism().map_or(1, |count| count.get());
+    let mut counts: Vec<usize> = [1, 2, 4, 8]
+        .into_iter()
+        .filter(|&count| count < available)
+        .collect();
+    counts.push(available);
+    counts
+}
+
+fn index_corpus(sources: &[Source], threads: usize) -> usize {
+    let mut declarations = 0;
+    let options = IndexOptions {
+        threads,
+        ..Default::default()
+    };
+    index_sources(sources, &options, |file| {
+        declarations += file.instances.len() + file.functions.len();
+    });
+    declarations
+}
+
+fn bench_thread_counts(group: &mut BenchmarkGroup<WallTime>, sources: &[Source]) {
+    for threads in thread_counts() {
+        group.bench_with_input(
+            BenchmarkId::new("threads", threads),
+            &threads,
+            |b, &threads| {
+                b.iter(|| index_corpus(sources, threads));
+            },
+        );
+    }
+}
+
+fn bench_index(c: &mut Criterion) {
+    let sources = corpus();
+    if sources.is_empty() {
+        eprintln!("no corpus files found");
+        return;
+    }
+    let total_bytes: u64 = sources
+        .iter()
+        .map(|source| source.bytes().len() as u64)
+        .sum();
+    eprintln!(
+        "corpus: {} files, {} bytes ({} bytes per file)",
+        sources.len(),
+        total_bytes,
+        total_bytes / sources.len() as u64
+    );
+
+    let mut group = c.benchmark_group("parse");
+    group.throughput(Throughput::Bytes(total_bytes));
+    group.bench_function("single_parser", |b| {
+        let mut parser = new_parser();
+        b.iter(|| {
+            for source in &sources {
+                criterion::black_box(index_source(&mut parser, source, Encoding::Auto));
+            }
+        });
+    });
+    group.finish();
+
+    let mut group = c.benchmark_group("index");
+    group.throughput(Throughput::Bytes(total_bytes));
+    bench_thread_counts(&mut group, &sources);
+    group.finish();
+
+    let mut group = c.benchmark_group("index_files");
+    group.throughput(Throughput::Elements(sources.len() as u64));
+    bench_thread_counts(&mut group, &sources);
+    group.finish();
+}
+
+criterion_group!(benches, bench_index);
+criterion_main!(benches);
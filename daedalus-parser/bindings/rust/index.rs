@@ -0,0 +1,669 @@
+//! Parallel extraction of top-level declarations from Daedalus scripts.
+//!
+//! Sources are memory-mapped, parsed by a scoped pool of threads with one [Parser][] each, and
+//! streamed back to the caller as each file finishes. Extracted names and values borrow from
+//! the mapped sources, so indexing a project copies no text unless a file is not UTF-8. Such
+//! files are decoded from the code page in [IndexOptions::encoding][].
+//!
+//! ```no_run
+//! use tree_sitter_daedalus::index::{find_sources, index_sources, IndexOptions, Source};
+//!
+//! let paths = find_sources("Scripts/Content".as_ref()).unwrap();
+//! // Safety: the checkout is not modified while it is indexed
+//! let sources = paths
+//!     .into_iter()
+//!     .map(|path| unsafe { Source::map(path) })
+//!     .collect::<std::io::Result<Vec<_>>>()
+//!     .unwrap();
+//!
+//! index_sources(&sources, &IndexOptions::default(), |file| {
+//!     for instance in &file.instances {
+//!         if let Some(dialog) = &instance.dialog {
+//!             println!("{}: {} ({:?})", file.path.display(), instance.name, dialog.npc);
+//!         }
+//!     }
+//! });
+//! ```
+//!
+//! [Parser]: https://docs.rs/tree-sitter/*/tree_sitter/struct.Parser.html
+//! [IndexOptions::encoding]: struct.IndexOptions.html#structfield.encoding
+
+use std::borrow::Cow;
+use std::fs::{self, File};
+use std::io;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::mpsc;
+use std::thread;
+
+use memmap2::Mmap;
+use tree_sitter::{Node, Parser};
+
+const SKIPPED_DIRECTORIES: &[&str] = &[".git", ".svn", "node_modules"];
+
+/// Results a worker may queue ahead of the consumer; bounds memory when the consumer is slow.
+const RESULTS_PER_THREAD: usize = 4;
+
+/// Characters of the Windows-1252 bytes 0x80..=0x9F; the rest of the code page matches Latin-1.
+/// Undefined bytes map to the C1 control of the same value.
+const WINDOWS_1252_HIGH: [char; 32] = [
+    '€', '\u{81}', '‚', 'ƒ', '„', '…', '†', '‡', 'ˆ', '‰', 'Š', '‹', 'Œ', '\u{8D}', 'Ž', '\u{8F}',
+    '\u{90}', '‘', '’', '“', '”', '•', '–', '—', '˜', '™', 'š', '›', 'œ', '\u{9D}', 'ž', 'Ÿ',
+];
+
+/// Characters of the Windows-1250 bytes 0x80..=0xFF. Undefined bytes map to the C1 control of
+/// the same value.
+#[rustfmt::skip]
+const WINDOWS_1250_HIGH: [char; 128] = [
+    '€', '\u{81}', '‚', '\u{83}', '„', '…', '†', '‡', '\u{88}', '‰', 'Š', '‹', 'Ś', 'Ť', 'Ž', 'Ź',
+    '\u{90}', '‘', '’', '“', '”', '•', '–', '—', '\u{98}', '™', 'š', '›', 'ś', 'ť', 'ž', 'ź',
+    '\u{A0}', 'ˇ', '˘', 'Ł', '¤', 'Ą', '¦', '§', '¨', '©', 'Ş', '«', '¬', '\u{AD}', '®', 'Ż',
+    '°', '±', '˛', 'ł', '´', 'µ', '¶', '·', '¸', 'ą', 'ş', '»', 'Ľ', '˝', 'ľ', 'ż',
+    'Ŕ', 'Á', 'Â', 'Ă', 'Ä', 'Ĺ', 'Ć', 'Ç', 'Č', 'É', 'Ę', 'Ë', 'Ě', 'Í', 'Î', 'Ď',
+    'Đ', 'Ń', 'Ň', 'Ó', 'Ô', 'Ő', 'Ö', '×', 'Ř', 'Ů', 'Ú', 'Ű', 'Ü', 'Ý', 'Ţ', 'ß',
+    'ŕ', 'á', 'â', 'ă', 'ä', 'ĺ', 'ć', 'ç', 'č', 'é', 'ę', 'ë', 'ě', 'í', 'î', 'ď',
+    'đ', 'ń', 'ň', 'ó', 'ô', 'ő', 'ö', '÷', 'ř', 'ů', 'ú', 'ű', 'ü', 'ý', 'ţ', '˙',
+];
+
+enum Contents {
+    Mapped(Mmap),
+    Owned(Vec<u8>),
+}
+
+/// The text of one script file, memory-mapped or held in memory.
+pub struct Source {
+    path: PathBuf,
+    contents: Contents,
+}
+
+impl Source {
+    /// Memory-map the file at `path`.
+    ///
+    /// # Safety
+    ///
+    /// The file must not be modified or truncated while the returned `Source` or anything
+    /// extracted from it is alive. Use [Source::from_bytes][] for files that may change.
+    ///
+    /// [Source::from_bytes]: struct.Source.html#method.from_bytes
+    pub unsafe fn map(path: impl Into<PathBuf>) -> io::Result<Self> {
+        let path = path.into();
+        let file = File::open(&path)?;
+        // Mapping an empty file fails on some platforms
+        let contents = if file.metadata()?.len() == 0 {
+            Contents::Owned(Vec::new())
+        } else {
+            Contents::Mapped(Mmap::map(&file)?)
+        };
+        Ok(Self { path, contents })
+    }
+
+    /// A source held in memory, e.g. an unsaved buffer.
+    pub fn from_bytes(path: impl Into<PathBuf>, bytes: impl Into<Vec<u8>>) -> Self {
+        Self {
+            path: path.into(),
+            contents: Contents::Owned(bytes.into()),
+        }
+    }
+
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+
+    pub fn bytes(&self) -> &[u8] {
+        match &self.contents {
+            Contents::Mapped(map) => map,
+            Contents::Owned(bytes) => bytes,
+        }
+    }
+}
+
+/// A zero-based row and byte column in a source file.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct Position {
+    pub row: usize,
+    pub column: usize,
+}
+
+/// Spans a declaration from its keyword to its closing brace or semicolon.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct Range {
+    pub start: Position,
+    pub end: Position,
+}
+
+/// The properties a dialog (`instance Name (C_INFO)`) assigns in its body. Each holds the
+/// source text of the last assignment's value; `description` has its quotes removed.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct DialogProperties<'a> {
+    pub npc: Option<Cow<'a, str>>,
+    pub nr: Option<Cow<'a, str>>,
+    pub condition: Option<Cow<'a, str>>,
+    pub information: Option<Cow<'a, str>>,
+    pub description: Option<Cow<'a, str>>,
+}
+
+/// An `instance Name (Parent)` declaration.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Instance<'a> {
+    pub name: Cow<'a, str>,
+    pub parent: Cow<'a, str>,
+    pub range: Range,
+    /// Set for dialogs, i.e. instances of C_INFO.
+    pub dialog: Option<DialogProperties<'a>>,
+}
+
+/// A `prototype Name (Class)` declaration.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Prototype<'a> {
+    pub name: Cow<'a, str>,
+    pub parent: Cow<'a, str>,
+    pub range: Range,
+}
+
+/// A `func Type Name (...)` declaration.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Function<'a> {
+    pub name: Cow<'a, str>,
+    pub return_type: Cow<'a, str>,
+    pub range: Range,
+}
+
+/// A top-level `const Type Name = Value;` declaration. `value` is the initializer's source text.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Constant<'a> {
+    pub name: Cow<'a, str>,
+    pub type_name: Cow<'a, str>,
+    pub value: Cow<'a, str>,
+    pub range: Range,
+}
+
+/// A top-level `var Type Name;` declaration, e.g. MIS_ quest states.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Variable<'a> {
+    pub name: Cow<'a, str>,
+    pub type_name: Cow<'a, str>,
+    pub range: Range,
+}
+
+/// The top-level declarations of one file, in source order.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct FileDeclarations<'a> {
+    pub path: &'a Path,
+    pub instances: Vec<Instance<'a>>,
+    pub prototypes: Vec<Prototype<'a>>,
+    pub functions: Vec<Function<'a>>,
+    pub constants: Vec<Constant<'a>>,
+    pub variables: Vec<Variable<'a>>,
+    /// Set when the file has syntax errors; declarations that parsed are still reported.
+    pub has_errors: bool,
+}
+
+/// How the bytes of a source are turned into text. Slices that are plain ASCII read the same
+/// in all of them and are never copied.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub enum Encoding {
+    /// UTF-8 when the whole file is valid UTF-8, otherwise Windows-1252, the code page of most
+    /// Gothic scripts.
+    #[default]
+    Auto,
+    /// UTF-8; invalid sequences become U+FFFD.
+    Utf8,
+    /// Central European releases, e.g. the Polish and Czech translations.
+    Windows1250,
+    /// Western European releases, e.g. the German and English originals.
+    Windows1252,
+}
+
+/// Options for [index_sources][].
+///
+/// [index_sources]: fn.index_sources.html
+#[derive(Debug, Clone, Default)]
+pub struct IndexOptions {
+    /// Number of parsing threads; 0 means [std::thread::available_parallelism][].
+    ///
+    /// [std::thread::available_parallelism]: https://doc.rust-lang.org/std/thread/fn.available_parallelism.html
+    pub threads: usize,
+    /// Encoding of the sources.
+    pub encoding: Encoding,
+}
+
+impl IndexOptions {
+    fn thread_count(&self) -> usize {
+        if self.threads > 0 {
+            self.threads
+        } else {
+            thread::available_parallelism().map_or(1, |count| count.get())
+        }
+    }
+}
+
+/// Source text of a file, decoded per extracted slice.
+#[derive(Clone, Copy)]
+struct Text<'a> {
+    bytes: &'a [u8],
+    /// Auto resolved for this file
+    encoding: Encoding,
+}
+
+impl<'a> Text<'a> {
+    fn new(bytes: &'a [u8], encoding: Encoding) -> Self {
+        let encoding = match encoding {
+            Encoding::Auto if std::str::from_utf8(bytes).is_ok() => Encoding::Utf8,
+            Encoding::Auto => Encoding::Windows1252,
+            encoding => encoding,
+        };
+        Self { bytes, encoding }
+    }
+
+    fn slice(&self, range: std::ops::Range<usize>) -> Cow<'a, str> {
+        let bytes = &self.bytes[range];
+        // Only non-ASCII slices of code page files are copied
+        if self.encoding == Encoding::Utf8 || bytes.is_ascii() {
+            return String::from_utf8_lossy(bytes);
+        }
+        let decode = |byte: u8| match (self.encoding, byte) {
+            (_, 0x00..=0x7F) => char::from(byte),
+            (Encoding::Windows1250, _) => WINDOWS_1250_HIGH[usize::from(byte - 0x80)],
+            (_, 0x80..=0x9F) => WINDOWS_1252_HIGH[usize::from(byte - 0x80)],
+            // The rest of Windows-1252 matches Latin-1
+            _ => char::from(byte),
+        };
+        Cow::Owned(bytes.iter().map(|&byte| decode(byte)).collect())
+    }
+
+    fn node(&self, node: Node) -> Cow<'a, str> {
+        self.slice(node.byte_range())
+    }
+
+    fn field(&self, node: Node, field: &str) -> Option<Cow<'a, str>> {
+        node.child_by_field_name(field)
+            .map(|child| self.node(child))
+    }
+
+    /// A value's text; string literals lose their quotes.
+    fn value(&self, node: Node) -> Cow<'a, str> {
+        let range = node.byte_range();
+        if node.kind() == "string" && range.len() >= 2 {
+            self.slice(range.start + 1..range.end - 1)
+        } else {
+            self.slice(range)
+        }
+    }
+}
+
+fn node_range(node: Node) -> Range {
+    let (start, end) = (node.start_position(), node.end_position());
+    Range {
+        start: Position {
+            row: start.row,
+            column: start.column,
+        },
+        end: Position {
+            row: end.row,
+            column: end.column,
+        },
+    }
+}
+
+fn dialog_properties<'a>(body: Node, text: Text<'a>) -> DialogProperties<'a> {
+    let mut properties = DialogProperties::default();
+    let mut cursor = body.walk();
+    for statement in body.named_children(&mut cursor) {
+        if statement.kind() != "assignment_statement" {
+            continue;
+        }
+        let (Some(left), Some(right)) = (
+            statement.child_by_field_name("left"),
+            statement.child_by_field_name("right"),
+        ) else {
+            continue;
+        };
+        if left.kind() != "identifier" {
+            continue;
+        }
+        let slot = match &text.bytes[left.byte_range()] {
+            name if name.eq_ignore_ascii_case(b"npc") => &mut properties.npc,
+            name if name.eq_ignore_ascii_case(b"nr") => &mut properties.nr,
+            name if name.eq_ignore_ascii_case(b"condition") => &mut properties.condition,
+            name if name.eq_ignore_ascii_case(b"information") => &mut properties.information,
+            name if name.eq_ignore_ascii_case(b"description") => &mut properties.description,
+            _ => continue,
+        };
+        *slot = Some(text.value(right));
+    }
+    properties
+}
+
+/// Collect the top-level declarations under `root`, which must have been parsed from `source`.
+pub fn extract_declarations<'a>(
+    path: &'a Path,
+    root: Node,
+    source: &'a [u8],
+    encoding: Encoding,
+) -> FileDeclarations<'a> {
+    let text = Text::new(source, encoding);
+    let mut declarations = FileDeclarations {
+        path,
+        instances: Vec::new(),
+        prototypes: Vec::new(),
+        functions: Vec::new(),
+        constants: Vec::new(),
+        variables: Vec::new(),
+        has_errors: root.has_error(),
+    };
+
+    let mut cursor = root.walk();
+    for node in root.named_children(&mut cursor) {
+        let Some(name) = text.field(node, "name") else {
+            continue;
+        };
+        let range = node_range(node);
+        let field = |field_name: &str| text.field(node, field_name).unwrap_or_default();
+
+        match node.kind() {
+            "instance_declaration" => {
+                let parent = field("parent");
+                let dialog = match node.child_by_field_name("body") {
+                    Some(body) if parent.eq_ignore_ascii_case("C_INFO") => {
+                        Some(dialog_properties(body, text))
+                    }
+                    _ => None,
+                };
+                declarations.instances.push(Instance {
+                    name,
+                    parent,
+                    range,
+                    dialog,
+                });
+            }
+            "prototype_declaration" => declarations.prototypes.push(Prototype {
+                name,
+                parent: field("parent"),
+                range,
+            }),
+            "function_declaration" => declarations.functions.push(Function {
+                name,
+                return_type: field("return_type"),
+                range,
+            }),
+            "variable_declaration" => {
+                let type_name = field("type");
+                if field("keyword").eq_ignore_ascii_case("const") {
+                    declarations.constants.push(Constant {
+                        name,
+                        type_name,
+                        value: field("value"),
+                        range,
+                    });
+                } else {
+                    declarations.variables.push(Variable {
+                        name,
+                        type_name,
+                        range,
+                    });
+                }
+            }
+            _ => {}
+        }
+    }
+    declarations
+}
+
+/// A parser for Daedalus.
+pub fn new_parser() -> Parser {
+    let mut parser = Parser::new();
+    parser
+        .set_language(&crate::language())
+        .expect("Error loading Daedalus grammar");
+    parser
+}
+
+/// Parse one source with `parser` and extract its declarations.
+pub fn index_source<'a>(
+    parser: &mut Parser,
+    source: &'a Source,
+    encoding: Encoding,
+) -> FileDeclarations<'a> {
+    let bytes = source.bytes();
+    // Only a cancelled or timed-out parse returns None, and neither is configured here
+    let tree = parser
+        .parse(bytes, None)
+        .expect("parser without timeout or cancellation returned no tree");
+    extract_declarations(source.path(), tree.root_node(), bytes, encoding)
+}
+
+/// Index `sources` on a scoped pool of threads, one parser per thread, and call `on_file` on
+/// the calling thread with each file's declarations as soon as it is done. Files complete in
+/// no particular order; sort by `path` when order matters.
+pub fn index_sources<'a, F>(sources: &'a [Source], options: &IndexOptions, mut on_file: F)
+where
+    F: FnMut(FileDeclarations<'a>),
+{
+    let threads = options.thread_count().min(sources.len());
+    if threads == 0 {
+        return;
+    }
+
+    let next = AtomicUsize::new(0);
+    let (sender, receiver) = mpsc::sync_channel(threads * RESULTS_PER_THREAD);
+    thread::scope(|scope| {
+        for _ in 0..threads {
+            let sender = sender.clone();
+            let next = &next;
+            scope.spawn(move || {
+                let mut parser = new_parser();
+                // Files are claimed one at a time, so a few large files do not leave threads idle
+                while let Some(source) = sources.get(next.fetch_add(1, Ordering::Relaxed)) {
+                    let declarations = index_source(&mut parser, source, options.encoding);
+                    if sender.send(declarations).is_err() {
+                        break; // The consumer panicked
+                    }
+                }
+            });
+        }
+        drop(sender);
+        for declarations in receiver {
+            on_file(declarations);
+        }
+    });
+}
+
+/// Every `.d` file under `root`, sorted. Version control and `node_modules` directories are
+/// skipped, as are subdirectories that cannot be read.
+pub fn find_sources(root: &Path) -> io::Result<Vec<PathBuf>> {
+    let mut paths = Vec::new();
+    let mut pending = vec![root.to_path_buf()];
+    while let Some(dir) = pending.pop() {
+        let entries = match fs::read_dir(&dir) {
+            Ok(entries) => entries,
+            Err(error) if dir == root => return Err(error),
+            Err(_) => continue,
+        };
+        for entry in entries.flatten() {
+            let path = entry.path();
+            let Ok(file_type) = entry.file_type() else {
+                continue;
+            };
+            if file_type.is_dir() {
+                let skipped = entry
+                    .file_name()
+                    .to_str()
+                    .is_some_and(|name| SKIPPED_DIRECTORIES.contains(&name));
+                if !skipped {
+                    pending.push(path);
+                }
+            } else if path
+                .extension()
+                .is_some_and(|extension| extension.eq_ignore_ascii_case("d"))
+            {
+                paths.push(path);
+            }
+        }
+    }
+    paths.sort();
+    Ok(paths)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const QUESTS: &str = r#"const string TOPIC_Trade = "Trade";
+var int MIS_Trade;
+
+prototype Mil_Proto (C_NPC) {};
+"#;
+
+    const DIALOG: &str = r#"INSTANCE DIA_Merchant_Hello (C_INFO)
+{
+    npc         = Merchant;
+    nr          = 2;
+    condition   = DIA_Merchant_Hello_Condition;
+    information = DIA_Merchant_Hello_Info;
+    description = "Hello";
+};
+
+instance Merchant (C_NPC)
+{
+    name = "Merchant";
+};
+
+func int DIA_Merchant_Hello_Condition()
+{
+    return TRUE;
+};
+"#;
+
+    fn index_all(sources: &[Source], threads: usize) -> Vec<FileDeclarations<'_>> {
+        index_with(
+            sources,
+            &IndexOptions {
+                threads,
+                ..Default::default()
+            },
+        )
+    }
+
+    fn index_with<'a>(sources: &'a [Source], options: &IndexOptions) -> Vec<FileDeclarations<'a>> {
+        let mut files = Vec::new();
+        index_sources(sources, options, |file| files.push(file));
+        files.sort_by_key(|file| file.path);
+        files
+    }
+
+    #[test]
+    fn test_extracts_declarations_and_dialog_properties() {
+        let sources = [
+            Source::from_bytes("DIA_Merchant.d", DIALOG),
+            Source::from_bytes("Quests.d", QUESTS),
+        ];
+        let files = index_all(&sources, 2);
+        assert_eq!(files.len(), 2);
+
+        let dialog = &files[0];
+        assert!(!dialog.has_errors);
+        assert_eq!(dialog.instances.len(), 2);
+        assert_eq!(dialog.instances[0].name, "DIA_Merchant_Hello");
+        assert_eq!(
+            dialog.instances[0].dialog,
+            Some(DialogProperties {
+                npc: Some("Merchant".into()),
+                nr: Some("2".into()),
+                condition: Some("DIA_Merchant_Hello_Condition".into()),
+                information: Some("DIA_Merchant_Hello_Info".into()),
+                description: Some("Hello".into()),
+            })
+        );
+        assert_eq!(dialog.instances[1].dialog, None);
+        assert_eq!(dialog.functions[0].return_type, "int");
+        assert_eq!(
+            dialog.instances[0].range.start,
+            Position { row: 0, column: 0 }
+        );
+
+        // Names and values point into the source text rather than copies of it
+        let range = sources[0].bytes().as_ptr_range();
+        assert!(
+            matches!(&dialog.instances[0].name, Cow::Borrowed(name) if range.contains(&name.as_ptr()))
+        );
+
+        let quests = &files[1];
+        assert_eq!(quests.constants[0].name, "TOPIC_Trade");
+        assert_eq!(quests.constants[0].value, "\"Trade\"");
+        assert_eq!(quests.variables[0].type_name, "int");
+        assert_eq!(quests.prototypes[0].parent, "C_NPC");
+    }
+
+    #[test]
+    fn test_decodes_windows_1252_sources() {
+        let mut source = b"instance DIA_Smith (C_INFO) { description = \"Gr".to_vec();
+        source.extend_from_slice(&[0xFC, 0xDF, 0x80]);
+        source.extend_from_slice(b"\"; };");
+        let sources = [Source::from_bytes("DIA_Smith.d", source)];
+        let files = index_all(&sources, 1);
+
+        let dialog = files[0].instances[0].dialog.as_ref().unwrap();
+        assert_eq!(dialog.description.as_deref(), Some("Grüß€"));
+        assert!(matches!(
+            files[0].instances[0].name,
+            Cow::Borrowed("DIA_Smith")
+        ));
+    }
+
+    #[test]
+    fn test_decodes_the_configured_code_page() {
+        // "Żółw" in Windows-1250; the same bytes read "¯ó³w" as Windows-1252
+        let mut source = b"instance DIA_Zolw (C_INFO) { description = \"".to_vec();
+        source.extend_from_slice(&[0xAF, 0xF3, 0xB3, b'w']);
+        source.extend_from_slice(b"\"; };");
+        let sources = [Source::from_bytes("DIA_Zolw.d", source)];
+        let description = |encoding| {
+            let options = IndexOptions {
+                threads: 1,
+                encoding,
+            };
+            let files = index_with(&sources, &options);
+            let dialog = files[0].instances[0].dialog.clone().unwrap();
+            dialog.description.unwrap().into_owned()
+        };
+
+        assert_eq!(description(Encoding::Windows1250), "Żółw");
+        assert_eq!(description(Encoding::Windows1252), "¯ó³w");
+        assert_eq!(description(Encoding::Auto), "¯ó³w");
+        assert_eq!(description(Encoding::Utf8), "\u{FFFD}\u{FFFD}w");
+    }
+
+    #[test]
+    fn test_indexes_many_files_across_threads() {
+        let sources: Vec<_> = (0..64)
+            .map(|i| Source::from_bytes(format!("file_{i:02}.d"), DIALOG))
+            .collect();
+        let files = index_all(&sources, 4);
+        assert_eq!(files.len(), 64);
+        assert!(files.iter().all(|file| file.instances.len() == 2));
+        assert_eq!(files[63].path, Path::new("file_63.d"));
+    }
+
+    #[test]
+    fn test_maps_and_finds_sources() {
+        let root = std::env::temp_dir().join(format!("daedalus-index-{}", std::process::id()));
+        fs::create_dir_all(root.join("Story/node_modules")).unwrap();
+        fs::write(root.join("Story/Quests.D"), QUESTS).unwrap();
+        fs::write(root.join("Story/node_modules/skipped.d"), QUESTS).unwrap();
+        fs::write(root.join("Empty.d"), "").unwrap();
+        fs::write(root.join("notes.txt"), "").unwrap();
+
+        let paths = find_sources(&root).unwrap();
+        let sources = paths
+            .iter()
+            .map(|path| unsafe { Source::map(path) })
+            .collect::<io::Result<Vec<_>>>()
+            .unwrap();
+        let files = index_all(&sources, 0);
+        fs::remove_dir_all(&root).unwrap();
+
+        assert_eq!(paths, [root.join("Empty.d"), root.join("Story/Quests.D")]);
+        assert!(files[0].constants.is_empty());
+        assert_eq!(files[1].variables[0].name, "MIS_Trade");
+    }
+}
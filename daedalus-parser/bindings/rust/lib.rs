@@ -12,13 +12,19 @@
 //! assert!(!tree.root_node().has_error());
 //! ```
 //!
+//! To index a whole project, the [index][index mod] module parses many files in parallel and
+//! extracts their declarations and dialog properties.
+//!
 //! [Language]: https://docs.rs/tree-sitter/*/tree_sitter/struct.Language.html
+//! [index mod]: index/index.html
 //! [language func]: fn.language.html
 //! [Parser]: https://docs.rs/tree-sitter/*/tree_sitter/struct.Parser.html
 //! [tree-sitter]: https://tree-sitter.github.io/
 
 use tree_sitter::Language;
 
+pub mod index;
+
 extern "C" {
     fn tree_sitter_daedalus() -> Language;
 }
@@ -36,7 +36,7 @@ module.exports = [
         assert: 'readonly'
       }
     },
-    files: ['src/**/*.js', 'test/**/*.js', 'bin/daedalus-parse.js'],
+    files: ['src/**/*.js', 'test/**/*.js', 'bin/daedalus-parse.js', 'bin/daedalus-lsp.js'],
     rules: {
       // Possible Errors
       'no-console': 'off', // Allow console for CLI tools and debugging
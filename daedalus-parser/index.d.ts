@@ -5,6 +5,14 @@ interface Position {
 
 interface ParseOptions {
   bufferSize?: number;
+  /** Abort with an error whose `code` is `PARSE_TIMEOUT` after this many microseconds */
+  timeoutMicros?: number;
+  /** Polled during parsing; returning true aborts with `code` `PARSE_CANCELLED` */
+  shouldCancel?: () => boolean;
+  /** How long to parse between two `shouldCancel` checks, in microseconds (default: 20000) */
+  sliceMicros?: number;
+  /** Previous tree of the source, already updated with `tree.edit()`, to reparse incrementally */
+  oldTree?: any;
   [key: string]: unknown;
 }
 
@@ -69,12 +77,27 @@ declare class DaedalusParser {
 
   parse(sourceCode: string, options?: ParseOptions): ParseResult;
   parseFile(filePath: string, options?: ParseFileOptions): ParseResult;
+  readSource(
+    filePath: string,
+    options?: Pick<ParseFileOptions, 'encoding' | 'detectEncoding'>
+  ): { sourceCode: string; encoding: string; confidence: number };
   validate(sourceCode: string): ValidationResult;
 
   extractComments(parseResult: ParseResult): Comment[];
   extractDeclarations(parseResult: ParseResult): Declaration[];
 
   static parseSource(sourceCode: string, options?: ParseOptions): ParseResult;
+  static withParseResult<T>(sourceCode: string, callback: (result: ParseResult) => T, options?: ParseOptions): T;
+  static withParser<T>(callback: (parser: DaedalusParser) => T): T;
+  static acquire(): DaedalusParser;
+  static release(parser: DaedalusParser): void;
+  /**
+   * Drop the result's tree. Node tree-sitter has no Tree.delete(), so native
+   * tree memory is freed only when V8 garbage-collects the tree.
+   */
+  static disposeResult(result: ParseResult): void;
+  /** Trees parsed on this thread and neither disposed nor collected; a warning is emitted past 256 */
+  static liveTreeCount(): number;
   static create(): DaedalusParser;
 }
 
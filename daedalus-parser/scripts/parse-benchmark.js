@@ -0,0 +1,158 @@
+#!/usr/bin/env node
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const DaedalusParser = require('../src/core/parser');
+
+function parseArgs(argv) {
+  const args = { dirs: [] };
+  for (let i = 0; i < argv.length; i += 1) {
+    const token = argv[i];
+    if (token === '--iterations') {
+      args.iterations = Number(argv[i + 1]);
+      i += 1;
+    } else if (token === '--output') {
+      args.output = argv[i + 1];
+      i += 1;
+    } else if (token === '--baseline') {
+      args.baseline = argv[i + 1];
+      i += 1;
+    } else if (token === '--label') {
+      args.label = argv[i + 1];
+      i += 1;
+    } else if (token === '--help' || token === '-h') {
+      args.help = true;
+    } else {
+      args.dirs.push(token);
+    }
+  }
+  return args;
+}
+
+function printHelp() {
+  const text = [
+    'Usage: node scripts/parse-benchmark.js [options] <dir>...',
+    '',
+    'Parses every .d file under the given directories with the native parser',
+    'currently built (build/Release or a prebuild) and reports throughput.',
+    '',
+    'Options:',
+    '  --iterations <n>    Timed passes over all files; the median is reported (default: 5)',
+    '  --output <file>     Also write the result as JSON',
+    '  --baseline <file>   JSON result of an earlier run on the same files; prints the speedup',
+    '  --label <name>      Name of this build in the output (default: current)',
+    '  --help, -h          Show this help',
+    '',
+    'Example (what make pgo runs):',
+    '  node scripts/parse-benchmark.js --output baseline.json examples reference',
+    '  # ...rebuild...',
+    '  node scripts/parse-benchmark.js --baseline baseline.json --label pgo examples reference'
+  ];
+  console.log(text.join('\n'));
+}
+
+function collectFiles(rootDir) {
+  const files = [];
+  if (!fs.existsSync(rootDir)) {
+    return files;
+  }
+  const stack = [rootDir];
+  while (stack.length > 0) {
+    const current = stack.pop();
+    for (const entry of fs.readdirSync(current, { withFileTypes: true })) {
+      const fullPath = path.join(current, entry.name);
+      if (entry.isDirectory()) {
+        stack.push(fullPath);
+      } else if (entry.isFile() && entry.name.toLowerCase().endsWith('.d')) {
+        files.push(fullPath);
+      }
+    }
+  }
+  return files.sort();
+}
+
+function median(values) {
+  const sorted = [...values].sort((a, b) => a - b);
+  const middle = sorted.length >> 1;
+  return sorted.length % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+}
+
+/**
+ * Time passes over `sources`, after one untimed warm-up pass
+ * @returns {{label: string, files: number, bytes: number, iterations: number, medianMs: number,
+ *   filesPerSecond: number, bytesPerSecond: number}}
+ */
+function benchmark(sources, iterations, label) {
+  const parser = new DaedalusParser();
+  const bytes = sources.reduce((total, source) => total + source.bytes, 0);
+  const pass = () => {
+    const start = process.hrtime.bigint();
+    for (const source of sources) {
+      parser.parse(source.text);
+    }
+    return Number(process.hrtime.bigint() - start) / 1_000_000;
+  };
+
+  pass();
+  const timings = [];
+  for (let i = 0; i < iterations; i += 1) {
+    timings.push(pass());
+  }
+  const medianMs = median(timings);
+  return {
+    label,
+    files: sources.length,
+    bytes,
+    iterations,
+    medianMs,
+    filesPerSecond: sources.length / medianMs * 1000,
+    bytesPerSecond: bytes / medianMs * 1000
+  };
+}
+
+function formatResult(result) {
+  return `${result.label}: ${result.files} files, ${(result.bytes / 1024 / 1024).toFixed(2)} MB, `
+    + `median ${result.medianMs.toFixed(1)} ms over ${result.iterations} passes `
+    + `(${Math.round(result.filesPerSecond)} files/s, ${(result.bytesPerSecond / 1024 / 1024).toFixed(2)} MB/s)`;
+}
+
+function main() {
+  const args = parseArgs(process.argv.slice(2));
+  if (args.help || args.dirs.length === 0) {
+    printHelp();
+    process.exit(args.help ? 0 : 2);
+  }
+
+  const parser = new DaedalusParser();
+  const sources = args.dirs.flatMap(collectFiles).map((file) => {
+    const { sourceCode } = parser.readSource(file);
+    return { file, text: sourceCode, bytes: fs.statSync(file).size };
+  });
+  if (sources.length === 0) {
+    console.error(`No .d files found under ${args.dirs.join(', ')}`);
+    process.exit(2);
+  }
+
+  const iterations = Number.isInteger(args.iterations) && args.iterations > 0 ? args.iterations : 5;
+  const result = benchmark(sources, iterations, args.label || 'current');
+  console.log(formatResult(result));
+
+  if (args.output) {
+    fs.mkdirSync(path.dirname(path.resolve(args.output)), { recursive: true });
+    fs.writeFileSync(args.output, `${JSON.stringify(result, null, 2)}\n`);
+  }
+
+  if (args.baseline) {
+    const baseline = JSON.parse(fs.readFileSync(args.baseline, 'utf8'));
+    console.log(formatResult(baseline));
+    if (baseline.files !== result.files || baseline.bytes !== result.bytes) {
+      console.error('Warning: the baseline was measured on different files; the speedup is not comparable');
+    }
+    const speedup = baseline.medianMs / result.medianMs;
+    console.log(`Speedup of ${result.label} over ${baseline.label}: ${speedup.toFixed(2)}x `
+      + `(${((speedup - 1) * 100).toFixed(1)}% ${speedup >= 1 ? 'faster' : 'slower'})`);
+  }
+}
+
+main();
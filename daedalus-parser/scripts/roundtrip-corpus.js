@@ -2,12 +2,18 @@
 'use strict';
 
 const fs = require('fs');
+const os = require('os');
 const path = require('path');
+const crypto = require('crypto');
+const { Worker, isMainThread, parentPort } = require('worker_threads');
 const iconv = require('iconv-lite');
 const DaedalusParser = require('../src/core/parser');
 const { SemanticModelBuilderVisitor } = require('../dist/semantic/semantic-visitor-index');
 const { SemanticCodeGenerator } = require('../dist/codegen/generator');
 
+const CACHE_VERSION = 1;
+const STAGES = ['parse', 'model', 'generate', 'reparse', 'compare'];
+
 function parseArgs(argv) {
   const args = {};
   for (let i = 0; i < argv.length; i += 1) {
@@ -24,6 +30,14 @@ function parseArgs(argv) {
     } else if (token === '--report-dir') {
       args.reportDir = argv[i + 1];
       i += 1;
+    } else if (token === '--jobs') {
+      args.jobs = Number(argv[i + 1]);
+      i += 1;
+    } else if (token === '--cache') {
+      args.cache = argv[i + 1];
+      i += 1;
+    } else if (token === '--no-cache') {
+      args.cache = false;
     } else if (token === '--strict') {
       args.strict = true;
     } else if (token === '--no-strict') {
@@ -44,19 +58,28 @@ function printHelp() {
     '  --report-prefix <prefix>  Prefix for report files (default: dialog-roundtrip-corpus)',
     '  --report-dir <path>       Directory for generated reports (default: <repo>/reports)',
     '  --max-files <n>           Stop after processing n files',
+    '  --jobs <n>                Worker threads (default: CPU count, 1 runs in-process)',
+    '  --cache <path>            Result cache (default: <report-dir>/<prefix>-cache.json)',
+    '  --no-cache                Re-check every file and leave the cache untouched',
     '  --strict                  Exit 1 on structural drift (default)',
     '  --no-strict               Always exit 0',
     '  --help, -h                Show this help',
     '',
     'Examples:',
     '  npm run test:roundtrip-corpus -- --root "C:\\\\mods\\\\Story\\\\Dialoge"',
-    '  npm run test:roundtrip-corpus -- --max-files 50 --no-strict'
+    '  npm run test:roundtrip-corpus -- --max-files 50 --no-strict',
+    '',
+    'Files that passed cleanly before are skipped while neither their content nor',
+    'the parser/generator build has changed.'
   ];
   console.log(text.join('\n'));
 }
 
-function collectDialogFiles(rootDir) {
+function collectFiles(rootDir, matchName) {
   const files = [];
+  if (!fs.existsSync(rootDir)) {
+    return files;
+  }
   const stack = [rootDir];
 
   while (stack.length > 0) {
@@ -66,7 +89,7 @@ function collectDialogFiles(rootDir) {
       const fullPath = path.join(current, entry.name);
       if (entry.isDirectory()) {
         stack.push(fullPath);
-      } else if (entry.isFile() && entry.name.toLowerCase().endsWith('.d')) {
+      } else if (entry.isFile() && matchName(entry.name)) {
         files.push(fullPath);
       }
     }
@@ -76,6 +99,10 @@ function collectDialogFiles(rootDir) {
   return files;
 }
 
+function collectDialogFiles(rootDir) {
+  return collectFiles(rootDir, (name) => name.toLowerCase().endsWith('.d'));
+}
+
 function extractModelSummary(model) {
   const dialogs = Object.keys(model.dialogs).sort();
   const functions = Object.keys(model.functions).sort();
@@ -210,8 +237,41 @@ function parseFileWithFallback(filePath, parser) {
   }
 }
 
+function createStageTimings() {
+  const timings = {};
+  STAGES.forEach((stage) => {
+    timings[stage] = 0;
+  });
+  return timings;
+}
+
+function timed(timings, stage, fn) {
+  const start = process.hrtime.bigint();
+  try {
+    return fn();
+  } finally {
+    timings[stage] += Number(process.hrtime.bigint() - start) / 1e6;
+  }
+}
+
 function analyzeFile(filePath, parser, generator) {
-  const source = parseFileWithFallback(filePath, parser);
+  const timings = createStageTimings();
+  const start = process.hrtime.bigint();
+  const result = analyzeFileStages(filePath, parser, generator, timings);
+  timings.total = Number(process.hrtime.bigint() - start) / 1e6;
+  result.timings = timings;
+  return result;
+}
+
+function buildModel(tree) {
+  const visitor = new SemanticModelBuilderVisitor();
+  visitor.pass1_createObjects(tree.rootNode);
+  visitor.pass2_analyzeAndLink(tree.rootNode);
+  return visitor;
+}
+
+function analyzeFileStages(filePath, parser, generator, timings) {
+  const source = timed(timings, 'parse', () => parseFileWithFallback(filePath, parser));
 
   if (source.hasErrors) {
     return {
@@ -222,12 +282,10 @@ function analyzeFile(filePath, parser, generator) {
     };
   }
 
-  const sourceVisitor = new SemanticModelBuilderVisitor();
-  sourceVisitor.pass1_createObjects(source.rootNode);
-  sourceVisitor.pass2_analyzeAndLink(source.rootNode);
+  const sourceVisitor = timed(timings, 'model', () => buildModel(source));
 
-  const generatedText = generator.generateSemanticModel(sourceVisitor.semanticModel);
-  const generated = parser.parse(generatedText);
+  const generatedText = timed(timings, 'generate', () => generator.generateSemanticModel(sourceVisitor.semanticModel));
+  const generated = timed(timings, 'reparse', () => parser.parse(generatedText));
 
   if (generated.hasErrors) {
     return {
@@ -238,15 +296,14 @@ function analyzeFile(filePath, parser, generator) {
     };
   }
 
-  const generatedVisitor = new SemanticModelBuilderVisitor();
-  generatedVisitor.pass1_createObjects(generated.rootNode);
-  generatedVisitor.pass2_analyzeAndLink(generated.rootNode);
+  const generatedVisitor = timed(timings, 'reparse', () => buildModel(generated));
 
   // Idempotence check: save output should stabilize after the first generation.
-  const generatedTextSecond = generator.generateSemanticModel(generatedVisitor.semanticModel);
+  const generatedTextSecond = timed(timings, 'generate',
+    () => generator.generateSemanticModel(generatedVisitor.semanticModel));
   const byteIdempotenceDrift = generatedText !== generatedTextSecond;
 
-  const generatedSecond = parser.parse(generatedTextSecond);
+  const generatedSecond = timed(timings, 'reparse', () => parser.parse(generatedTextSecond));
   if (generatedSecond.hasErrors) {
     return {
       file: filePath,
@@ -256,10 +313,19 @@ function analyzeFile(filePath, parser, generator) {
     };
   }
 
-  const generatedSecondVisitor = new SemanticModelBuilderVisitor();
-  generatedSecondVisitor.pass1_createObjects(generatedSecond.rootNode);
-  generatedSecondVisitor.pass2_analyzeAndLink(generatedSecond.rootNode);
+  const generatedSecondVisitor = timed(timings, 'reparse', () => buildModel(generatedSecond));
 
+  return timed(timings, 'compare', () => compareModels(
+    filePath,
+    source,
+    sourceVisitor,
+    generatedVisitor,
+    generatedSecondVisitor,
+    byteIdempotenceDrift
+  ));
+}
+
+function compareModels(filePath, source, sourceVisitor, generatedVisitor, generatedSecondVisitor, byteIdempotenceDrift) {
   const sourceSummary = extractModelSummary(sourceVisitor.semanticModel);
   const generatedSummary = extractModelSummary(generatedVisitor.semanticModel);
   const generatedSecondSummary = extractModelSummary(generatedSecondVisitor.semanticModel);
@@ -376,6 +442,71 @@ function analyzeFile(filePath, parser, generator) {
   };
 }
 
+function formatMs(ms) {
+  return ms < 1000 ? `${ms.toFixed(1)}ms` : `${(ms / 1000).toFixed(2)}s`;
+}
+
+/**
+ * Aggregate per-stage timings over the files analyzed in this run
+ */
+function summarizeStageTimings(details) {
+  const analyzed = details.filter((d) => d.timings && !d.cached);
+  const stageTimings = {};
+  [...STAGES, 'total'].forEach((stage) => {
+    const values = analyzed.map((d) => d.timings[stage] || 0);
+    const totalMs = values.reduce((sum, value) => sum + value, 0);
+    stageTimings[stage] = {
+      totalMs,
+      avgMs: values.length > 0 ? totalMs / values.length : 0,
+      maxMs: values.length > 0 ? Math.max(...values) : 0
+    };
+  });
+  return stageTimings;
+}
+
+function hashFile(filePath) {
+  return crypto.createHash('sha256').update(fs.readFileSync(filePath)).digest('hex');
+}
+
+/**
+ * Fingerprint of everything that decides a file's result: the runner, the
+ * parser (grammar and wrapper) and the compiled semantic/codegen build.
+ */
+function computeToolVersion() {
+  const hash = crypto.createHash('sha256');
+  const packageRoot = path.resolve(__dirname, '..');
+  const inputs = [
+    __filename,
+    path.join(packageRoot, 'package.json'),
+    path.join(packageRoot, 'src', 'parser.c'),
+    path.join(packageRoot, 'src', 'core', 'parser.js'),
+    ...collectFiles(path.join(packageRoot, 'dist'), (name) => name.endsWith('.js'))
+  ];
+  for (const filePath of inputs) {
+    hash.update(path.relative(packageRoot, filePath));
+    hash.update(fs.existsSync(filePath) ? fs.readFileSync(filePath) : '');
+  }
+  return hash.digest('hex');
+}
+
+function loadResultCache(cachePath, toolVersion) {
+  try {
+    const cache = JSON.parse(fs.readFileSync(cachePath, 'utf8'));
+    if (cache.version === CACHE_VERSION && cache.toolVersion === toolVersion && cache.files) {
+      return cache.files;
+    }
+  } catch (_error) {
+    // Missing or unreadable cache: start cold.
+  }
+  return {};
+}
+
+function saveResultCache(cachePath, toolVersion, entries) {
+  ensureDir(path.dirname(cachePath));
+  const cache = { version: CACHE_VERSION, toolVersion, files: entries };
+  fs.writeFileSync(cachePath, `${JSON.stringify(cache)}\n`, 'utf8');
+}
+
 function ensureDir(dirPath) {
   if (!fs.existsSync(dirPath)) {
     fs.mkdirSync(dirPath, { recursive: true });
@@ -410,7 +541,16 @@ function writeReports(reportDir, reportPrefix, summary, details) {
     `- Condition multiset drift files: **${summary.conditionMultisetDriftFiles}**`,
     `- Semantic idempotence drift files: **${summary.semanticIdempotenceDriftFiles}**`,
     `- Byte idempotence drift files (non-failing): **${summary.byteIdempotenceDriftFiles}**`,
-    `- Generated at: ${summary.generatedAt}`
+    `- Skipped via result cache: **${summary.cachedFiles}**`,
+    `- Workers: **${summary.workers}**, wall time: **${formatMs(summary.wallTimeMs)}**`,
+    `- Generated at: ${summary.generatedAt}`,
+    '',
+    '## Stage timings',
+    '',
+    '| Stage | Total | Avg / file | Max / file |',
+    '| --- | ---: | ---: | ---: |',
+    ...Object.entries(summary.stageTimings).map(([stage, t]) =>
+      `| ${stage} | ${formatMs(t.totalMs)} | ${formatMs(t.avgMs)} | ${formatMs(t.maxMs)} |`)
   ];
 
   fs.writeFileSync(markdownPath, `${mdLines.join('\n')}\n`, 'utf8');
@@ -418,7 +558,81 @@ function writeReports(reportDir, reportPrefix, summary, details) {
   return { summaryPath, markdownPath, detailsPath, byteIdempotencePath };
 }
 
-function main() {
+function createAnalyzer() {
+  const parser = DaedalusParser.acquire();
+  const generator = new SemanticCodeGenerator({
+    includeComments: true,
+    sectionHeaders: true,
+    preserveSourceStyle: true
+  });
+  return (file) => analyzeFile(file, parser, generator);
+}
+
+function runWorker() {
+  const analyze = createAnalyzer();
+  parentPort.on('message', ({ index, file }) => {
+    try {
+      parentPort.postMessage({ index, result: analyze(file) });
+    } catch (error) {
+      parentPort.postMessage({ index, error: error && error.stack ? error.stack : String(error) });
+    }
+  });
+}
+
+/**
+ * Analyze `files` on `jobs` worker threads; results keep the input order
+ */
+function analyzeInPool(files, jobs) {
+  const details = new Array(files.length);
+  if (files.length === 0) {
+    return Promise.resolve(details);
+  }
+
+  return new Promise((resolve, reject) => {
+    const workers = [];
+    let nextIndex = 0;
+    let completed = 0;
+    let failed = false;
+
+    const fail = (error) => {
+      if (failed) return;
+      failed = true;
+      workers.forEach((worker) => worker.terminate());
+      reject(error);
+    };
+
+    const feed = (worker) => {
+      if (nextIndex < files.length) {
+        const index = nextIndex;
+        nextIndex += 1;
+        worker.postMessage({ index, file: files[index] });
+      }
+    };
+
+    for (let i = 0; i < Math.min(jobs, files.length); i += 1) {
+      const worker = new Worker(__filename);
+      workers.push(worker);
+      worker.on('message', ({ index, result, error }) => {
+        if (error) {
+          fail(new Error(`Failed to analyze ${files[index]}:\n${error}`));
+          return;
+        }
+        details[index] = result;
+        completed += 1;
+        if (completed === files.length) {
+          workers.forEach((w) => w.terminate());
+          resolve(details);
+        } else {
+          feed(worker);
+        }
+      });
+      worker.on('error', fail);
+      feed(worker);
+    }
+  });
+}
+
+async function main() {
   const args = parseArgs(process.argv.slice(2));
   if (args.help) {
     printHelp();
@@ -430,27 +644,72 @@ function main() {
   const repoRoot = path.resolve(__dirname, '..', '..');
   const root = path.resolve(args.root || path.join(repoRoot, 'mdk', 'Content', 'Story', 'Dialoge'));
   const reportDir = path.resolve(args.reportDir || path.join(repoRoot, 'reports'));
+  const cachePath = args.cache === false
+    ? null
+    : path.resolve(args.cache || path.join(reportDir, `${reportPrefix}-cache.json`));
+  const availableCpus = typeof os.availableParallelism === 'function' ? os.availableParallelism() : os.cpus().length;
+  const jobs = Number.isInteger(args.jobs) && args.jobs > 0 ? args.jobs : availableCpus;
 
   if (!fs.existsSync(root) || !fs.statSync(root).isDirectory()) {
     console.error(`Corpus root does not exist or is not a directory: ${root}`);
     process.exit(2);
   }
 
+  const startTime = process.hrtime.bigint();
   const allFiles = collectDialogFiles(root);
   const files = Number.isFinite(args.maxFiles) && args.maxFiles > 0
     ? allFiles.slice(0, args.maxFiles)
     : allFiles;
 
-  const parser = DaedalusParser.create();
-  const generator = new SemanticCodeGenerator({
-    includeComments: true,
-    sectionHeaders: true,
-    preserveSourceStyle: true
+  // Reuse clean results for files whose content and tooling are unchanged
+  const toolVersion = cachePath ? computeToolVersion() : null;
+  const cachedEntries = cachePath ? loadResultCache(cachePath, toolVersion) : {};
+  const hashes = new Map();
+  const details = new Array(files.length);
+  const pending = [];
+  files.forEach((file, index) => {
+    if (cachePath) {
+      hashes.set(file, hashFile(file));
+      const cached = cachedEntries[file];
+      if (cached && cached.hash === hashes.get(file)) {
+        details[index] = { ...cached.result, cached: true };
+        return;
+      }
+    }
+    pending.push(index);
   });
 
-  const details = [];
-  for (const file of files) {
-    details.push(analyzeFile(file, parser, generator));
+  const workerCount = Math.max(1, Math.min(jobs, pending.length));
+  const pendingFiles = pending.map((index) => files[index]);
+  let analyzed;
+  if (workerCount === 1) {
+    const analyze = createAnalyzer();
+    analyzed = pendingFiles.map((file) => analyze(file));
+  } else {
+    analyzed = await analyzeInPool(pendingFiles, workerCount);
+  }
+  pending.forEach((fileIndex, i) => {
+    details[fileIndex] = analyzed[i];
+  });
+
+  if (cachePath) {
+    // Merge into what was loaded, so runs over part of the corpus (--max-files,
+    // another --root) keep the entries of files they didn't look at
+    const entries = { ...cachedEntries };
+    files.forEach((file, index) => {
+      const { cached: _cached, ...result } = details[index];
+      if (result.status === 'ok') {
+        entries[file] = { hash: hashes.get(file), result };
+      } else {
+        delete entries[file];
+      }
+    });
+    Object.keys(entries).forEach((file) => {
+      if (!fs.existsSync(file)) {
+        delete entries[file];
+      }
+    });
+    saveResultCache(cachePath, toolVersion, entries);
   }
 
   const summary = {
@@ -468,9 +727,12 @@ function main() {
     byteIdempotenceDriftFiles: details.filter((d) => d.drift && d.drift.byteIdempotenceDrift).length,
     choiceTargetIssuesBefore: details.reduce((sum, d) => sum + ((d.drift && d.drift.missingChoiceTargetsBefore.length) || 0), 0),
     choiceTargetIssuesAfter: details.reduce((sum, d) => sum + ((d.drift && d.drift.missingChoiceTargetsAfter.length) || 0), 0),
-    choiceTargetIncreases: details.filter((d) => d.drift && d.drift.choiceTargetIncrease).length
+    choiceTargetIncreases: details.filter((d) => d.drift && d.drift.choiceTargetIncrease).length,
+    cachedFiles: details.filter((d) => d.cached).length,
+    workers: pending.length > 0 ? workerCount : 0,
+    wallTimeMs: Number(process.hrtime.bigint() - startTime) / 1e6,
+    stageTimings: summarizeStageTimings(details)
   };
-
   const reportPaths = writeReports(reportDir, reportPrefix, summary, details);
 
   console.log(`Roundtrip corpus scan finished.`);
@@ -486,6 +748,12 @@ function main() {
   console.log(`Condition multiset drift files: ${summary.conditionMultisetDriftFiles}`);
   console.log(`Semantic idempotence drift files: ${summary.semanticIdempotenceDriftFiles}`);
   console.log(`Byte idempotence drift files (non-failing): ${summary.byteIdempotenceDriftFiles}`);
+  console.log(`Skipped via result cache: ${summary.cachedFiles}`);
+  console.log(`Workers: ${summary.workers}, wall time: ${formatMs(summary.wallTimeMs)}`);
+  console.log(`Stage timings (total / avg per file):`);
+  Object.entries(summary.stageTimings).forEach(([stage, t]) => {
+    console.log(`  ${stage}: ${formatMs(t.totalMs)} / ${formatMs(t.avgMs)}`);
+  });
   console.log(`Reports:`);
   console.log(`  ${reportPaths.summaryPath}`);
   console.log(`  ${reportPaths.markdownPath}`);
@@ -500,4 +768,11 @@ function main() {
   }
 }
 
-main();
+if (isMainThread) {
+  main().catch((error) => {
+    console.error(error);
+    process.exit(1);
+  });
+} else {
+  runWorker();
+}
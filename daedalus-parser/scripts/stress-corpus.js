@@ -0,0 +1,196 @@
+#!/usr/bin/env node
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+
+function parseArgs(argv) {
+  const args = {};
+  for (let i = 0; i < argv.length; i += 1) {
+    const token = argv[i];
+    if (token === '--out') {
+      args.out = argv[i + 1];
+      i += 1;
+    } else if (token === '--scale') {
+      args.scale = Number(argv[i + 1]);
+      i += 1;
+    } else if (token === '--shape') {
+      args.shapes = (args.shapes || []).concat(argv[i + 1].split(','));
+      i += 1;
+    } else if (token === '--help' || token === '-h') {
+      args.help = true;
+    }
+  }
+  return args;
+}
+
+function printHelp() {
+  const text = [
+    'Usage: node scripts/stress-corpus.js --out <dir> [options]',
+    '',
+    'Options:',
+    '  --out <dir>       Directory to write the .d files to (created if missing)',
+    '  --scale <n>       Multiplier for every shape\'s default size (default: 1)',
+    '  --shape <names>   Comma-separated shapes to write (default: all)',
+    '  --help, -h        Show this help',
+    '',
+    'Writes one dialog file per pathological shape: long else-if chains, deeply',
+    'nested parenthesized conditions, long && chains, deeply nested arithmetic,',
+    'huge string literals and a broken else-if chain full of syntax errors.',
+    `Shapes: ${Object.keys(STRESS_SHAPES).join(', ')}`,
+    '',
+    'test/perf/stress.perf.test.js (npm run test:stress) uses the same generators',
+    'to check that parsing and the semantic passes stay linear in the input size.'
+  ];
+  console.log(text.join('\n'));
+}
+
+/**
+ * Wrap a condition function body and an information function body in a C_INFO
+ * dialog, so the semantic passes treat them as condition and action code
+ */
+function dialog(name, conditionBody, infoBody, description = `"${name}"`) {
+  return [
+    `INSTANCE ${name} (C_INFO)`,
+    '{',
+    '\tnpc\t\t\t= VLK_400_Stress;',
+    '\tnr\t\t\t= 1;',
+    `\tcondition\t= ${name}_Condition;`,
+    `\tinformation\t= ${name}_Info;`,
+    '\tpermanent\t= FALSE;',
+    `\tdescription\t= ${description};`,
+    '};',
+    '',
+    `FUNC INT ${name}_Condition()`,
+    '{',
+    ...conditionBody,
+    '};',
+    '',
+    `FUNC VOID ${name}_Info()`,
+    '{',
+    ...infoBody,
+    '};',
+    ''
+  ].join('\n');
+}
+
+function elseIfChain(branches, { terminate = true } = {}) {
+  const lines = [];
+  for (let i = 0; i < branches; i += 1) {
+    const keyword = i === 0 ? '\tif' : '\telse if';
+    lines.push(
+      `${keyword} (Stress_Counter == ${i})`,
+      '\t{',
+      `\t\t// branch ${i}`,
+      terminate ? `\t\tAI_Output (self, other, "DIA_Stress_8_${i}");` : `\t\tStress_Counter = ${i + 1}`,
+      '\t}'
+    );
+  }
+  lines.push('\telse', '\t{', '\t\tStress_Counter = 0;', '\t};');
+  return lines;
+}
+
+/**
+ * Generators for pathological inputs, keyed by shape name. Each takes a size
+ * (branches, nesting depth, terms or bytes) and returns the source text; the
+ * tree depth or file size grows linearly with it.
+ */
+const STRESS_SHAPES = {
+  'else-if-chain': {
+    defaultSize: 2000,
+    generate: (size) => dialog('DIA_Stress_ElseIf', elseIfChain(size), elseIfChain(size))
+  },
+  'nested-parentheses': {
+    defaultSize: 2000,
+    generate: (size) => {
+      const condition = `${'('.repeat(size)}Npc_KnowsInfo (other, DIA_Stress_Parens)${')'.repeat(size)}`;
+      return dialog(
+        'DIA_Stress_Parens',
+        [`\tif ${condition}`, '\t{', '\t\treturn TRUE;', '\t};'],
+        [`\tStress_Counter = ${'('.repeat(size)}Stress_Counter + 1${')'.repeat(size)};`]
+      );
+    }
+  },
+  'logical-chain': {
+    defaultSize: 2000,
+    generate: (size) => {
+      const terms = [];
+      for (let i = 0; i < size; i += 1) {
+        terms.push(i % 2 === 0 ? `(Stress_Var_${i} == ${i})` : `Npc_KnowsInfo (other, DIA_Stress_${i})`);
+      }
+      return dialog(
+        'DIA_Stress_Logical',
+        [`\tif ${terms.join('\n\t&& ')}`, '\t{', '\t\treturn TRUE;', '\t};'],
+        ['\tStress_Counter = 1;']
+      );
+    }
+  },
+  'nested-binary': {
+    defaultSize: 2000,
+    generate: (size) => {
+      let expression = 'Stress_Counter';
+      for (let i = 0; i < size; i += 1) {
+        expression = i % 2 === 0 ? `(${expression} + ${i})` : `(${i} * ${expression})`;
+      }
+      return dialog(
+        'DIA_Stress_Binary',
+        [`\tif (${expression} > 0)`, '\t{', '\t\treturn TRUE;', '\t};'],
+        [`\tStress_Counter = ${expression};`, `\tB_GiveInvItems (other, self, ItMi_Gold, ${expression});`]
+      );
+    }
+  },
+  'huge-string': {
+    defaultSize: 1 << 20,
+    generate: (size) => {
+      const filler = 'Khorinis \\"Hafen\\" '.repeat(Math.ceil(size / 20)).slice(0, size).replace(/\\$/, '');
+      return dialog(
+        'DIA_Stress_String',
+        ['\treturn TRUE;'],
+        [
+          `\tAI_Output (self, other, "DIA_Stress_String_8_00"); //${'x'.repeat(size)}`,
+          `\tB_LogEntry (TOPIC_Stress, "${filler}");`
+        ],
+        `"${filler}"`
+      );
+    }
+  },
+  'broken-else-if-chain': {
+    defaultSize: 2000,
+    generate: (size) => dialog('DIA_Stress_Broken', ['\treturn TRUE;'], elseIfChain(size, { terminate: false }))
+  }
+};
+
+/**
+ * Write one file per stress shape
+ * @param {{out: string, scale?: number, shapes?: string[]}} options
+ * @returns {{files: number, bytes: number}} What was written
+ */
+function writeStressCorpus(options) {
+  const scale = options.scale || 1;
+  const shapes = options.shapes || Object.keys(STRESS_SHAPES);
+  fs.mkdirSync(options.out, { recursive: true });
+
+  let bytes = 0;
+  for (const shape of shapes) {
+    const generator = STRESS_SHAPES[shape];
+    if (!generator) {
+      throw new Error(`Unknown stress shape: ${shape}`);
+    }
+    const text = generator.generate(Math.max(1, Math.round(generator.defaultSize * scale)));
+    fs.writeFileSync(path.join(options.out, `STRESS_${shape.replace(/-/g, '_')}.d`), text);
+    bytes += Buffer.byteLength(text);
+  }
+  return { files: shapes.length, bytes };
+}
+
+if (require.main === module) {
+  const args = parseArgs(process.argv.slice(2));
+  if (args.help || !args.out) {
+    printHelp();
+    process.exit(args.help ? 0 : 2);
+  }
+  const written = writeStressCorpus(args);
+  console.log(`Wrote ${written.files} files (${(written.bytes / 1024 / 1024).toFixed(1)} MB) to ${path.resolve(args.out)}`);
+}
+
+module.exports = { STRESS_SHAPES, writeStressCorpus };
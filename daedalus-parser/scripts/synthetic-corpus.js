@@ -0,0 +1,199 @@
+#!/usr/bin/env node
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+
+function parseArgs(argv) {
+  const args = {};
+  for (let i = 0; i < argv.length; i += 1) {
+    const token = argv[i];
+    if (token === '--out') {
+      args.out = argv[i + 1];
+      i += 1;
+    } else if (token === '--files') {
+      args.files = Number(argv[i + 1]);
+      i += 1;
+    } else if (token === '--dialogs') {
+      args.dialogs = Number(argv[i + 1]);
+      i += 1;
+    } else if (token === '--seed') {
+      args.seed = Number(argv[i + 1]);
+      i += 1;
+    } else if (token === '--help' || token === '-h') {
+      args.help = true;
+    }
+  }
+  return args;
+}
+
+function printHelp() {
+  const text = [
+    'Usage: node scripts/synthetic-corpus.js --out <dir> [options]',
+    '',
+    'Options:',
+    '  --out <dir>       Directory to write the .d files to (created if missing)',
+    '  --files <n>       Number of files (default: 200)',
+    '  --dialogs <n>     Dialogs per file (default: 40)',
+    '  --seed <n>        Generator seed (default: 1); equal seeds give equal corpora',
+    '  --help, -h        Show this help',
+    '',
+    'Writes dialog files shaped like the original scripts: C_INFO instances with',
+    'condition and information functions, AI_Output lines, choices, log entries,',
+    'nested conditions and quest variables. Used to train and benchmark the',
+    'native parser (make pgo).'
+  ];
+  console.log(text.join('\n'));
+}
+
+/** Small deterministic PRNG (mulberry32) so corpora are reproducible */
+function createRandom(seed) {
+  let state = seed >>> 0;
+  const next = () => {
+    state = (state + 0x6D2B79F5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+  return {
+    int: (max) => Math.floor(next() * max),
+    pick: (items) => items[Math.floor(next() * items.length)]
+  };
+}
+
+const WORDS = ['Gold', 'Schwert', 'Paladin', 'Hafen', 'Kloster', 'Erz', 'Bauer', 'Miliz', 'Drache', 'Taverne',
+  'Auftrag', 'Ruestung', 'Trank', 'Bogen', 'Lager', 'Onar', 'Lares', 'Vatras', 'Khorinis', 'Stadt'];
+const NPC_KINDS = ['VLK', 'MIL', 'SLD', 'KDF', 'BAU', 'PAL', 'NOV'];
+
+function sentence(random, words) {
+  const parts = [];
+  for (let i = 0; i < words; i += 1) {
+    parts.push(random.pick(WORDS));
+  }
+  return parts.join(' ');
+}
+
+function generateFile(random, fileIndex, dialogCount) {
+  const npc = `${random.pick(NPC_KINDS)}_${1000 + fileIndex}_${random.pick(WORDS)}`;
+  const topic = `TOPIC_${npc}`;
+  const mission = `MIS_${npc}`;
+  const lines = [
+    '// ************************************************************',
+    `// \t\t\t${npc}`,
+    '// ************************************************************',
+    '',
+    `const string ${topic} = "${sentence(random, 3)}";`,
+    `var int ${mission};`,
+    `var int ${npc}_Counter;`,
+    ''
+  ];
+
+  for (let d = 0; d < dialogCount; d += 1) {
+    const name = `DIA_${npc}_${d}`;
+    const choices = random.int(3);
+    lines.push(
+      `INSTANCE ${name} (C_INFO)`,
+      '{',
+      `\tnpc\t\t\t= ${npc};`,
+      `\tnr\t\t\t= ${d + 1};`,
+      `\tcondition\t= ${name}_Condition;`,
+      `\tinformation\t= ${name}_Info;`,
+      `\tpermanent\t= ${random.int(4) === 0 ? 'TRUE' : 'FALSE'};`,
+      `\tdescription\t= "${sentence(random, 4)}";`,
+      '};',
+      '',
+      `FUNC INT ${name}_Condition()`,
+      '{'
+    );
+    if (d > 0) {
+      lines.push(
+        `\tif (Npc_KnowsInfo (other, DIA_${npc}_${random.int(d)}))`,
+        `\t&& (${mission} == LOG_RUNNING)`,
+        '\t{',
+        '\t\treturn TRUE;',
+        '\t};'
+      );
+    } else {
+      lines.push('\treturn TRUE;');
+    }
+    lines.push('};', '', `FUNC VOID ${name}_Info()`, '{');
+
+    const outputs = 2 + random.int(6);
+    for (let o = 0; o < outputs; o += 1) {
+      const speaker = o % 2 === 0 ? 'other, self' : 'self, other';
+      const voice = o % 2 === 0 ? 15 : 8;
+      lines.push(`\tAI_Output (${speaker}, "${name}_${voice}_${String(o).padStart(2, '0')}"); //${sentence(random, 8)}`);
+    }
+    if (random.int(3) === 0) {
+      lines.push(
+        `\tif (Npc_HasItems (other, ItMi_Gold) >= ${10 * (1 + random.int(50))})`,
+        '\t{',
+        `\t\tB_GiveInvItems (other, self, ItMi_Gold, ${10 * (1 + random.int(50))});`,
+        `\t\t${npc}_Counter = ${npc}_Counter + 1;`,
+        '\t}',
+        '\telse',
+        '\t{',
+        `\t\tAI_Output (self, other, "${name}_8_90"); //${sentence(random, 5)}`,
+        '\t};'
+      );
+    }
+    if (d === 0) {
+      lines.push(
+        `\tLog_CreateTopic (${topic}, LOG_MISSION);`,
+        `\tLog_SetTopicStatus (${topic}, LOG_RUNNING);`,
+        `\t${mission} = LOG_RUNNING;`
+      );
+    }
+    lines.push(`\tB_LogEntry (${topic}, "${sentence(random, 10)}");`);
+    for (let c = 0; c < choices; c += 1) {
+      lines.push(`\tInfo_AddChoice (${name}, "${sentence(random, 3)}", ${name}_Choice_${c});`);
+    }
+    lines.push('};', '');
+
+    for (let c = 0; c < choices; c += 1) {
+      lines.push(
+        `FUNC VOID ${name}_Choice_${c}()`,
+        '{',
+        `\tAI_Output (other, self, "${name}_Choice_${c}_15_00"); //${sentence(random, 6)}`,
+        `\tInfo_ClearChoices (${name});`,
+        '};',
+        ''
+      );
+    }
+  }
+
+  return { name: `DIA_${npc}.d`, text: lines.join('\r\n') };
+}
+
+/**
+ * Write a synthetic corpus
+ * @param {{out: string, files?: number, dialogs?: number, seed?: number}} options
+ * @returns {{files: number, bytes: number}} What was written
+ */
+function writeSyntheticCorpus(options) {
+  const random = createRandom(options.seed || 1);
+  const fileCount = options.files || 200;
+  const dialogCount = options.dialogs || 40;
+  fs.mkdirSync(options.out, { recursive: true });
+
+  let bytes = 0;
+  for (let i = 0; i < fileCount; i += 1) {
+    const file = generateFile(random, i, dialogCount);
+    fs.writeFileSync(path.join(options.out, file.name), file.text);
+    bytes += Buffer.byteLength(file.text);
+  }
+  return { files: fileCount, bytes };
+}
+
+if (require.main === module) {
+  const args = parseArgs(process.argv.slice(2));
+  if (args.help || !args.out) {
+    printHelp();
+    process.exit(args.help ? 0 : 2);
+  }
+  const written = writeSyntheticCorpus(args);
+  console.log(`Wrote ${written.files} files (${(written.bytes / 1024 / 1024).toFixed(1)} MB) to ${path.resolve(args.out)}`);
+}
+
+module.exports = { writeSyntheticCorpus };
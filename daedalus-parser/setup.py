@@ -1,5 +1,9 @@
+from os import environ
 from os.path import isdir, join
 from platform import system
+from shutil import which
+from subprocess import CalledProcessError, check_output
+from sys import stderr
 
 from setuptools import Extension, find_packages, setup
 from setuptools.command.build import build
@@ -22,6 +26,79 @@ class BdistWheel(bdist_wheel):
         return python, abi, platform
 
 
+def tree_sitter_runtime():
+    """Build settings for the tree-sitter runtime, or None when it is not available.
+
+    TREE_SITTER_LIB_DIR may point at the lib/ directory of a tree-sitter
+    checkout to compile the runtime into the extension; otherwise an installed
+    runtime is looked up with pkg-config.
+    """
+    lib_dir = environ.get("TREE_SITTER_LIB_DIR")
+    if lib_dir:
+        return {
+            "sources": [join(lib_dir, "src", "lib.c")],
+            "include_dirs": [join(lib_dir, "include"), join(lib_dir, "src")],
+            "define_macros": [("_POSIX_C_SOURCE", "200112L"), ("_DEFAULT_SOURCE", None)],
+        }
+    if not which("pkg-config"):
+        return None
+    try:
+        cflags = check_output(["pkg-config", "--cflags-only-I", "tree-sitter"], text=True).split()
+        libs = check_output(["pkg-config", "--libs", "tree-sitter"], text=True).split()
+    except CalledProcessError:
+        return None
+    return {
+        "include_dirs": [flag[2:] for flag in cflags],
+        "library_dirs": [flag[2:] for flag in libs if flag.startswith("-L")],
+        "libraries": [flag[2:] for flag in libs if flag.startswith("-l")],
+    }
+
+
+def index_extensions():
+    """The _index extension behind parse_many(), which parses in C and so needs the runtime.
+
+    Without a runtime the package still builds, but parse_many() raises
+    RuntimeError. That is reported on stderr, and is an error when
+    DAEDALUS_REQUIRE_INDEX is set (e.g. for release wheels).
+    """
+    runtime = tree_sitter_runtime()
+    if not runtime:
+        message = (
+            "tree-sitter runtime not found: set TREE_SITTER_LIB_DIR to the lib/ directory of a "
+            "tree-sitter checkout, or install libtree-sitter for pkg-config. Building without "
+            "the _index extension; parse_many() will raise RuntimeError."
+        )
+        if environ.get("DAEDALUS_REQUIRE_INDEX"):
+            raise SystemExit(f"error: {message}")
+        print(f"\n{'*' * 72}\nWARNING: {message}\n{'*' * 72}\n", file=stderr)
+        return []
+    return [
+        Extension(
+            name="_index",
+            sources=[
+                "bindings/python/tree_sitter_daedalus/index.c",
+                "src/parser.c",
+                *runtime.get("sources", []),
+            ],
+            extra_compile_args=[
+                "-std=c11",
+            ] if system() != "Windows" else [
+                "/std:c11",
+                "/utf-8",
+            ],
+            define_macros=[
+                ("Py_LIMITED_API", "0x03080000"),
+                ("PY_SSIZE_T_CLEAN", None),
+                *runtime.get("define_macros", []),
+            ],
+            include_dirs=["src", *runtime["include_dirs"]],
+            library_dirs=runtime.get("library_dirs", []),
+            libraries=runtime.get("libraries", []) + ([] if system() == "Windows" else ["pthread"]),
+            py_limited_api=True,
+        )
+    ]
+
+
 setup(
     packages=find_packages("bindings/python"),
     package_dir={"": "bindings/python"},
@@ -51,7 +128,7 @@ setup(
             include_dirs=["src"],
             py_limited_api=True,
         )
-    ],
+    ] + index_extensions(),
     cmdclass={
         "build": Build,
         "bdist_wheel": BdistWheel
@@ -7,8 +7,11 @@ import {
   DialogFunction,
   DialogAction,
   DialogCondition,
-  CodeGeneratable
+  CodeGeneratable,
+  getDeclarationIdentity,
+  getDeclarationVersion
 } from '../semantic/semantic-model';
+import { traceSpan } from '../core/tracing';
 
 export interface CodeGeneratorOptions {
   indentSize?: number;
@@ -17,12 +20,88 @@ export interface CodeGeneratorOptions {
   sectionHeaders?: boolean;
   uppercaseKeywords?: boolean;
   preserveSourceStyle?: boolean;
+  /**
+   * Optional fragment cache shared between generator instances.
+   * Generated dialog/function code is memoized per declaration identity, version and options.
+   */
+  fragmentCache?: GeneratedCodeCache;
+}
+
+type ResolvedCodeGeneratorOptions = Required<Omit<CodeGeneratorOptions, 'fragmentCache'>>;
+
+interface CachedFragment {
+  version: number;
+  code: string;
+}
+
+/**
+ * Memoizes generated code fragments per declaration.
+ *
+ * Fragments are keyed by declaration identity (see `getDeclarationIdentity`:
+ * the plain object a declaration was deserialized from, else the declaration
+ * itself) and the generator options, and stamped with the declaration's
+ * version. Immutable models (e.g. Immer drafts) get new objects for changed
+ * declarations; code that edits declarations in place calls
+ * `markDeclarationChanged`. Looking up a fragment never walks the declaration,
+ * and fragments go away with their declarations.
+ */
+export class GeneratedCodeCache {
+  private fragments = new WeakMap<object, Map<string, CachedFragment>>();
+  private hits = 0;
+  private misses = 0;
+  private stored = 0;
+
+  /**
+   * Return the cached fragment for `declaration` under `variant` (the options
+   * key), rendering and storing it when missing or stale
+   */
+  getOrRender(declaration: object, variant: string, render: () => string): string {
+    const identity = getDeclarationIdentity(declaration);
+    const version = getDeclarationVersion(identity);
+    let variants = this.fragments.get(identity);
+    const cached = variants?.get(variant);
+    if (cached && cached.version === version) {
+      this.hits++;
+      return cached.code;
+    }
+
+    this.misses++;
+    const code = render();
+    if (!variants) {
+      variants = new Map();
+      this.fragments.set(identity, variants);
+    }
+    if (!cached) {
+      this.stored++;
+    }
+    variants.set(variant, { version, code });
+    return code;
+  }
+
+  clear(): void {
+    this.fragments = new WeakMap();
+    this.hits = 0;
+    this.misses = 0;
+    this.stored = 0;
+  }
+
+  /** Fragments stored since the last clear(), including those of since-collected declarations */
+  get size(): number {
+    return this.stored;
+  }
+
+  getStats(): { hits: number; misses: number; size: number } {
+    return { hits: this.hits, misses: this.misses, size: this.stored };
+  }
 }
 
 export class SemanticCodeGenerator {
-  private options: Required<CodeGeneratorOptions>;
+  private options: ResolvedCodeGeneratorOptions;
+  private fragmentCache: GeneratedCodeCache | null;
+  private optionsKey: string;
 
   constructor(options: CodeGeneratorOptions = {}) {
+    const { fragmentCache, ...generatorOptions } = options;
     this.options = {
       indentSize: 1,
       indentChar: '\t',
@@ -30,42 +109,60 @@ export class SemanticCodeGenerator {
       sectionHeaders: true,
       uppercaseKeywords: false,
       preserveSourceStyle: true,
-      ...options
+      ...generatorOptions
     };
+    this.fragmentCache = fragmentCache ?? null;
+    this.optionsKey = JSON.stringify(this.options);
   }
 
   /**
    * Generate complete Daedalus source file from semantic model
    */
   generateSemanticModel(model: SemanticModel): string {
-    if (model.declarationOrder && model.declarationOrder.length > 0) {
-      return this.generateByDeclarationOrder(model);
+    return traceSpan('codegen.generateSemanticModel', () => Array.from(this.generateSections(model)).join('\n'));
+  }
+
+  /**
+   * Generate the source file as a sequence of fragments.
+   * Concatenating the yielded chunks produces exactly `generateSemanticModel(model)`,
+   * but callers can encode and write each chunk as it is produced instead of
+   * holding the whole file in memory.
+   */
+  *generateSemanticModelChunks(model: SemanticModel): Generator<string, void, undefined> {
+    let first = true;
+    for (const section of this.generateSections(model)) {
+      if (!first) {
+        yield '\n';
+      }
+      first = false;
+      yield section;
     }
+  }
 
-    const sections: string[] = [];
+  private *generateSections(model: SemanticModel): Generator<string, void, undefined> {
+    if (model.declarationOrder && model.declarationOrder.length > 0) {
+      yield* this.generateByDeclarationOrder(model);
+      return;
+    }
 
     // Group dialogs and their associated functions together
     const processedFunctions = new Set<string>();
 
     for (const dialogName in model.dialogs) {
       const dialog = model.dialogs[dialogName];
-      const dialogSection = this.generateDialogSection(dialog, model, processedFunctions);
-      sections.push(dialogSection);
+      yield this.generateDialogSection(dialog, model, processedFunctions);
     }
 
     // Generate any remaining functions not associated with dialogs
     for (const funcName in model.functions) {
       if (!processedFunctions.has(funcName)) {
         const func = model.functions[funcName];
-        sections.push(this.generateFunction(func));
+        yield this.generateFunction(func);
       }
     }
-
-    return sections.join('\n');
   }
 
-  private generateByDeclarationOrder(model: SemanticModel): string {
-    const sections: string[] = [];
+  private *generateByDeclarationOrder(model: SemanticModel): Generator<string, void, undefined> {
     const emittedDialogs = new Set<string>();
     const emittedFunctions = new Set<string>();
 
@@ -75,11 +172,11 @@ export class SemanticCodeGenerator {
         if (dialog && !emittedDialogs.has(dialog.name)) {
           const leading = this.renderLeadingComments(dialog.leadingComments);
           if (leading) {
-            sections.push(leading);
+            yield leading;
           } else if (this.options.sectionHeaders && this.options.includeComments) {
-            sections.push(this.generateSectionHeader(this.extractDisplayName(dialog.name)));
+            yield this.generateSectionHeader(this.extractDisplayName(dialog.name));
           }
-          sections.push(this.generateDialog(dialog));
+          yield this.generateDialog(dialog);
           emittedDialogs.add(dialog.name);
         }
       } else if (declaration.type === 'function') {
@@ -87,9 +184,9 @@ export class SemanticCodeGenerator {
         if (func && !emittedFunctions.has(func.name)) {
           const leading = this.renderLeadingComments(func.leadingComments);
           if (leading) {
-            sections.push(leading);
+            yield leading;
           }
-          sections.push(this.generateFunction(func));
+          yield this.generateFunction(func);
           emittedFunctions.add(func.name);
         }
       }
@@ -101,11 +198,11 @@ export class SemanticCodeGenerator {
         const dialog = model.dialogs[dialogName];
         const leading = this.renderLeadingComments(dialog.leadingComments);
         if (leading) {
-          sections.push(leading);
+          yield leading;
         } else if (this.options.sectionHeaders && this.options.includeComments) {
-          sections.push(this.generateSectionHeader(this.extractDisplayName(dialog.name)));
+          yield this.generateSectionHeader(this.extractDisplayName(dialog.name));
         }
-        sections.push(this.generateDialog(dialog));
+        yield this.generateDialog(dialog);
       }
     }
     for (const funcName in model.functions) {
@@ -113,13 +210,11 @@ export class SemanticCodeGenerator {
         const func = model.functions[funcName];
         const leading = this.renderLeadingComments(func.leadingComments);
         if (leading) {
-          sections.push(leading);
+          yield leading;
         }
-        sections.push(this.generateFunction(func));
+        yield this.generateFunction(func);
       }
     }
-
-    return sections.join('\n');
   }
 
   /**
@@ -200,6 +295,13 @@ export class SemanticCodeGenerator {
    * Generate a dialog instance declaration
    */
   generateDialog(dialog: Dialog): string {
+    if (!this.fragmentCache) {
+      return this.renderDialog(dialog);
+    }
+    return this.fragmentCache.getOrRender(dialog, this.optionsKey, () => this.renderDialog(dialog));
+  }
+
+  private renderDialog(dialog: Dialog): string {
     const indent = this.indent();
     const instanceKeyword = this.resolveKeyword('instance', dialog.keyword);
     const spaceBeforeParen = this.options.preserveSourceStyle && dialog.spaceBeforeParen ? ' ' : '';
@@ -284,6 +386,13 @@ export class SemanticCodeGenerator {
    * Generate a function declaration
    */
   generateFunction(func: DialogFunction, preservedBody?: string): string {
+    if (!this.fragmentCache || preservedBody) {
+      return this.renderFunction(func, preservedBody);
+    }
+    return this.fragmentCache.getOrRender(func, this.optionsKey, () => this.renderFunction(func));
+  }
+
+  private renderFunction(func: DialogFunction, preservedBody?: string): string {
     const indent = this.indent();
     const funcKeyword = this.resolveKeyword('func', func.keyword);
     const returnType = this.normalizeReturnType(func.returnType, func.returnType);
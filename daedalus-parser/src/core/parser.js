@@ -1,5 +1,54 @@
 const Parser = require('tree-sitter');
 const Daedalus = require('../../bindings/node');
+const { traceSpan } = require('./tracing');
+
+// How often a cancellable parse yields back to check `shouldCancel`
+const CANCELLATION_SLICE_MICROS = 20_000;
+
+// Idle parsers kept for static parses. Module state is per thread, so every
+// worker_thread gets its own pool and parsers are never shared across threads.
+const MAX_POOLED_PARSERS = 4;
+const parserPool = [];
+
+// Syntax trees handed out on this thread that were neither disposed nor
+// garbage collected. Node tree-sitter has no Tree.delete(), so a tree's native
+// memory is freed only when V8 collects it, and V8 does not see that memory
+// when deciding to collect. Past the threshold a warning points at the leak.
+const LIVE_TREE_WARNING_THRESHOLD = 256;
+let liveTrees = 0;
+let liveTreeWarningIssued = false;
+const treeFinalizer = new FinalizationRegistry(() => {
+  liveTrees--;
+});
+
+/**
+ * Count a tree handed out by parse() until it is disposed or collected
+ * @param {Object} tree - Tree-sitter tree
+ */
+function trackTree(tree) {
+  liveTrees++;
+  treeFinalizer.register(tree, undefined, tree);
+  if (liveTrees > LIVE_TREE_WARNING_THRESHOLD && !liveTreeWarningIssued) {
+    liveTreeWarningIssued = true;
+    process.emitWarning(
+      `${liveTrees} Daedalus syntax trees are alive on this thread; release parse results with ` +
+        'DaedalusParser.disposeResult() or parse through withParseResult()',
+      { code: 'DAEDALUS_LIVE_TREES' }
+    );
+  }
+}
+
+/**
+ * Create the error thrown when a bounded parse is stopped
+ * @param {'PARSE_CANCELLED'|'PARSE_TIMEOUT'} code - Why parsing stopped
+ * @param {string} message - Error message
+ * @returns {Error} Error carrying `code`
+ */
+function createParseAbortError(code, message) {
+  const error = new Error(message);
+  error.code = code;
+  return error;
+}
 
 class DaedalusParser {
   constructor() {
@@ -11,17 +60,35 @@ class DaedalusParser {
    * Parse Daedalus source code and return syntax tree
    * @param {string} sourceCode - The Daedalus source code to parse
    * @param {Object} options - Parsing options
+   * @param {number} options.timeoutMicros - Abort with code PARSE_TIMEOUT after this long (0: unbounded)
+   * @param {Function} options.shouldCancel - Polled while parsing; returning true aborts with code PARSE_CANCELLED
+   * @param {number} options.sliceMicros - How long to parse between two shouldCancel checks (default: 20ms)
+   * @param {Object} options.oldTree - Previous tree of this source, already updated with tree.edit(),
+   *   to reparse incrementally
    * @returns {Object} Parse tree with metadata
    */
   parse(sourceCode, options = {}) {
     const startTime = process.hrtime.bigint();
+    const {
+      timeoutMicros = 0,
+      shouldCancel,
+      sliceMicros = CANCELLATION_SLICE_MICROS,
+      oldTree,
+      ...treeSitterOptions
+    } = options;
 
     const parseOptions = {
-      bufferSize: options.bufferSize || (sourceCode.length + 1),
-      ...options
+      bufferSize: treeSitterOptions.bufferSize || (sourceCode.length + 1),
+      ...treeSitterOptions
     };
 
-    const tree = this.parser.parse(sourceCode, undefined, parseOptions);
+    const isBounded = (timeoutMicros > 0 || typeof shouldCancel === 'function') &&
+      typeof this.parser.setTimeoutMicros === 'function';
+    const tree = traceSpan('parser.parse', () => (isBounded
+      ? this.parseBounded(sourceCode, parseOptions, { startTime, timeoutMicros, shouldCancel, sliceMicros, oldTree })
+      : this.parser.parse(sourceCode, oldTree, parseOptions)), { sourceLength: sourceCode.length });
+
+    trackTree(tree);
 
     const endTime = process.hrtime.bigint();
     const parseTimeMs = Number(endTime - startTime) / 1_000_000;
@@ -38,12 +105,53 @@ class DaedalusParser {
 
     if (result.hasErrors) {
       result.errors = [];
-      this.collectErrors(tree.rootNode, sourceCode, result.errors);
+      traceSpan('parser.collectErrors', () => this.collectErrors(tree.rootNode, sourceCode, result.errors));
     }
 
     return result;
   }
 
+  /**
+   * Parse in time slices using tree-sitter's timeout. A timed-out parse keeps
+   * its state and resumes on the next call with the same input, so slicing
+   * only adds the cost of the checks in between.
+   * @private
+   */
+  parseBounded(sourceCode, parseOptions, { startTime, timeoutMicros, shouldCancel, sliceMicros, oldTree }) {
+    const canCancel = typeof shouldCancel === 'function';
+    try {
+      while (true) {
+        if (canCancel && shouldCancel()) {
+          throw createParseAbortError('PARSE_CANCELLED', 'Parse cancelled');
+        }
+
+        let slice = canCancel ? sliceMicros : timeoutMicros;
+        if (timeoutMicros > 0) {
+          const elapsedMicros = Number(process.hrtime.bigint() - startTime) / 1000;
+          const remaining = timeoutMicros - elapsedMicros;
+          if (remaining <= 0) {
+            throw createParseAbortError('PARSE_TIMEOUT', `Parse exceeded ${Math.round(timeoutMicros / 1000)}ms`);
+          }
+          slice = Math.min(slice, remaining);
+        }
+
+        this.parser.setTimeoutMicros(Math.max(1, Math.floor(slice)));
+        const tree = this.parser.parse(sourceCode, oldTree, parseOptions);
+        if (tree) {
+          return tree;
+        }
+      }
+    } catch (error) {
+      // Discard the half-finished parse so the next one starts fresh
+      if (typeof this.parser.reset === 'function') {
+        this.parser.reset();
+      }
+      throw error;
+    } finally {
+      this.parser.setTimeoutMicros(0);
+    }
+  }
+
   /**
    * Parse file from filesystem
    * @param {string} filePath - Path to Daedalus file
@@ -54,46 +162,49 @@ class DaedalusParser {
    * @returns {Object} Parse result
    */
   parseFile(filePath, options = {}) {
+    const { encoding, detectEncoding, ...parseOptions } = options;
+    const source = this.readSource(filePath, { encoding, detectEncoding });
+
+    const result = this.parse(source.sourceCode, parseOptions);
+    result.filePath = filePath;
+    result.encoding = source.encoding;
+    result.encodingConfidence = source.confidence;
+
+    return result;
+  }
+
+  /**
+   * Read and decode a Daedalus file
+   * @param {string} filePath - Path to Daedalus file
+   * @param {Object} options - Decoding options, as for parseFile()
+   * @returns {{sourceCode: string, encoding: string, confidence: number}} Decoded text
+   */
+  readSource(filePath, options = {}) {
     const fs = require('fs');
     const iconv = require('iconv-lite');
     const jschardet = require('jschardet');
-    const {
-      encoding: explicitEncoding,
-      detectEncoding = true,
-      ...parseOptions
-    } = options;
+    const { encoding: explicitEncoding, detectEncoding = true } = options;
 
     // Read file as buffer first
     const buffer = fs.readFileSync(filePath);
 
-    let sourceCode;
     let detectedEncoding = null;
     let confidence = 100;
 
     if (explicitEncoding) {
       // Use specified encoding
-      sourceCode = iconv.decode(buffer, explicitEncoding);
       detectedEncoding = explicitEncoding;
     } else if (detectEncoding) {
       // Auto-detect encoding using jschardet
       const detection = jschardet.detect(buffer);
       detectedEncoding = detection.encoding || 'utf-8'; // Default to UTF-8 if detection fails
       confidence = detection.confidence ? detection.confidence * 100 : 100;
-
-      // Decode with detected encoding using iconv-lite
-      sourceCode = iconv.decode(buffer, detectedEncoding);
     } else {
       // Use UTF-8 fallback when detection is explicitly disabled.
       detectedEncoding = 'utf-8';
-      sourceCode = iconv.decode(buffer, detectedEncoding);
     }
 
-    const result = this.parse(sourceCode, parseOptions);
-    result.filePath = filePath;
-    result.encoding = detectedEncoding;
-    result.encodingConfidence = confidence;
-
-    return result;
+    return { sourceCode: iconv.decode(buffer, detectedEncoding), encoding: detectedEncoding, confidence };
   }
 
   /**
@@ -103,10 +214,13 @@ class DaedalusParser {
    */
   extractComments(parseResult) {
     const comments = [];
-    const { rootNode } = parseResult;
+    const cursor = parseResult.rootNode.walk();
 
-    function findComments(node) {
-      if (node.type === 'comment') {
+    // Pre-order cursor walk: no recursion, so deeply nested code cannot overflow the stack
+    let descending = true;
+    while (true) {
+      if (descending && cursor.nodeType === 'comment') {
+        const node = cursor.currentNode;
         const text = node.text || '';
         comments.push({
           type: text.startsWith('//') ? 'line' : 'block',
@@ -120,12 +234,19 @@ class DaedalusParser {
         });
       }
 
-      for (let i = 0; i < node.childCount; i++) {
-        findComments(node.child(i));
+      if (descending && cursor.gotoFirstChild()) {
+        continue;
+      }
+      if (cursor.gotoNextSibling()) {
+        descending = true;
+        continue;
+      }
+      if (!cursor.gotoParent()) {
+        break;
       }
+      descending = false;
     }
 
-    findComments(rootNode);
     return comments;
   }
 
@@ -230,26 +351,46 @@ class DaedalusParser {
    * @private
    */
   collectErrors(node, sourceCode, errors) {
-    if (node.type === 'ERROR') {
-      errors.push({
-        type: 'syntax_error',
-        message: `Syntax error at line ${node.startPosition.row + 1}, column ${node.startPosition.column + 1}`,
-        position: node.startPosition,
-        text: sourceCode.slice(node.startIndex, node.endIndex)
-      });
-    }
-
-    if (node.isMissing) {
-      errors.push({
-        type: 'missing_token',
-        message: `Missing ${node.type} at line ${node.startPosition.row + 1}, column ${node.startPosition.column + 1}`,
-        position: node.startPosition,
-        text: ''
-      });
-    }
+    const cursor = node.walk();
+
+    // Pre-order cursor walk that skips error-free subtrees (hasError also covers missing
+    // nodes); iterative so long else-if chains and nested expressions cannot overflow the stack
+    let depth = 0;
+    while (true) {
+      const current = cursor.currentNode;
+      if (current.hasError) {
+        const { row, column } = current.startPosition;
+        if (current.type === 'ERROR') {
+          errors.push({
+            type: 'syntax_error',
+            message: `Syntax error at line ${row + 1}, column ${column + 1}`,
+            position: current.startPosition,
+            text: sourceCode.slice(current.startIndex, current.endIndex)
+          });
+        }
+
+        if (current.isMissing) {
+          errors.push({
+            type: 'missing_token',
+            message: `Missing ${current.type} at line ${row + 1}, column ${column + 1}`,
+            position: current.startPosition,
+            text: ''
+          });
+        }
+
+        if (cursor.gotoFirstChild()) {
+          depth += 1;
+          continue;
+        }
+      }
 
-    for (let i = 0; i < node.childCount; i++) {
-      this.collectErrors(node.child(i), sourceCode, errors);
+      while (depth > 0 && !cursor.gotoNextSibling()) {
+        cursor.gotoParent();
+        depth -= 1;
+      }
+      if (depth === 0) {
+        return;
+      }
     }
   }
 
@@ -261,7 +402,95 @@ class DaedalusParser {
    * @returns {Object} Parse result
    */
   static parseSource(sourceCode, options = {}) {
-    return DaedalusParser.create().parse(sourceCode, options);
+    return DaedalusParser.withParser((parser) => parser.parse(sourceCode, options));
+  }
+
+  /**
+   * Parse source, hand the result to `callback` and dispose its tree afterwards.
+   * Batch callers use this so at most one tree per call stays alive instead of
+   * every tree waiting for the garbage collector.
+   * @param {string} sourceCode - Daedalus source code to parse
+   * @param {Function} callback - Receives the parse result; must not keep the tree or its nodes
+   * @param {Object} options - Parsing options
+   * @returns {*} Whatever `callback` returns
+   */
+  static withParseResult(sourceCode, callback, options = {}) {
+    const result = DaedalusParser.parseSource(sourceCode, options);
+    try {
+      return callback(result);
+    } finally {
+      DaedalusParser.disposeResult(result);
+    }
+  }
+
+  /**
+   * Run `callback` with a pooled parser, returning it to the pool afterwards
+   * @param {Function} callback - Receives a DaedalusParser
+   * @returns {*} Whatever `callback` returns
+   */
+  static withParser(callback) {
+    const parser = DaedalusParser.acquire();
+    try {
+      return callback(parser);
+    } finally {
+      DaedalusParser.release(parser);
+    }
+  }
+
+  /**
+   * Take an idle parser from this thread's pool, creating one if it is empty.
+   * Reusing a parser skips language setup and keeps its internal parse stacks allocated.
+   * @returns {DaedalusParser} Parser instance; hand it back with release()
+   */
+  static acquire() {
+    return parserPool.pop() || DaedalusParser.create();
+  }
+
+  /**
+   * Return a parser obtained from acquire(). Parsers beyond the pool bound are dropped.
+   * @param {DaedalusParser} parser - Parser to return
+   */
+  static release(parser) {
+    if (!(parser instanceof DaedalusParser) || parserPool.includes(parser)) {
+      return;
+    }
+    // Clear leftover state from an interrupted parse; the stacks' capacity is kept
+    if (typeof parser.parser.reset === 'function') {
+      parser.parser.reset();
+    }
+    if (parserPool.length < MAX_POOLED_PARSERS) {
+      parserPool.push(parser);
+    }
+  }
+
+  /**
+   * Release the syntax tree held by a parse result. The result's tree and
+   * nodes must not be used afterwards. With node tree-sitter, which has no
+   * Tree.delete(), this drops the result's references and the native memory
+   * is freed once nothing else references the tree and V8 collects it.
+   * @param {Object} result - Result from parse()
+   */
+  static disposeResult(result) {
+    if (!result || !result.tree) {
+      return;
+    }
+    if (treeFinalizer.unregister(result.tree)) {
+      liveTrees--;
+    }
+    if (typeof result.tree.delete === 'function') {
+      result.tree.delete();
+    }
+    result.tree = null;
+    result.rootNode = null;
+  }
+
+  /**
+   * Number of trees parsed on this thread that were neither disposed nor
+   * garbage collected yet
+   * @returns {number} Live tree count
+   */
+  static liveTreeCount() {
+    return liveTrees;
   }
 
   /**
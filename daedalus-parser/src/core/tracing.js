@@ -0,0 +1,256 @@
+/**
+ * Lightweight span tracing that exports Chrome/Perfetto trace JSON
+ *
+ * Disabled by default: every entry point checks a single flag and runs the
+ * wrapped function directly, so instrumented hot paths cost one branch.
+ *
+ * This is the only implementation. It is plain JavaScript so the parser, the
+ * CLI and the LSP server can load it before the TypeScript build has run; the
+ * build compiles it to dist/core/tracing.js (with typings) for the TypeScript
+ * sources. The dialog editor (main process, workers and renderer) loads it as
+ * `daedalus-parser/tracing`. It uses no Node APIs, so it also runs in a browser.
+ *
+ * State lives on `globalThis` under a registered symbol, so every copy of the
+ * module loaded on a thread (src and dist) writes into one buffer. Worker
+ * threads drain their buffer and post the events to whoever writes the trace file.
+ */
+
+/**
+ * @typedef {Object} TraceEvent
+ * @property {string} name
+ * @property {string} [cat]
+ * @property {'X'|'M'|'i'} ph
+ * @property {number} [ts]
+ * @property {number} [dur]
+ * @property {number} pid
+ * @property {number} tid
+ * @property {'t'|'p'|'g'} [s]
+ * @property {Record<string, unknown>} [args]
+ */
+
+/**
+ * @typedef {Object} ChromeTrace
+ * @property {TraceEvent[]} traceEvents
+ * @property {'ms'} displayTimeUnit
+ */
+
+/**
+ * @typedef {Object} TracingOptions
+ * @property {number} [pid] - Process id stamped on events (default: process.pid where available, else 0)
+ * @property {number} [tid] - Thread id stamped on events; workers pass their `worker_threads` threadId (default: 0)
+ * @property {string} [threadName] - Label shown for this thread in the trace viewer
+ */
+
+/** @typedef {Record<string, unknown>} TraceArgs */
+
+/**
+ * @typedef {Object} TracingState
+ * @property {boolean} enabled
+ * @property {number} pid
+ * @property {number} tid
+ * @property {TraceEvent[]} events
+ * @property {number} dropped
+ */
+
+const STATE_KEY = Symbol.for('daedalus.tracing.v1');
+
+// Beyond this, further events are counted but dropped
+const MAX_BUFFERED_EVENTS = 500_000;
+
+const noopEnd = () => undefined;
+
+/** @returns {TracingState} */
+function getState() {
+  const holder = /** @type {Record<symbol, TracingState | undefined>} */ (/** @type {unknown} */ (globalThis));
+  let state = holder[STATE_KEY];
+  if (!state) {
+    state = { enabled: false, pid: 0, tid: 0, events: [], dropped: 0 };
+    holder[STATE_KEY] = state;
+  }
+  return state;
+}
+
+const state = getState();
+
+/** @param {TraceEvent} event */
+function pushEvent(event) {
+  if (state.events.length >= MAX_BUFFERED_EVENTS) {
+    state.dropped += 1;
+    return;
+  }
+  state.events.push(event);
+}
+
+/**
+ * Current time in microseconds since the epoch, comparable across threads and processes
+ * @returns {number}
+ */
+function traceNow() {
+  return (performance.timeOrigin + performance.now()) * 1000;
+}
+
+/**
+ * Start recording spans on this thread. Events recorded in a browser carry
+ * pid 0 until whoever collects them stamps the real process id.
+ * @param {TracingOptions} [options]
+ */
+function enableTracing(options = {}) {
+  const nodeProcess = typeof process !== 'undefined' ? process : undefined;
+  state.enabled = true;
+  state.pid = options.pid ?? nodeProcess?.pid ?? 0;
+  state.tid = options.tid ?? 0;
+  if (options.threadName) {
+    pushEvent({ name: 'thread_name', ph: 'M', pid: state.pid, tid: state.tid, args: { name: options.threadName } });
+  }
+}
+
+/** Stop recording; buffered events stay until drained */
+function disableTracing() {
+  state.enabled = false;
+}
+
+/**
+ * Whether spans are being recorded on this thread
+ * @returns {boolean}
+ */
+function isTracingEnabled() {
+  return state.enabled;
+}
+
+/**
+ * Record a finished span with explicit timestamps
+ * @param {string} name - Span name, e.g. `parser.parse`
+ * @param {number} startMicros - Start time from traceNow()
+ * @param {number} endMicros - End time from traceNow()
+ * @param {TraceArgs} [args] - Extra data shown with the span
+ */
+function recordSpan(name, startMicros, endMicros, args) {
+  if (!state.enabled) {
+    return;
+  }
+  /** @type {TraceEvent} */
+  const event = {
+    name,
+    cat: 'daedalus',
+    ph: 'X',
+    ts: startMicros,
+    dur: Math.max(0, endMicros - startMicros),
+    pid: state.pid,
+    tid: state.tid
+  };
+  if (args) {
+    event.args = args;
+  }
+  pushEvent(event);
+}
+
+/**
+ * Open a span; call the returned function (optionally with more args) to close it
+ * @param {string} name
+ * @param {TraceArgs} [args]
+ * @returns {(endArgs?: TraceArgs) => void}
+ */
+function beginSpan(name, args) {
+  if (!state.enabled) {
+    return noopEnd;
+  }
+  const start = traceNow();
+  return (endArgs) => recordSpan(name, start, traceNow(), endArgs ? { ...args, ...endArgs } : args);
+}
+
+/**
+ * Run synchronous `fn` inside a span and return its result
+ * @template T
+ * @param {string} name
+ * @param {() => T} fn
+ * @param {TraceArgs} [args]
+ * @returns {T}
+ */
+function traceSpan(name, fn, args) {
+  if (!state.enabled) {
+    return fn();
+  }
+  const start = traceNow();
+  try {
+    return fn();
+  } finally {
+    recordSpan(name, start, traceNow(), args);
+  }
+}
+
+/**
+ * Await `fn` inside a span and return what it resolves to
+ * @template T
+ * @param {string} name
+ * @param {() => Promise<T>} fn
+ * @param {TraceArgs} [args]
+ * @returns {Promise<T>}
+ */
+async function traceAsync(name, fn, args) {
+  if (!state.enabled) {
+    return fn();
+  }
+  const start = traceNow();
+  try {
+    return await fn();
+  } finally {
+    recordSpan(name, start, traceNow(), args);
+  }
+}
+
+/**
+ * Take all buffered events, e.g. to post them from a worker to its owner
+ * @returns {TraceEvent[]}
+ */
+function drainTraceEvents() {
+  const events = state.events;
+  state.events = [];
+  if (state.dropped > 0) {
+    events.push({
+      name: 'trace.dropped',
+      cat: 'daedalus',
+      ph: 'i',
+      s: 't',
+      ts: traceNow(),
+      pid: state.pid,
+      tid: state.tid,
+      args: { count: state.dropped }
+    });
+    state.dropped = 0;
+  }
+  return events;
+}
+
+/**
+ * Add events recorded elsewhere (workers, other processes) to this thread's buffer
+ * @param {TraceEvent[] | undefined} events
+ */
+function appendTraceEvents(events) {
+  if (!state.enabled || !Array.isArray(events)) {
+    return;
+  }
+  events.forEach(pushEvent);
+}
+
+/**
+ * Wrap events in the JSON object format understood by chrome://tracing and Perfetto
+ * @param {TraceEvent[]} events
+ * @returns {ChromeTrace}
+ */
+function toChromeTrace(events) {
+  return { traceEvents: events, displayTimeUnit: 'ms' };
+}
+
+module.exports = {
+  traceNow,
+  enableTracing,
+  disableTracing,
+  isTracingEnabled,
+  recordSpan,
+  beginSpan,
+  traceSpan,
+  traceAsync,
+  drainTraceEvents,
+  appendTraceEvents,
+  toChromeTrace
+};
@@ -0,0 +1,105 @@
+// JSON-RPC 2.0 over a byte stream with LSP `Content-Length` framing
+
+const HEADER_DELIMITER = Buffer.from('\r\n\r\n');
+const CONTENT_LENGTH = /^content-length:\s*(\d+)\s*$/im;
+
+const ErrorCodes = {
+  ParseError: -32700,
+  InvalidRequest: -32600,
+  MethodNotFound: -32601,
+  InvalidParams: -32602,
+  InternalError: -32603,
+  ServerNotInitialized: -32002,
+  RequestCancelled: -32800
+};
+
+/**
+ * Split a stream of framed messages into parsed JSON payloads
+ */
+class MessageReader {
+  /**
+   * @param {import('stream').Readable} input - Stream to read from
+   * @param {Function} onMessage - Called with each decoded message
+   * @param {Function} onError - Called with framing or JSON errors
+   */
+  constructor(input, onMessage, onError) {
+    this.buffer = Buffer.alloc(0);
+    this.onMessage = onMessage;
+    this.onError = onError;
+    input.on('data', (chunk) => this.push(chunk));
+  }
+
+  push(chunk) {
+    this.buffer = this.buffer.length ? Buffer.concat([this.buffer, chunk]) : chunk;
+
+    while (true) {
+      const headerEnd = this.buffer.indexOf(HEADER_DELIMITER);
+      if (headerEnd === -1) {
+        return;
+      }
+
+      const header = this.buffer.toString('ascii', 0, headerEnd);
+      const match = CONTENT_LENGTH.exec(header);
+      if (!match) {
+        // Unrecoverable: without a length we cannot find the next message
+        this.buffer = Buffer.alloc(0);
+        this.onError(new Error(`Missing Content-Length header: ${header}`));
+        return;
+      }
+
+      const bodyStart = headerEnd + HEADER_DELIMITER.length;
+      const bodyEnd = bodyStart + Number(match[1]);
+      if (this.buffer.length < bodyEnd) {
+        return;
+      }
+
+      const body = this.buffer.toString('utf8', bodyStart, bodyEnd);
+      this.buffer = this.buffer.subarray(bodyEnd);
+
+      let message;
+      try {
+        message = JSON.parse(body);
+      } catch (error) {
+        this.onError(error);
+        continue;
+      }
+      this.onMessage(message);
+    }
+  }
+}
+
+/**
+ * Frame messages onto a writable stream
+ */
+class MessageWriter {
+  /**
+   * @param {import('stream').Writable} output - Stream to write to
+   */
+  constructor(output) {
+    this.output = output;
+  }
+
+  write(message) {
+    const body = Buffer.from(JSON.stringify({ jsonrpc: '2.0', ...message }), 'utf8');
+    this.output.write(`Content-Length: ${body.length}\r\n\r\n`);
+    this.output.write(body);
+  }
+}
+
+/**
+ * Error answered to a request instead of a result
+ */
+class ResponseError extends Error {
+  constructor(code, message, data) {
+    super(message);
+    this.code = code;
+    this.data = data;
+  }
+}
+
+module.exports = {
+  ErrorCodes,
+  MessageReader,
+  MessageWriter,
+  ResponseError
+};
@@ -0,0 +1,325 @@
+// Project-wide symbol index for the language server
+//
+// Each file contributes its top-level declarations and every identifier
+// occurrence, grouped by lower-cased name (Daedalus is case-insensitive).
+// Updating a file replaces only that file's entries, so an edit costs a walk
+// of one syntax tree, and lookups are map reads independent of project size.
+
+const { SemanticModelBuilderVisitor } = require('../../dist/semantic/semantic-visitor-index');
+const { nodeRange } = require('./text-document');
+
+// LSP SymbolKind / CompletionItemKind per indexed symbol kind
+const SYMBOL_KINDS = {
+  dialog: { symbolKind: 24, completionKind: 23 }, // Event
+  function: { symbolKind: 12, completionKind: 3 }, // Function
+  instance: { symbolKind: 19, completionKind: 12 }, // Object / Value
+  topic: { symbolKind: 15, completionKind: 21 }, // String / Constant
+  mission: { symbolKind: 13, completionKind: 6 }, // Variable
+  constant: { symbolKind: 14, completionKind: 21 }, // Constant
+  variable: { symbolKind: 13, completionKind: 6 }, // Variable
+  class: { symbolKind: 23, completionKind: 22 }, // Struct
+  prototype: { symbolKind: 5, completionKind: 7 } // Class
+};
+
+const DECLARATION_TYPES = new Set([
+  'function_declaration',
+  'instance_declaration',
+  'variable_declaration',
+  'class_declaration',
+  'prototype_declaration'
+]);
+
+/**
+ * Classify a top-level declaration using the semantic model built for its file
+ */
+function classifyDeclaration(node, name, model) {
+  switch (node.type) {
+    case 'function_declaration': {
+      const func = model.functions[name];
+      return { kind: 'function', detail: func ? `func ${func.returnType}` : 'func' };
+    }
+    case 'instance_declaration': {
+      const parent = node.childForFieldName('parent');
+      const parentName = parent ? parent.text : '';
+      return model.dialogs[name]
+        ? { kind: 'dialog', detail: `dialog (${parentName})` }
+        : { kind: 'instance', detail: `instance (${parentName})` };
+    }
+    case 'variable_declaration': {
+      const upperName = name.toUpperCase();
+      const constant = model.constants[name];
+      if (constant) {
+        const kind = upperName.startsWith('TOPIC_') ? 'topic' : 'constant';
+        return { kind, detail: `const ${constant.type} = ${JSON.stringify(constant.value)}` };
+      }
+      const variable = model.variables[name];
+      const type = variable ? variable.type : '';
+      return { kind: upperName.startsWith('MIS_') ? 'mission' : 'variable', detail: `var ${type}`.trim() };
+    }
+    case 'class_declaration':
+      return { kind: 'class', detail: 'class' };
+    default: {
+      const parent = node.childForFieldName('parent');
+      return { kind: 'prototype', detail: `prototype (${parent ? parent.text : ''})` };
+    }
+  }
+}
+
+/**
+ * Collect every identifier in the tree by lower-cased name. Member names
+ * (`self.aivar`) are fields, not project symbols, and are skipped.
+ */
+function collectOccurrences(rootNode, sourceCode) {
+  const occurrences = new Map();
+  const cursor = rootNode.walk();
+
+  let descending = true;
+  while (true) {
+    if (descending && cursor.nodeType === 'identifier' && cursor.currentFieldName !== 'member') {
+      const name = sourceCode.slice(cursor.startIndex, cursor.endIndex).toLowerCase();
+      const start = cursor.startPosition;
+      const end = cursor.endPosition;
+      const range = {
+        start: { line: start.row, character: start.column },
+        end: { line: end.row, character: end.column }
+      };
+      const ranges = occurrences.get(name);
+      if (ranges) {
+        ranges.push(range);
+      } else {
+        occurrences.set(name, [range]);
+      }
+    }
+
+    if (descending && cursor.gotoFirstChild()) {
+      continue;
+    }
+    if (cursor.gotoNextSibling()) {
+      descending = true;
+      continue;
+    }
+    if (!cursor.gotoParent()) {
+      break;
+    }
+    descending = false;
+  }
+
+  return occurrences;
+}
+
+/**
+ * Index one parsed file: declarations, identifier occurrences and syntax errors
+ * @param {Object} rootNode - Root of the file's syntax tree
+ * @param {string} sourceCode - Text the tree was parsed from
+ * @returns {{symbols: Array, occurrences: Map, errors: Array}}
+ */
+function indexFile(rootNode, sourceCode) {
+  const visitor = new SemanticModelBuilderVisitor();
+  visitor.checkForSyntaxErrors(rootNode, sourceCode);
+  visitor.pass1_createObjects(rootNode);
+  const model = visitor.semanticModel;
+
+  const symbols = [];
+  for (const node of rootNode.namedChildren) {
+    if (!DECLARATION_TYPES.has(node.type)) {
+      continue;
+    }
+    const nameNode = node.childForFieldName('name');
+    if (!nameNode) {
+      continue;
+    }
+    const name = nameNode.text;
+    symbols.push({
+      name,
+      ...classifyDeclaration(node, name, model),
+      range: nodeRange(node),
+      selectionRange: nodeRange(nameNode)
+    });
+  }
+
+  return {
+    symbols,
+    occurrences: collectOccurrences(rootNode, sourceCode),
+    errors: model.errors || []
+  };
+}
+
+/** @returns {boolean} Whether `key` was new to the map */
+function addToSetMap(map, key, value) {
+  const set = map.get(key);
+  if (set) {
+    set.add(value);
+    return false;
+  }
+  map.set(key, new Set([value]));
+  return true;
+}
+
+/** @returns {boolean} Whether `key` left the map */
+function removeFromSetMap(map, key, value) {
+  const set = map.get(key);
+  if (!set) {
+    return false;
+  }
+  set.delete(value);
+  if (set.size > 0) {
+    return false;
+  }
+  map.delete(key);
+  return true;
+}
+
+class ProjectIndex {
+  constructor() {
+    this.files = new Map();
+    this.definitionFiles = new Map();
+    this.referenceFiles = new Map();
+    // Sorted defined names for completion; dropped only when a name appears or disappears
+    this.completionNames = null;
+  }
+
+  get symbolCount() {
+    return this.definitionFiles.size;
+  }
+
+  /**
+   * Replace a file's entries
+   * @param {string} uri - File URI
+   * @param {{symbols: Array, occurrences: Map}} entry - Result of indexFile()
+   */
+  update(uri, entry) {
+    const removedNames = this.removeEntries(uri);
+    this.files.set(uri, entry);
+
+    let namesChanged = false;
+    for (const symbol of entry.symbols) {
+      const key = symbol.name.toLowerCase();
+      if (addToSetMap(this.definitionFiles, key, uri) && !removedNames.delete(key)) {
+        namesChanged = true;
+      }
+    }
+    for (const name of entry.occurrences.keys()) {
+      addToSetMap(this.referenceFiles, name, uri);
+    }
+
+    if (namesChanged || removedNames.size > 0) {
+      this.completionNames = null;
+    }
+  }
+
+  remove(uri) {
+    if (this.removeEntries(uri).size > 0) {
+      this.completionNames = null;
+    }
+  }
+
+  /**
+   * Drop a file's entries
+   * @private
+   * @returns {Set<string>} Defined names no file declares any more
+   */
+  removeEntries(uri) {
+    const removedNames = new Set();
+    const entry = this.files.get(uri);
+    if (!entry) {
+      return removedNames;
+    }
+    this.files.delete(uri);
+    for (const symbol of entry.symbols) {
+      const key = symbol.name.toLowerCase();
+      if (removeFromSetMap(this.definitionFiles, key, uri)) {
+        removedNames.add(key);
+      }
+    }
+    for (const name of entry.occurrences.keys()) {
+      removeFromSetMap(this.referenceFiles, name, uri);
+    }
+    return removedNames;
+  }
+
+  documentSymbols(uri) {
+    const entry = this.files.get(uri);
+    return entry ? entry.symbols : [];
+  }
+
+  /**
+   * Declarations of a name across the project
+   * @returns {Array<{uri: string, symbol: Object}>}
+   */
+  findDefinitions(name) {
+    const key = name.toLowerCase();
+    const results = [];
+    for (const uri of this.definitionFiles.get(key) || []) {
+      for (const symbol of this.files.get(uri).symbols) {
+        if (symbol.name.toLowerCase() === key) {
+          results.push({ uri, symbol });
+        }
+      }
+    }
+    return results;
+  }
+
+  /**
+   * Every occurrence of a name across the project, declarations included
+   * @returns {Array<{uri: string, range: Object}>}
+   */
+  findReferences(name) {
+    const key = name.toLowerCase();
+    const results = [];
+    for (const uri of this.referenceFiles.get(key) || []) {
+      for (const range of this.files.get(uri).occurrences.get(key)) {
+        results.push({ uri, range });
+      }
+    }
+    return results;
+  }
+
+  /**
+   * Symbols whose name starts with `prefix` (case-insensitive), one per name
+   * @param {string} prefix - Typed prefix
+   * @param {number} limit - Maximum number of symbols
+   * @returns {{symbols: Array, isIncomplete: boolean}}
+   */
+  complete(prefix, limit) {
+    const names = this.getCompletionNames();
+    const key = prefix.toLowerCase();
+
+    let low = 0;
+    let high = names.length;
+    while (low < high) {
+      const mid = (low + high) >> 1;
+      if (names[mid] < key) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+
+    const symbols = [];
+    for (let i = low; i < names.length && names[i].startsWith(key); i++) {
+      if (symbols.length === limit) {
+        return { symbols, isIncomplete: true };
+      }
+      symbols.push(this.findDefinitions(names[i])[0].symbol);
+    }
+    return { symbols, isIncomplete: false };
+  }
+
+  /**
+   * Sorted lower-cased defined names
+   * @private
+   */
+  getCompletionNames() {
+    if (!this.completionNames) {
+      this.completionNames = Array.from(this.definitionFiles.keys()).sort();
+    }
+    return this.completionNames;
+  }
+}
+
+module.exports = {
+  ProjectIndex,
+  SYMBOL_KINDS,
+  collectOccurrences,
+  indexFile
+};
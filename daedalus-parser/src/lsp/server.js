@@ -0,0 +1,449 @@
+// Daedalus language server: diagnostics, definitions, references, document
+// symbols and completion over the Language Server Protocol
+//
+// Open documents keep their syntax tree and are reparsed incrementally from
+// the previous tree on every change. Workspace files are parsed once in the
+// background, indexed and their trees dropped. All queries are answered from
+// the ProjectIndex, so their cost does not grow with the size of the mod.
+
+const fs = require('fs');
+const path = require('path');
+const { fileURLToPath, pathToFileURL } = require('url');
+const DaedalusParser = require('../core/parser');
+const { traceSpan } = require('../core/tracing');
+const { ErrorCodes, MessageReader, MessageWriter, ResponseError } = require('./json-rpc');
+const { ProjectIndex, SYMBOL_KINDS, indexFile } = require('./project-index');
+const { TextDocument } = require('./text-document');
+
+const SERVER_VERSION = require('../../package.json').version;
+
+const DAEDALUS_EXTENSION = '.d';
+const SKIPPED_DIRECTORIES = new Set(['.git', '.svn', 'node_modules']);
+// Workspace indexing yields to pending messages after this long
+const INDEX_SLICE_MS = 20;
+const MAX_COMPLETION_ITEMS = 200;
+// Requests slower than this are reported through window/logMessage
+const SLOW_REQUEST_MS = 50;
+const IDENTIFIER_SUFFIX = /[A-Za-z0-9_\u0080-\u00FF]*$/;
+
+const TextDocumentSyncKind = { Incremental: 2 };
+const DiagnosticSeverity = { Error: 1 };
+const MessageType = { Info: 3, Log: 4 };
+
+/**
+ * Canonical form of a file URI so that client and workspace URIs of one file match
+ */
+function normalizeUri(uri) {
+  if (!uri.startsWith('file:')) {
+    return uri;
+  }
+  try {
+    return pathToFileURL(fileURLToPath(uri)).href;
+  } catch {
+    return uri;
+  }
+}
+
+function walkDaedalusFiles(rootDir, files) {
+  const pending = [rootDir];
+  while (pending.length > 0) {
+    const dir = pending.pop();
+    let entries;
+    try {
+      entries = fs.readdirSync(dir, { withFileTypes: true });
+    } catch {
+      continue;
+    }
+    for (const entry of entries) {
+      const fullPath = path.join(dir, entry.name);
+      if (entry.isDirectory()) {
+        if (!SKIPPED_DIRECTORIES.has(entry.name)) {
+          pending.push(fullPath);
+        }
+      } else if (entry.isFile() && path.extname(entry.name).toLowerCase() === DAEDALUS_EXTENSION) {
+        files.push(fullPath);
+      }
+    }
+  }
+  return files;
+}
+
+function disposeTree(tree) {
+  if (tree && typeof tree.delete === 'function') {
+    tree.delete();
+  }
+}
+
+class DaedalusLanguageServer {
+  /**
+   * @param {Object} options
+   * @param {import('stream').Readable} options.input - Client to server messages
+   * @param {import('stream').Writable} options.output - Server to client messages
+   * @param {Function} [options.onExit] - Called with the exit code on `exit` or end of input
+   */
+  constructor({ input, output, onExit = () => {} }) {
+    this.writer = new MessageWriter(output);
+    this.onExit = onExit;
+    this.parser = DaedalusParser.create();
+    this.index = new ProjectIndex();
+    this.documents = new Map();
+    this.workspaceRoots = [];
+    this.pendingFiles = [];
+    this.initialized = false;
+    this.shutdownRequested = false;
+
+    this.requestHandlers = {
+      initialize: (params) => this.initialize(params),
+      shutdown: () => this.shutdown(),
+      'textDocument/definition': (params) => this.definition(params),
+      'textDocument/references': (params) => this.references(params),
+      'textDocument/documentSymbol': (params) => this.documentSymbol(params),
+      'textDocument/completion': (params) => this.completion(params)
+    };
+    this.notificationHandlers = {
+      initialized: () => this.startWorkspaceIndexing(),
+      exit: () => this.onExit(this.shutdownRequested ? 0 : 1),
+      'textDocument/didOpen': (params) => this.didOpen(params),
+      'textDocument/didChange': (params) => this.didChange(params),
+      'textDocument/didClose': (params) => this.didClose(params),
+      'workspace/didChangeWatchedFiles': (params) => this.didChangeWatchedFiles(params)
+    };
+
+    new MessageReader(input, (message) => this.handleMessage(message), (error) => {
+      this.log(MessageType.Log, `Dropped malformed message: ${error.message}`);
+    });
+    input.on('end', () => this.onExit(this.shutdownRequested ? 0 : 1));
+  }
+
+  handleMessage(message) {
+    if (message.id !== undefined && message.method === undefined) {
+      return; // Response to a server-initiated request; none are awaited
+    }
+    if (message.id === undefined) {
+      this.handleNotification(message);
+    } else {
+      this.handleRequest(message);
+    }
+  }
+
+  handleRequest({ id, method, params }) {
+    const startTime = process.hrtime.bigint();
+    try {
+      const handler = this.requestHandlers[method];
+      if (!handler) {
+        throw new ResponseError(ErrorCodes.MethodNotFound, `Unhandled method ${method}`);
+      }
+      if (!this.initialized && method !== 'initialize') {
+        throw new ResponseError(ErrorCodes.ServerNotInitialized, 'Server not initialized');
+      }
+      const result = traceSpan(`lsp.${method}`, () => handler(params || {}));
+      this.writer.write({ id, result: result === undefined ? null : result });
+    } catch (error) {
+      const code = error instanceof ResponseError ? error.code : ErrorCodes.InternalError;
+      this.writer.write({ id, error: { code, message: error.message } });
+    }
+
+    const elapsedMs = Number(process.hrtime.bigint() - startTime) / 1_000_000;
+    if (elapsedMs > SLOW_REQUEST_MS) {
+      this.log(MessageType.Log, `${method} took ${elapsedMs.toFixed(1)}ms`);
+    }
+  }
+
+  handleNotification({ method, params }) {
+    const handler = this.notificationHandlers[method];
+    if (!handler || (!this.initialized && method !== 'exit')) {
+      return; // Includes $/cancelRequest: requests are answered synchronously
+    }
+    try {
+      traceSpan(`lsp.${method}`, () => handler(params || {}));
+    } catch (error) {
+      this.log(MessageType.Log, `${method} failed: ${error.message}`);
+    }
+  }
+
+  log(type, message) {
+    this.writer.write({ method: 'window/logMessage', params: { type, message } });
+  }
+
+  // ===================================================================
+  // LIFECYCLE
+  // ===================================================================
+
+  initialize(params) {
+    const folders = params.workspaceFolders || [];
+    if (folders.length > 0) {
+      this.workspaceRoots = folders.map((folder) => folder.uri);
+    } else if (params.rootUri) {
+      this.workspaceRoots = [params.rootUri];
+    } else if (params.rootPath) {
+      this.workspaceRoots = [pathToFileURL(params.rootPath).href];
+    }
+    this.initialized = true;
+
+    return {
+      capabilities: {
+        textDocumentSync: { openClose: true, change: TextDocumentSyncKind.Incremental },
+        definitionProvider: true,
+        referencesProvider: true,
+        documentSymbolProvider: true,
+        completionProvider: { resolveProvider: false }
+      },
+      serverInfo: { name: 'daedalus-lsp', version: SERVER_VERSION }
+    };
+  }
+
+  shutdown() {
+    this.shutdownRequested = true;
+    this.pendingFiles = [];
+    return null;
+  }
+
+  // ===================================================================
+  // WORKSPACE INDEX
+  // ===================================================================
+
+  startWorkspaceIndexing() {
+    const files = [];
+    for (const root of this.workspaceRoots) {
+      if (root.startsWith('file:')) {
+        walkDaedalusFiles(fileURLToPath(root), files);
+      }
+    }
+    this.pendingFiles = files;
+    this.indexingStart = process.hrtime.bigint();
+    this.indexedFiles = 0;
+    setImmediate(() => this.indexPendingFiles());
+  }
+
+  /**
+   * Index workspace files in time slices so requests are served in between
+   * @private
+   */
+  indexPendingFiles() {
+    const sliceEnd = process.hrtime.bigint() + BigInt(INDEX_SLICE_MS * 1_000_000);
+    while (this.pendingFiles.length > 0 && process.hrtime.bigint() < sliceEnd) {
+      const filePath = this.pendingFiles.pop();
+      const uri = normalizeUri(pathToFileURL(filePath).href);
+      if (!this.documents.has(uri)) {
+        this.indexFromDisk(uri, filePath);
+        this.indexedFiles++;
+      }
+    }
+
+    if (this.pendingFiles.length > 0) {
+      setImmediate(() => this.indexPendingFiles());
+      return;
+    }
+    if (this.shutdownRequested) {
+      return;
+    }
+
+    const durationMs = Number(process.hrtime.bigint() - this.indexingStart) / 1_000_000;
+    this.log(MessageType.Info, `Indexed ${this.indexedFiles} files in ${durationMs.toFixed(0)}ms`);
+    this.writer.write({
+      method: 'daedalus/indexed',
+      params: { files: this.indexedFiles, symbols: this.index.symbolCount, durationMs }
+    });
+  }
+
+  indexFromDisk(uri, filePath) {
+    let sourceCode;
+    try {
+      ({ sourceCode } = this.parser.readSource(filePath));
+    } catch {
+      this.index.remove(uri);
+      return;
+    }
+    const result = this.parser.parse(sourceCode);
+    try {
+      this.index.update(uri, indexFile(result.rootNode, sourceCode));
+    } finally {
+      DaedalusParser.disposeResult(result);
+    }
+  }
+
+  didChangeWatchedFiles({ changes = [] }) {
+    const FileChangeType = { Deleted: 3 };
+    for (const change of changes) {
+      const uri = normalizeUri(change.uri);
+      if (this.documents.has(uri) || !uri.startsWith('file:')) {
+        continue; // The editor's text wins over the disk
+      }
+      if (change.type === FileChangeType.Deleted) {
+        this.index.remove(uri);
+      } else {
+        this.indexFromDisk(uri, fileURLToPath(uri));
+      }
+    }
+  }
+
+  // ===================================================================
+  // DOCUMENT SYNC
+  // ===================================================================
+
+  didOpen({ textDocument }) {
+    const uri = normalizeUri(textDocument.uri);
+    const previous = this.documents.get(uri);
+    if (previous) {
+      disposeTree(previous.tree);
+    }
+    const document = new TextDocument(uri, textDocument.version, textDocument.text);
+    const open = { document, tree: null };
+    this.documents.set(uri, open);
+    this.reparse(open);
+  }
+
+  didChange({ textDocument, contentChanges = [] }) {
+    const open = this.documents.get(normalizeUri(textDocument.uri));
+    if (!open) {
+      return;
+    }
+    for (const change of contentChanges) {
+      const edit = open.document.applyChange(change);
+      if (open.tree) {
+        open.tree.edit(edit);
+      }
+    }
+    open.document.version = textDocument.version;
+    this.reparse(open);
+  }
+
+  didClose({ textDocument }) {
+    const uri = normalizeUri(textDocument.uri);
+    const open = this.documents.get(uri);
+    if (!open) {
+      return;
+    }
+    this.documents.delete(uri);
+    disposeTree(open.tree);
+    this.writer.write({ method: 'textDocument/publishDiagnostics', params: { uri, diagnostics: [] } });
+
+    // Fall back to what is on disk, or drop a file that was never saved
+    const filePath = uri.startsWith('file:') ? fileURLToPath(uri) : null;
+    if (filePath && fs.existsSync(filePath)) {
+      this.indexFromDisk(uri, filePath);
+    } else {
+      this.index.remove(uri);
+    }
+  }
+
+  /**
+   * Parse an open document, reusing its previous (edited) tree, then reindex and publish diagnostics
+   * @private
+   */
+  reparse(open) {
+    const { document } = open;
+    const previousTree = open.tree;
+    const result = this.parser.parse(document.text, previousTree ? { oldTree: previousTree } : {});
+    open.tree = result.tree;
+    disposeTree(previousTree);
+
+    const entry = indexFile(open.tree.rootNode, document.text);
+    this.index.update(document.uri, entry);
+    this.publishDiagnostics(document, entry.errors);
+  }
+
+  publishDiagnostics(document, errors) {
+    const diagnostics = errors.map((error) => {
+      // Error positions are 1-based; the range covers the erroneous text
+      const start = { line: error.position.row - 1, character: error.position.column - 1 };
+      const startOffset = document.offsetAt(start);
+      const endPoint = document.pointAt(startOffset + (error.text ? error.text.length : 0));
+      return {
+        range: { start, end: { line: endPoint.row, character: endPoint.column } },
+        severity: DiagnosticSeverity.Error,
+        source: 'daedalus',
+        code: error.type,
+        message: error.message
+      };
+    });
+    this.writer.write({
+      method: 'textDocument/publishDiagnostics',
+      params: { uri: document.uri, version: document.version, diagnostics }
+    });
+  }
+
+  // ===================================================================
+  // QUERIES
+  // ===================================================================
+
+  /**
+   * Identifier under (or directly before) the cursor in an open document
+   * @private
+   */
+  identifierAt({ textDocument, position }) {
+    const open = this.documents.get(normalizeUri(textDocument.uri));
+    if (!open || !position) {
+      return null;
+    }
+    const { rootNode } = open.tree;
+    const point = { row: position.line, column: position.character };
+    let node = rootNode.descendantForPosition(point);
+    if (node.type !== 'identifier' && point.column > 0) {
+      node = rootNode.descendantForPosition({ row: point.row, column: point.column - 1 });
+    }
+    return node.type === 'identifier' ? node.text : null;
+  }
+
+  definition(params) {
+    const name = this.identifierAt(params);
+    if (!name) {
+      return null;
+    }
+    return this.index.findDefinitions(name).map(({ uri, symbol }) => ({ uri, range: symbol.selectionRange }));
+  }
+
+  references(params) {
+    const name = this.identifierAt(params);
+    if (!name) {
+      return null;
+    }
+    const references = this.index.findReferences(name);
+    if (params.context && params.context.includeDeclaration === false) {
+      const declarations = this.index.findDefinitions(name);
+      const isDeclaration = ({ uri, range }) => declarations.some(({ uri: definitionUri, symbol }) =>
+        definitionUri === uri
+        && symbol.selectionRange.start.line === range.start.line
+        && symbol.selectionRange.start.character === range.start.character);
+      return references.filter((reference) => !isDeclaration(reference));
+    }
+    return references;
+  }
+
+  documentSymbol({ textDocument }) {
+    return this.index.documentSymbols(normalizeUri(textDocument.uri)).map((symbol) => ({
+      name: symbol.name,
+      detail: symbol.detail,
+      kind: SYMBOL_KINDS[symbol.kind].symbolKind,
+      range: symbol.range,
+      selectionRange: symbol.selectionRange
+    }));
+  }
+
+  completion({ textDocument, position }) {
+    const open = this.documents.get(normalizeUri(textDocument.uri));
+    if (!open) {
+      return null;
+    }
+    const linePrefix = open.document.linePrefix(position);
+    const prefix = IDENTIFIER_SUFFIX.exec(linePrefix)[0];
+    if (linePrefix.charAt(linePrefix.length - prefix.length - 1) === '.') {
+      return { isIncomplete: false, items: [] }; // Member access: class fields are not indexed
+    }
+
+    const { symbols, isIncomplete } = this.index.complete(prefix, MAX_COMPLETION_ITEMS);
+    return {
+      isIncomplete,
+      items: symbols.map((symbol) => ({
+        label: symbol.name,
+        kind: SYMBOL_KINDS[symbol.kind].completionKind,
+        detail: symbol.detail
+      }))
+    };
+  }
+}
+
+module.exports = {
+  DaedalusLanguageServer,
+  normalizeUri
+};
@@ -0,0 +1,118 @@
+// Open document text with LSP position mapping and tree-sitter edit descriptions
+//
+// LSP positions count UTF-16 code units, which is what JavaScript string
+// indices and tree-sitter's JS binding use as well, so offsets carry over
+// without conversion. Lines are split on '\n' as tree-sitter does.
+
+class TextDocument {
+  /**
+   * @param {string} uri - Document URI
+   * @param {number} version - Client version of the text
+   * @param {string} text - Full text
+   */
+  constructor(uri, version, text) {
+    this.uri = uri;
+    this.version = version;
+    this.text = text;
+    this.lineOffsets = null;
+  }
+
+  getLineOffsets() {
+    if (!this.lineOffsets) {
+      const offsets = [0];
+      let index = this.text.indexOf('\n');
+      while (index !== -1) {
+        offsets.push(index + 1);
+        index = this.text.indexOf('\n', index + 1);
+      }
+      this.lineOffsets = offsets;
+    }
+    return this.lineOffsets;
+  }
+
+  /**
+   * Offset of an LSP position, clamped to the text
+   */
+  offsetAt(position) {
+    const offsets = this.getLineOffsets();
+    if (position.line >= offsets.length) {
+      return this.text.length;
+    }
+    if (position.line < 0) {
+      return 0;
+    }
+    const lineStart = offsets[position.line];
+    const lineEnd = position.line + 1 < offsets.length ? offsets[position.line + 1] - 1 : this.text.length;
+    return Math.min(lineStart + Math.max(position.character, 0), lineEnd);
+  }
+
+  /**
+   * tree-sitter point ({row, column}) of an offset
+   */
+  pointAt(offset) {
+    const offsets = this.getLineOffsets();
+    let low = 0;
+    let high = offsets.length - 1;
+    while (low < high) {
+      const mid = (low + high + 1) >> 1;
+      if (offsets[mid] <= offset) {
+        low = mid;
+      } else {
+        high = mid - 1;
+      }
+    }
+    return { row: low, column: offset - offsets[low] };
+  }
+
+  /**
+   * Text of the line up to an LSP position
+   */
+  linePrefix(position) {
+    const offset = this.offsetAt(position);
+    return this.text.slice(this.getLineOffsets()[this.pointAt(offset).row], offset);
+  }
+
+  /**
+   * Apply one `TextDocumentContentChangeEvent`
+   * @returns {Object} The matching tree-sitter edit (for `tree.edit()`)
+   */
+  applyChange(change) {
+    const startIndex = change.range ? this.offsetAt(change.range.start) : 0;
+    const oldEndIndex = change.range ? Math.max(this.offsetAt(change.range.end), startIndex) : this.text.length;
+    const startPosition = this.pointAt(startIndex);
+    const oldEndPosition = this.pointAt(oldEndIndex);
+
+    this.text = this.text.slice(0, startIndex) + change.text + this.text.slice(oldEndIndex);
+    this.lineOffsets = null;
+
+    const newEndIndex = startIndex + change.text.length;
+    const lastNewline = change.text.lastIndexOf('\n');
+    let newEndPosition;
+    if (lastNewline === -1) {
+      newEndPosition = { row: startPosition.row, column: startPosition.column + change.text.length };
+    } else {
+      let lines = 0;
+      for (let i = change.text.indexOf('\n'); i !== -1; i = change.text.indexOf('\n', i + 1)) {
+        lines++;
+      }
+      newEndPosition = { row: startPosition.row + lines, column: change.text.length - lastNewline - 1 };
+    }
+
+    return { startIndex, oldEndIndex, newEndIndex, startPosition, oldEndPosition, newEndPosition };
+  }
+}
+
+/**
+ * LSP range of a tree-sitter node
+ */
+function nodeRange(node) {
+  return {
+    start: { line: node.startPosition.row, character: node.startPosition.column },
+    end: { line: node.endPosition.row, character: node.endPosition.column }
+  };
+}
+
+module.exports = {
+  TextDocument,
+  nodeRange
+};
@@ -1,6 +1,3 @@
-import 'reflect-metadata';
-import { Type, plainToInstance, ClassConstructor } from 'class-transformer';
-
 // Semantic model classes and types for Daedalus dialog parsing
 
 // Type definitions for tree-sitter nodes
@@ -796,92 +793,37 @@ export type DialogAction =
   | RemoveInventoryItemsAction
   | InsertNpcAction;
 
-const ACTION_DISCRIMINATOR = {
-  property: 'type',
-  subTypes: [
-    { value: DialogLine, name: 'DialogLine' },
-    { value: CreateTopic, name: 'CreateTopic' },
-    { value: LogEntry, name: 'LogEntry' },
-    { value: LogSetTopicStatus, name: 'LogSetTopicStatus' },
-    { value: Action, name: 'Action' },
-    { value: ConditionalAction, name: 'ConditionalAction' },
-    { value: Choice, name: 'Choice' },
-    { value: CreateInventoryItems, name: 'CreateInventoryItems' },
-    { value: GiveInventoryItems, name: 'GiveInventoryItems' },
-    { value: AttackAction, name: 'AttackAction' },
-    { value: SetAttitudeAction, name: 'SetAttitudeAction' },
-    { value: ExchangeRoutineAction, name: 'ExchangeRoutineAction' },
-    { value: ChapterTransitionAction, name: 'ChapterTransitionAction' },
-    { value: SetVariableAction, name: 'SetVariableAction' },
-    { value: StopProcessInfosAction, name: 'StopProcessInfosAction' },
-    { value: PlayAniAction, name: 'PlayAniAction' },
-    { value: GivePlayerXPAction, name: 'GivePlayerXPAction' },
-    { value: PickpocketAction, name: 'PickpocketAction' },
-    { value: StartOtherRoutineAction, name: 'StartOtherRoutineAction' },
-    { value: TeachAction, name: 'TeachAction' },
-    { value: GiveTradeInventoryAction, name: 'GiveTradeInventoryAction' },
-    { value: RemoveInventoryItemsAction, name: 'RemoveInventoryItemsAction' },
-    { value: InsertNpcAction, name: 'InsertNpcAction' },
-  ],
-};
-
-// Helper to ensure action has a type (legacy support)
-function ensureActionType(json: any): void {
-  if (!json.type) {
-    if ('speaker' in json && 'text' in json && 'id' in json) json.type = 'DialogLine';
-    else if ('topic' in json && 'topicType' in json) json.type = 'CreateTopic';
-    else if ('topic' in json && 'text' in json) json.type = 'LogEntry';
-    else if ('topic' in json && 'status' in json) json.type = 'LogSetTopicStatus';
-    else if ('condition' in json && 'thenActions' in json && 'elseActions' in json) json.type = 'ConditionalAction';
-    else if ('dialogRef' in json && 'targetFunction' in json) json.type = 'Choice';
-    else if ('target' in json && 'item' in json && 'quantity' in json && !('giver' in json)) json.type = 'CreateInventoryItems';
-    else if ('giver' in json && 'receiver' in json) json.type = 'GiveInventoryItems';
-    else if ('attacker' in json && 'attackReason' in json) json.type = 'AttackAction';
-    else if ('attitude' in json) json.type = 'SetAttitudeAction';
-    else if ('routine' in json) json.type = 'ExchangeRoutineAction';
-    else if ('chapter' in json && 'world' in json) json.type = 'ChapterTransitionAction';
-    else if ('variableName' in json && 'operator' in json && 'value' in json) json.type = 'SetVariableAction';
-    else if ('target' in json && 'animationName' in json) json.type = 'PlayAniAction';
-    else if ('target' in json && Object.keys(json).length === 1) json.type = 'StopProcessInfosAction';
-    else if ('xpAmount' in json) json.type = 'GivePlayerXPAction';
-    else if ('pickpocketMode' in json) json.type = 'PickpocketAction';
-    else if ('routineFunctionName' in json && 'routineNpc' in json && 'routineName' in json) json.type = 'StartOtherRoutineAction';
-    else if ('teachFunctionName' in json && 'teachArgs' in json) json.type = 'TeachAction';
-    else if ('tradeTarget' in json) json.type = 'GiveTradeInventoryAction';
-    else if ('removeFunctionName' in json && 'removeNpc' in json && 'removeItem' in json) json.type = 'RemoveInventoryItemsAction';
-    else if ('npcInstance' in json && 'spawnPoint' in json) json.type = 'InsertNpcAction';
-    else if ('action' in json) json.type = 'Action';
-  }
-
-  if (Array.isArray(json.thenActions)) {
-    json.thenActions.forEach((action: any) => ensureActionType(action));
-  }
-  if (Array.isArray(json.elseActions)) {
-    json.elseActions.forEach((action: any) => ensureActionType(action));
-  }
+// Legacy support: infer the type of an action serialized without one
+function inferActionType(json: any): string | undefined {
+  if ('speaker' in json && 'text' in json && 'id' in json) return 'DialogLine';
+  if ('topic' in json && 'topicType' in json) return 'CreateTopic';
+  if ('topic' in json && 'text' in json) return 'LogEntry';
+  if ('topic' in json && 'status' in json) return 'LogSetTopicStatus';
+  if ('condition' in json && 'thenActions' in json && 'elseActions' in json) return 'ConditionalAction';
+  if ('dialogRef' in json && 'targetFunction' in json) return 'Choice';
+  if ('target' in json && 'item' in json && 'quantity' in json && !('giver' in json)) return 'CreateInventoryItems';
+  if ('giver' in json && 'receiver' in json) return 'GiveInventoryItems';
+  if ('attacker' in json && 'attackReason' in json) return 'AttackAction';
+  if ('attitude' in json) return 'SetAttitudeAction';
+  if ('routine' in json) return 'ExchangeRoutineAction';
+  if ('chapter' in json && 'world' in json) return 'ChapterTransitionAction';
+  if ('variableName' in json && 'operator' in json && 'value' in json) return 'SetVariableAction';
+  if ('target' in json && 'animationName' in json) return 'PlayAniAction';
+  if ('target' in json && Object.keys(json).length === 1) return 'StopProcessInfosAction';
+  if ('xpAmount' in json) return 'GivePlayerXPAction';
+  if ('pickpocketMode' in json) return 'PickpocketAction';
+  if ('routineFunctionName' in json && 'routineNpc' in json && 'routineName' in json) return 'StartOtherRoutineAction';
+  if ('teachFunctionName' in json && 'teachArgs' in json) return 'TeachAction';
+  if ('tradeTarget' in json) return 'GiveTradeInventoryAction';
+  if ('removeFunctionName' in json && 'removeNpc' in json && 'removeItem' in json) return 'RemoveInventoryItemsAction';
+  if ('npcInstance' in json && 'spawnPoint' in json) return 'InsertNpcAction';
+  if ('action' in json) return 'Action';
+  return undefined;
 }
 
 // Helper to deserialize any action
 export function deserializeAction(json: any): DialogAction | any {
-  ensureActionType(json);
-
-  if (json.type) {
-    const subType = ACTION_DISCRIMINATOR.subTypes.find(s => s.name === json.type);
-    if (subType) {
-      const instance = plainToInstance(subType.value as ClassConstructor<any>, json);
-      if (instance instanceof ConditionalAction) {
-        instance.thenActions = Array.isArray(json.thenActions)
-          ? json.thenActions.map((action: any) => deserializeAction(action))
-          : [];
-        instance.elseActions = Array.isArray(json.elseActions)
-          ? json.elseActions.map((action: any) => deserializeAction(action))
-          : [];
-      }
-      return instance;
-    }
-  }
-
-  return json;
+  return readAction(json);
 }
 
 // ===================================================================
@@ -1172,47 +1114,24 @@ export type DialogCondition =
   | Condition
   | VariableCondition;
 
-const CONDITION_DISCRIMINATOR = {
-  property: 'type',
-  subTypes: [
-    { value: NpcKnowsInfoCondition, name: 'NpcKnowsInfoCondition' },
-    { value: NpcHasItemsCondition, name: 'NpcHasItemsCondition' },
-    { value: NpcIsInStateCondition, name: 'NpcIsInStateCondition' },
-    { value: NpcIsDeadCondition, name: 'NpcIsDeadCondition' },
-    { value: NpcGetDistToWpCondition, name: 'NpcGetDistToWpCondition' },
-    { value: NpcGetTalentSkillCondition, name: 'NpcGetTalentSkillCondition' },
-    { value: Condition, name: 'Condition' },
-    { value: VariableCondition, name: 'VariableCondition' },
-  ],
-};
-
-// Helper to ensure condition has a type (legacy support)
-function ensureConditionType(json: any): void {
-  if (!json.type) {
-    if ('npc' in json && 'dialogRef' in json) json.type = 'NpcKnowsInfoCondition';
-    else if ('npc' in json && 'item' in json) json.type = 'NpcHasItemsCondition';
-    else if ('npc' in json && 'state' in json) json.type = 'NpcIsInStateCondition';
-    else if ('npc' in json && !('dialogRef' in json) && !('item' in json) && !('state' in json) && !('waypoint' in json) && !('talent' in json)) json.type = 'NpcIsDeadCondition';
-    else if ('npc' in json && 'waypoint' in json) json.type = 'NpcGetDistToWpCondition';
-    else if ('npc' in json && 'talent' in json) json.type = 'NpcGetTalentSkillCondition';
-    else if ('variableName' in json) json.type = 'VariableCondition';
-    else if ('condition' in json) json.type = 'Condition';
-  }
+// Legacy support: infer the type of a condition serialized without one
+function inferConditionType(json: any): string | undefined {
+  if ('npc' in json && 'dialogRef' in json) return 'NpcKnowsInfoCondition';
+  if ('npc' in json && 'item' in json) return 'NpcHasItemsCondition';
+  if ('npc' in json && 'state' in json) return 'NpcIsInStateCondition';
+  if ('npc' in json && !('dialogRef' in json) && !('item' in json) && !('state' in json) && !('waypoint' in json) && !('talent' in json)) return 'NpcIsDeadCondition';
+  if ('npc' in json && 'waypoint' in json) return 'NpcGetDistToWpCondition';
+  if ('npc' in json && 'talent' in json) return 'NpcGetTalentSkillCondition';
+  if ('variableName' in json) return 'VariableCondition';
+  if ('condition' in json) return 'Condition';
+  return undefined;
 }
 
 // Helper to deserialize any condition
 export function deserializeCondition(json: any): DialogCondition {
-  ensureConditionType(json);
-
-  if (json.type) {
-    const subType = CONDITION_DISCRIMINATOR.subTypes.find(s => s.name === json.type);
-    if (subType) {
-      return plainToInstance(subType.value as ClassConstructor<any>, json);
-    }
-  }
-
+  const condition = readCondition(json);
   // Fallback
-  return new Condition('');
+  return condition === json ? new Condition('') : condition;
 }
 
 // ===================================================================
@@ -1227,15 +1146,7 @@ export class DialogFunction {
   public leadingComments?: string[];
   public hasExplicitBodyContent?: boolean;
   public calls: string[];
-
-  @Type(() => Object, {
-    discriminator: ACTION_DISCRIMINATOR,
-  })
   public actions: DialogAction[];
-
-  @Type(() => Object, {
-    discriminator: CONDITION_DISCRIMINATOR,
-  })
   public conditions: DialogCondition[];
 
   constructor(name: string, returnType: string) {
@@ -1349,8 +1260,423 @@ export interface SemanticModel {
   hasErrors?: boolean;
 }
 
-// Helper to deserialize full semantic model
+// ===================================================================
+// SERIALIZATION
+// ===================================================================
+//
+// Every serializable class is described once in a type registry. Each entry
+// is compiled into a reader for plain JSON (what IPC and postMessage
+// deliver) and a writer/reader pair for the compact wire format, so each
+// type gets its own straight-line code instead of generic reflection.
+
+type Constructor = new () => any;
+
+interface TypeSchema {
+  name: string;
+  ctor: Constructor;
+  /** Data fields in wire order; `type` tags of actions and conditions are implied */
+  fields: readonly string[];
+  /** Fields holding nested action lists */
+  actionLists?: readonly string[];
+  /** Fields holding arrays of primitives, copied on read */
+  valueLists?: readonly string[];
+  /** Fields the caller fills in itself */
+  managed?: readonly string[];
+}
+
+export const ACTION_TYPES: readonly TypeSchema[] = [
+  { name: 'DialogLine', ctor: DialogLine as Constructor, fields: ['speaker', 'listener', 'text', 'id', 'inlineComment'] },
+  { name: 'CreateTopic', ctor: CreateTopic as Constructor, fields: ['topic', 'topicType'] },
+  { name: 'LogEntry', ctor: LogEntry as Constructor, fields: ['topic', 'text'] },
+  { name: 'LogSetTopicStatus', ctor: LogSetTopicStatus as Constructor, fields: ['topic', 'status'] },
+  { name: 'Action', ctor: Action as Constructor, fields: ['action'] },
+  {
+    name: 'ConditionalAction',
+    ctor: ConditionalAction as Constructor,
+    fields: ['condition', 'thenActions', 'elseActions'],
+    actionLists: ['thenActions', 'elseActions']
+  },
+  { name: 'Choice', ctor: Choice as Constructor, fields: ['dialogRef', 'text', 'targetFunction', 'textIsExpression'] },
+  { name: 'CreateInventoryItems', ctor: CreateInventoryItems as Constructor, fields: ['target', 'item', 'quantity'] },
+  { name: 'GiveInventoryItems', ctor: GiveInventoryItems as Constructor, fields: ['giver', 'receiver', 'item', 'quantity'] },
+  { name: 'AttackAction', ctor: AttackAction as Constructor, fields: ['attacker', 'target', 'attackReason', 'damage'] },
+  { name: 'SetAttitudeAction', ctor: SetAttitudeAction as Constructor, fields: ['target', 'attitude'] },
+  { name: 'ExchangeRoutineAction', ctor: ExchangeRoutineAction as Constructor, fields: ['target', 'routine'] },
+  { name: 'ChapterTransitionAction', ctor: ChapterTransitionAction as Constructor, fields: ['chapter', 'world'] },
+  { name: 'SetVariableAction', ctor: SetVariableAction as Constructor, fields: ['variableName', 'operator', 'value'] },
+  { name: 'StopProcessInfosAction', ctor: StopProcessInfosAction as Constructor, fields: ['target'] },
+  { name: 'PlayAniAction', ctor: PlayAniAction as Constructor, fields: ['target', 'animationName'] },
+  { name: 'GivePlayerXPAction', ctor: GivePlayerXPAction as Constructor, fields: ['xpAmount'] },
+  { name: 'PickpocketAction', ctor: PickpocketAction as Constructor, fields: ['pickpocketMode', 'minChance', 'maxChance'] },
+  {
+    name: 'StartOtherRoutineAction',
+    ctor: StartOtherRoutineAction as Constructor,
+    fields: ['routineFunctionName', 'routineNpc', 'routineName']
+  },
+  {
+    name: 'TeachAction',
+    ctor: TeachAction as Constructor,
+    fields: ['teachFunctionName', 'teachArgs'],
+    valueLists: ['teachArgs']
+  },
+  { name: 'GiveTradeInventoryAction', ctor: GiveTradeInventoryAction as Constructor, fields: ['tradeTarget'] },
+  {
+    name: 'RemoveInventoryItemsAction',
+    ctor: RemoveInventoryItemsAction as Constructor,
+    fields: ['removeFunctionName', 'removeNpc', 'removeItem', 'removeQuantity']
+  },
+  { name: 'InsertNpcAction', ctor: InsertNpcAction as Constructor, fields: ['npcInstance', 'spawnPoint'] }
+];
+
+export const CONDITION_TYPES: readonly TypeSchema[] = [
+  { name: 'NpcKnowsInfoCondition', ctor: NpcKnowsInfoCondition as Constructor, fields: ['npc', 'dialogRef'] },
+  { name: 'NpcHasItemsCondition', ctor: NpcHasItemsCondition as Constructor, fields: ['npc', 'item', 'operator', 'value'] },
+  { name: 'NpcIsInStateCondition', ctor: NpcIsInStateCondition as Constructor, fields: ['npc', 'state', 'negated'] },
+  { name: 'NpcIsDeadCondition', ctor: NpcIsDeadCondition as Constructor, fields: ['npc', 'negated'] },
+  {
+    name: 'NpcGetDistToWpCondition',
+    ctor: NpcGetDistToWpCondition as Constructor,
+    fields: ['npc', 'waypoint', 'operator', 'value']
+  },
+  {
+    name: 'NpcGetTalentSkillCondition',
+    ctor: NpcGetTalentSkillCondition as Constructor,
+    fields: ['npc', 'talent', 'operator', 'value']
+  },
+  { name: 'Condition', ctor: Condition as Constructor, fields: ['condition'] },
+  { name: 'VariableCondition', ctor: VariableCondition as Constructor, fields: ['variableName', 'negated', 'operator', 'value'] }
+];
+
+const FUNCTION_SCHEMA: TypeSchema = {
+  name: 'DialogFunction',
+  ctor: DialogFunction as Constructor,
+  fields: ['name', 'returnType', 'keyword', 'spaceBeforeParen', 'leadingComments', 'hasExplicitBodyContent', 'calls'],
+  valueLists: ['leadingComments', 'calls'],
+  managed: ['actions', 'conditions']
+};
+
+const GLOBAL_LOCATION_FIELDS = ['filePath', 'position', 'range'];
+
+const GLOBAL_CONSTANT_SCHEMA: TypeSchema = {
+  name: 'GlobalConstant',
+  ctor: GlobalConstant as Constructor,
+  fields: ['name', 'type', 'value', ...GLOBAL_LOCATION_FIELDS]
+};
+
+const GLOBAL_VARIABLE_SCHEMA: TypeSchema = {
+  name: 'GlobalVariable',
+  ctor: GlobalVariable as Constructor,
+  fields: ['name', 'type', ...GLOBAL_LOCATION_FIELDS]
+};
+
+const GLOBAL_INSTANCE_SCHEMA: TypeSchema = {
+  name: 'GlobalInstance',
+  ctor: GlobalInstance as Constructor,
+  fields: ['name', 'parent', 'displayName', ...GLOBAL_LOCATION_FIELDS]
+};
+
+const FIELD_VALUE = 0;
+const FIELD_VALUE_LIST = 1;
+const FIELD_ACTION_LIST = 2;
+
+type ActionDecoder = (item: any) => any;
+
+interface CompiledType {
+  name: string;
+  /** Build an instance from plain JSON; nested actions are read as plain JSON too */
+  fromPlain(json: any): any;
+  /** Encode as `[tag, presenceMask, ...presentFields, extras?]` */
+  toWire(value: any): any[];
+  /** Inverse of toWire; nested action tuples go through `decodeAction` */
+  fromWire(tuple: any[], decodeAction: ActionDecoder): any;
+}
+
+/**
+ * Compile a schema into readers and writers. Fields are visited in a fixed
+ * order and instances always come from the class constructor, so each type
+ * builds objects of one shape. Keys outside the schema are carried along
+ * (as an extras object on the wire). Primitive arrays are copied, other
+ * nested values are shared with the input.
+ */
+function compileType(schema: TypeSchema, tag: number): CompiledType {
+  const { ctor, fields } = schema;
+  const count = fields.length;
+  const kinds = fields.map((field) => {
+    if (schema.actionLists?.includes(field)) {
+      return FIELD_ACTION_LIST;
+    }
+    return schema.valueLists?.includes(field) ? FIELD_VALUE_LIST : FIELD_VALUE;
+  });
+  const known = new Set<string>(['type', ...fields, ...(schema.managed ?? [])]);
+  const extrasBit = 2 ** count;
+
+  return {
+    name: schema.name,
+
+    fromPlain(json: any): any {
+      const instance = new ctor();
+      for (let i = 0; i < count; i++) {
+        const field = fields[i];
+        if (field in json) {
+          const value = json[field];
+          const kind = kinds[i];
+          if (kind === FIELD_ACTION_LIST) {
+            instance[field] = Array.isArray(value) ? value.map(readAction) : [];
+          } else {
+            instance[field] = kind === FIELD_VALUE_LIST && Array.isArray(value) ? value.slice() : value;
+          }
+        }
+      }
+      for (const key in json) {
+        if (!known.has(key)) {
+          instance[key] = json[key];
+        }
+      }
+      return instance;
+    },
+
+    toWire(value: any): any[] {
+      const tuple: any[] = [tag, 0];
+      let mask = 0;
+      for (let i = 0; i < count; i++) {
+        const field = fields[i];
+        const fieldValue = value[field];
+        // Left out like JSON does; an undefined tuple slot would come back as null
+        if (fieldValue !== undefined) {
+          mask |= 2 ** i;
+          tuple.push(kinds[i] === FIELD_ACTION_LIST && Array.isArray(fieldValue) ? fieldValue.map(encodeAction) : fieldValue);
+        }
+      }
+      let extras: Record<string, unknown> | undefined;
+      for (const key in value) {
+        if (!known.has(key)) {
+          (extras ??= {})[key] = value[key];
+        }
+      }
+      if (extras) {
+        mask |= extrasBit;
+        tuple.push(extras);
+      }
+      tuple[1] = mask;
+      return tuple;
+    },
+
+    fromWire(tuple: any[], decodeAction: ActionDecoder): any {
+      const instance = new ctor();
+      const mask = tuple[1];
+      let position = 2;
+      for (let i = 0; i < count; i++) {
+        if (mask & (2 ** i)) {
+          const value = tuple[position++];
+          instance[fields[i]] = kinds[i] === FIELD_ACTION_LIST && Array.isArray(value) ? value.map(decodeAction) : value;
+        }
+      }
+      if (mask & extrasBit) {
+        Object.assign(instance, tuple[position]);
+      }
+      return instance;
+    }
+  };
+}
+
+const compiledActions = ACTION_TYPES.map((schema, tag) => compileType(schema, tag));
+const compiledConditions = CONDITION_TYPES.map((schema, tag) => compileType(schema, tag));
+const actionsByName = new Map(compiledActions.map((compiled) => [compiled.name, compiled]));
+const conditionsByName = new Map(compiledConditions.map((compiled) => [compiled.name, compiled]));
+const compiledFunction = compileType(FUNCTION_SCHEMA, -1);
+const compiledConstant = compileType(GLOBAL_CONSTANT_SCHEMA, -1);
+const compiledVariable = compileType(GLOBAL_VARIABLE_SCHEMA, -1);
+const compiledInstance = compileType(GLOBAL_INSTANCE_SCHEMA, -1);
+
+// Plain JSON action -> instance; unknown types are kept as plain objects
+function readAction(json: any): any {
+  if (json === null || typeof json !== 'object') {
+    return json;
+  }
+  if (!json.type) {
+    const inferred = inferActionType(json);
+    if (inferred) {
+      json.type = inferred;
+    }
+  }
+  const compiled = actionsByName.get(json.type);
+  return compiled ? compiled.fromPlain(json) : json;
+}
+
+// Plain JSON condition -> instance; unknown types are kept as plain objects
+function readCondition(json: any): any {
+  if (json === null || typeof json !== 'object') {
+    return json;
+  }
+  if (!json.type) {
+    const inferred = inferConditionType(json);
+    if (inferred) {
+      json.type = inferred;
+    }
+  }
+  const compiled = conditionsByName.get(json.type);
+  return compiled ? compiled.fromPlain(json) : json;
+}
+
+function encodeAction(action: any): any {
+  if (action === null || typeof action !== 'object') {
+    return action;
+  }
+  const compiled = actionsByName.get(action.type ?? inferActionType(action));
+  return compiled ? compiled.toWire(action) : action;
+}
+
+function encodeCondition(condition: any): any {
+  if (condition === null || typeof condition !== 'object') {
+    return condition;
+  }
+  const compiled = conditionsByName.get(condition.type ?? inferConditionType(condition));
+  return compiled ? compiled.toWire(condition) : condition;
+}
+
+function readFunction(json: any, actions: any[], conditions: any[]): DialogFunction {
+  const func = compiledFunction.fromPlain(json) as DialogFunction;
+  func.actions = actions;
+  func.conditions = conditions;
+  func.calls = func.calls || [];
+  return func;
+}
+
+// ===================================================================
+// DECLARATION IDENTITY
+// ===================================================================
+
+// Plain object each deserialized dialog/function was read from
+const declarationSources = new WeakMap<object, object>();
+// In-place edits recorded by markDeclarationChanged, per identity
+const declarationVersions = new WeakMap<object, number>();
+
+/**
+ * Object that stands for a declaration's content in caches: the plain object
+ * it was deserialized from, otherwise the declaration itself. A model whose
+ * unchanged entries keep their identity (structural sharing) therefore keeps
+ * them across repeated deserializations. Plain sources are treated as
+ * immutable.
+ */
+export function getDeclarationIdentity(declaration: object): object {
+  return declarationSources.get(declaration) ?? declaration;
+}
+
+/** Number of in-place changes recorded for a declaration */
+export function getDeclarationVersion(declaration: object): number {
+  return declarationVersions.get(getDeclarationIdentity(declaration)) ?? 0;
+}
+
+/**
+ * Record that a dialog or function was edited in place, so caches keyed by its
+ * identity (e.g. GeneratedCodeCache) regenerate it
+ */
+export function markDeclarationChanged(declaration: object): void {
+  const identity = getDeclarationIdentity(declaration);
+  declarationVersions.set(identity, (declarationVersions.get(identity) ?? 0) + 1);
+}
+
+// ===================================================================
+// WIRE FORMAT
+// ===================================================================
+
+export const SEMANTIC_WIRE_FORMAT = 'daedalus-semantic-model';
+export const SEMANTIC_WIRE_VERSION = 1;
+
+/**
+ * Compact, self-describing form of a semantic model for IPC, workers and
+ * caches. Actions and conditions are tuples tagged with an index into the
+ * type tables sent along, and dialogs reference functions by name instead
+ * of embedding them a second time.
+ */
+export interface SemanticModelWire {
+  format: typeof SEMANTIC_WIRE_FORMAT;
+  version: number;
+  actionTypes: string[];
+  conditionTypes: string[];
+  model: any;
+}
+
+export function isSemanticModelWire(value: any): value is SemanticModelWire {
+  return value !== null && typeof value === 'object' && value.format === SEMANTIC_WIRE_FORMAT;
+}
+
+export function encodeSemanticModel(model: SemanticModel): SemanticModelWire {
+  const functions: Record<string, any> = {};
+  for (const funcName in model.functions) {
+    const func = model.functions[funcName];
+    functions[funcName] = {
+      ...func,
+      actions: Array.isArray(func.actions) ? func.actions.map(encodeAction) : [],
+      conditions: Array.isArray(func.conditions) ? func.conditions.map(encodeCondition) : []
+    };
+  }
+
+  const dialogs: Record<string, any> = {};
+  for (const dialogName in model.dialogs) {
+    const dialog = model.dialogs[dialogName];
+    const properties: Record<string, any> = {};
+    for (const key in dialog.properties) {
+      const value = dialog.properties[key];
+      properties[key] = value !== null && typeof value === 'object' && 'name' in value && 'returnType' in value
+        ? { name: value.name, returnType: value.returnType }
+        : value;
+    }
+    dialogs[dialogName] = { ...dialog, properties };
+  }
+
+  return {
+    format: SEMANTIC_WIRE_FORMAT,
+    version: SEMANTIC_WIRE_VERSION,
+    actionTypes: ACTION_TYPES.map((schema) => schema.name),
+    conditionTypes: CONDITION_TYPES.map((schema) => schema.name),
+    model: { ...model, functions, dialogs }
+  };
+}
+
+function resolveWireTypes(names: string[], byName: Map<string, CompiledType>, kind: string): CompiledType[] {
+  return names.map((name) => {
+    const compiled = byName.get(name);
+    if (!compiled) {
+      throw new Error(`Unknown ${kind} type '${name}' in serialized semantic model`);
+    }
+    return compiled;
+  });
+}
+
+export function decodeSemanticModel(wire: SemanticModelWire): SemanticModel {
+  if (!isSemanticModelWire(wire)) {
+    throw new Error('Not a serialized semantic model');
+  }
+  if (wire.version !== SEMANTIC_WIRE_VERSION) {
+    throw new Error(`Unsupported semantic model wire version ${wire.version} (expected ${SEMANTIC_WIRE_VERSION})`);
+  }
+
+  const actionTable = resolveWireTypes(wire.actionTypes, actionsByName, 'action');
+  const conditionTable = resolveWireTypes(wire.conditionTypes, conditionsByName, 'condition');
+  const decodeAction: ActionDecoder = (item) => (Array.isArray(item) ? actionTable[item[0]].fromWire(item, decodeAction) : item);
+  const decodeCondition = (item: any) => (Array.isArray(item) ? conditionTable[item[0]].fromWire(item, decodeAction) : item);
+
+  return buildSemanticModel(wire.model, (funcJson) => readFunction(
+    funcJson,
+    Array.isArray(funcJson.actions) ? funcJson.actions.map(decodeAction) : [],
+    Array.isArray(funcJson.conditions) ? funcJson.conditions.map(decodeCondition) : []
+  ));
+}
+
+// Helper to deserialize full semantic model; accepts plain JSON or the wire format
 export function deserializeSemanticModel(json: any): SemanticModel {
+  if (isSemanticModelWire(json)) {
+    return decodeSemanticModel(json);
+  }
+  return buildSemanticModel(json, (funcJson) => readFunction(
+    funcJson,
+    Array.isArray(funcJson.actions) ? funcJson.actions.map(readAction) : [],
+    Array.isArray(funcJson.conditions) ? funcJson.conditions.map(readCondition) : []
+  ));
+}
+
+function buildSemanticModel(json: any, readFunctionJson: (funcJson: any) => DialogFunction): SemanticModel {
   const model: SemanticModel = {
     dialogs: {},
     functions: {},
@@ -1368,65 +1694,39 @@ export function deserializeSemanticModel(json: any): SemanticModel {
   // 1. Reconstruct functions first
   for (const funcName in json.functions) {
     const funcJson = json.functions[funcName];
-
-    // Ensure types are present in actions and conditions for class-transformer
-    if (funcJson.actions) {
-        funcJson.actions.forEach((a: any) => ensureActionType(a));
-    }
-    if (funcJson.conditions) {
-        funcJson.conditions.forEach((c: any) => ensureConditionType(c));
-    }
-
-    model.functions[funcName] = plainToInstance(DialogFunction as ClassConstructor<any>, funcJson);
-    model.functions[funcName].actions = (model.functions[funcName].actions || []).map((action: any) => deserializeAction(action));
-    model.functions[funcName].calls = funcJson.calls || [];
+    const func = readFunctionJson(funcJson);
+    declarationSources.set(func, getDeclarationIdentity(funcJson));
+    model.functions[funcName] = func;
   }
 
   // 2. Reconstruct dialogs and link to functions
   for (const dialogName in json.dialogs) {
-    model.dialogs[dialogName] = Dialog.fromJSON(json.dialogs[dialogName], model.functions);
+    const dialogJson = json.dialogs[dialogName];
+    const dialog = Dialog.fromJSON(dialogJson, model.functions);
+    declarationSources.set(dialog, getDeclarationIdentity(dialogJson));
+    model.dialogs[dialogName] = dialog;
   }
 
-  // 3. Reconstruct constants
-  if (json.constants) {
-    for (const key in json.constants) {
-      model.constants![key] = plainToInstance(GlobalConstant as ClassConstructor<any>, json.constants[key]);
-    }
+  // 3. Reconstruct constants and variables
+  for (const key in json.constants) {
+    model.constants![key] = compiledConstant.fromPlain(json.constants[key]);
   }
-
-  // 4. Reconstruct variables
-  if (json.variables) {
-    for (const key in json.variables) {
-      model.variables![key] = plainToInstance(GlobalVariable as ClassConstructor<any>, json.variables[key]);
-    }
+  for (const key in json.variables) {
+    model.variables![key] = compiledVariable.fromPlain(json.variables[key]);
   }
 
-  // 5. Reconstruct instances
-  if (json.instances) {
-    for (const key in json.instances) {
-      model.instances![key] = plainToInstance(GlobalInstance as ClassConstructor<any>, json.instances[key]);
-    }
+  // 4. Reconstruct instances, items, npcs and animations
+  for (const key in json.instances) {
+    model.instances![key] = compiledInstance.fromPlain(json.instances[key]);
   }
-
-  // 6. Reconstruct items
-  if (json.items) {
-    for (const key in json.items) {
-      model.items![key] = plainToInstance(GlobalInstance as ClassConstructor<any>, json.items[key]);
-    }
+  for (const key in json.items) {
+    model.items![key] = compiledInstance.fromPlain(json.items[key]);
   }
-
-  // 7. Reconstruct npcs
-  if (json.npcs) {
-    for (const key in json.npcs) {
-      model.npcs![key] = plainToInstance(GlobalInstance as ClassConstructor<any>, json.npcs[key]);
-    }
+  for (const key in json.npcs) {
+    model.npcs![key] = compiledInstance.fromPlain(json.npcs[key]);
   }
-
-  // 8. Reconstruct animations
-  if (json.animations) {
-    for (const key in json.animations) {
-      model.animations![key] = plainToInstance(GlobalInstance as ClassConstructor<any>, json.animations[key]);
-    }
+  for (const key in json.animations) {
+    model.animations![key] = compiledInstance.fromPlain(json.animations[key]);
   }
 
   // Backward compatibility: derive categorized maps from instances when missing
@@ -13,7 +13,7 @@ export { ConditionParsers } from './parsers/condition-parsers';
 export { SemanticModelBuilderVisitor } from './semantic-visitor';
 
 // Export the code generator
-export { SemanticCodeGenerator, CodeGeneratorOptions } from '../codegen/generator';
+export { SemanticCodeGenerator, CodeGeneratorOptions, GeneratedCodeCache } from '../codegen/generator';
 
 // Export parser utilities
 export { createDaedalusParser, parseDaedalusSource, parseSemanticModel, validateDaedalusFile } from '../utils/parser-utils';
\ No newline at end of file
@@ -7,6 +7,7 @@ import {
 import { ErrorVisitor } from './visitors/error-visitor';
 import { DeclarationVisitor } from './visitors/declaration-visitor';
 import { LinkingVisitor } from './visitors/linking-visitor';
+import { traceSpan } from '../core/tracing';
 
 export class SemanticModelBuilderVisitor {
   public semanticModel: SemanticModel;
@@ -32,7 +33,7 @@ export class SemanticModelBuilderVisitor {
    */
   checkForSyntaxErrors(node: TreeSitterNode, sourceCode?: string): void {
     const errorVisitor = new ErrorVisitor(this.semanticModel);
-    errorVisitor.checkForSyntaxErrors(node, sourceCode);
+    traceSpan('semantic.ErrorVisitor', () => errorVisitor.checkForSyntaxErrors(node, sourceCode));
   }
 
   // ===================================================================
@@ -44,7 +45,7 @@ export class SemanticModelBuilderVisitor {
    */
   pass1_createObjects(node: TreeSitterNode): void {
     const declarationVisitor = new DeclarationVisitor(this.semanticModel, this.functionNameMap);
-    declarationVisitor.visit(node);
+    traceSpan('semantic.DeclarationVisitor', () => declarationVisitor.visit(node));
   }
 
   // ===================================================================
@@ -56,6 +57,6 @@ export class SemanticModelBuilderVisitor {
    */
   pass2_analyzeAndLink(node: TreeSitterNode): void {
     const linkingVisitor = new LinkingVisitor(this.semanticModel, this.functionNameMap);
-    linkingVisitor.visit(node);
+    traceSpan('semantic.LinkingVisitor', () => linkingVisitor.visit(node));
   }
 }
@@ -16,21 +16,41 @@ export class ErrorVisitor {
    */
   checkForSyntaxErrors(node: TreeSitterNode, sourceCode?: string): void {
     const cursor = node.walk();
-    this.checkForSyntaxErrorsRecursively(cursor, sourceCode);
+    this.checkForSyntaxErrorsIteratively(cursor, sourceCode);
   }
 
-  private checkForSyntaxErrorsRecursively(cursor: TreeCursor, sourceCode?: string): void {
-    const node = cursor.currentNode;
+  /**
+   * Pre-order walk with the cursor instead of recursion, so long else-if chains and
+   * deeply nested expressions cannot overflow the JS stack
+   */
+  private checkForSyntaxErrorsIteratively(cursor: TreeCursor, sourceCode?: string): void {
+    let depth = 0;
 
-    // Optimization: Skip subtrees that don't contain errors
-    if (!node.hasError) {
-      return;
-    }
+    while (true) {
+      const node = cursor.currentNode;
+
+      // Optimization: Skip subtrees that don't contain errors
+      if (node.hasError) {
+        this.semanticModel.hasErrors = true;
+        this.recordError(node, sourceCode);
+
+        if (cursor.gotoFirstChild()) {
+          depth += 1;
+          continue;
+        }
+      }
 
-    if (node.hasError) {
-      this.semanticModel.hasErrors = true;
+      while (depth > 0 && !cursor.gotoNextSibling()) {
+        cursor.gotoParent();
+        depth -= 1;
+      }
+      if (depth === 0) {
+        return;
+      }
     }
+  }
 
+  private recordError(node: TreeSitterNode, sourceCode?: string): void {
     if (node.type === 'ERROR') {
       if (!this.semanticModel.errors) {
         this.semanticModel.errors = [];
@@ -62,12 +82,5 @@ export class ErrorVisitor {
         text: ''
       });
     }
-
-    if (cursor.gotoFirstChild()) {
-      do {
-        this.checkForSyntaxErrorsRecursively(cursor, sourceCode);
-      } while (cursor.gotoNextSibling());
-      cursor.gotoParent();
-    }
   }
 }
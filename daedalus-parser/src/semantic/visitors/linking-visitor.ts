@@ -21,6 +21,28 @@ import {
 } from '../parsers/ast-constants';
 import { parseLiteralOrIdentifier } from '../parsers/literal-parsing';
 
+/**
+ * One node on the path from the analyzed declaration down to the node being visited.
+ * Ancestor questions are answered from these frames instead of walking `node.parent`,
+ * which tree-sitter resolves by descending from the root again (O(depth) per step).
+ */
+interface NodeFrame {
+  node: TreeSitterNode;
+  type: string;
+  parent: NodeFrame | null;
+  /** Operator of a binary_expression, otherwise null */
+  binaryOperator: string | null;
+  /** Extent of an if_statement's condition or a call_expression's arguments */
+  fieldRange: { startIndex: number; endIndex: number } | null;
+  /** The node itself or its nearest ancestor that is a statement directly in a function body */
+  topLevelStatement: TreeSitterNode | null;
+  // Ancestor facts up to the nearest traversal boundary (if_statement, block, function_declaration)
+  comparisonBinaryAncestor: boolean;
+  nonLogicalBinaryAncestor: boolean;
+  callArgumentAncestor: boolean;
+  insideIfCondition: boolean;
+}
+
 export class LinkingVisitor {
   private dialogs: SemanticModel['dialogs'];
   private functions: SemanticModel['functions'];
@@ -56,7 +78,7 @@ export class LinkingVisitor {
         do {
           const child = cursor.currentNode;
           if (child.type === 'function_declaration' || child.type === 'instance_declaration') {
-            this.analyzeNodeRecursively(cursor);
+            this.analyzeDeclaration(cursor);
           }
         } while (cursor.gotoNextSibling());
         cursor.gotoParent();
@@ -64,30 +86,96 @@ export class LinkingVisitor {
       return;
     }
 
-    this.analyzeNodeRecursively(cursor);
+    this.analyzeDeclaration(cursor);
+  }
+
+  /**
+   * Walk the subtree under the cursor in document order without recursion, so deeply
+   * nested conditions or long else-if chains cannot overflow the stack. The cursor is
+   * back on the subtree root when this returns.
+   */
+  private analyzeDeclaration(cursor: TreeCursor): void {
+    let frame = this.createFrame(cursor.currentNode, cursor.nodeType, null);
+
+    while (true) {
+      if (this.enterNode(frame) && cursor.gotoFirstChild()) {
+        frame = this.createFrame(cursor.currentNode, cursor.nodeType, frame);
+        continue;
+      }
+
+      // Leave finished nodes until one has an unvisited sibling
+      this.leaveDeclarationContext(frame.type);
+      let parent = frame.parent;
+      while (parent && !cursor.gotoNextSibling()) {
+        cursor.gotoParent();
+        this.leaveDeclarationContext(parent.type);
+        parent = parent.parent;
+      }
+      if (!parent) {
+        return;
+      }
+      frame = this.createFrame(cursor.currentNode, cursor.nodeType, parent);
+    }
   }
 
-  private analyzeNodeRecursively(cursor: TreeCursor): void {
-    const type = cursor.nodeType;
-    const node = cursor.currentNode;
+  /**
+   * @returns Whether the node's children should be visited
+   */
+  private enterNode(frame: NodeFrame): boolean {
+    this.enterDeclarationContext(frame.type, frame.node);
+
+    if (this.shouldSkipChildren(frame)) {
+      return false;
+    }
+
+    this.handleStatementNode(frame);
+    this.handleConditionNode(frame);
+    return true;
+  }
 
-    this.enterDeclarationContext(type, node);
+  private createFrame(node: TreeSitterNode, type: string, parent: NodeFrame | null): NodeFrame {
+    let fieldRange: NodeFrame['fieldRange'] = null;
+    if (type === 'if_statement') {
+      fieldRange = node.childForFieldName('condition');
+    } else if (type === 'call_expression') {
+      fieldRange = node.childForFieldName('arguments');
+    }
 
-    const skipChildren = this.shouldSkipChildren(type, node);
+    const frame: NodeFrame = {
+      node,
+      type,
+      parent,
+      binaryOperator: type === 'binary_expression' ? getBinaryOperator(node) : null,
+      fieldRange: fieldRange && { startIndex: fieldRange.startIndex, endIndex: fieldRange.endIndex },
+      topLevelStatement: null,
+      comparisonBinaryAncestor: false,
+      nonLogicalBinaryAncestor: false,
+      callArgumentAncestor: false,
+      insideIfCondition: false
+    };
 
-    if (!skipChildren) {
-      this.handleStatementNode(type, node);
-      this.handleConditionNode(type, node);
+    if (!parent) {
+      return frame;
     }
 
-    if (!skipChildren && cursor.gotoFirstChild()) {
-      do {
-        this.analyzeNodeRecursively(cursor);
-      } while (cursor.gotoNextSibling());
-      cursor.gotoParent();
+    frame.topLevelStatement = this.isTopLevelStatement(frame) ? node : parent.topLevelStatement;
+
+    const inherit = !this.isAncestorTraversalBoundary(parent.type);
+    const parentIsBinary = parent.type === 'binary_expression';
+    frame.comparisonBinaryAncestor = (parentIsBinary && isComparisonOperator(parent.binaryOperator))
+      || (inherit && parent.comparisonBinaryAncestor);
+    frame.nonLogicalBinaryAncestor = (parentIsBinary && !isLogicalOperator(parent.binaryOperator))
+      || (inherit && parent.nonLogicalBinaryAncestor);
+    frame.callArgumentAncestor = (parent.type === 'call_expression' && this.nodeIsWithin(node, parent.fieldRange))
+      || (inherit && parent.callArgumentAncestor);
+
+    if (parent.type === 'if_statement') {
+      frame.insideIfCondition = this.nodeIsWithin(node, parent.fieldRange);
+    } else if (parent.type !== 'block' && parent.type !== 'function_declaration') {
+      frame.insideIfCondition = parent.insideIfCondition;
     }
 
-    this.leaveDeclarationContext(type);
+    return frame;
   }
 
   private enterDeclarationContext(type: string, node: TreeSitterNode): void {
@@ -121,14 +209,15 @@ export class LinkingVisitor {
     }
   }
 
-  private shouldSkipChildren(type: string, node: TreeSitterNode): boolean {
+  private shouldSkipChildren(frame: NodeFrame): boolean {
+    const { type, node } = frame;
     const isConditionFunc = this.isCurrentConditionFunction();
     const currentFunctionName = this.currentFunction?.name;
 
     if (isConditionFunc && currentFunctionName) {
       if (this.conditionRawMode.has(currentFunctionName)) {
-        if (this.isTopLevelStatement(node)) {
-          this.preserveConditionStatement(node);
+        if (this.isTopLevelStatement(frame)) {
+          this.preserveConditionStatement(frame);
         }
         return true;
       }
@@ -136,16 +225,16 @@ export class LinkingVisitor {
       if (type === 'if_statement') {
         const alternative = node.childForFieldName('alternative');
         if (alternative) {
-          this.triggerConditionRawMode(node);
+          this.triggerConditionRawMode(frame);
           return true;
         }
       }
 
-      if (type === 'return_statement' && this.isTopLevelStatement(node)) {
+      if (type === 'return_statement' && this.isTopLevelStatement(frame)) {
         if (this.isTrivialTopLevelTrueReturn(node)) {
           return true;
         }
-        this.triggerConditionRawMode(node);
+        this.triggerConditionRawMode(frame);
         return true;
       }
     }
@@ -168,29 +257,29 @@ export class LinkingVisitor {
     return false;
   }
 
-  private handleStatementNode(type: string, node: TreeSitterNode): void {
-    if (type === 'assignment_statement') {
+  private handleStatementNode(frame: NodeFrame): void {
+    if (frame.type === 'assignment_statement') {
       if (this.currentInstance) {
-        this.processAssignment(node);
+        this.processAssignment(frame.node);
       } else if (this.currentFunction) {
-        this.processFunctionAssignment(node);
+        this.processFunctionAssignment(frame);
       }
       return;
     }
 
-    if (type === 'call_expression' && this.currentFunction) {
-      this.processFunctionCall(node);
+    if (frame.type === 'call_expression' && this.currentFunction) {
+      this.processFunctionCall(frame);
     }
   }
 
-  private handleConditionNode(type: string, node: TreeSitterNode): void {
+  private handleConditionNode(frame: NodeFrame): void {
+    const { type, node } = frame;
     if (!this.isCurrentConditionFunction() || !this.currentFunction) {
       return;
     }
 
     if (type === 'binary_expression') {
-      const operator = getBinaryOperator(node);
-      if (isComparisonOperator(operator) && !this.hasComparisonBinaryAncestor(node)) {
+      if (isComparisonOperator(frame.binaryOperator) && !this.hasComparisonBinaryAncestor(frame)) {
         this.processCondition(node);
       }
       return;
@@ -200,17 +289,16 @@ export class LinkingVisitor {
       return;
     }
 
-    const parent = node.parent;
+    const parent = frame.parent;
     if (!parent) return;
 
     if (type === 'identifier' && parent.type === 'unary_expression') return;
-    if (this.hasNonLogicalBinaryAncestor(node)) return;
+    if (this.hasNonLogicalBinaryAncestor(frame)) return;
 
     let isAllowed = isConditionAllowedParentType(parent.type);
 
     if (parent.type === 'binary_expression') {
-      const operator = getBinaryOperator(parent);
-      if (!isComparisonOperator(operator)) {
+      if (!isComparisonOperator(parent.binaryOperator)) {
         isAllowed = true;
       }
     }
@@ -304,9 +392,10 @@ export class LinkingVisitor {
   /**
    * Process assignment statements in function bodies (variable updates)
    */
-  private processFunctionAssignment(node: TreeSitterNode): void {
+  private processFunctionAssignment(frame: NodeFrame): void {
     if (!this.currentFunction) return;
 
+    const { node } = frame;
     const leftNode = node.childForFieldName('left');
     const rightNode = node.childForFieldName('right');
     const operatorNode = node.childForFieldName('operator');
@@ -319,7 +408,7 @@ export class LinkingVisitor {
       const action = new SetVariableAction(variableName, operator, value);
 
       if (this.isCurrentConditionFunction()) {
-        this.triggerConditionRawMode(node);
+        this.triggerConditionRawMode(frame);
         return;
       }
 
@@ -330,7 +419,8 @@ export class LinkingVisitor {
   /**
    * Process function calls in function bodies
    */
-  private processFunctionCall(node: TreeSitterNode): void {
+  private processFunctionCall(frame: NodeFrame): void {
+    const { node } = frame;
     const funcToCallNode = node.childForFieldName('function');
     if (!funcToCallNode || !this.currentFunction) {
       return;
@@ -344,16 +434,16 @@ export class LinkingVisitor {
         return;
       }
 
-      if (this.isNegatedCallHandledByUnaryCondition(node, functionName)) {
+      if (this.isNegatedCallHandledByUnaryCondition(frame, functionName)) {
         return;
       }
 
-      if (!this.isCallInsideIfCondition(node)) {
-        this.triggerConditionRawMode(node);
+      if (!this.isCallInsideIfCondition(frame)) {
+        this.triggerConditionRawMode(frame);
         return;
       }
 
-      if (this.isCallInsideComparisonBinary(node) || this.isNestedCallArgument(node)) {
+      if (this.isCallInsideComparisonBinary(frame) || this.isNestedCallArgument(frame)) {
         return;
       }
 
@@ -361,7 +451,7 @@ export class LinkingVisitor {
       return;
     }
 
-    if (!this.isTopLevelCallStatement(node)) {
+    if (!this.isTopLevelCallStatement(frame)) {
       return;
     }
 
@@ -397,19 +487,19 @@ export class LinkingVisitor {
     return !!this.currentFunction && this.conditionFunctions.has(this.currentFunction.name);
   }
 
-  private isTopLevelStatement(node: TreeSitterNode): boolean {
-    if (!node.type.endsWith('_statement')) {
+  private isTopLevelStatement(frame: NodeFrame): boolean {
+    if (!frame.type.endsWith('_statement')) {
       return false;
     }
-    const parent = node.parent;
+    const parent = frame.parent;
     if (!parent || parent.type !== 'block') return false;
     const grandParent = parent.parent;
     return !!grandParent && grandParent.type === 'function_declaration';
   }
 
-  private preserveConditionStatement(node: TreeSitterNode): void {
+  private preserveConditionStatement(frame: NodeFrame): void {
     if (!this.currentFunction) return;
-    const topLevel = this.getTopLevelStatement(node) || node;
+    const topLevel = frame.topLevelStatement || frame.node;
     const rangeKey = `${topLevel.startIndex}:${topLevel.endIndex}`;
     const funcName = this.currentFunction.name;
     let ranges = this.preservedStatementRanges.get(funcName);
@@ -424,23 +514,14 @@ export class LinkingVisitor {
     this.recordActionForCurrentFunction(action);
   }
 
-  private getTopLevelStatement(node: TreeSitterNode): TreeSitterNode | null {
-    let current: TreeSitterNode | null = node;
-    while (current && current.parent) {
-      if (this.isTopLevelStatement(current)) return current;
-      current = current.parent;
-    }
-    return null;
-  }
-
-  private triggerConditionRawMode(node: TreeSitterNode): void {
+  private triggerConditionRawMode(frame: NodeFrame): void {
     if (!this.currentFunction) return;
     const funcName = this.currentFunction.name;
     if (!this.conditionRawMode.has(funcName)) {
       this.conditionRawMode.add(funcName);
       this.currentFunction.conditions = [];
     }
-    this.preserveConditionStatement(node);
+    this.preserveConditionStatement(frame);
   }
 
   private isTrivialTopLevelTrueReturn(node: TreeSitterNode): boolean {
@@ -457,89 +538,36 @@ export class LinkingVisitor {
     return text === 'RETURN TRUE;' || text === 'RETURN 1;';
   }
 
-  private isCallInsideIfCondition(node: TreeSitterNode): boolean {
-    let current: TreeSitterNode | null = node;
-    while (current && current.parent) {
-      const parent = current.parent;
-      if (parent.type === 'if_statement') {
-        const cond = parent.childForFieldName('condition');
-        return !!cond && this.nodeIsWithin(node, cond);
-      }
-      if (parent.type === 'block' || parent.type === 'function_declaration') {
-        return false;
-      }
-      current = parent;
-    }
-    return false;
-  }
-
-  private isCallInsideComparisonBinary(node: TreeSitterNode): boolean {
-    return this.hasAncestor(node, (ancestor) => {
-      if (ancestor.type !== 'binary_expression') {
-        return false;
-      }
-      const operator = getBinaryOperator(ancestor);
-      return isComparisonOperator(operator);
-    });
+  private isCallInsideIfCondition(frame: NodeFrame): boolean {
+    return frame.insideIfCondition;
   }
 
-  private hasNonLogicalBinaryAncestor(node: TreeSitterNode): boolean {
-    return this.hasAncestor(node, (ancestor) => {
-      if (ancestor.type !== 'binary_expression') {
-        return false;
-      }
-      const operator = getBinaryOperator(ancestor);
-      return !isLogicalOperator(operator);
-    });
+  private isCallInsideComparisonBinary(frame: NodeFrame): boolean {
+    return frame.comparisonBinaryAncestor;
   }
 
-  private hasComparisonBinaryAncestor(node: TreeSitterNode): boolean {
-    return this.hasAncestor(node, (ancestor) => {
-      if (ancestor.type !== 'binary_expression') {
-        return false;
-      }
-      const operator = getBinaryOperator(ancestor);
-      return isComparisonOperator(operator);
-    });
+  private hasNonLogicalBinaryAncestor(frame: NodeFrame): boolean {
+    return frame.nonLogicalBinaryAncestor;
   }
 
-  private isNestedCallArgument(node: TreeSitterNode): boolean {
-    return this.hasAncestor(node, (ancestor) => {
-      if (ancestor.type !== 'call_expression') {
-        return false;
-      }
-      const args = ancestor.childForFieldName('arguments');
-      return !!args && this.nodeIsWithin(node, args);
-    });
+  private hasComparisonBinaryAncestor(frame: NodeFrame): boolean {
+    return frame.comparisonBinaryAncestor;
   }
 
-  private hasAncestor(node: TreeSitterNode, predicate: (ancestor: TreeSitterNode) => boolean): boolean {
-    let current: TreeSitterNode | null = node.parent;
-    while (current) {
-      if (predicate(current)) {
-        return true;
-      }
-
-      if (this.isAncestorTraversalBoundary(current)) {
-        break;
-      }
-
-      current = current.parent;
-    }
-
-    return false;
+  private isNestedCallArgument(frame: NodeFrame): boolean {
+    return frame.callArgumentAncestor;
   }
 
-  private isAncestorTraversalBoundary(node: TreeSitterNode): boolean {
-    return isAncestorTraversalBoundaryType(node.type);
+  private isAncestorTraversalBoundary(nodeType: string): boolean {
+    return isAncestorTraversalBoundaryType(nodeType);
   }
 
-  private nodeIsWithin(node: TreeSitterNode, container: TreeSitterNode): boolean {
-    return node.startIndex >= container.startIndex && node.endIndex <= container.endIndex;
+  private nodeIsWithin(node: TreeSitterNode, container: NodeFrame['fieldRange']): boolean {
+    return !!container && node.startIndex >= container.startIndex && node.endIndex <= container.endIndex;
   }
 
-  private isTopLevelCallStatement(node: TreeSitterNode): boolean {
-    const parent = node.parent;
+  private isTopLevelCallStatement(frame: NodeFrame): boolean {
+    const parent = frame.parent;
     if (!parent || parent.type !== 'expression_statement') {
       return false;
     }
@@ -547,17 +575,17 @@ export class LinkingVisitor {
     return !!grandParent && grandParent.type === 'block';
   }
 
-  private isNegatedCallHandledByUnaryCondition(node: TreeSitterNode, functionName: string): boolean {
+  private isNegatedCallHandledByUnaryCondition(frame: NodeFrame, functionName: string): boolean {
     if (functionName !== 'Npc_IsDead' && functionName !== 'Npc_IsInState') {
       return false;
     }
 
-    const parent = node.parent;
+    const parent = frame.parent;
     if (!parent || parent.type !== 'unary_expression') {
       return false;
     }
 
-    const operator = parent.child(0);
+    const operator = parent.node.child(0);
     return !!operator && operator.text === '!';
   }
 
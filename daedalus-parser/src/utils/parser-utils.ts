@@ -33,24 +33,26 @@ export function parseDaedalusSource(sourceCode: string): ParsedTree {
  * @returns Semantic model with error information if syntax errors exist
  */
 export function parseSemanticModel(sourceCode: string): SemanticModel {
-  const parseResult = DaedalusParser.parseSource(sourceCode);
-  const tree = parseResult.tree as ParsedTree;
+  // The model holds no tree nodes, so the tree is released as soon as it is built
+  return DaedalusParser.withParseResult(sourceCode, (parseResult) => {
+    const tree = parseResult.tree as ParsedTree;
 
-  const visitor = new SemanticModelBuilderVisitor();
+    const visitor = new SemanticModelBuilderVisitor();
 
-  // Check for syntax errors first
-  visitor.checkForSyntaxErrors(tree.rootNode, sourceCode);
+    // Check for syntax errors first
+    visitor.checkForSyntaxErrors(tree.rootNode, sourceCode);
 
-  // If there are syntax errors, return the model with errors
-  if (visitor.semanticModel.hasErrors) {
-    return visitor.semanticModel;
-  }
+    // If there are syntax errors, return the model with errors
+    if (visitor.semanticModel.hasErrors) {
+      return visitor.semanticModel;
+    }
 
-  // Otherwise, proceed with normal semantic analysis
-  visitor.pass1_createObjects(tree.rootNode);
-  visitor.pass2_analyzeAndLink(tree.rootNode);
+    // Otherwise, proceed with normal semantic analysis
+    visitor.pass1_createObjects(tree.rootNode);
+    visitor.pass2_analyzeAndLink(tree.rootNode);
 
-  return visitor.semanticModel;
+    return visitor.semanticModel;
+  });
 }
 
 /**
@@ -2,6 +2,8 @@ const { test } = require('node:test');
 const { strict: assert } = require('node:assert');
 const { spawnSync } = require('node:child_process');
 const path = require('node:path');
+const fs = require('node:fs');
+const os = require('node:os');
 
 const workspaceDir = path.resolve(__dirname, '..');
 
@@ -24,3 +26,31 @@ test('format CLI help succeeds', () => {
   assert.equal(result.status, 0, `format script failed: ${result.stderr || result.error?.message}`);
   assert.ok(result.stdout.includes('Usage:'), 'format help output should include usage text');
 });
+
+test('parse CLI batch mode streams NDJSON records and a summary', () => {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'daedalus-batch-'));
+  fs.mkdirSync(path.join(dir, 'nested'));
+  fs.writeFileSync(path.join(dir, 'Good.d'), 'instance Hero (C_NPC) { name = "Hero"; };\n');
+  fs.writeFileSync(path.join(dir, 'nested', 'Broken.d'), 'func void Broken() { var int x = ; };\n');
+  fs.writeFileSync(path.join(dir, 'notes.txt'), 'not daedalus');
+
+  const result = spawnSync(process.execPath, [path.join(workspaceDir, 'bin', 'daedalus-parse.js'), dir, '--jobs', '2'], {
+    encoding: 'utf8',
+    timeout: 120000
+  });
+
+  const records = result.stdout.trim().split('\n').map((line) => JSON.parse(line));
+  const fileRecords = records.filter((record) => record.type === 'file');
+  const summary = records[records.length - 1];
+
+  assert.equal(result.status, 1, 'Syntax errors should fail the batch');
+  assert.equal(fileRecords.length, 2);
+  assert.deepEqual(fileRecords.map((record) => path.basename(record.file)).sort(), ['Broken.d', 'Good.d']);
+  assert.equal(fileRecords.find((record) => record.file.endsWith('Good.d')).declarations[0].name, 'Hero');
+  assert.ok(fileRecords.find((record) => record.file.endsWith('Broken.d')).errors.length > 0);
+  assert.equal(summary.type, 'summary');
+  assert.equal(summary.ok, 1);
+  assert.equal(summary.error, 1);
+  assert.ok(summary.latency.p99 >= summary.latency.p50);
+  assert.ok(summary.peakRssBytes > 0);
+});
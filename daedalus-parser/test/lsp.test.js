@@ -0,0 +1,199 @@
+const { test } = require('node:test');
+const { strict: assert } = require('node:assert');
+const { spawn } = require('node:child_process');
+const fs = require('node:fs');
+const os = require('node:os');
+const path = require('node:path');
+const { pathToFileURL } = require('node:url');
+const { MessageReader, MessageWriter } = require('../src/lsp/json-rpc');
+
+const serverPath = path.resolve(__dirname, '..', 'bin', 'daedalus-lsp.js');
+
+const QUESTS_SOURCE = `const string TOPIC_Trade = "Trade";
+var int MIS_Trade;
+
+instance Merchant (C_NPC)
+{
+    name = "Merchant";
+};
+`;
+
+const DIALOG_SOURCE = `instance DIA_Merchant_Hello (C_INFO)
+{
+    npc = Merchant;
+    information = DIA_Merchant_Hello_Info;
+};
+
+func void DIA_Merchant_Hello_Info()
+{
+    MIS_Trade = 1;
+    Log_CreateTopic(TOPIC_Trade, LOG_MISSION);
+};
+`;
+
+/**
+ * Minimal scripted LSP client talking to the server over its stdio
+ */
+class ScriptedClient {
+  constructor(child) {
+    this.child = child;
+    this.writer = new MessageWriter(child.stdin);
+    this.nextId = 1;
+    this.pending = new Map();
+    this.notifications = [];
+    this.waiters = [];
+    new MessageReader(child.stdout, (message) => this.receive(message), (error) => {
+      throw error;
+    });
+  }
+
+  receive(message) {
+    if (message.id !== undefined && this.pending.has(message.id)) {
+      const { resolve, reject } = this.pending.get(message.id);
+      this.pending.delete(message.id);
+      if (message.error) {
+        reject(Object.assign(new Error(message.error.message), { code: message.error.code }));
+      } else {
+        resolve(message.result);
+      }
+      return;
+    }
+    this.notifications.push(message);
+    this.waiters = this.waiters.filter((waiter) => !waiter(message));
+  }
+
+  request(method, params) {
+    const id = this.nextId++;
+    return new Promise((resolve, reject) => {
+      this.pending.set(id, { resolve, reject });
+      this.writer.write({ id, method, params });
+    });
+  }
+
+  notify(method, params) {
+    this.writer.write({ method, params });
+  }
+
+  /** Resolve with the next notification matching `predicate` */
+  waitFor(method, predicate = () => true) {
+    return new Promise((resolve) => {
+      this.waiters.push((message) => {
+        if (message.method === method && predicate(message.params)) {
+          resolve(message.params);
+          return true;
+        }
+        return false;
+      });
+    });
+  }
+}
+
+function positionOf(source, needle, offset = 0) {
+  const index = source.indexOf(needle) + offset;
+  const before = source.slice(0, index).split('\n');
+  return { line: before.length - 1, character: before[before.length - 1].length };
+}
+
+test('daedalus-lsp serves a scripted session over stdio', async () => {
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'daedalus-lsp-'));
+  fs.writeFileSync(path.join(dir, 'Quests.d'), QUESTS_SOURCE);
+  fs.writeFileSync(path.join(dir, 'DIA_Merchant.d'), DIALOG_SOURCE);
+  const questsUri = pathToFileURL(path.join(dir, 'Quests.d')).href;
+  const dialogUri = pathToFileURL(path.join(dir, 'DIA_Merchant.d')).href;
+
+  const child = spawn(process.execPath, [serverPath, '--stdio'], { stdio: ['pipe', 'pipe', 'inherit'] });
+  const exited = new Promise((resolve) => child.on('exit', resolve));
+  const client = new ScriptedClient(child);
+
+  try {
+    const init = await client.request('initialize', { processId: process.pid, rootUri: pathToFileURL(dir).href });
+    assert.equal(init.serverInfo.name, 'daedalus-lsp');
+    assert.equal(init.capabilities.textDocumentSync.change, 2);
+    assert.ok(init.capabilities.definitionProvider);
+
+    const indexed = client.waitFor('daedalus/indexed');
+    client.notify('initialized', {});
+    assert.equal((await indexed).files, 2);
+
+    const opened = client.waitFor('textDocument/publishDiagnostics', (params) => params.uri === dialogUri);
+    client.notify('textDocument/didOpen', {
+      textDocument: { uri: dialogUri, languageId: 'daedalus', version: 1, text: DIALOG_SOURCE }
+    });
+    assert.deepEqual((await opened).diagnostics, []);
+
+    // Definition across files, case-insensitively
+    const definitions = await client.request('textDocument/definition', {
+      textDocument: { uri: dialogUri },
+      position: positionOf(DIALOG_SOURCE, 'TOPIC_Trade', 3)
+    });
+    assert.deepEqual(definitions, [{ uri: questsUri, range: {
+      start: { line: 0, character: 13 },
+      end: { line: 0, character: 24 }
+    } }]);
+
+    // References with and without the declaration
+    const referenceParams = {
+      textDocument: { uri: dialogUri },
+      position: positionOf(DIALOG_SOURCE, 'MIS_Trade'),
+      context: { includeDeclaration: true }
+    };
+    const references = await client.request('textDocument/references', referenceParams);
+    assert.deepEqual(references.map((reference) => reference.uri).sort(), [dialogUri, questsUri].sort());
+    const usages = await client.request('textDocument/references', {
+      ...referenceParams,
+      context: { includeDeclaration: false }
+    });
+    assert.deepEqual(usages.map((reference) => reference.uri), [dialogUri]);
+
+    const symbols = await client.request('textDocument/documentSymbol', { textDocument: { uri: dialogUri } });
+    assert.deepEqual(symbols.map((symbol) => [symbol.name, symbol.kind]), [
+      ['DIA_Merchant_Hello', 24],
+      ['DIA_Merchant_Hello_Info', 12]
+    ]);
+
+    // Incremental edit: type a prefix on a new line, then complete it
+    const insertAt = positionOf(DIALOG_SOURCE, '    Log_CreateTopic');
+    const edited = client.waitFor('textDocument/publishDiagnostics', (params) => params.version === 2);
+    client.notify('textDocument/didChange', {
+      textDocument: { uri: dialogUri, version: 2 },
+      contentChanges: [{ range: { start: insertAt, end: insertAt }, text: '    mis_ = ;\n' }]
+    });
+    assert.ok((await edited).diagnostics.length > 0, 'An unfinished statement should be reported');
+
+    const completion = await client.request('textDocument/completion', {
+      textDocument: { uri: dialogUri },
+      position: { line: insertAt.line, character: 8 }
+    });
+    assert.deepEqual(completion.items.map((item) => item.label), ['MIS_Trade']);
+    assert.equal(completion.items[0].kind, 6);
+
+    // Undo the edit; the document is clean again
+    const reverted = client.waitFor('textDocument/publishDiagnostics', (params) => params.version === 3);
+    client.notify('textDocument/didChange', {
+      textDocument: { uri: dialogUri, version: 3 },
+      contentChanges: [{
+        range: { start: insertAt, end: { line: insertAt.line + 1, character: 0 } },
+        text: ''
+      }]
+    });
+    assert.deepEqual((await reverted).diagnostics, []);
+
+    const latencies = [];
+    for (let i = 0; i < 50; i++) {
+      const start = process.hrtime.bigint();
+      await client.request('textDocument/references', referenceParams);
+      latencies.push(Number(process.hrtime.bigint() - start) / 1_000_000);
+    }
+    latencies.sort((a, b) => a - b);
+    assert.ok(latencies[25] < 50, `Median reference latency ${latencies[25].toFixed(2)}ms should stay below 50ms`);
+
+    await assert.rejects(client.request('textDocument/hover', {}), (error) => error.code === -32601);
+
+    assert.equal(await client.request('shutdown'), null);
+    client.notify('exit');
+    assert.equal(await exited, 0);
+  } finally {
+    child.kill();
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+});
@@ -1,4 +1,4 @@
-const { test, describe } = require('node:test');
+const { test, describe, before } = require('node:test');
 const { strict: assert } = require('node:assert');
 const DaedalusParser = require('../src/core/parser');
 const fs = require('fs');
@@ -447,4 +447,110 @@ Prototype SpecialWeapon(BasicItem)
     const result = parser.parse(source);
     assert.equal(result.hasErrors, false, 'Should parse comparison binary expressions without errors');
   });
+
+  test('should stop a parse whose cancellation check fires', () => {
+    const source = 'func void Big() { var int x; };\n'.repeat(2000);
+
+    assert.throws(
+      () => parser.parse(source, { shouldCancel: () => true }),
+      (error) => error.code === 'PARSE_CANCELLED'
+    );
+
+    // The parser is reusable after an aborted parse
+    const result = parser.parse(source, { shouldCancel: () => false, timeoutMicros: 60_000_000 });
+    assert.equal(result.hasErrors, false);
+    assert.equal(result.rootNode.namedChildCount, 2000);
+  });
+
+  describe('bounded parsing', () => {
+    // Large enough to need many 1µs slices; mixes declarations so a bad resume shows in the tree
+    const source = Array.from({ length: 1500 }, (_, i) => [
+      `func int Check_${i}() { if (Npc_KnowsInfo (other, DIA_${i}) && (x_${i} > ${i})) { return TRUE; }; return FALSE; };`,
+      `instance DIA_${i} (C_INFO) { npc = PC_${i}; nr = ${i}; description = "Line ${i}"; };`
+    ].join('\n')).join('\n');
+    let reference;
+
+    before(() => {
+      reference = parser.parse(source).rootNode.toString();
+    });
+
+    test('resumes timed-out slices into the same tree', () => {
+      let slices = 0;
+      const result = parser.parse(source, {
+        sliceMicros: 1,
+        shouldCancel: () => {
+          slices += 1;
+          return false;
+        }
+      });
+
+      assert.ok(slices > 1, `expected the parse to take several slices, took ${slices}`);
+      assert.equal(result.hasErrors, false);
+      assert.equal(result.rootNode.toString(), reference);
+    });
+
+    test('throws PARSE_TIMEOUT once the budget is spent and stays reusable', () => {
+      assert.throws(
+        () => parser.parse(source, { timeoutMicros: 1 }),
+        (error) => error.code === 'PARSE_TIMEOUT'
+      );
+      // The timed-out parse must not leak into the next one
+      assert.equal(parser.parse(source).rootNode.toString(), reference);
+    });
+
+    test('cancels between slices and starts the next parse fresh', () => {
+      const cancelAfter = 3;
+      let checks = 0;
+      assert.throws(
+        () => parser.parse(source, {
+          sliceMicros: 1,
+          shouldCancel: () => {
+            checks += 1;
+            return checks >= cancelAfter;
+          }
+        }),
+        (error) => error.code === 'PARSE_CANCELLED'
+      );
+      assert.equal(checks, cancelAfter, 'should stop at the first check that asks to cancel');
+
+      const other = 'func void Other() {};';
+      const result = parser.parse(other, { sliceMicros: 1, shouldCancel: () => false });
+      assert.equal(result.rootNode.toString(), parser.parse(other).rootNode.toString());
+      assert.equal(parser.parse(source).rootNode.toString(), reference);
+    });
+  });
+
+  test('should reuse pooled parsers for static parses', () => {
+    const pooled = DaedalusParser.acquire();
+    DaedalusParser.release(pooled);
+    assert.equal(DaedalusParser.acquire(), pooled, 'Released parser should be handed out again');
+    DaedalusParser.release(pooled);
+
+    const result = DaedalusParser.parseSource('func void A() {};');
+    assert.equal(result.hasErrors, false);
+    assert.equal(DaedalusParser.acquire(), pooled, 'parseSource should return its parser to the pool');
+    DaedalusParser.release(pooled);
+
+    const childCount = DaedalusParser.withParseResult('func void B() {};', (parsed) => parsed.rootNode.namedChildCount);
+    assert.equal(childCount, 1);
+
+    DaedalusParser.disposeResult(result);
+    assert.equal(result.tree, null);
+    assert.equal(result.rootNode, null);
+  });
+
+  test('should count trees until their results are disposed', () => {
+    const before = DaedalusParser.liveTreeCount();
+    const result = DaedalusParser.parseSource('func void A() {};');
+    assert.equal(DaedalusParser.liveTreeCount(), before + 1);
+
+    DaedalusParser.disposeResult(result);
+    DaedalusParser.disposeResult(result);
+    assert.equal(DaedalusParser.liveTreeCount(), before);
+
+    DaedalusParser.withParseResult('func void B() {};', () => {
+      assert.equal(DaedalusParser.liveTreeCount(), before + 1);
+    });
+    assert.equal(DaedalusParser.liveTreeCount(), before);
+  });
 });
@@ -0,0 +1,149 @@
+const { test } = require('node:test');
+const { strict: assert } = require('node:assert');
+const {
+  ACTION_TYPES,
+  CONDITION_TYPES,
+  ConditionalAction,
+  Dialog,
+  DialogFunction,
+  GlobalConstant,
+  GlobalInstance,
+  GlobalVariable,
+  deserializeSemanticModel,
+  encodeSemanticModel
+} = require('../../dist/semantic/semantic-visitor-index');
+const { buildLargeModel } = require('../semantic-model-fixtures');
+
+let plainToInstance = null;
+try {
+  require('reflect-metadata');
+  ({ plainToInstance } = require('class-transformer'));
+} catch (_error) {
+  // Dev dependency; without it there is nothing to compare against
+}
+
+const actionClasses = new Map(ACTION_TYPES.map((schema) => [schema.name, schema.ctor]));
+const conditionClasses = new Map(CONDITION_TYPES.map((schema) => [schema.name, schema.ctor]));
+
+/**
+ * The class-transformer deserializer that the schema-compiled readers replaced:
+ * plainToInstance per function, action, condition and global, with nested
+ * ConditionalAction lists read recursively. The fixture carries every `type`
+ * tag, so the old type inference is left out.
+ */
+function legacyDeserialize(json) {
+  const readAction = (actionJson) => {
+    const ctor = actionClasses.get(actionJson.type);
+    if (!ctor) {
+      return actionJson;
+    }
+    const instance = plainToInstance(ctor, actionJson);
+    if (instance instanceof ConditionalAction) {
+      instance.thenActions = (actionJson.thenActions || []).map(readAction);
+      instance.elseActions = (actionJson.elseActions || []).map(readAction);
+    }
+    return instance;
+  };
+  const readCondition = (conditionJson) => plainToInstance(conditionClasses.get(conditionJson.type), conditionJson);
+
+  const model = {
+    dialogs: {},
+    functions: {},
+    declarationOrder: json.declarationOrder || [],
+    constants: {},
+    variables: {},
+    instances: {},
+    items: {},
+    npcs: {},
+    animations: {},
+    errors: json.errors,
+    hasErrors: json.hasErrors
+  };
+  for (const name in json.functions) {
+    const funcJson = json.functions[name];
+    const func = plainToInstance(DialogFunction, funcJson);
+    func.actions = (funcJson.actions || []).map(readAction);
+    func.conditions = (funcJson.conditions || []).map(readCondition);
+    func.calls = funcJson.calls || [];
+    model.functions[name] = func;
+  }
+  for (const name in json.dialogs) {
+    model.dialogs[name] = Dialog.fromJSON(json.dialogs[name], model.functions);
+  }
+  for (const name in json.constants) {
+    model.constants[name] = plainToInstance(GlobalConstant, json.constants[name]);
+  }
+  for (const name in json.variables) {
+    model.variables[name] = plainToInstance(GlobalVariable, json.variables[name]);
+  }
+  for (const name in json.instances) {
+    model.instances[name] = plainToInstance(GlobalInstance, json.instances[name]);
+  }
+  return model;
+}
+
+// Lower bound on the speedup over class-transformer; typical runs are well above it
+const MIN_SPEEDUP = 2;
+
+/** Fastest of a few runs, in milliseconds */
+function bestTime(fn, runs = 5) {
+  fn();
+  let best = Infinity;
+  for (let i = 0; i < runs; i += 1) {
+    const start = process.hrtime.bigint();
+    fn();
+    best = Math.min(best, Number(process.hrtime.bigint() - start) / 1_000_000);
+  }
+  return best;
+}
+
+test('deserializeSemanticModel beats the class-transformer deserializer it replaced', {
+  skip: !plainToInstance && 'class-transformer is not installed'
+}, (t) => {
+  // What IPC or postMessage delivers: plain objects from a structured clone
+  const plain = structuredClone(deserializeSemanticModel(buildLargeModel(2000)));
+
+  const legacy = legacyDeserialize(structuredClone(plain));
+  const current = deserializeSemanticModel(structuredClone(plain));
+  assert.deepEqual(
+    JSON.parse(JSON.stringify(current)),
+    JSON.parse(JSON.stringify(legacy)),
+    'both deserializers should rebuild the same model'
+  );
+  assert.strictEqual(current.dialogs.DIA_Bench_1999.properties.condition, current.functions.DIA_Bench_1999_Condition);
+
+  // Each run gets a fresh clone, as each IPC message does; cloning is not timed
+  const inputs = Array.from({ length: 12 }, () => structuredClone(plain));
+  const legacyMs = bestTime(() => legacyDeserialize(inputs.pop()));
+  const currentMs = bestTime(() => deserializeSemanticModel(inputs.pop()));
+  const speedup = legacyMs / currentMs;
+  t.diagnostic(
+    `class-transformer: ${legacyMs.toFixed(1)} ms, compiled readers: ${currentMs.toFixed(1)} ms, ` +
+      `speedup: ${speedup.toFixed(1)}x`
+  );
+
+  assert.ok(
+    speedup >= MIN_SPEEDUP,
+    `compiled readers were ${speedup.toFixed(1)}x as fast as class-transformer, expected at least ${MIN_SPEEDUP}x`
+  );
+});
+
+test('wire format cache entries are smaller than plain JSON', (t) => {
+  const model = deserializeSemanticModel(buildLargeModel(2000));
+  const plainText = JSON.stringify(model);
+  const wireText = JSON.stringify(encodeSemanticModel(model));
+
+  // What a cache hit does: parse the file text and rebuild the model
+  const plainMs = bestTime(() => deserializeSemanticModel(JSON.parse(plainText)));
+  const wireMs = bestTime(() => deserializeSemanticModel(JSON.parse(wireText)));
+  const sizeRatio = wireText.length / plainText.length;
+  t.diagnostic(
+    `plain: ${(plainText.length / 1024).toFixed(0)} KiB, ${plainMs.toFixed(1)} ms; ` +
+      `wire: ${(wireText.length / 1024).toFixed(0)} KiB, ${wireMs.toFixed(1)} ms; ` +
+      `size ratio: ${sizeRatio.toFixed(2)}, time ratio: ${(wireMs / plainMs).toFixed(2)}`
+  );
+
+  const decoded = deserializeSemanticModel(JSON.parse(wireText));
+  assert.strictEqual(decoded.dialogs.DIA_Bench_1999.properties.condition, decoded.functions.DIA_Bench_1999_Condition);
+  assert.ok(sizeRatio < 0.75, `wire entries were ${sizeRatio.toFixed(2)} of the plain JSON size`);
+});
@@ -0,0 +1,43 @@
+const { test, describe } = require('node:test');
+const { strict: assert } = require('node:assert');
+const DaedalusParser = require('../../src/core/parser');
+const { STRESS_SHAPES } = require('../../scripts/stress-corpus');
+const { analyze } = require('../stress-analysis');
+
+// Growing an input GROWTH times may grow the time by at most GROWTH * SLACK (plus a
+// small floor against timer noise); a quadratic pass grows it by GROWTH squared.
+// Wall-clock ratios depend on the machine's load, so this runs in `npm run test:stress`
+// rather than `npm test`.
+const GROWTH = 4;
+const SLACK = 2.5;
+const NOISE_FLOOR_MS = 20;
+
+/** Fastest of a few runs, in milliseconds */
+function bestTime(fn, runs = 3) {
+  let best = Infinity;
+  for (let i = 0; i < runs; i += 1) {
+    const start = process.hrtime.bigint();
+    fn();
+    best = Math.min(best, Number(process.hrtime.bigint() - start) / 1_000_000);
+  }
+  return best;
+}
+
+describe('Pathological inputs (timing)', () => {
+  const parser = new DaedalusParser();
+
+  for (const [shape, { defaultSize, generate }] of Object.entries(STRESS_SHAPES)) {
+    test(`${shape} is analyzed in linear time`, { timeout: 60_000 }, () => {
+      const small = generate(defaultSize);
+      const large = generate(defaultSize * GROWTH);
+
+      const smallMs = bestTime(() => analyze(parser, small));
+      const largeMs = bestTime(() => analyze(parser, large));
+      assert.ok(
+        largeMs <= smallMs * GROWTH * SLACK + NOISE_FLOOR_MS,
+        `${shape}: ${GROWTH}x the input took ${(largeMs / smallMs).toFixed(1)}x as long `
+          + `(${smallMs.toFixed(1)} ms -> ${largeMs.toFixed(1)} ms)`
+      );
+    });
+  }
+});
@@ -64,3 +64,88 @@ func void DIA_Test_Smoke_Next()
   assert.equal(summary.choiceTargetIncreases, 0, 'Should not create new missing choice targets');
   assert.equal(summary.semanticIdempotenceDriftFiles, 0, 'Second pass should be semantically stable');
 });
+
+test('roundtrip corpus runner skips unchanged clean files on the next run', () => {
+  const tmpRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'roundtrip-corpus-cache-'));
+  const corpusDir = path.join(tmpRoot, 'corpus');
+  const reportDir = path.join(tmpRoot, 'reports');
+  fs.mkdirSync(corpusDir, { recursive: true });
+
+  for (const name of ['DIA_Cache_A', 'DIA_Cache_B']) {
+    fs.writeFileSync(path.join(corpusDir, `${name}.d`), `
+func void ${name}_Info()
+{
+\tAI_Output(other, self, "${name}_15_00");
+};
+`, 'utf8');
+  }
+
+  const scriptPath = path.resolve(__dirname, '..', 'scripts', 'roundtrip-corpus.js');
+  const run = () => {
+    execFileSync(process.execPath, [
+      scriptPath,
+      '--root', corpusDir,
+      '--report-dir', reportDir,
+      '--report-prefix', 'cache-roundtrip-corpus',
+      '--jobs', '2'
+    ], { stdio: 'pipe' });
+    return JSON.parse(fs.readFileSync(path.join(reportDir, 'cache-roundtrip-corpus-summary.json'), 'utf8'));
+  };
+
+  const first = run();
+  assert.equal(first.scanned, 2);
+  assert.equal(first.okFiles, 2);
+  assert.equal(first.cachedFiles, 0);
+  assert.equal(first.workers, 2);
+  assert.ok(first.stageTimings.parse.totalMs > 0, 'Should report per-stage timings');
+
+  fs.appendFileSync(path.join(corpusDir, 'DIA_Cache_B.d'), '\n// touched\n', 'utf8');
+  const second = run();
+  assert.equal(second.scanned, 2);
+  assert.equal(second.okFiles, 2, 'Cached results should still count towards the report');
+  assert.equal(second.cachedFiles, 1, 'Only the changed file should be analyzed again');
+});
+
+test('roundtrip corpus runner keeps cache entries of files a partial run skipped', () => {
+  const tmpRoot = fs.mkdtempSync(path.join(os.tmpdir(), 'roundtrip-corpus-merge-'));
+  const corpusDir = path.join(tmpRoot, 'corpus');
+  const reportDir = path.join(tmpRoot, 'reports');
+  fs.mkdirSync(corpusDir, { recursive: true });
+
+  for (const name of ['DIA_Merge_A', 'DIA_Merge_B', 'DIA_Merge_C']) {
+    fs.writeFileSync(path.join(corpusDir, `${name}.d`), `
+func void ${name}_Info()
+{
+\tAI_Output(other, self, "${name}_15_00");
+};
+`, 'utf8');
+  }
+
+  const scriptPath = path.resolve(__dirname, '..', 'scripts', 'roundtrip-corpus.js');
+  const run = (...extraArgs) => {
+    execFileSync(process.execPath, [
+      scriptPath,
+      '--root', corpusDir,
+      '--report-dir', reportDir,
+      '--report-prefix', 'merge-roundtrip-corpus',
+      '--jobs', '1',
+      ...extraArgs
+    ], { stdio: 'pipe' });
+    return JSON.parse(fs.readFileSync(path.join(reportDir, 'merge-roundtrip-corpus-summary.json'), 'utf8'));
+  };
+
+  assert.equal(run().cachedFiles, 0);
+  assert.equal(run('--max-files', '1').cachedFiles, 1);
+
+  fs.rmSync(path.join(corpusDir, 'DIA_Merge_C.d'));
+  const full = run();
+  assert.equal(full.scanned, 2);
+  assert.equal(full.cachedFiles, 2, 'The partial run should not have dropped the other entries');
+
+  const cache = JSON.parse(fs.readFileSync(path.join(reportDir, 'merge-roundtrip-corpus-cache.json'), 'utf8'));
+  assert.deepEqual(
+    Object.keys(cache.files).map((file) => path.basename(file)).sort(),
+    ['DIA_Merge_A.d', 'DIA_Merge_B.d'],
+    'Entries of deleted files should be pruned'
+  );
+});
@@ -256,6 +256,113 @@ test('SemanticCodeGenerator should handle empty semantic model', () => {
   assert.ok(result.length === 0 || result.trim() === '');
 });
 
+// ===================================================================
+// FRAGMENT CACHE TESTS
+// ===================================================================
+
+function buildCacheTestModel() {
+  const { Dialog, DialogFunction, DialogLine } = require('../dist/semantic/semantic-visitor-index');
+
+  const info = new DialogFunction('DIA_Test_Hello_Info', 'void');
+  info.actions.push(new DialogLine('other', 'Hi!', 'DIA_Test_Hello_15_00'));
+
+  const dialog = new Dialog('DIA_Test_Hello', 'C_INFO');
+  dialog.properties.npc = 'TEST_NPC';
+  dialog.properties.nr = 1;
+  dialog.properties.information = info;
+
+  return {
+    dialogs: { DIA_Test_Hello: dialog },
+    functions: { DIA_Test_Hello_Info: info },
+    declarationOrder: [
+      { type: 'dialog', name: 'DIA_Test_Hello' },
+      { type: 'function', name: 'DIA_Test_Hello_Info' }
+    ]
+  };
+}
+
+test('SemanticCodeGenerator fragment cache should reuse fragments for unchanged declarations', () => {
+  const { GeneratedCodeCache } = require('../dist/codegen/generator');
+  const fragmentCache = new GeneratedCodeCache();
+  const model = buildCacheTestModel();
+  const uncached = new SemanticCodeGenerator().generateSemanticModel(model);
+
+  const first = new SemanticCodeGenerator({ fragmentCache }).generateSemanticModel(model);
+  const second = new SemanticCodeGenerator({ fragmentCache }).generateSemanticModel(model);
+
+  assert.equal(first, uncached);
+  assert.equal(second, uncached);
+  assert.deepEqual(fragmentCache.getStats(), { hits: 2, misses: 2, size: 2 });
+});
+
+test('SemanticCodeGenerator fragment cache should regenerate declarations marked as changed', () => {
+  const { GeneratedCodeCache } = require('../dist/codegen/generator');
+  const { markDeclarationChanged } = require('../dist/semantic/semantic-model');
+  const fragmentCache = new GeneratedCodeCache();
+  const generator = new SemanticCodeGenerator({ fragmentCache });
+  const model = buildCacheTestModel();
+
+  generator.generateSemanticModel(model);
+  model.functions.DIA_Test_Hello_Info.actions[0].text = 'Changed!';
+  markDeclarationChanged(model.functions.DIA_Test_Hello_Info);
+  const result = generator.generateSemanticModel(model);
+
+  assert.ok(result.includes('//Changed!'));
+  assert.ok(!result.includes('//Hi!'));
+  // The dialog instance only references the function by name and stays cached
+  assert.equal(fragmentCache.getStats().hits, 1);
+});
+
+test('SemanticCodeGenerator fragment cache should key deserialized declarations by their plain source', () => {
+  const { GeneratedCodeCache } = require('../dist/codegen/generator');
+  const { deserializeSemanticModel } = require('../dist/semantic/semantic-model');
+  const fragmentCache = new GeneratedCodeCache();
+  const generator = new SemanticCodeGenerator({ fragmentCache });
+  const plain = JSON.parse(JSON.stringify(buildCacheTestModel()));
+
+  const first = generator.generateSemanticModel(deserializeSemanticModel(plain));
+  // A new version of the model that shares the unchanged dialog, as structural sharing does
+  const edited = JSON.parse(JSON.stringify(plain.functions.DIA_Test_Hello_Info));
+  edited.actions[0].text = 'Changed!';
+  const next = { ...plain, functions: { ...plain.functions, DIA_Test_Hello_Info: edited } };
+  const second = generator.generateSemanticModel(deserializeSemanticModel(next));
+
+  assert.ok(first.includes('//Hi!'));
+  assert.ok(second.includes('//Changed!'));
+  assert.deepEqual(fragmentCache.getStats(), { hits: 1, misses: 3, size: 3 });
+});
+
+test('SemanticCodeGenerator fragment cache should key fragments by generator options', () => {
+  const { GeneratedCodeCache } = require('../dist/codegen/generator');
+  const fragmentCache = new GeneratedCodeCache();
+  const model = buildCacheTestModel();
+
+  const withComments = new SemanticCodeGenerator({ fragmentCache }).generateSemanticModel(model);
+  const withoutComments = new SemanticCodeGenerator({ fragmentCache, includeComments: false })
+    .generateSemanticModel(model);
+
+  assert.ok(withComments.includes('//Hi!'));
+  assert.ok(!withoutComments.includes('//Hi!'));
+});
+
+test('SemanticCodeGenerator chunks should concatenate to the full generated file', () => {
+  const generator = new SemanticCodeGenerator();
+  const model = buildCacheTestModel();
+  const { DialogFunction } = require('../dist/semantic/semantic-visitor-index');
+  model.functions.Standalone_Func = new DialogFunction('Standalone_Func', 'int');
+
+  const chunks = Array.from(generator.generateSemanticModelChunks(model));
+
+  assert.ok(chunks.length > 1, 'Should yield more than one chunk');
+  assert.equal(chunks.join(''), generator.generateSemanticModel(model));
+
+  delete model.declarationOrder;
+  assert.equal(
+    Array.from(generator.generateSemanticModelChunks(model)).join(''),
+    generator.generateSemanticModel(model)
+  );
+});
+
 // ===================================================================
 // VALIDATION AND ROBUSTNESS TESTS
 // ===================================================================
@@ -0,0 +1,63 @@
+/**
+ * Semantic model fixtures shared by the serialization tests and benchmarks
+ */
+
+/**
+ * Plain-JSON model (as IPC delivers it) with `functionCount` dialogs, each with
+ * an information function full of nested actions and a condition function
+ * @param {number} functionCount - Number of dialogs; the model has twice as many functions
+ * @returns {Object} Plain semantic model
+ */
+function buildLargeModel(functionCount) {
+  const functions = {};
+  const dialogs = {};
+  for (let i = 0; i < functionCount; i++) {
+    const name = `DIA_Bench_${i}`;
+    functions[`${name}_Info`] = {
+      name: `${name}_Info`,
+      returnType: 'void',
+      calls: ['AI_StopProcessInfos'],
+      conditions: [],
+      actions: [
+        { type: 'DialogLine', speaker: 'other', listener: 'self', text: `Line ${i}`, id: `${name}_15_00` },
+        { type: 'DialogLine', speaker: 'self', listener: 'other', text: `Reply ${i}`, id: `${name}_03_01` },
+        { type: 'SetVariableAction', variableName: 'MIS_Bench', operator: '=', value: i },
+        { type: 'CreateInventoryItems', target: 'other', item: 'ItMi_Gold', quantity: 10 },
+        { type: 'TeachAction', teachFunctionName: 'B_TeachAttributePoints', teachArgs: ['self', 'other', 'ATR_STRENGTH', '1'] },
+        {
+          type: 'ConditionalAction',
+          condition: 'MIS_Bench == LOG_RUNNING',
+          thenActions: [{ type: 'LogEntry', topic: 'TOPIC_Bench', text: `Entry ${i}` }],
+          elseActions: [{ type: 'Choice', dialogRef: name, text: 'Back', targetFunction: `${name}_Back` }]
+        }
+      ]
+    };
+    functions[`${name}_Condition`] = {
+      name: `${name}_Condition`,
+      returnType: 'int',
+      calls: [],
+      actions: [],
+      conditions: [
+        { type: 'NpcKnowsInfoCondition', npc: 'other', dialogRef: name },
+        { type: 'VariableCondition', variableName: 'MIS_Bench', negated: false, operator: '==', value: 'LOG_RUNNING' }
+      ]
+    };
+    dialogs[name] = {
+      name,
+      parent: 'C_INFO',
+      properties: {
+        npc: 'BDT_Bench',
+        nr: i,
+        description: `Bench ${i}`,
+        information: { name: `${name}_Info`, returnType: 'void' },
+        condition: { name: `${name}_Condition`, returnType: 'int' }
+      },
+      actions: []
+    };
+  }
+  return { dialogs, functions, hasErrors: false, errors: [] };
+}
+
+module.exports = {
+  buildLargeModel
+};
@@ -6,6 +6,7 @@ const {
   DialogFunction,
   DialogLine
 } = require('../dist/semantic/semantic-visitor-index');
+const { buildLargeModel } = require('./semantic-model-fixtures');
 
 test('deserializeSemanticModel should reconstruct full object graph', () => {
   // 1. Create a "serialized" plain object structure (what IPC sends)
@@ -173,3 +174,75 @@ test('deserializeSemanticModel should handle global constants and variables', ()
   assert.equal(model.variables['MIS_Test'].name, 'MIS_Test');
   assert.equal(model.variables['MIS_Test'].type, 'int');
 });
+
+test('deserializeSemanticModel round-trips instances, links, nested actions and extra fields', () => {
+  const {
+    ConditionalAction,
+    LogEntry,
+    TeachAction,
+    VariableCondition,
+    DialogFunction: DialogFunctionClass
+  } = require('../dist/semantic/semantic-visitor-index');
+
+  const plain = buildLargeModel(2);
+  plain.functions.DIA_Bench_0_Info.actions[0].editorId = 'kept';
+  plain.functions.DIA_Bench_0_Info.actions.push({ type: 'FutureAction', payload: 1 });
+  const model = deserializeSemanticModel(plain);
+
+  // What crosses IPC or postMessage back to the next reader
+  const decoded = deserializeSemanticModel(structuredClone(model));
+  const info = decoded.functions.DIA_Bench_0_Info;
+  assert.ok(info instanceof DialogFunctionClass);
+  assert.ok(info.actions[0] instanceof DialogLine);
+  assert.equal(info.actions[0].editorId, 'kept');
+  assert.ok(info.actions[4] instanceof TeachAction);
+  assert.deepEqual(info.actions[4].teachArgs, ['self', 'other', 'ATR_STRENGTH', '1']);
+  assert.ok(info.actions[5] instanceof ConditionalAction);
+  assert.ok(info.actions[5].thenActions[0] instanceof LogEntry);
+  assert.deepEqual(info.actions[6], { type: 'FutureAction', payload: 1 });
+  assert.ok(decoded.functions.DIA_Bench_0_Condition.conditions[1] instanceof VariableCondition);
+  assert.strictEqual(decoded.dialogs.DIA_Bench_0.properties.information, info);
+
+  assert.deepEqual(JSON.parse(JSON.stringify(decoded)), JSON.parse(JSON.stringify(model)));
+});
+
+test('wire format round-trips instances, links, nested actions and extra fields', () => {
+  const {
+    encodeSemanticModel,
+    decodeSemanticModel,
+    ConditionalAction,
+    LogEntry,
+    DialogFunction: DialogFunctionClass
+  } = require('../dist/semantic/semantic-visitor-index');
+
+  const plain = buildLargeModel(2);
+  plain.functions.DIA_Bench_0_Info.actions[0].editorId = 'kept';
+  plain.functions.DIA_Bench_0_Info.actions.push({ type: 'FutureAction', payload: 1 });
+  const model = deserializeSemanticModel(plain);
+
+  // Written to and read back from a cache file
+  const wire = JSON.parse(JSON.stringify(encodeSemanticModel(model)));
+  assert.equal(wire.version, 1);
+  assert.ok(Array.isArray(wire.model.functions.DIA_Bench_0_Info.actions[0]), 'actions should be tagged tuples');
+  assert.deepEqual(wire.model.dialogs.DIA_Bench_0.properties.information, { name: 'DIA_Bench_0_Info', returnType: 'void' });
+
+  const decoded = decodeSemanticModel(wire);
+  const info = decoded.functions.DIA_Bench_0_Info;
+  assert.ok(info instanceof DialogFunctionClass);
+  assert.ok(info.actions[0] instanceof DialogLine);
+  assert.equal(info.actions[0].editorId, 'kept');
+  assert.ok(info.actions[5] instanceof ConditionalAction);
+  assert.ok(info.actions[5].thenActions[0] instanceof LogEntry);
+  assert.deepEqual(info.actions[6], { type: 'FutureAction', payload: 1 });
+  assert.strictEqual(decoded.dialogs.DIA_Bench_0.properties.information, info);
+
+  assert.deepEqual(JSON.parse(JSON.stringify(decoded)), JSON.parse(JSON.stringify(model)));
+  assert.deepEqual(JSON.parse(JSON.stringify(deserializeSemanticModel(wire))), JSON.parse(JSON.stringify(model)));
+});
+
+test('wire format rejects other versions and unknown types', () => {
+  const { encodeSemanticModel, decodeSemanticModel } = require('../dist/semantic/semantic-visitor-index');
+  const wire = encodeSemanticModel(deserializeSemanticModel(buildLargeModel(1)));
+  assert.throws(() => decodeSemanticModel({ ...wire, version: 99 }), /Unsupported semantic model wire version 99/);
+  assert.throws(() => decodeSemanticModel({ ...wire, actionTypes: ['Nope'] }), /Unknown action type 'Nope'/);
+});
@@ -0,0 +1,17 @@
+const { SemanticModelBuilderVisitor } = require('../dist/semantic/semantic-visitor-index');
+
+/**
+ * Everything that walks the tree: parse (collectErrors when broken), comment
+ * extraction, and the error, declaration and linking passes of the semantic model
+ */
+function analyze(parser, source) {
+  const result = parser.parse(source);
+  const comments = parser.extractComments(result);
+  const visitor = new SemanticModelBuilderVisitor();
+  visitor.checkForSyntaxErrors(result.rootNode, source);
+  visitor.pass1_createObjects(result.rootNode);
+  visitor.pass2_analyzeAndLink(result.rootNode);
+  return { result, comments, model: visitor.semanticModel };
+}
+
+module.exports = { analyze };
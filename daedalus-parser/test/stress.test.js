@@ -0,0 +1,50 @@
+const { test, describe } = require('node:test');
+const { strict: assert } = require('node:assert');
+const DaedalusParser = require('../src/core/parser');
+const { STRESS_SHAPES } = require('../scripts/stress-corpus');
+const { analyze } = require('./stress-analysis');
+
+// Inputs this many times the default size; the timing check that they stay linear is
+// test/perf/stress.perf.test.js (npm run test:stress)
+const GROWTH = 4;
+
+describe('Pathological inputs', () => {
+  const parser = new DaedalusParser();
+
+  for (const [shape, { defaultSize, generate }] of Object.entries(STRESS_SHAPES)) {
+    test(`${shape} is analyzed without overflowing the stack`, { timeout: 60_000 }, () => {
+      const large = generate(defaultSize * GROWTH);
+
+      const { result, model } = analyze(parser, large);
+      assert.equal(result.rootNode.type, 'program');
+      if (shape.startsWith('broken-')) {
+        assert.ok(model.hasErrors, 'broken input should be flagged');
+        assert.ok(result.errors.length > 0, 'collectErrors should report the broken statements');
+        assert.ok(model.errors.length > 0, 'the semantic model should report the broken statements');
+      } else {
+        assert.equal(result.hasErrors, false, `${shape} should parse cleanly`);
+      }
+    });
+  }
+
+  test('deep nesting does not overflow the stack', () => {
+    const depth = STRESS_SHAPES['nested-parentheses'].defaultSize * 10;
+    const { model } = analyze(parser, STRESS_SHAPES['nested-parentheses'].generate(depth));
+    const condition = model.functions.DIA_Stress_Parens_Condition;
+    assert.equal(condition.conditions.length, 1, 'the nested Npc_KnowsInfo should still be one condition');
+  });
+
+  test('every else-if branch keeps its comment', () => {
+    const branches = STRESS_SHAPES['else-if-chain'].defaultSize;
+    const { comments } = analyze(parser, STRESS_SHAPES['else-if-chain'].generate(branches));
+    // The chain is generated into both the condition and the information function
+    assert.equal(comments.length, branches * 2);
+    assert.equal(comments[comments.length - 1].content, `branch ${branches - 1}`);
+  });
+
+  test('every term of a long && chain becomes a condition', () => {
+    const terms = STRESS_SHAPES['logical-chain'].defaultSize;
+    const { model } = analyze(parser, STRESS_SHAPES['logical-chain'].generate(terms));
+    assert.equal(model.functions.DIA_Stress_Logical_Condition.conditions.length, terms);
+  });
+});
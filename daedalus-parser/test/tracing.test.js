@@ -0,0 +1,43 @@
+const { test } = require('node:test');
+const { strict: assert } = require('node:assert');
+const tracing = require('../src/core/tracing');
+
+test('tracing records nothing while disabled', () => {
+  tracing.disableTracing();
+  tracing.drainTraceEvents();
+
+  assert.equal(tracing.traceSpan('idle', () => 42), 42);
+  tracing.beginSpan('idle')();
+  assert.deepEqual(tracing.drainTraceEvents(), []);
+});
+
+test('tracing records nested spans as Chrome complete events', async () => {
+  tracing.enableTracing({ pid: 7, tid: 3, threadName: 'test thread' });
+  try {
+    tracing.traceSpan('outer', () => {
+      tracing.traceSpan('inner', () => undefined, { size: 1 });
+    });
+    const value = await tracing.traceAsync('async', async () => 'done');
+    assert.equal(value, 'done');
+    assert.throws(() => tracing.traceSpan('failing', () => {
+      throw new Error('boom');
+    }), /boom/);
+  } finally {
+    tracing.disableTracing();
+  }
+
+  const events = tracing.drainTraceEvents();
+  assert.deepEqual(events.map((event) => event.name), ['thread_name', 'inner', 'outer', 'async', 'failing']);
+
+  const inner = events.find((event) => event.name === 'inner');
+  const outer = events.find((event) => event.name === 'outer');
+  assert.equal(inner.ph, 'X');
+  assert.equal(inner.pid, 7);
+  assert.equal(inner.tid, 3);
+  assert.deepEqual(inner.args, { size: 1 });
+  assert.ok(inner.ts >= outer.ts && inner.ts + inner.dur <= outer.ts + outer.dur, 'inner should nest inside outer');
+
+  const trace = JSON.parse(JSON.stringify(tracing.toChromeTrace(events)));
+  assert.equal(trace.traceEvents.length, events.length);
+  assert.deepEqual(tracing.drainTraceEvents(), []);
+});